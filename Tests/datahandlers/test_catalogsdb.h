@@ -17,6 +17,7 @@
 #include <qtestcase.h>
 #include "catalogsdb.h"
 #include "skymesh.h"
+#include "trixelloader.h"
 
 using namespace CatalogsDB;
 class TestCatalogsDB_DBManager : public QObject
@@ -454,6 +455,48 @@ class TestCatalogsDB_DBManager : public QObject
         QVERIFY(f1.result() && f2.result());
     }
 
+    void trixel_loader()
+    {
+        TrixelLoader loader{ m_manager.db_file_name() };
+        const int num_trixels = SkyMesh::Create(m_manager.htmesh_level())->size();
+
+        std::vector<TrixelLoader::Request> requests;
+        for (int trixel = 0; trixel < num_trixels; trixel++)
+        {
+            requests.push_back({ trixel, TrixelLoader::Query::KnownMag });
+            requests.push_back({ trixel, TrixelLoader::Query::UnknownMag });
+        }
+
+        std::vector<TrixelLoader::Result> results;
+        const auto collect = [&]() {
+            for (auto &result : loader.takeResults())
+                results.push_back(std::move(result));
+            return results.size();
+        };
+
+        loader.request(requests);
+        QTRY_COMPARE_WITH_TIMEOUT(collect(), requests.size(), 10000);
+
+        // in the order requested and the same as loaded directly
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const auto &result = results[i];
+            QCOMPARE(result.trixel, requests[i].trixel);
+            QVERIFY(result.query == requests[i].query);
+            QVERIFY(result.objects ==
+                    (result.query == TrixelLoader::Query::KnownMag ?
+                         m_manager.get_objects_in_trixel_no_nulls(result.trixel) :
+                         m_manager.get_objects_in_trixel_null_mag(result.trixel)));
+        }
+
+        // nothing arrives after clearing
+        results.clear();
+        loader.request(requests);
+        loader.clear();
+        QTest::qWait(100);
+        QCOMPARE(collect(), size_t(0));
+    }
+
     void statistics()
     {
         auto success_add =
@@ -0,0 +1,166 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef FITSSTATISTICSREFERENCE_H
+#define FITSSTATISTICSREFERENCE_H
+
+#include "fitsviewer/fitsstatistics.h"
+
+#include <fitsio.h>
+
+#include <QList>
+#include <QPair>
+#include <QRandomGenerator>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Shared by the FITS statistics tests and benchmarks
+namespace FITSStatisticsReference
+{
+const QList<QPair<const char *, uint32_t>> dataTypes =
+{
+    { "TBYTE", TBYTE }, { "TSHORT", TSHORT }, { "TUSHORT", TUSHORT }, { "TLONG", TLONG },
+    { "TULONG", TULONG }, { "TFLOAT", TFLOAT }, { "TLONGLONG", TLONGLONG }, { "TDOUBLE", TDOUBLE }
+};
+
+template <typename T>
+inline void fill(T *buffer, const uint32_t samples, const double background, const double sigma, const double hot,
+                 QRandomGenerator &generator)
+{
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        // Gaussian background by Box-Muller, with 1% hot pixels
+        const double u1 = std::max(generator.generateDouble(), 1e-12);
+        const double u2 = generator.generateDouble();
+        double value = background + sigma * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+        if (generator.generateDouble() < 0.01)
+            value = hot;
+        buffer[i] = static_cast<T>(std::max(static_cast<double>(std::numeric_limits<T>::lowest()),
+                                            std::min(value, static_cast<double>(std::numeric_limits<T>::max()))));
+    }
+}
+
+// The statistics calculated the simple way, one pass for each. Medians of 8 and 16 bit images are exact,
+// wider types use every downsample'th pixel like FITSStatistics
+template <typename T>
+inline FITSStatistics::Channel reference(const T *buffer, const uint32_t samples)
+{
+    double min = buffer[0], max = buffer[0];
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        min = std::min(min, static_cast<double>(buffer[i]));
+        max = std::max(max, static_cast<double>(buffer[i]));
+    }
+
+    double sum = 0;
+    for (uint32_t i = 0; i < samples; i++)
+        sum += buffer[i];
+    const double mean = sum / samples;
+
+    double squaredSum = 0;
+    for (uint32_t i = 0; i < samples; i++)
+        squaredSum += (buffer[i] - mean) * (buffer[i] - mean);
+    const double stddev = std::sqrt(squaredSum / samples);
+
+    const uint32_t downsample = (sizeof(T) <= 2) ? 1 :
+                                (samples + FITSStatistics::MaxMedianSamples - 1) / FITSStatistics::MaxMedianSamples;
+    std::vector<double> values;
+    for (uint32_t i = 0; i < samples; i += downsample)
+        values.push_back(buffer[i]);
+    std::sort(values.begin(), values.end());
+    const size_t n = values.size();
+    const double median = (n % 2) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+
+    return { min, max, mean, stddev, median };
+}
+
+inline FITSStatistics::Channel reference(const uint8_t *buffer, const uint32_t dataType, const uint32_t samples)
+{
+    switch (dataType)
+    {
+        case TBYTE:
+            return reference(buffer, samples);
+        case TSHORT:
+            return reference(reinterpret_cast<const int16_t *>(buffer), samples);
+        case TUSHORT:
+            return reference(reinterpret_cast<const uint16_t *>(buffer), samples);
+        case TLONG:
+            return reference(reinterpret_cast<const int32_t *>(buffer), samples);
+        case TULONG:
+            return reference(reinterpret_cast<const uint32_t *>(buffer), samples);
+        case TFLOAT:
+            return reference(reinterpret_cast<const float *>(buffer), samples);
+        case TLONGLONG:
+            return reference(reinterpret_cast<const int64_t *>(buffer), samples);
+        default:
+            return reference(reinterpret_cast<const double *>(buffer), samples);
+    }
+}
+
+inline int bytesPerPixel(const uint32_t dataType)
+{
+    switch (dataType)
+    {
+        case TBYTE:
+            return 1;
+        case TSHORT:
+        case TUSHORT:
+            return 2;
+        case TLONG:
+        case TULONG:
+        case TFLOAT:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+// Fill a planar image of the data type with noisy background and a few hot pixels
+inline std::vector<uint8_t> makeImage(const uint32_t dataType, const uint32_t samples, const int channels)
+{
+    QRandomGenerator generator(42);
+    std::vector<uint8_t> image(samples * channels * bytesPerPixel(dataType));
+    for (int n = 0; n < channels; n++)
+    {
+        // Each channel has a different background
+        const double offset = 100.0 * n;
+        switch (dataType)
+        {
+            case TBYTE:
+                fill(image.data() + n * samples, samples, 20 + offset / 10, 5, 255, generator);
+                break;
+            case TSHORT:
+                fill(reinterpret_cast<int16_t *>(image.data()) + n * samples, samples, offset, 30, 32000, generator);
+                break;
+            case TUSHORT:
+                fill(reinterpret_cast<uint16_t *>(image.data()) + n * samples, samples, 1000 + offset, 30, 65535, generator);
+                break;
+            case TLONG:
+                fill(reinterpret_cast<int32_t *>(image.data()) + n * samples, samples, -5000 + offset, 300, 1e9, generator);
+                break;
+            case TULONG:
+                fill(reinterpret_cast<uint32_t *>(image.data()) + n * samples, samples, 1e5 + offset, 300, 4e9, generator);
+                break;
+            case TFLOAT:
+                fill(reinterpret_cast<float *>(image.data()) + n * samples, samples, 0.1 + offset / 1e4, 0.003, 1.0, generator);
+                break;
+            case TLONGLONG:
+                fill(reinterpret_cast<int64_t *>(image.data()) + n * samples, samples, 1e5 + offset, 300, 1e12, generator);
+                break;
+            case TDOUBLE:
+                fill(reinterpret_cast<double *>(image.data()) + n * samples, samples, 0.1 + offset / 1e4, 0.003, 1.0, generator);
+                break;
+        }
+    }
+    return image;
+}
+}
+
+#endif // FITSSTATISTICSREFERENCE_H
@@ -0,0 +1,131 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef STACKREJECTIONREFERENCE_H
+#define STACKREJECTIONREFERENCE_H
+
+#include "fitsviewer/fitsstackrejection.h"
+#include "robuststatistics.h"
+
+#include <QRandomGenerator>
+#include <QVector>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Shared by the stack rejection tests and benchmarks
+namespace StackRejectionReference
+{
+constexpr double lowSigma = 2.5;
+constexpr double highSigma = 2.5;
+constexpr double winsorCutoff = 2.0;
+
+// The per-pixel sigma clipping that FITSStack used before FITSStackRejection, kept as a reference, and
+// extended to return the running state of the accepted values
+inline void referenceRejection(const LiveStackRejection method, const std::vector<const float *> &images,
+                               const QVector<float> &weights, const int pixels, const int channels,
+                               float *result, const QVector<float *> &state)
+{
+    const int numImages = images.size();
+    for (int x = 0; x < pixels; x++)
+    {
+        std::vector<float> values(numImages);
+        for (int ch = 0; ch < channels; ch++)
+        {
+            for (int image = 0; image < numImages; image++)
+                values[image] = images[image][x * channels + ch];
+
+            float pixelValue = 0.0;
+
+            if (method == LS_STACKING_REJ_WINDSOR)
+            {
+                float median = Mathematics::RobustStatistics::ComputeLocation(
+                                   Mathematics::RobustStatistics::LOCATION_MEDIAN, values);
+                auto const stddev = std::sqrt(Mathematics::RobustStatistics::ComputeScale(
+                                                  Mathematics::RobustStatistics::SCALE_VARIANCE, values));
+
+                float lower = std::max(0.0, median - (stddev * winsorCutoff));
+                float upper = median + (stddev * winsorCutoff);
+
+                for (unsigned int i = 0; i < values.size(); i++)
+                {
+                    if (values[i] < lower)
+                        values[i] = lower;
+                    else if (values[i] > upper)
+                        values[i] = upper;
+                }
+            }
+
+            float median = Mathematics::RobustStatistics::ComputeLocation(
+                               Mathematics::RobustStatistics::LOCATION_MEDIAN, values);
+
+            // Values too few to reject any are all accepted into the state
+            float lower = std::numeric_limits<float>::lowest(), upper = std::numeric_limits<float>::max();
+            if (values.size() > 3)
+            {
+                auto const stddev = std::sqrt(Mathematics::RobustStatistics::ComputeScale(
+                                                  Mathematics::RobustStatistics::SCALE_VARIANCE, values));
+
+                lower = std::max(0.0, median - (stddev * lowSigma));
+                upper = median + (stddev * highSigma);
+            }
+
+            float sum = 0.0, weightSum = 0.0, count = 0.0;
+            for (unsigned int i = 0; i < values.size(); i++)
+            {
+                if (values[i] < lower || values[i] > upper)
+                    continue;
+
+                sum += values[i] * weights[i];
+                weightSum += weights[i];
+                count++;
+            }
+
+            const float mean = (weightSum > 0.0) ? sum / weightSum : median;
+            float m2 = 0.0;
+            for (unsigned int i = 0; i < values.size(); i++)
+            {
+                if (values[i] >= lower && values[i] <= upper)
+                    m2 += weights[i] * (values[i] - mean) * (values[i] - mean);
+            }
+
+            pixelValue = (values.size() <= 3) ? median : mean;
+
+            float *pixelState = state[ch] + x * 4;
+            pixelState[0] = mean;
+            pixelState[1] = m2;
+            pixelState[2] = weightSum;
+            pixelState[3] = count;
+            result[x * channels + ch] = pixelValue;
+        }
+    }
+}
+
+// Fill subs with noisy background and a few outliers
+inline void makeSubs(const int numSubs, const int pixels, const int channels, std::vector<std::vector<float>> &subs)
+{
+    QRandomGenerator generator(42);
+    subs.assign(numSubs, std::vector<float>(pixels * channels));
+    for (auto &sub : subs)
+    {
+        for (auto &value : sub)
+        {
+            // Gaussian background by Box-Muller, with 2% hot and 1% dead pixels
+            const double u1 = std::max(generator.generateDouble(), 1e-12);
+            const double u2 = generator.generateDouble();
+            value = 1000.0 + 30.0 * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+            const double outlier = generator.generateDouble();
+            if (outlier < 0.02)
+                value *= 10.0f;
+            else if (outlier < 0.03)
+                value = 0.0f;
+        }
+    }
+}
+}
+
+#endif // STACKREJECTIONREFERENCE_H
@@ -0,0 +1,346 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include "testfitsconvolution.h"
+#include "fitsviewer/fitsconvolution.h"
+
+#include <fitsio.h>
+
+#include <QRandomGenerator>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace
+{
+const QList<QPair<const char *, uint32_t>> dataTypes =
+{
+    { "TBYTE", TBYTE }, { "TSHORT", TSHORT }, { "TUSHORT", TUSHORT }, { "TLONG", TLONG },
+    { "TULONG", TULONG }, { "TFLOAT", TFLOAT }, { "TLONGLONG", TLONGLONG }, { "TDOUBLE", TDOUBLE }
+};
+
+// The convolution calculated the simple way, one pixel at a time with bounds checks and double precision sums
+template <typename T>
+void reference(const T *source, T *destination, const uint32_t width, const uint32_t height,
+               const std::vector<double> &kernel, const int size)
+{
+    const int radius = size / 2;
+    for (int y = 0; y < static_cast<int>(height); y++)
+    {
+        for (int x = 0; x < static_cast<int>(width); x++)
+        {
+            double sum = 0;
+            for (int i = 0; i < size; i++)
+            {
+                for (int j = 0; j < size; j++)
+                {
+                    const int sourceY = y + i - radius, sourceX = x + j - radius;
+                    if (sourceY >= 0 && sourceY < static_cast<int>(height) && sourceX >= 0 && sourceX < static_cast<int>(width))
+                        sum += kernel[i * size + j] * source[sourceY * width + sourceX];
+                }
+            }
+            if (!std::is_floating_point<T>::value)
+                sum = std::max(static_cast<double>(std::numeric_limits<T>::lowest()),
+                               std::min(std::nearbyint(sum), static_cast<double>(std::numeric_limits<T>::max())));
+            destination[y * width + x] = static_cast<T>(sum);
+        }
+    }
+}
+
+void reference(const uint8_t *source, uint8_t *destination, const uint32_t dataType, const uint32_t width,
+               const uint32_t height, const std::vector<double> &kernel, const int size)
+{
+    switch (dataType)
+    {
+        case TBYTE:
+            return reference(source, destination, width, height, kernel, size);
+        case TSHORT:
+            return reference(reinterpret_cast<const int16_t *>(source), reinterpret_cast<int16_t *>(destination), width, height,
+                             kernel, size);
+        case TUSHORT:
+            return reference(reinterpret_cast<const uint16_t *>(source), reinterpret_cast<uint16_t *>(destination), width, height,
+                             kernel, size);
+        case TLONG:
+            return reference(reinterpret_cast<const int32_t *>(source), reinterpret_cast<int32_t *>(destination), width, height,
+                             kernel, size);
+        case TULONG:
+            return reference(reinterpret_cast<const uint32_t *>(source), reinterpret_cast<uint32_t *>(destination), width, height,
+                             kernel, size);
+        case TFLOAT:
+            return reference(reinterpret_cast<const float *>(source), reinterpret_cast<float *>(destination), width, height,
+                             kernel, size);
+        case TLONGLONG:
+            return reference(reinterpret_cast<const int64_t *>(source), reinterpret_cast<int64_t *>(destination), width, height,
+                             kernel, size);
+        default:
+            return reference(reinterpret_cast<const double *>(source), reinterpret_cast<double *>(destination), width, height,
+                             kernel, size);
+    }
+}
+
+int bytesPerPixel(const uint32_t dataType)
+{
+    switch (dataType)
+    {
+        case TBYTE:
+            return 1;
+        case TSHORT:
+        case TUSHORT:
+            return 2;
+        case TLONG:
+        case TULONG:
+        case TFLOAT:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+double pixel(const uint8_t *buffer, const uint32_t dataType, const uint32_t index)
+{
+    switch (dataType)
+    {
+        case TBYTE:
+            return buffer[index];
+        case TSHORT:
+            return reinterpret_cast<const int16_t *>(buffer)[index];
+        case TUSHORT:
+            return reinterpret_cast<const uint16_t *>(buffer)[index];
+        case TLONG:
+            return reinterpret_cast<const int32_t *>(buffer)[index];
+        case TULONG:
+            return reinterpret_cast<const uint32_t *>(buffer)[index];
+        case TFLOAT:
+            return reinterpret_cast<const float *>(buffer)[index];
+        case TLONGLONG:
+            return reinterpret_cast<const int64_t *>(buffer)[index];
+        default:
+            return reinterpret_cast<const double *>(buffer)[index];
+    }
+}
+
+// Largest difference between two images. 8 and 16 bit images and floats are summed in single precision, so
+// integers may round the other way and floats differ in the last few bits
+double maxDifference(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b, const uint32_t dataType)
+{
+    double result = 0;
+    const uint32_t samples = a.size() / bytesPerPixel(dataType);
+    for (uint32_t i = 0; i < samples; i++)
+        result = std::max(result, std::fabs(pixel(a.data(), dataType, i) - pixel(b.data(), dataType, i)));
+    return result;
+}
+}
+
+TestFitsConvolution::TestFitsConvolution(QObject *parent) : QObject(parent)
+{
+}
+
+std::vector<uint8_t> TestFitsConvolution::makeImage(const uint32_t dataType, const uint32_t samples,
+        const int channels)
+{
+    QRandomGenerator generator(42);
+    std::vector<uint8_t> image(samples * channels * bytesPerPixel(dataType));
+    for (uint32_t i = 0; i < samples * channels; i++)
+    {
+        // Values every type can hold, with a fraction for the floating point types
+        const double value = generator.bounded(250.0);
+        switch (dataType)
+        {
+            case TBYTE:
+                image[i] = static_cast<uint8_t>(value);
+                break;
+            case TSHORT:
+                reinterpret_cast<int16_t *>(image.data())[i] = static_cast<int16_t>(value * 100 - 12500);
+                break;
+            case TUSHORT:
+                reinterpret_cast<uint16_t *>(image.data())[i] = static_cast<uint16_t>(value * 250);
+                break;
+            case TLONG:
+                reinterpret_cast<int32_t *>(image.data())[i] = static_cast<int32_t>(value * 1e6 - 1e8);
+                break;
+            case TULONG:
+                reinterpret_cast<uint32_t *>(image.data())[i] = static_cast<uint32_t>(value * 1e6);
+                break;
+            case TFLOAT:
+                reinterpret_cast<float *>(image.data())[i] = static_cast<float>(value / 250);
+                break;
+            case TLONGLONG:
+                reinterpret_cast<int64_t *>(image.data())[i] = static_cast<int64_t>(value * 1e9);
+                break;
+            case TDOUBLE:
+                reinterpret_cast<double *>(image.data())[i] = value / 250;
+                break;
+        }
+    }
+    return image;
+}
+
+std::vector<double> TestFitsConvolution::makeKernel(const int size, const double sigma, const bool separable)
+{
+    std::vector<double> kernel(size * size);
+    const int radius = size / 2;
+    double sum = 0;
+    for (int y = -radius; y <= radius; y++)
+    {
+        for (int x = -radius; x <= radius; x++)
+        {
+            double &value = kernel[(y + radius) * size + x + radius];
+            value = std::exp(-(x * x + y * y) / (2 * sigma * sigma));
+            // Stretching one diagonal breaks the separability
+            if (!separable && x == y)
+                value *= 1.5;
+            sum += value;
+        }
+    }
+    for (auto &value : kernel)
+        value /= sum;
+    return kernel;
+}
+
+void TestFitsConvolution::testSeparate()
+{
+    std::vector<double> column, row;
+
+    const std::vector<double> gaussian = makeKernel(7, 1.5, true);
+    QVERIFY(FITSConvolution::separate(gaussian, 7, column, row));
+    for (int i = 0; i < 7; i++)
+    {
+        for (int j = 0; j < 7; j++)
+            QVERIFY(std::fabs(column[i] * row[j] - gaussian[i * 7 + j]) < 1e-12);
+    }
+
+    QVERIFY(!FITSConvolution::separate(makeKernel(7, 1.5, false), 7, column, row));
+
+    // A Laplacian isn't separable, a box filter is
+    QVERIFY(!FITSConvolution::separate({ 0, -1, 0, -1, 4, -1, 0, -1, 0 }, 3, column, row));
+    QVERIFY(FITSConvolution::separate(std::vector<double>(25, 1.0 / 25), 5, column, row));
+}
+
+void TestFitsConvolution::testMatchesReference_data()
+{
+    QTest::addColumn<uint>("dataType");
+    QTest::addColumn<bool>("separable");
+
+    for (const auto &dataType : dataTypes)
+    {
+        QTest::addRow("%s separable", dataType.first) << dataType.second << true;
+        QTest::addRow("%s dense", dataType.first) << dataType.second << false;
+    }
+}
+
+void TestFitsConvolution::testMatchesReference()
+{
+    QFETCH(uint, dataType);
+    QFETCH(bool, separable);
+
+    // Odd sizes, wider than the column tiles of the vertical pass, and a kernel larger than a few rows
+    const uint32_t width = 2501, height = 37;
+    const int size = separable ? 9 : 5;
+    const std::vector<double> kernel = makeKernel(size, 1.5, separable);
+    const std::vector<uint8_t> image = makeImage(dataType, width * height, 1);
+
+    std::vector<uint8_t> result(image.size()), expected(image.size());
+    QVERIFY(FITSConvolution::convolve(image.data(), result.data(), dataType, width, height, 1, kernel, size));
+    reference(image.data(), expected.data(), dataType, width, height, kernel, size);
+
+    const double tolerance = (dataType == TFLOAT || dataType == TDOUBLE) ? 1e-5 : 1;
+    const double difference = maxDifference(result, expected, dataType);
+    QVERIFY2(difference <= tolerance, qPrintable(QString("Largest difference %1").arg(difference)));
+}
+
+void TestFitsConvolution::testInPlace_data()
+{
+    QTest::addColumn<uint>("width");
+    QTest::addColumn<uint>("height");
+    QTest::addColumn<bool>("separable");
+
+    // Frames wide enough to be split into several bands of rows whatever the number of threads
+    for (const bool separable : { true, false })
+    {
+        QTest::addRow("640x480 %s", separable ? "separable" : "dense") << 640u << 480u << separable;
+        QTest::addRow("8192x300 %s", separable ? "separable" : "dense") << 8192u << 300u << separable;
+    }
+}
+
+void TestFitsConvolution::testInPlace()
+{
+    QFETCH(uint, width);
+    QFETCH(uint, height);
+    QFETCH(bool, separable);
+
+    const std::vector<double> kernel = makeKernel(7, 2, separable);
+    const std::vector<uint8_t> image = makeImage(TUSHORT, width * height, 1);
+
+    // Filtering in place must use the original pixels only, including in the halos of the bands
+    std::vector<uint8_t> outOfPlace(image.size()), inPlace = image, expected(image.size());
+    QVERIFY(FITSConvolution::convolve(image.data(), outOfPlace.data(), TUSHORT, width, height, 1, kernel, 7));
+    QVERIFY(FITSConvolution::convolve(inPlace.data(), inPlace.data(), TUSHORT, width, height, 1, kernel, 7));
+    QVERIFY(inPlace == outOfPlace);
+
+    reference(image.data(), expected.data(), TUSHORT, width, height, kernel, 7);
+    QVERIFY(maxDifference(outOfPlace, expected, TUSHORT) <= 1);
+}
+
+void TestFitsConvolution::testChannelsIndependent()
+{
+    const uint32_t width = 300, height = 200, samples = width * height;
+    const std::vector<double> kernel = makeKernel(5, 1, true);
+    const std::vector<uint8_t> image = makeImage(TFLOAT, samples, 3);
+    std::vector<uint8_t> result(image.size());
+    QVERIFY(FITSConvolution::convolve(image.data(), result.data(), TFLOAT, width, height, 3, kernel, 5));
+
+    // Each channel is blurred on its own, without pixels of the neighbouring channels bleeding in
+    for (int n = 0; n < 3; n++)
+    {
+        const size_t offset = n * samples * sizeof(float);
+        std::vector<uint8_t> channel(image.begin() + offset, image.begin() + offset + samples * sizeof(float));
+        std::vector<uint8_t> expected(channel.size());
+        reference(channel.data(), expected.data(), TFLOAT, width, height, kernel, 5);
+        std::vector<uint8_t> actual(result.begin() + offset, result.begin() + offset + samples * sizeof(float));
+        QVERIFY(maxDifference(actual, expected, TFLOAT) <= 1e-5);
+    }
+}
+
+void TestFitsConvolution::testConvolutionBenchmark_data()
+{
+    QTest::addColumn<bool>("reference");
+    QTest::addColumn<bool>("separable");
+
+    QTest::addRow("reference") << true << true;
+    QTest::addRow("separable") << false << true;
+    QTest::addRow("dense") << false << false;
+}
+
+void TestFitsConvolution::testConvolutionBenchmark()
+{
+    QFETCH(bool, reference);
+    QFETCH(bool, separable);
+
+    // A 4 MP 16 bit frame with a 9x9 Gaussian kernel
+    const uint32_t width = 2048, height = 2048;
+    const std::vector<double> kernel = makeKernel(9, 1.5, separable);
+    const std::vector<uint8_t> image = makeImage(TUSHORT, width * height, 1);
+    std::vector<uint8_t> result(image.size());
+
+    if (reference)
+    {
+        QBENCHMARK { ::reference(image.data(), result.data(), TUSHORT, width, height, kernel, 9); }
+    }
+    else
+    {
+        QBENCHMARK { FITSConvolution::convolve(image.data(), result.data(), TUSHORT, width, height, 1, kernel, 9); }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestFitsConvolution)
@@ -0,0 +1,41 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TESTFITSCONVOLUTION_H
+#define TESTFITSCONVOLUTION_H
+
+#include <QObject>
+
+#include <cstdint>
+#include <vector>
+
+class TestFitsConvolution : public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestFitsConvolution(QObject *parent = nullptr);
+
+    private slots:
+        void testSeparate();
+
+        void testMatchesReference_data();
+        void testMatchesReference();
+
+        void testInPlace_data();
+        void testInPlace();
+        void testChannelsIndependent();
+
+        void testConvolutionBenchmark_data();
+        void testConvolutionBenchmark();
+
+    private:
+        /** @brief Fill a planar image of the data type with random pixels */
+        static std::vector<uint8_t> makeImage(const uint32_t dataType, const uint32_t samples, const int channels);
+        /** @brief Normalised size x size Gaussian kernel, optionally made non-separable */
+        static std::vector<double> makeKernel(const int size, const double sigma, const bool separable);
+};
+
+#endif // TESTFITSCONVOLUTION_H
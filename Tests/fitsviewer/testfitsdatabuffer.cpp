@@ -0,0 +1,135 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include "testfitsdatabuffer.h"
+#include "fitsviewer/fitsdata.h"
+
+#include <fitsio.h>
+
+#include <QFile>
+#include <QRandomGenerator>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const long width = 64;
+const long height = 48;
+
+// Writes a width x height image of the given FITS type. Unless bzero is 0 it is written as a BZERO keyword,
+// and the pixel values are scaled by cfitsio. A compressed image goes into a tile compressed extension.
+bool writeImage(const QString &filename, int bitpix, double bzero, bool compressed, const std::vector<double> &values)
+{
+    int status = 0;
+    fitsfile *fptr = nullptr;
+    long naxes[2] = { width, height };
+    const QString name = QString("!%1%2").arg(filename, compressed ? "[compress]" : "");
+    if (fits_create_file(&fptr, name.toLocal8Bit().data(), &status) ||
+            fits_create_img(fptr, bitpix, 2, naxes, &status))
+        return false;
+    if (bzero != 0)
+    {
+        fits_update_key_dbl(fptr, "BZERO", bzero, -15, nullptr, &status);
+        fits_set_bscale(fptr, 1.0, bzero, &status);
+    }
+    fits_write_img(fptr, TDOUBLE, 1, values.size(), const_cast<double *>(values.data()), &status);
+    fits_close_file(fptr, &status);
+    return status == 0;
+}
+}
+
+TestFitsDataBuffer::TestFitsDataBuffer(QObject *parent) : QObject(parent)
+{
+}
+
+void TestFitsDataBuffer::testLoadFromBuffer_data()
+{
+    QTest::addColumn<int>("bitpix");
+    QTest::addColumn<double>("bzero");
+    QTest::addColumn<double>("minimum");
+    QTest::addColumn<double>("maximum");
+    QTest::addColumn<bool>("compressed");
+    QTest::addColumn<bool>("shared");
+    QTest::addColumn<bool>("adopted");
+
+    // USHORT images are stored signed with BZERO 32768, which is undone in place
+    QTest::newRow("USHORT") << static_cast<int>(USHORT_IMG) << 0.0 << 0.0 << 65535.0 << false << false << true;
+    QTest::newRow("USHORT shared") << static_cast<int>(USHORT_IMG) << 0.0 << 0.0 << 65535.0 << false << true << false;
+    QTest::newRow("USHORT compressed") << static_cast<int>(USHORT_IMG) << 0.0 << 0.0 << 65535.0 << true << false << true;
+    QTest::newRow("SHORT BZERO") << static_cast<int>(SHORT_IMG) << 1000.0 << 1000.0 << 30000.0 << false << false << false;
+    QTest::newRow("FLOAT") << static_cast<int>(FLOAT_IMG) << 0.0 << -50.0 << 1000.0 << false << false << true;
+    QTest::newRow("FLOAT BZERO") << static_cast<int>(FLOAT_IMG) << 100.5 << -50.0 << 1000.0 << false << false << false;
+}
+
+// Loading a frame moved into FITSData, which may convert its pixels in place, gives the same image as reading it
+// from disk through cfitsio.
+void TestFitsDataBuffer::testLoadFromBuffer()
+{
+    QFETCH(int, bitpix);
+    QFETCH(double, bzero);
+    QFETCH(double, minimum);
+    QFETCH(double, maximum);
+    QFETCH(bool, compressed);
+    QFETCH(bool, shared);
+    QFETCH(bool, adopted);
+
+    QVERIFY(m_Dir.isValid());
+    const QString filename = m_Dir.filePath(QString("%1.fits").arg(QTest::currentDataTag()).replace(' ', '_'));
+    QRandomGenerator generator(42);
+    std::vector<double> values(width * height);
+    const bool integer = (bitpix != FLOAT_IMG);
+    for (auto &value : values)
+    {
+        value = minimum + generator.generateDouble() * (maximum - minimum);
+        if (integer)
+            value = std::round(value);
+    }
+    QVERIFY(writeImage(filename, bitpix, bzero, compressed, values));
+
+    FITSData fromFile(FITS_GUIDE);
+    QVERIFY(fromFile.loadFromFile(filename).result());
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray buffer = file.readAll();
+    const QByteArray copy = shared ? buffer : QByteArray();
+    FITSData fromBuffer(FITS_GUIDE);
+    fromBuffer.setExtension("fits");
+    QVERIFY(fromBuffer.loadFromBuffer(std::move(buffer)));
+    QCOMPARE(fromBuffer.m_ImageBufferAdopted, adopted);
+
+    // The compressed frame isn't needed once it is unpacked
+    if (compressed)
+        QVERIFY(fromBuffer.m_FileBuffer.isEmpty());
+
+    const auto &fileStats = fromFile.getStatistics();
+    const auto &bufferStats = fromBuffer.getStatistics();
+    QCOMPARE(bufferStats.width, static_cast<uint16_t>(width));
+    QCOMPARE(bufferStats.height, static_cast<uint16_t>(height));
+    QCOMPARE(bufferStats.dataType, fileStats.dataType);
+    QCOMPARE(bufferStats.bytesPerPixel, fileStats.bytesPerPixel);
+    QVERIFY(std::memcmp(fromBuffer.getImageBuffer(), fromFile.getImageBuffer(),
+                        width * height * fileStats.bytesPerPixel) == 0);
+
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        const double actual = (bufferStats.dataType == TFLOAT) ?
+                              reinterpret_cast<const float *>(fromBuffer.getImageBuffer())[i] :
+                              reinterpret_cast<const uint16_t *>(fromBuffer.getImageBuffer())[i];
+        QVERIFY2(std::fabs(actual - values[i]) <= 1e-3,
+                 qPrintable(QString("Pixel %1: %2 != %3").arg(i).arg(actual).arg(values[i])));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestFitsDataBuffer)
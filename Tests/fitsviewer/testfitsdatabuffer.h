@@ -0,0 +1,27 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TESTFITSDATABUFFER_H
+#define TESTFITSDATABUFFER_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class TestFitsDataBuffer : public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestFitsDataBuffer(QObject *parent = nullptr);
+
+    private slots:
+        void testLoadFromBuffer_data();
+        void testLoadFromBuffer();
+
+    private:
+        QTemporaryDir m_Dir;
+};
+
+#endif // TESTFITSDATABUFFER_H
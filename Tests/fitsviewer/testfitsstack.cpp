@@ -0,0 +1,100 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include "testfitsstack.h"
+#include "fitsviewer/fitsstack.h"
+
+#include <cmath>
+
+namespace
+{
+const int width = 64;
+const int height = 48;
+const unsigned short subLevel = 10000;
+
+LiveStackData stackData()
+{
+    LiveStackData params;
+    params.alignMethod = LS_ALIGNMENT_NONE;
+    // More than the subs added so the initial stack isn't post processed
+    params.numInMem = 10;
+    params.downscale = LS_DOWNSCALE_NONE;
+    params.weighting = LS_STACKING_EQUAL;
+    params.rejection = LS_STACKING_REJ_NONE;
+    params.lowSigma = 2.5;
+    params.highSigma = 2.5;
+    params.windsorCutoff = 2.0;
+    params.tiled = false;
+    params.tileRows = 0;
+    params.postProcessing.postProcess = false;
+    return params;
+}
+}
+
+TestFITSStack::TestFITSStack(QObject *parent) : QObject(parent)
+{
+}
+
+bool TestFITSStack::readStackedImage(const QByteArray &fits, std::vector<unsigned short> &pixels)
+{
+    QByteArray buffer = fits;
+    void *data = buffer.data();
+    size_t size = buffer.size();
+    fitsfile *fptr = nullptr;
+    int status = 0;
+    if (fits_open_memfile(&fptr, "", READONLY, &data, &size, 0, nullptr, &status))
+        return false;
+
+    long naxes[2] = { 0, 0 };
+    int anynul = 0;
+    fits_get_img_size(fptr, 2, naxes, &status);
+    pixels.resize(naxes[0] * naxes[1]);
+    fits_read_img(fptr, TUSHORT, 1, pixels.size(), nullptr, pixels.data(), &anynul, &status);
+    int closeStatus = 0;
+    fits_close_file(fptr, &closeStatus);
+    return status == 0 && naxes[0] == width && naxes[1] == height;
+}
+
+void TestFITSStack::testNormalisedDark_data()
+{
+    QTest::addColumn<bool>("normalised");
+
+    QTest::newRow("ADU dark") << false;
+    QTest::newRow("normalised dark") << true;
+}
+
+void TestFITSStack::testNormalisedDark()
+{
+    QFETCH(bool, normalised);
+
+    // The masters are loaded before the first sub, as FITSData does
+    FITSStack stack(nullptr, stackData());
+    const float darkLevel = 2000.0f;
+    std::vector<float> dark(width * height, normalised ? darkLevel / 65535.0f : darkLevel);
+    stack.addMaster(true, dark.data(), width, height, sizeof(float), CV_32FC1);
+
+    std::vector<unsigned short> sub(width * height, subLevel);
+    for (int i = 0; i < 3; i++)
+    {
+        stack.setupNextSub();
+        QVERIFY(stack.addSub(sub.data(), CV_16UC1, width, height, sizeof(unsigned short)));
+        stack.addSubStatus(true);
+    }
+    QVERIFY(stack.stack());
+
+    std::vector<unsigned short> pixels;
+    QVERIFY(readStackedImage(stack.getStackedImage(), pixels));
+    for (const auto pixel : pixels)
+        QVERIFY(std::abs(pixel - (subLevel - darkLevel)) <= 1.0);
+}
+
+QTEST_GUILESS_MAIN(TestFITSStack)
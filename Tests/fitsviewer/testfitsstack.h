@@ -0,0 +1,29 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TESTFITSSTACK_H
+#define TESTFITSSTACK_H
+
+#include <QObject>
+
+#include <vector>
+
+class TestFITSStack : public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestFITSStack(QObject *parent = nullptr);
+
+    private slots:
+        void testNormalisedDark_data();
+        void testNormalisedDark();
+
+    private:
+        /** @brief Read the pixels of the stacked image, which FITSStack keeps as an in-memory FITS file */
+        static bool readStackedImage(const QByteArray &fits, std::vector<unsigned short> &pixels);
+};
+
+#endif // TESTFITSSTACK_H
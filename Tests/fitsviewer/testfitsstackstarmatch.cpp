@@ -0,0 +1,204 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include "testfitsstackstarmatch.h"
+#include "fitsviewer/fitsstackstarmatch.h"
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+const int width = 1000;
+const int height = 800;
+const int numStars = 40;
+
+FITSImage::Star makeStar(float x, float y, float flux)
+{
+    FITSImage::Star star {};
+    star.x = x;
+    star.y = y;
+    star.flux = flux;
+    return star;
+}
+
+// The reference sub: stars at random positions, brightest first
+QList<FITSImage::Star> referenceStars(std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> x(0, width), y(0, height);
+    QList<FITSImage::Star> stars;
+    for (int i = 0; i < numStars; i++)
+        stars.append(makeStar(x(rng), y(rng), 1000.0f - 20.0f * i));
+    return stars;
+}
+
+// The 3x3 transform taking sub pixels to reference pixels
+cv::Mat makeWarp(double angle, double scale, double dx, double dy)
+{
+    const double radians = angle * M_PI / 180.0;
+    cv::Mat warp = cv::Mat::eye(3, 3, CV_64F);
+    warp.at<double>(0, 0) = scale * std::cos(radians);
+    warp.at<double>(0, 1) = -scale * std::sin(radians);
+    warp.at<double>(0, 2) = dx;
+    warp.at<double>(1, 0) = scale * std::sin(radians);
+    warp.at<double>(1, 1) = scale * std::cos(radians);
+    warp.at<double>(1, 2) = dy;
+    return warp;
+}
+
+cv::Point2d apply(const cv::Mat &warp, double x, double y)
+{
+    return cv::Point2d(warp.at<double>(0, 0) * x + warp.at<double>(0, 1) * y + warp.at<double>(0, 2),
+                       warp.at<double>(1, 0) * x + warp.at<double>(1, 1) * y + warp.at<double>(1, 2));
+}
+
+// The reference stars as seen in a sub taken with the given warp, with centroid noise, some stars lost
+// (e.g. behind a cloud or below the detection limit) and some spurious detections added
+QList<FITSImage::Star> subStars(const QList<FITSImage::Star> &reference, const cv::Mat &warp, int numRemoved,
+                                int numOutliers, std::mt19937 &rng)
+{
+    const cv::Mat inverse = warp.inv();
+    std::normal_distribution<float> noise(0.0f, 0.1f);
+    QList<FITSImage::Star> stars;
+    for (int i = 0; i < reference.size(); i++)
+    {
+        // Spread the lost stars over the brightest, which are the ones used for matching
+        if (i % 5 == 2 && i / 5 < numRemoved)
+            continue;
+        const cv::Point2d p = apply(inverse, reference[i].x, reference[i].y);
+        stars.append(makeStar(p.x + noise(rng), p.y + noise(rng), reference[i].flux));
+    }
+
+    std::uniform_real_distribution<float> x(0, width), y(0, height);
+    for (int i = 0; i < numOutliers; i++)
+        stars.append(makeStar(x(rng), y(rng), 990.0f - 150.0f * i));
+    return stars;
+}
+}
+
+TestFITSStackStarMatch::TestFITSStackStarMatch(QObject *parent) : QObject(parent)
+{
+}
+
+void TestFITSStackStarMatch::testAlign_data()
+{
+    QTest::addColumn<double>("angle");
+    QTest::addColumn<double>("scale");
+    QTest::addColumn<double>("dx");
+    QTest::addColumn<double>("dy");
+    QTest::addColumn<int>("numRemoved");
+    QTest::addColumn<int>("numOutliers");
+
+    QTest::newRow("identity") << 0.0 << 1.0 << 0.0 << 0.0 << 0 << 0;
+    QTest::newRow("translation") << 0.0 << 1.0 << 37.5 << -21.25 << 0 << 0;
+    QTest::newRow("rotation") << 12.0 << 1.0 << 0.0 << 0.0 << 0 << 0;
+    QTest::newRow("meridian flip") << 180.0 << 1.0 << 1000.0 << 800.0 << 0 << 0;
+    QTest::newRow("rotation scale translation") << -35.0 << 1.03 << -60.0 << 85.0 << 0 << 0;
+    QTest::newRow("stars removed") << 8.0 << 0.98 << 25.0 << 40.0 << 4 << 0;
+    QTest::newRow("outliers added") << 8.0 << 0.98 << 25.0 << 40.0 << 0 << 5;
+    QTest::newRow("stars removed and outliers added") << -20.0 << 1.02 << -15.0 << 30.0 << 5 << 5;
+}
+
+void TestFITSStackStarMatch::testAlign()
+{
+    QFETCH(double, angle);
+    QFETCH(double, scale);
+    QFETCH(double, dx);
+    QFETCH(double, dy);
+    QFETCH(int, numRemoved);
+    QFETCH(int, numOutliers);
+
+    std::mt19937 rng(1234);
+    const QList<FITSImage::Star> reference = referenceStars(rng);
+    const cv::Mat expected = makeWarp(angle, scale, dx, dy);
+    const QList<FITSImage::Star> sub = subStars(reference, expected, numRemoved, numOutliers, rng);
+
+    FITSStackStarMatcher matcher;
+    matcher.setReference(reference);
+    QVERIFY(matcher.hasReference());
+
+    cv::Mat warp;
+    QVERIFY(matcher.align(sub, warp));
+    QCOMPARE(warp.rows, 3);
+    QCOMPARE(warp.cols, 3);
+    QCOMPARE(warp.type(), CV_64F);
+
+    // The recovered transform should put every part of the sub where the known one does
+    for (const double x : { 0.0, width / 2.0, static_cast<double>(width) })
+    {
+        for (const double y : { 0.0, height / 2.0, static_cast<double>(height) })
+        {
+            const cv::Point2d actual = apply(warp, x, y);
+            const cv::Point2d wanted = apply(expected, x, y);
+            QVERIFY2(cv::norm(actual - wanted) < 0.5,
+                     qPrintable(QString("(%1, %2) maps to (%3, %4) not (%5, %6)").arg(x).arg(y)
+                                .arg(actual.x).arg(actual.y).arg(wanted.x).arg(wanted.y)));
+        }
+    }
+    QVERIFY(std::fabs(warp.at<double>(2, 0)) < 1e-12 && std::fabs(warp.at<double>(2, 1)) < 1e-12);
+    QCOMPARE(warp.at<double>(2, 2), 1.0);
+}
+
+void TestFITSStackStarMatch::testNoReference()
+{
+    std::mt19937 rng(1234);
+    const QList<FITSImage::Star> reference = referenceStars(rng);
+
+    FITSStackStarMatcher matcher;
+    cv::Mat warp;
+    QVERIFY(!matcher.hasReference());
+    QVERIFY(!matcher.align(reference, warp));
+
+    matcher.setReference(reference);
+    QVERIFY(matcher.hasReference());
+    matcher.reset();
+    QVERIFY(!matcher.hasReference());
+    QVERIFY(!matcher.align(reference, warp));
+}
+
+void TestFITSStackStarMatch::testTooFewStars()
+{
+    std::mt19937 rng(1234);
+    const QList<FITSImage::Star> reference = referenceStars(rng);
+
+    FITSStackStarMatcher matcher;
+    matcher.setReference(reference);
+
+    // Fewer stars than MinMatches can't be aligned, so plate solving has to take over
+    cv::Mat warp;
+    QVERIFY(!matcher.align(reference.mid(0, FITSStackStarMatcher::MinMatches - 1), warp));
+    QVERIFY(warp.empty());
+
+    // Stars unrelated to the reference don't give a transform either
+    std::uniform_real_distribution<float> x(0, width), y(0, height);
+    QList<FITSImage::Star> unrelated;
+    for (int i = 0; i < numStars; i++)
+        unrelated.append(makeStar(x(rng), y(rng), 1000.0f - 20.0f * i));
+    QVERIFY(!matcher.align(unrelated, warp));
+    QVERIFY(warp.empty());
+}
+
+void TestFITSStackStarMatch::testScaleChange()
+{
+    std::mt19937 rng(1234);
+    const QList<FITSImage::Star> reference = referenceStars(rng);
+    const QList<FITSImage::Star> sub = subStars(reference, makeWarp(5.0, 1.3, 10.0, 10.0), 0, 0, rng);
+
+    FITSStackStarMatcher matcher;
+    matcher.setReference(reference);
+
+    // Subs from the same optical train keep their scale, so a large change is rejected
+    cv::Mat warp;
+    QVERIFY(!matcher.align(sub, warp));
+}
+
+QTEST_GUILESS_MAIN(TestFITSStackStarMatch)
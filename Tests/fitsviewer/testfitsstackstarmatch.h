@@ -0,0 +1,26 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TESTFITSSTACKSTARMATCH_H
+#define TESTFITSSTACKSTARMATCH_H
+
+#include <QObject>
+
+class TestFITSStackStarMatch : public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestFITSStackStarMatch(QObject *parent = nullptr);
+
+    private slots:
+        void testAlign_data();
+        void testAlign();
+        void testNoReference();
+        void testTooFewStars();
+        void testScaleChange();
+};
+
+#endif // TESTFITSSTACKSTARMATCH_H
@@ -0,0 +1,110 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include "testfitsstatistics.h"
+#include "fitsstatisticsreference.h"
+
+using namespace FITSStatisticsReference;
+
+namespace
+{
+bool fuzzyEqual(const double a, const double b)
+{
+    return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+}
+}
+
+TestFitsStatistics::TestFitsStatistics(QObject *parent) : QObject(parent)
+{
+}
+
+void TestFitsStatistics::testMatchesReference_data()
+{
+    QTest::addColumn<uint>("dataType");
+    QTest::addColumn<uint>("samples");
+
+    for (const auto &dataType : dataTypes)
+    {
+        // A single chunk with an odd number of pixels, and a large even frame that is split into chunks
+        // with a sampled median for the wider types
+        QTest::addRow("%s 999 pixels", dataType.first) << dataType.second << 999u;
+        QTest::addRow("%s 1024x768 pixels", dataType.first) << dataType.second << 1024u * 768u;
+    }
+}
+
+void TestFitsStatistics::testMatchesReference()
+{
+    QFETCH(uint, dataType);
+    QFETCH(uint, samples);
+
+    const std::vector<uint8_t> image = makeImage(dataType, samples, 1);
+    FITSStatistics::Channel result;
+    QVERIFY(FITSStatistics::calculate(image.data(), dataType, samples, 1, &result));
+
+    const FITSStatistics::Channel expected = reference(image.data(), dataType, samples);
+    QCOMPARE(result.min, expected.min);
+    QCOMPARE(result.max, expected.max);
+    QVERIFY2(fuzzyEqual(result.mean, expected.mean), qPrintable(QString("%1 vs %2").arg(result.mean).arg(expected.mean)));
+    QVERIFY2(fuzzyEqual(result.stddev, expected.stddev),
+             qPrintable(QString("%1 vs %2").arg(result.stddev).arg(expected.stddev)));
+    QCOMPARE(result.median, expected.median);
+}
+
+void TestFitsStatistics::testChannelsIndependent()
+{
+    const uint32_t samples = 1000 * 600;
+    for (const auto &dataType : dataTypes)
+    {
+        const std::vector<uint8_t> image = makeImage(dataType.second, samples, 3);
+        FITSStatistics::Channel results[3];
+        QVERIFY(FITSStatistics::calculate(image.data(), dataType.second, samples, 3, results));
+
+        // Each channel's statistics only depend on its own pixels
+        for (int n = 0; n < 3; n++)
+        {
+            const FITSStatistics::Channel expected = reference(image.data() + n * samples * bytesPerPixel(dataType.second),
+                    dataType.second, samples);
+            QCOMPARE(results[n].min, expected.min);
+            QCOMPARE(results[n].max, expected.max);
+            QVERIFY(fuzzyEqual(results[n].mean, expected.mean));
+            QCOMPARE(results[n].median, expected.median);
+        }
+    }
+}
+
+void TestFitsStatistics::testMeanStdDevMatchesReference()
+{
+    const uint32_t samples = 1000 * 600;
+    for (const auto &dataType : dataTypes)
+    {
+        const std::vector<uint8_t> image = makeImage(dataType.second, samples, 3);
+        FITSStatistics::Channel results[3];
+        QVERIFY(FITSStatistics::calculateMeanStdDev(image.data(), dataType.second, samples, 3, results));
+
+        for (int n = 0; n < 3; n++)
+        {
+            const FITSStatistics::Channel expected = reference(image.data() + n * samples * bytesPerPixel(dataType.second),
+                    dataType.second, samples);
+            QVERIFY2(fuzzyEqual(results[n].mean, expected.mean),
+                     qPrintable(QString("%1 channel %2: %3 vs %4").arg(dataType.first).arg(n).arg(results[n].mean)
+                                .arg(expected.mean)));
+            QVERIFY2(fuzzyEqual(results[n].stddev, expected.stddev),
+                     qPrintable(QString("%1 channel %2: %3 vs %4").arg(dataType.first).arg(n).arg(results[n].stddev)
+                                .arg(expected.stddev)));
+        }
+    }
+
+    FITSStatistics::Channel result;
+    QVERIFY(!FITSStatistics::calculateMeanStdDev(nullptr, TSTRING, 1, 1, &result));
+}
+
+QTEST_GUILESS_MAIN(TestFitsStatistics)
@@ -0,0 +1,27 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TESTFITSSTATISTICS_H
+#define TESTFITSSTATISTICS_H
+
+#include <QObject>
+
+class TestFitsStatistics : public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestFitsStatistics(QObject *parent = nullptr);
+
+    private slots:
+        void testMatchesReference_data();
+        void testMatchesReference();
+
+        void testChannelsIndependent();
+
+        void testMeanStdDevMatchesReference();
+};
+
+#endif // TESTFITSSTATISTICS_H
@@ -0,0 +1,69 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include "testfitsstatisticsbenchmark.h"
+#include "fitsstatisticsreference.h"
+
+using namespace FITSStatisticsReference;
+
+namespace
+{
+enum Method
+{
+    Reference,
+    Fused,
+    MeanStdDev
+};
+}
+
+TestFitsStatisticsBenchmark::TestFitsStatisticsBenchmark(QObject *parent) : QObject(parent)
+{
+}
+
+void TestFitsStatisticsBenchmark::testStatisticsBenchmark_data()
+{
+    QTest::addColumn<uint>("dataType");
+    QTest::addColumn<int>("method");
+
+    for (const auto &dataType : dataTypes)
+    {
+        QTest::addRow("reference %s", dataType.first) << dataType.second << static_cast<int>(Reference);
+        QTest::addRow("fused %s", dataType.first) << dataType.second << static_cast<int>(Fused);
+        QTest::addRow("mean stddev %s", dataType.first) << dataType.second << static_cast<int>(MeanStdDev);
+    }
+}
+
+void TestFitsStatisticsBenchmark::testStatisticsBenchmark()
+{
+    QFETCH(uint, dataType);
+    QFETCH(int, method);
+
+    // A 16 MP mono frame
+    const uint32_t samples = 4096 * 4096;
+    const std::vector<uint8_t> image = makeImage(dataType, samples, 1);
+    FITSStatistics::Channel result;
+
+    switch (method)
+    {
+        case Reference:
+            QBENCHMARK { result = reference(image.data(), dataType, samples); }
+            break;
+        case Fused:
+            QBENCHMARK { FITSStatistics::calculate(image.data(), dataType, samples, 1, &result); }
+            break;
+        default:
+            QBENCHMARK { FITSStatistics::calculateMeanStdDev(image.data(), dataType, samples, 1, &result); }
+            break;
+    }
+}
+
+QTEST_GUILESS_MAIN(TestFitsStatisticsBenchmark)
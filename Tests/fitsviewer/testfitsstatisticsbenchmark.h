@@ -0,0 +1,23 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TESTFITSSTATISTICSBENCHMARK_H
+#define TESTFITSSTATISTICSBENCHMARK_H
+
+#include <QObject>
+
+class TestFitsStatisticsBenchmark : public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestFitsStatisticsBenchmark(QObject *parent = nullptr);
+
+    private slots:
+        void testStatisticsBenchmark_data();
+        void testStatisticsBenchmark();
+};
+
+#endif // TESTFITSSTATISTICSBENCHMARK_H
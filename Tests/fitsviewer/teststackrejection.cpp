@@ -0,0 +1,202 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include "teststackrejection.h"
+#include "stackrejectionreference.h"
+
+Q_DECLARE_METATYPE(LiveStackRejection);
+
+using namespace StackRejectionReference;
+
+namespace
+{
+bool fuzzyEqual(const float a, const float b)
+{
+    return std::fabs(a - b) <= 1e-4 * std::max(1.0f, std::fabs(b));
+}
+}
+
+TestStackRejection::TestStackRejection(QObject *parent) : QObject(parent)
+{
+}
+
+void TestStackRejection::testMatchesReference_data()
+{
+    QTest::addColumn<LiveStackRejection>("method");
+    QTest::addColumn<int>("numSubs");
+    QTest::addColumn<int>("channels");
+
+    for (int numSubs : { 3, 4, 7, 20 })
+    {
+        for (int channels : { 1, 3 })
+        {
+            QTest::addRow("sigma %d subs %d channels", numSubs, channels) << LS_STACKING_REJ_SIGMA << numSubs << channels;
+            QTest::addRow("winsor %d subs %d channels", numSubs, channels) << LS_STACKING_REJ_WINDSOR << numSubs << channels;
+        }
+    }
+}
+
+void TestStackRejection::testMatchesReference()
+{
+    QFETCH(LiveStackRejection, method);
+    QFETCH(int, numSubs);
+    QFETCH(int, channels);
+
+    // An odd number of pixels exercises a partial block
+    const int pixels = 1001;
+    std::vector<std::vector<float>> subs;
+    makeSubs(numSubs, pixels, channels, subs);
+
+    std::vector<const float *> images;
+    QVector<float> weights;
+    for (int i = 0; i < numSubs; i++)
+    {
+        images.push_back(subs[i].data());
+        weights.push_back(1.0f + 0.1f * i);
+    }
+
+    std::vector<float> expected(pixels * channels), actual(pixels * channels);
+    std::vector<std::vector<float>> expectedState(channels, std::vector<float>(pixels * 4));
+    std::vector<std::vector<float>> actualState(channels, std::vector<float>(pixels * 4));
+    QVector<float *> expectedStatePtrs, actualStatePtrs;
+    for (int ch = 0; ch < channels; ch++)
+    {
+        expectedStatePtrs.push_back(expectedState[ch].data());
+        actualStatePtrs.push_back(actualState[ch].data());
+    }
+
+    referenceRejection(method, images, weights, pixels, channels, expected.data(), expectedStatePtrs);
+
+    FITSStackRejection rejection(method, lowSigma, highSigma, winsorCutoff, weights);
+    // Split the range to check that processing in batches gives the same result
+    rejection.process(images, 0, 500, channels, actual.data(), actualStatePtrs);
+    rejection.process(images, 500, pixels, channels, actual.data(), actualStatePtrs);
+
+    for (int i = 0; i < pixels * channels; i++)
+        QVERIFY2(fuzzyEqual(actual[i], expected[i]),
+                 qPrintable(QString("Pixel %1: %2 != %3").arg(i).arg(actual[i]).arg(expected[i])));
+    for (int ch = 0; ch < channels; ch++)
+        for (int i = 0; i < pixels * 4; i++)
+            QVERIFY2(fuzzyEqual(actualState[ch][i], expectedState[ch][i]),
+                     qPrintable(QString("State %1/%2: %3 != %4").arg(ch).arg(i).arg(actualState[ch][i])
+                                .arg(expectedState[ch][i])));
+}
+
+void TestStackRejection::testLinearFitRejectsOutliers()
+{
+    // A sky background brightening steadily over 20 subs, with a satellite trail in one sub
+    // and a cosmic ray in another
+    const int numSubs = 20;
+    std::vector<float> values(numSubs);
+    double inlierSum = 0.0;
+    for (int i = 0; i < numSubs; i++)
+    {
+        values[i] = 100.0f + 2.0f * i + ((i % 3) - 1) * 0.5f;
+        if (i == 5)
+            values[i] = 5000.0f;
+        else if (i == 12)
+            values[i] = 3000.0f;
+        else
+            inlierSum += values[i];
+    }
+
+    std::vector<const float *> images;
+    for (int i = 0; i < numSubs; i++)
+        images.push_back(&values[i]);
+    QVector<float> weights(numSubs, 1.0f);
+
+    float result = 0.0f;
+    std::vector<float> state(4);
+    QVector<float *> statePtrs { state.data() };
+
+    FITSStackRejection rejection(LS_STACKING_REJ_LINEAR_FIT, lowSigma, highSigma, winsorCutoff, weights);
+    rejection.process(images, 0, 1, 1, &result, statePtrs);
+
+    QVERIFY(std::fabs(result - inlierSum / (numSubs - 2)) < 1e-3);
+    QCOMPARE(state[0], result);
+    QCOMPARE(state[2], static_cast<float>(numSubs - 2));
+    QCOMPARE(state[3], static_cast<float>(numSubs - 2));
+}
+
+void TestStackRejection::testAccumulateMatchesBatch()
+{
+    // Values alternate either side of a per pixel level so none of them are rejected, and folding subs
+    // in one at a time must give the same mean and variance as stacking them all at once
+    const int pixels = 100, initialSubs = 5, totalSubs = 40;
+    std::vector<std::vector<float>> subs(totalSubs, std::vector<float>(pixels));
+    QVector<float> weights;
+    for (int i = 0; i < totalSubs; i++)
+    {
+        for (int x = 0; x < pixels; x++)
+            subs[i][x] = 1000.0f + x + ((i % 2 == 0) ? 10.0f : -10.0f) + 0.1f * (i % 5);
+        weights.push_back(1.0f + 0.25f * (i % 4));
+    }
+
+    std::vector<const float *> images;
+    for (int i = 0; i < initialSubs; i++)
+        images.push_back(subs[i].data());
+    std::vector<float> result(pixels), state(pixels * 4);
+    QVector<float *> statePtrs { state.data() };
+    FITSStackRejection initial(LS_STACKING_REJ_SIGMA, lowSigma, highSigma, winsorCutoff, weights.mid(0, initialSubs));
+    initial.process(images, 0, pixels, 1, result.data(), statePtrs);
+
+    for (int i = initialSubs; i < totalSubs; i++)
+    {
+        FITSStackRejection running(LS_STACKING_REJ_SIGMA, lowSigma, highSigma, winsorCutoff, weights.mid(i, 1));
+        running.accumulate({ subs[i].data() }, 0, pixels, 1, result.data(), statePtrs);
+    }
+
+    images.clear();
+    for (int i = 0; i < totalSubs; i++)
+        images.push_back(subs[i].data());
+    std::vector<float> expected(pixels), expectedState(pixels * 4);
+    QVector<float *> expectedStatePtrs { expectedState.data() };
+    referenceRejection(LS_STACKING_REJ_NONE, images, weights, pixels, 1, expected.data(), expectedStatePtrs);
+
+    for (int x = 0; x < pixels; x++)
+    {
+        QVERIFY(fuzzyEqual(result[x], expected[x]));
+        QCOMPARE(state[x * 4 + 3], static_cast<float>(totalSubs));
+        QVERIFY(std::fabs(state[x * 4 + 1] - expectedState[x * 4 + 1]) <= 1e-3 * expectedState[x * 4 + 1]);
+    }
+}
+
+void TestStackRejection::testAccumulateRejectsOutliers()
+{
+    const int pixels = 64, numSubs = 20;
+    std::vector<std::vector<float>> subs;
+    makeSubs(numSubs, pixels, 1, subs);
+    QVector<float> weights(numSubs, 1.0f);
+
+    std::vector<const float *> images;
+    for (const auto &sub : subs)
+        images.push_back(sub.data());
+    std::vector<float> result(pixels), state(pixels * 4);
+    QVector<float *> statePtrs { state.data() };
+    FITSStackRejection initial(LS_STACKING_REJ_SIGMA, lowSigma, highSigma, winsorCutoff, weights);
+    initial.process(images, 0, pixels, 1, result.data(), statePtrs);
+
+    // A satellite trail crosses every pixel of the new sub
+    const std::vector<float> before(state);
+    const std::vector<float> trail(pixels, 20000.0f);
+    FITSStackRejection running(LS_STACKING_REJ_SIGMA, lowSigma, highSigma, winsorCutoff, QVector<float>(1, 1.0f));
+    running.accumulate({ trail.data() }, 0, pixels, 1, result.data(), statePtrs);
+
+    for (int x = 0; x < pixels; x++)
+    {
+        QCOMPARE(state[x * 4 + 3], before[x * 4 + 3]);
+        QVERIFY(fuzzyEqual(result[x], before[x * 4]));
+        QVERIFY(result[x] < 1200.0f);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestStackRejection)
@@ -0,0 +1,28 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TESTSTACKREJECTION_H
+#define TESTSTACKREJECTION_H
+
+#include <QObject>
+
+class TestStackRejection : public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestStackRejection(QObject *parent = nullptr);
+
+    private slots:
+        void testMatchesReference_data();
+        void testMatchesReference();
+
+        void testLinearFitRejectsOutliers();
+
+        void testAccumulateMatchesBatch();
+        void testAccumulateRejectsOutliers();
+};
+
+#endif // TESTSTACKREJECTION_H
@@ -0,0 +1,107 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include "teststackrejectionbenchmark.h"
+#include "stackrejectionreference.h"
+
+Q_DECLARE_METATYPE(LiveStackRejection);
+
+using namespace StackRejectionReference;
+
+TestStackRejectionBenchmark::TestStackRejectionBenchmark(QObject *parent) : QObject(parent)
+{
+}
+
+void TestStackRejectionBenchmark::testRejectionBenchmark_data()
+{
+    QTest::addColumn<LiveStackRejection>("method");
+    QTest::addColumn<int>("numSubs");
+    QTest::addColumn<bool>("reference");
+
+    for (int numSubs : { 20, 50, 100 })
+    {
+        QTest::addRow("reference sigma %d subs", numSubs) << LS_STACKING_REJ_SIGMA << numSubs << true;
+        QTest::addRow("kernel sigma %d subs", numSubs) << LS_STACKING_REJ_SIGMA << numSubs << false;
+        QTest::addRow("reference winsor %d subs", numSubs) << LS_STACKING_REJ_WINDSOR << numSubs << true;
+        QTest::addRow("kernel winsor %d subs", numSubs) << LS_STACKING_REJ_WINDSOR << numSubs << false;
+        QTest::addRow("kernel linear fit %d subs", numSubs) << LS_STACKING_REJ_LINEAR_FIT << numSubs << false;
+    }
+}
+
+void TestStackRejectionBenchmark::testRejectionBenchmark()
+{
+    QFETCH(LiveStackRejection, method);
+    QFETCH(int, numSubs);
+    QFETCH(bool, reference);
+
+    const int pixels = 4096;
+    std::vector<std::vector<float>> subs;
+    makeSubs(numSubs, pixels, 1, subs);
+
+    std::vector<const float *> images;
+    for (const auto &sub : subs)
+        images.push_back(sub.data());
+    QVector<float> weights(numSubs, 1.0f);
+
+    std::vector<float> result(pixels), state(pixels * 4);
+    QVector<float *> statePtrs { state.data() };
+
+    if (reference)
+    {
+        QBENCHMARK { referenceRejection(method, images, weights, pixels, 1, result.data(), statePtrs); }
+    }
+    else
+    {
+        FITSStackRejection rejection(method, lowSigma, highSigma, winsorCutoff, weights);
+        QBENCHMARK { rejection.process(images, 0, pixels, 1, result.data(), statePtrs); }
+    }
+}
+
+void TestStackRejectionBenchmark::testAccumulateBenchmark_data()
+{
+    QTest::addColumn<int>("stackedSubs");
+
+    // Adding the 500th sub should cost the same as adding the 5th
+    for (int stackedSubs : { 5, 50, 500 })
+        QTest::addRow("%d stacked subs", stackedSubs) << stackedSubs;
+}
+
+void TestStackRejectionBenchmark::testAccumulateBenchmark()
+{
+    QFETCH(int, stackedSubs);
+
+    const int pixels = 4096;
+    std::vector<std::vector<float>> subs;
+    makeSubs(stackedSubs + 1, pixels, 1, subs);
+
+    std::vector<float> result(pixels), state(pixels * 4);
+    QVector<float *> statePtrs { state.data() };
+    FITSStackRejection running(LS_STACKING_REJ_SIGMA, lowSigma, highSigma, winsorCutoff, QVector<float>(1, 1.0f));
+    FITSStackRejection initial(LS_STACKING_REJ_SIGMA, lowSigma, highSigma, winsorCutoff, QVector<float>(5, 1.0f));
+    std::vector<const float *> images;
+    for (int i = 0; i < 5; i++)
+        images.push_back(subs[i].data());
+    initial.process(images, 0, pixels, 1, result.data(), statePtrs);
+    for (int i = 5; i < stackedSubs; i++)
+        running.accumulate({ subs[i].data() }, 0, pixels, 1, result.data(), statePtrs);
+
+    // Each iteration works on a copy of the state so every one adds the same sub to the same stack
+    const std::vector<float> stackedState(state);
+    const std::vector<const float *> newSub { subs[stackedSubs].data() };
+    QBENCHMARK
+    {
+        std::copy(stackedState.begin(), stackedState.end(), state.begin());
+        running.accumulate(newSub, 0, pixels, 1, result.data(), statePtrs);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestStackRejectionBenchmark)
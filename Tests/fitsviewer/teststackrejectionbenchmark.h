@@ -0,0 +1,26 @@
+/*  KStars tests
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TESTSTACKREJECTIONBENCHMARK_H
+#define TESTSTACKREJECTIONBENCHMARK_H
+
+#include <QObject>
+
+class TestStackRejectionBenchmark : public QObject
+{
+        Q_OBJECT
+    public:
+        explicit TestStackRejectionBenchmark(QObject *parent = nullptr);
+
+    private slots:
+        void testRejectionBenchmark_data();
+        void testRejectionBenchmark();
+
+        void testAccumulateBenchmark_data();
+        void testAccumulateBenchmark();
+};
+
+#endif // TESTSTACKREJECTIONBENCHMARK_H
@@ -0,0 +1,206 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ekos/focus/focusfwhm.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include <QObject>
+#include <QRandomGenerator>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// Tests the 3D Gaussian star fitting of FocusFWHM on synthetic star fields.
+
+class TestFocusFWHM : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestFocusFWHM();
+        ~TestFocusFWHM() override = default;
+
+    private slots:
+        void accuracyTest();
+        void parallelMatchesSequentialTest();
+        void overlapTest();
+
+        void fwhmBenchmark_data();
+        void fwhmBenchmark();
+};
+
+#include "testfocusfwhm.moc"
+
+using Ekos::FocusFWHM;
+
+namespace
+{
+constexpr int imageWidth = 2000;
+constexpr int imageHeight = 1500;
+constexpr double background = 1000;
+constexpr double peak = 5000;
+constexpr double sigma = 2.0;
+
+struct StarField
+{
+    std::vector<uint16_t> image;
+    QList<Edge *> stars;
+
+    StarField() : image(imageWidth * imageHeight) {}
+    ~StarField()
+    {
+        qDeleteAll(stars);
+    }
+
+    void addStar(double x, double y)
+    {
+        Edge *star = new Edge();
+        star->x = x;
+        star->y = y;
+        star->val = peak;
+        star->HFR = sigma * std::sqrt(2.0 * std::log(2.0));
+        // Gives a 16 pixel box to fit
+        star->numPixels = 100;
+        stars.append(star);
+    }
+
+    // Render the stars over a noisy background
+    void render()
+    {
+        QRandomGenerator generator(42);
+        for (auto &pixel : image)
+            pixel = background + generator.bounded(20.0) - 10.0;
+
+        for (const auto star : stars)
+        {
+            for (int y = std::max(0, int(star->y) - 10); y < std::min(imageHeight, int(star->y) + 10); y++)
+            {
+                for (int x = std::max(0, int(star->x) - 10); x < std::min(imageWidth, int(star->x) + 10); x++)
+                {
+                    const double dx = x + 0.5 - star->x, dy = y + 0.5 - star->y;
+                    image[y * imageWidth + x] += peak * std::exp(-(dx * dx + dy * dy) / (2 * sigma * sigma));
+                }
+            }
+        }
+    }
+
+    // A grid of well separated stars, off the pixel centres
+    static std::unique_ptr<StarField> grid(int columns, int rows)
+    {
+        std::unique_ptr<StarField> field(new StarField());
+        for (int row = 0; row < rows; row++)
+            for (int column = 0; column < columns; column++)
+                field->addStar(50 + column * (imageWidth - 100) / columns + 0.3, 50 + row * (imageHeight - 100) / rows + 0.7);
+        field->render();
+        return field;
+    }
+
+    void process(double *FWHM, double *weight, int maxThreads = 0)
+    {
+        FocusFWHM focusFWHM(Mathematics::RobustStatistics::SCALE_MAD);
+        std::unique_ptr<Ekos::CurveFitting> starFitting(new Ekos::CurveFitting());
+        const uint16_t *buffer = image.data();
+        focusFWHM.processFWHM(buffer, imageWidth, imageHeight, background, stars, starFitting, FWHM, weight, maxThreads);
+    }
+};
+}
+
+TestFocusFWHM::TestFocusFWHM() : QObject()
+{
+}
+
+void TestFocusFWHM::accuracyTest()
+{
+    auto field = StarField::grid(10, 8);
+    double FWHM = 0, weight = 0;
+    field->process(&FWHM, &weight);
+
+    // FWHM = 2.sqrt(2.ln(2)).sigma
+    const double expected = 2.0 * std::sqrt(2.0 * std::log(2.0)) * sigma;
+    QVERIFY2(std::fabs(FWHM - expected) < 0.02 * expected, qPrintable(QString("FWHM %1 vs %2").arg(FWHM).arg(expected)));
+    QVERIFY(weight > 0);
+}
+
+void TestFocusFWHM::parallelMatchesSequentialTest()
+{
+    auto field = StarField::grid(20, 15);
+
+    // The stars are fitted independently and the results combined in star order, so the thread count
+    // mustn't change the answer
+    double sequentialFWHM = 0, sequentialWeight = 0;
+    field->process(&sequentialFWHM, &sequentialWeight, 1);
+    for (const int threads : { 2, 3, 8 })
+    {
+        double FWHM = 0, weight = 0;
+        field->process(&FWHM, &weight, threads);
+        QCOMPARE(FWHM, sequentialFWHM);
+        QCOMPARE(weight, sequentialWeight);
+    }
+}
+
+void TestFocusFWHM::overlapTest()
+{
+    // Two stars whose boxes overlap are both rejected
+    {
+        StarField field;
+        field.addStar(500.3, 500.7);
+        field.addStar(510.3, 505.7);
+        field.render();
+        double FWHM = 0, weight = 0;
+        field.process(&FWHM, &weight);
+        QCOMPARE(FWHM, FocusFWHM::INVALID_STAR_MEASURE);
+    }
+
+    // In a chain of three, the first rejects the second, which no longer rejects the third
+    {
+        StarField field;
+        field.addStar(500.3, 500.7);
+        field.addStar(512.3, 500.7);
+        field.addStar(524.3, 500.7);
+        field.render();
+        double FWHM = 0, weight = 0;
+        field.process(&FWHM, &weight);
+        QVERIFY(FWHM != FocusFWHM::INVALID_STAR_MEASURE);
+    }
+
+    // Neighbouring stars whose boxes share a grid cell but don't overlap are kept
+    {
+        StarField field;
+        field.addStar(500.3, 500.7);
+        field.addStar(517.3, 500.7);
+        field.render();
+        double FWHM = 0, weight = 0;
+        field.process(&FWHM, &weight);
+        QVERIFY(FWHM != FocusFWHM::INVALID_STAR_MEASURE);
+    }
+}
+
+void TestFocusFWHM::fwhmBenchmark_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::addRow("sequential") << 1;
+    QTest::addRow("parallel") << 0;
+}
+
+void TestFocusFWHM::fwhmBenchmark()
+{
+    QFETCH(int, threads);
+
+    // Several hundred stars, as found on a full frame sensor
+    auto field = StarField::grid(25, 20);
+    double FWHM = 0, weight = 0;
+    QBENCHMARK { field->process(&FWHM, &weight, threads); }
+}
+
+QTEST_GUILESS_MAIN(TestFocusFWHM)
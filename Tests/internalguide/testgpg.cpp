@@ -0,0 +1,188 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ekos/guide/internalguide/gpg.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include <QObject>
+
+#include <cmath>
+
+class TestGPG : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** @short Constructor */
+        TestGPG();
+
+        /** @short Destructor */
+        ~TestGPG() override = default;
+
+    private slots:
+        void asyncMatchesSyncTest_data();
+        void asyncMatchesSyncTest();
+        void requestDroppedOnResetTest();
+        void staleModelDroppedTest_data();
+        void staleModelDroppedTest();
+};
+
+#include "testgpg.moc"
+
+namespace
+{
+constexpr double period = 300.0;
+constexpr double timeStep = 3.0;
+
+GaussianProcessGuider::guide_parameters guideParameters()
+{
+    GaussianProcessGuider::guide_parameters parameters;
+    parameters.control_gain_ = 0.8;
+    parameters.min_periods_for_inference_ = 1.0;
+    parameters.min_move_ = 0.2;
+    parameters.SE0KLengthScale_ = 500.0;
+    parameters.SE0KSignalVariance_ = 10.0;
+    parameters.PKLengthScale_ = 10.0;
+    parameters.PKPeriodLength_ = 250.0;
+    parameters.PKSignalVariance_ = 10.0;
+    parameters.SE1KLengthScale_ = 5.0;
+    parameters.SE1KSignalVariance_ = 1.0;
+    parameters.min_periods_for_period_estimation_ = 2.0;
+    parameters.points_for_approximation_ = 100;
+    parameters.prediction_gain_ = 1.0;
+    parameters.compute_period_ = true;
+    return parameters;
+}
+
+// A periodic gear error with a slow drift, sampled every timeStep seconds
+double measurement(int i)
+{
+    const double t = i * timeStep;
+    return 2.0 * std::sin(2 * M_PI * t / period) + 0.3 * std::sin(2 * M_PI * t / 37.0) + 0.001 * t;
+}
+
+// Injects numPoints measurements and then runs one guide cycle, with explicit time stamps so that
+// every guider given the same data sees exactly the same history.
+void feed(GaussianProcessGuider &guider, int numPoints)
+{
+    for (int i = 0; i < numPoints; i++)
+        guider.inject_data_point(i * timeStep, measurement(i), 50.0, 0.0);
+    guider.result(measurement(numPoints), 50.0, timeStep, numPoints * timeStep);
+}
+
+Eigen::VectorXd predictions(const GP &model, int numPoints)
+{
+    return model.predictProjected(Eigen::VectorXd::LinSpaced(50, 0, (numPoints + 20) * timeStep));
+}
+}
+
+TestGPG::TestGPG() : QObject()
+{
+}
+
+void TestGPG::asyncMatchesSyncTest_data()
+{
+    QTest::addColumn<int>("numPoints");
+
+    // Before and after there is enough data to estimate the period
+    QTest::newRow("100 points") << 100;
+    QTest::newRow("400 points") << 400;
+    QTest::newRow("1000 points") << 1000;
+}
+
+void TestGPG::asyncMatchesSyncTest()
+{
+    QFETCH(int, numPoints);
+
+    GaussianProcessGuider syncGuider(guideParameters());
+    syncGuider.SetLearningRate(1.0);
+    GaussianProcessGuider asyncGuider(guideParameters());
+    asyncGuider.SetLearningRate(1.0);
+    asyncGuider.SetAsynchronousUpdate(true);
+
+    feed(syncGuider, numPoints);
+    feed(asyncGuider, numPoints);
+
+    // The synchronous guider updates its own model and never leaves a request
+    GaussianProcessGuider::model_input input;
+    QVERIFY(!syncGuider.TakeModelRequest(&input));
+
+    // Run the asynchronous guider's request here, as GPG would on its worker thread
+    QVERIFY(asyncGuider.TakeModelRequest(&input));
+    QVERIFY(!asyncGuider.TakeModelRequest(&input));
+    asyncGuider.SetModel(GaussianProcessGuider::ComputeModel(asyncGuider.GetModel(), input));
+
+    const std::vector<double> syncHyperparameters = syncGuider.GetGPHyperparameters();
+    const std::vector<double> asyncHyperparameters = asyncGuider.GetGPHyperparameters();
+    QCOMPARE(asyncHyperparameters.size(), syncHyperparameters.size());
+    for (size_t i = 0; i < syncHyperparameters.size(); i++)
+        QVERIFY2(std::fabs(asyncHyperparameters[i] - syncHyperparameters[i]) <= 1e-9 * std::fabs(syncHyperparameters[i]),
+                 qPrintable(QString("Hyperparameter %1: %2 != %3").arg(i).arg(asyncHyperparameters[i])
+                            .arg(syncHyperparameters[i])));
+
+    const Eigen::VectorXd expected = predictions(syncGuider.GetModel(), numPoints);
+    const Eigen::VectorXd actual = predictions(asyncGuider.GetModel(), numPoints);
+    QVERIFY(expected.cwiseAbs().maxCoeff() > 0.1);
+    for (int i = 0; i < expected.size(); i++)
+        QVERIFY2(std::fabs(actual(i) - expected(i)) <= 1e-9,
+                 qPrintable(QString("Prediction %1: %2 != %3").arg(i).arg(actual(i)).arg(expected(i))));
+}
+
+void TestGPG::requestDroppedOnResetTest()
+{
+    GaussianProcessGuider guider(guideParameters());
+    guider.SetAsynchronousUpdate(true);
+    feed(guider, 100);
+    guider.reset();
+
+    GaussianProcessGuider::model_input input;
+    QVERIFY(!guider.TakeModelRequest(&input));
+}
+
+void TestGPG::staleModelDroppedTest_data()
+{
+    QTest::addColumn<int>("change");
+
+    QTest::newRow("none") << 0;
+    QTest::newRow("reset") << 1;
+    QTest::newRow("updateParameters") << 2;
+}
+
+void TestGPG::staleModelDroppedTest()
+{
+    QFETCH(int, change);
+
+    GPG gpg;
+    feed(*gpg.gpg, 200);
+
+    // Start the worker and let it finish before the guider changes
+    gpg.requestModel();
+    QVERIFY(gpg.m_ModelUpdateRunning);
+    gpg.m_ModelUpdate.waitForFinished();
+
+    if (change == 1)
+        gpg.reset();
+    else if (change == 2)
+        gpg.updateParameters();
+
+    gpg.collectModel();
+    QVERIFY(!gpg.m_ModelUpdateRunning);
+
+    // The guider's own model never had any data, so it predicts nothing
+    const double largest = predictions(gpg.gpg->GetModel(), 200).cwiseAbs().maxCoeff();
+    if (change == 0)
+        QVERIFY(largest > 0.1);
+    else
+        QCOMPARE(largest, 0.0);
+}
+
+QTEST_GUILESS_MAIN(TestGPG)
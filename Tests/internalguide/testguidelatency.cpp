@@ -0,0 +1,162 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ekos/guide/guidelatency.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QObject>
+
+#include <cmath>
+
+using Ekos::GuideLatency;
+
+class TestGuideLatency : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** @short Constructor */
+        TestGuideLatency();
+
+        /** @short Destructor */
+        ~TestGuideLatency() override = default;
+
+    private slots:
+        void stageTest();
+        void missingMarksTest();
+        void percentileTest();
+        void chromeTraceTest();
+};
+
+#include "testguidelatency.moc"
+
+namespace
+{
+constexpr qint64 ms = 1000000;
+
+// A full guide cycle starting at start, with a 1s exposure and a 200ms pulse on two axes
+void addFrame(GuideLatency &latency, qint64 start, qint64 detection = 30 * ms)
+{
+    latency.startFrame(1.0, start);
+    latency.mark(GuideLatency::BLOB_RECEIVED, start + 1100 * ms);
+    latency.mark(GuideLatency::IMAGE_LOADED, start + 1120 * ms);
+    latency.mark(GuideLatency::IMAGE_RECEIVED, start + 1125 * ms);
+    latency.mark(GuideLatency::STAR_FOUND, start + 1125 * ms + detection);
+    latency.mark(GuideLatency::PULSE_SENT, start + 1126 * ms + detection);
+    latency.setPulse(200, 2);
+    latency.pulseCompleted(start + 1300 * ms + detection);
+    latency.pulseCompleted(start + 1340 * ms + detection);
+}
+}
+
+TestGuideLatency::TestGuideLatency() : QObject()
+{
+}
+
+void TestGuideLatency::stageTest()
+{
+    GuideLatency latency;
+    QVERIFY(!latency.finishFrame());
+    addFrame(latency, 1000 * ms);
+    // A mark is only kept the first time it is reached
+    latency.mark(GuideLatency::BLOB_RECEIVED, 5000 * ms);
+    QVERIFY(latency.finishFrame());
+    QCOMPARE(latency.size(), 1);
+
+    const auto &frame = latency.lastFrame();
+    QCOMPARE(frame.number, 1);
+    QCOMPARE(frame.pulseMs, 200);
+    QCOMPARE(GuideLatency::stageMs(frame, GuideLatency::EXPOSURE), 1000.0);
+    QCOMPARE(GuideLatency::stageMs(frame, GuideLatency::DOWNLOAD), 100.0);
+    QCOMPARE(GuideLatency::stageMs(frame, GuideLatency::LOAD), 20.0);
+    QCOMPARE(GuideLatency::stageMs(frame, GuideLatency::DISPATCH), 5.0);
+    QCOMPARE(GuideLatency::stageMs(frame, GuideLatency::DETECTION), 30.0);
+    QCOMPARE(GuideLatency::stageMs(frame, GuideLatency::CALCULATION), 1.0);
+    // The pulse is only done when both axes are
+    QCOMPARE(GuideLatency::stageMs(frame, GuideLatency::PULSE), 214.0);
+
+    // Starting the next frame finishes this one
+    latency.startFrame(1.0, 3000 * ms);
+    QVERIFY(latency.startFrame(1.0, 4000 * ms));
+    QCOMPARE(latency.size(), 2);
+    QCOMPARE(latency.lastFrame().number, 2);
+}
+
+void TestGuideLatency::missingMarksTest()
+{
+    GuideLatency latency;
+    latency.startFrame(2.0, 1000 * ms);
+    latency.mark(GuideLatency::IMAGE_RECEIVED, 3100 * ms);
+    // Pulses without a frame being timed are ignored
+    latency.finishFrame();
+    latency.setPulse(100, 1);
+    latency.pulseCompleted(3200 * ms);
+
+    const auto &frame = latency.lastFrame();
+    QCOMPARE(GuideLatency::stageMs(frame, GuideLatency::EXPOSURE), 2000.0);
+    QVERIFY(std::isnan(GuideLatency::stageMs(frame, GuideLatency::DOWNLOAD)));
+    QVERIFY(std::isnan(GuideLatency::stageMs(frame, GuideLatency::DETECTION)));
+    QVERIFY(std::isnan(GuideLatency::stageMs(frame, GuideLatency::PULSE)));
+    QVERIFY(std::isnan(latency.percentile(GuideLatency::PULSE, 50)));
+}
+
+void TestGuideLatency::percentileTest()
+{
+    // Detection times of 1 to 100ms, with a ring that only keeps the last 100 frames
+    GuideLatency latency(100);
+    for (int i = 0; i < 150; i++)
+        addFrame(latency, i * 2000 * ms, ((i < 50) ? 500 : i - 49) * ms);
+    latency.finishFrame();
+    QCOMPARE(latency.size(), 100);
+
+    QCOMPARE(latency.percentile(GuideLatency::DETECTION, 0), 1.0);
+    QCOMPARE(latency.percentile(GuideLatency::DETECTION, 100), 100.0);
+    QCOMPARE(latency.percentile(GuideLatency::DETECTION, 50), 50.5);
+    QVERIFY(std::fabs(latency.percentile(GuideLatency::DETECTION, 90) - 90.1) < 1e-9);
+    QCOMPARE(latency.percentile(GuideLatency::LOAD, 99), 20.0);
+    QVERIFY(latency.summary().contains("Detection"));
+
+    latency.clear();
+    QCOMPARE(latency.size(), 0);
+    QVERIFY(!latency.isTiming());
+}
+
+void TestGuideLatency::chromeTraceTest()
+{
+    GuideLatency latency;
+    addFrame(latency, 1000 * ms);
+    addFrame(latency, 3000 * ms);
+    latency.finishFrame();
+
+    const QJsonObject trace = latency.chromeTrace().object();
+    const QJsonArray events = trace["traceEvents"].toArray();
+    // The thread name, then 7 stages per frame
+    QCOMPARE(events.size(), 1 + 2 * GuideLatency::STAGE_COUNT);
+
+    const QJsonObject first = events[1].toObject();
+    QCOMPARE(first["name"].toString(), QString("Exposure"));
+    QCOMPARE(first["ph"].toString(), QString("X"));
+    QCOMPARE(first["ts"].toDouble(), 0.0);
+    QCOMPARE(first["dur"].toDouble(), 1e6);
+    QCOMPARE(first["args"].toObject()["frame"].toInt(), 1);
+
+    // Times are microseconds relative to the first frame
+    const QJsonObject download = events[2 + GuideLatency::STAGE_COUNT].toObject();
+    QCOMPARE(download["name"].toString(), QString("Download"));
+    QCOMPARE(download["ts"].toDouble(), 3e6);
+    QCOMPARE(download["dur"].toDouble(), 1e5);
+    QCOMPARE(download["args"].toObject()["frame"].toInt(), 2);
+}
+
+QTEST_GUILESS_MAIN(TestGuideLatency)
@@ -6,6 +6,7 @@
 
 #include "../indi/indiproperty.h"
 #include "ekos/guide/internalguide/guidestars.h"
+#include "fitsviewer/fitsdata.h"
 
 #include <QtGlobal>
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -16,6 +17,8 @@
 
 #include <QObject>
 
+#include <random>
+
 // The high-level methods, selectGuideStar() and findGuideStar() are not yet tested.
 // Neither are the SEP-related EvaluateSEPStars, findTopStars, findAllSEPStars().
 
@@ -34,6 +37,7 @@ class TestGuideStars : public QObject
         void basicTest();
         void calibrationTest();
         void testFindGuideStar();
+        void roiStarTest();
 };
 
 #include "testguidestars.moc"
@@ -704,4 +708,39 @@ void TestGuideStars::testFindGuideStar()
 #endif
 }
 
+void TestGuideStars::roiStarTest()
+{
+    // A noisy background with a star, and part of a brighter neighbor on the edge of the subframe.
+    constexpr int width = 200, height = 150;
+    std::vector<uint16_t> image(width * height);
+    std::mt19937 generator(3);
+    std::normal_distribution<double> noise(0, 5);
+    const double starX = 83.37, starY = 61.8, sigma = 1.5;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const double d1 = (x - starX) * (x - starX) + (y - starY) * (y - starY);
+            const double d2 = (x - 100.0) * (x - 100.0) + (y - 61.0) * (y - 61.0);
+            image[y * width + x] = std::max(0.0, 500 + noise(generator) + 3000 * exp(-d1 / (2 * sigma * sigma)) +
+                                            4000 * exp(-d2 / (2 * sigma * sigma)));
+        }
+    }
+    const uint8_t *buffer = reinterpret_cast<const uint8_t *>(image.data());
+
+    Edge star;
+    SkyBackground background;
+    QVERIFY(GuideStars::measureRoiStar(buffer, TUSHORT, width, QRect(58, 40, 45, 45), 10, &star, &background));
+    QVERIFY(fabs(star.x - starX) < 0.1);
+    QVERIFY(fabs(star.y - starY) < 0.1);
+    // The flux of the Gaussian is 3000 * 2 pi sigma^2.
+    QVERIFY(fabs(star.sum - 3000 * 2 * M_PI * sigma * sigma) < 0.1 * star.sum);
+    QVERIFY(star.HFR > 1 && star.HFR < 3);
+    QVERIFY(fabs(background.mean - 500) < 2);
+    QVERIFY(background.sigma < 10);
+
+    // No star in this one.
+    QVERIFY(!GuideStars::measureRoiStar(buffer, TUSHORT, width, QRect(10, 100, 45, 45), 10, &star, &background));
+}
+
 QTEST_GUILESS_MAIN(TestGuideStars)
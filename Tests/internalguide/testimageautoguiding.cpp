@@ -0,0 +1,162 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ekos/guide/internalguide/imageautoguiding.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include <QElapsedTimer>
+#include <QObject>
+
+#include <cmath>
+#include <random>
+
+class TestImageAutoGuiding : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** @short Constructor */
+        TestImageAutoGuiding();
+
+        /** @short Destructor */
+        ~TestImageAutoGuiding() override = default;
+
+    private slots:
+        void shiftTest_data();
+        void shiftTest();
+        void referenceTest();
+        void invalidSizeTest();
+        void benchmarkTest();
+};
+
+#include "testimageautoguiding.moc"
+
+namespace
+{
+constexpr int imageSize = 256;
+
+// A noisy field of Gaussian stars, shifted by dx along the rows and dy along the columns
+std::vector<float> makeImage(double dx, double dy, unsigned int noiseSeed)
+{
+    std::mt19937 starGenerator(1);
+    std::uniform_real_distribution<double> position(40, imageSize - 40), flux(200, 2000);
+    std::vector<double> rows, columns, fluxes;
+    for (int s = 0; s < 15; s++)
+    {
+        rows.push_back(position(starGenerator));
+        columns.push_back(position(starGenerator));
+        fluxes.push_back(flux(starGenerator));
+    }
+
+    std::mt19937 noiseGenerator(noiseSeed);
+    std::normal_distribution<double> noise(0, 3);
+    std::vector<float> image(imageSize * imageSize);
+    for (int j = 0; j < imageSize; j++)
+    {
+        for (int i = 0; i < imageSize; i++)
+        {
+            double value = 100 + noise(noiseGenerator);
+            for (int s = 0; s < 15; s++)
+            {
+                const double a = j - (rows[s] + dx), b = i - (columns[s] + dy);
+                value += fluxes[s] * std::exp(-(a * a + b * b) / 8.0);
+            }
+            image[j * imageSize + i] = value;
+        }
+    }
+    return image;
+}
+}
+
+TestImageAutoGuiding::TestImageAutoGuiding() : QObject()
+{
+}
+
+void TestImageAutoGuiding::shiftTest_data()
+{
+    QTest::addColumn<double>("dx");
+    QTest::addColumn<double>("dy");
+
+    QTest::newRow("none") << 0.0 << 0.0;
+    QTest::newRow("sub-pixel") << 0.3 << -0.2;
+    QTest::newRow("small") << -2.6 << 3.1;
+    // The phase slope alone wraps around beyond a few pixels, so these need the correlation peak
+    QTest::newRow("large") << 12.4 << -20.7;
+    QTest::newRow("larger") << -30.25 << 9.5;
+}
+
+void TestImageAutoGuiding::shiftTest()
+{
+    QFETCH(double, dx);
+    QFETCH(double, dy);
+
+    std::vector<float> ref = makeImage(0, 0, 1);
+    std::vector<float> im = makeImage(dx, dy, 2);
+    float xshift = 0, yshift = 0;
+    ImageAutoGuiding::ImageAutoGuiding1(ref.data(), im.data(), imageSize, &xshift, &yshift);
+    QVERIFY2(std::fabs(xshift - dx) < 0.02, qPrintable(QString("x %1 vs %2").arg(xshift).arg(dx)));
+    QVERIFY2(std::fabs(yshift - dy) < 0.02, qPrintable(QString("y %1 vs %2").arg(yshift).arg(dy)));
+}
+
+void TestImageAutoGuiding::referenceTest()
+{
+    ImageAutoGuiding::CrossCorrelator correlator(imageSize);
+    QCOMPARE(correlator.size(), imageSize);
+    QVERIFY(!correlator.hasReference());
+
+    std::vector<float> ref = makeImage(0, 0, 1);
+    float xshift = 0, yshift = 0;
+    QVERIFY(!correlator.findShift(ref.data(), &xshift, &yshift));
+    QVERIFY(correlator.setReference(ref.data()));
+    QVERIFY(correlator.hasReference());
+
+    // The same reference is used for a series of frames
+    for (int frame = 0; frame < 5; frame++)
+    {
+        const double dx = 0.7 * frame, dy = -1.1 * frame;
+        std::vector<float> im = makeImage(dx, dy, 10 + frame);
+        QVERIFY(correlator.findShift(im.data(), &xshift, &yshift));
+        QVERIFY(std::fabs(xshift - dx) < 0.02);
+        QVERIFY(std::fabs(yshift - dy) < 0.02);
+    }
+}
+
+void TestImageAutoGuiding::invalidSizeTest()
+{
+    ImageAutoGuiding::CrossCorrelator correlator(200);
+    QCOMPARE(correlator.size(), 0);
+    std::vector<float> ref(200 * 200, 1);
+    QVERIFY(!correlator.setReference(ref.data()));
+
+    float xshift = 1, yshift = 1;
+    ImageAutoGuiding::ImageAutoGuiding1(ref.data(), ref.data(), 200, &xshift, &yshift);
+    QCOMPARE(xshift, 0.0f);
+    QCOMPARE(yshift, 0.0f);
+}
+
+void TestImageAutoGuiding::benchmarkTest()
+{
+    std::vector<float> ref = makeImage(0, 0, 1);
+    std::vector<float> im = makeImage(1.3, -0.6, 2);
+    ImageAutoGuiding::CrossCorrelator correlator(imageSize);
+    correlator.setReference(ref.data());
+
+    constexpr int frames = 100;
+    float xshift = 0, yshift = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < frames; i++)
+        correlator.findShift(im.data(), &xshift, &yshift);
+    qInfo() << "Shift of a" << imageSize << "x" << imageSize << "frame:" << timer.nsecsElapsed() / 1e6 / frames << "ms";
+}
+
+QTEST_GUILESS_MAIN(TestImageAutoGuiding)
@@ -5,6 +5,7 @@
 */
 
 #include "ekos/guide/internalguide/starcorrespondence.h"
+#include "ekos/guide/internalguide/stargrid.h"
 
 #include <QtGlobal>
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -16,6 +17,8 @@
 #include <QObject>
 #include "Options.h"
 
+#include <random>
+
 
 class TestStarCorrespondence : public QObject
 {
@@ -30,6 +33,7 @@ class TestStarCorrespondence : public QObject
 
     private slots:
         void basicTest();
+        void gridTest();
 };
 
 #include "teststarcorrespondence.moc"
@@ -245,4 +249,60 @@ void TestStarCorrespondence::basicTest()
     runNoCorrespondenceTest();
 }
 
+void TestStarCorrespondence::gridTest()
+{
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> position(0, 1000);
+    QList<Edge> stars;
+    for (int i = 0; i < 300; ++i)
+        stars.append(makeEdge(position(generator), position(generator) / 10));
+    // A star on top of another one.
+    stars.append(stars[7]);
+
+    StarGrid grid;
+    grid.build(stars, 5.0);
+    QCOMPARE(grid.size(), stars.size());
+
+    // Compare against searching all the stars.
+    for (int i = 0; i < 1000; ++i)
+    {
+        const double x = position(generator) * 1.2 - 100;
+        const double y = position(generator) / 8 - 10;
+        const double maxDistance = i % 20;
+        int closest = -1;
+        double closestSquared = maxDistance * maxDistance;
+        for (int j = 0; j < stars.size(); ++j)
+        {
+            const double squared = (stars[j].x - x) * (stars[j].x - x) + (stars[j].y - y) * (stars[j].y - y);
+            if (squared <= closestSquared)
+            {
+                closest = j;
+                closestSquared = squared;
+            }
+        }
+        QCOMPARE(grid.findClosest(x, y, maxDistance), closest);
+    }
+
+    QList<Edge *> pointers;
+    for (auto &star : stars)
+        pointers.append(&star);
+    grid.build(pointers);
+    QCOMPARE(grid.nearestNeighborDistance(7), 0.0);
+    for (int i = 0; i < stars.size(); ++i)
+    {
+        double closestSquared = 1e10;
+        for (int j = 0; j < stars.size(); ++j)
+        {
+            if (j == i) continue;
+            const double squared = (stars[j].x - stars[i].x) * (stars[j].x - stars[i].x) +
+                                   (stars[j].y - stars[i].y) * (stars[j].y - stars[i].y);
+            closestSquared = std::min(closestSquared, squared);
+        }
+        QVERIFY(fabs(grid.nearestNeighborDistance(i) - sqrt(closestSquared)) < .001);
+    }
+
+    grid.build(QList<Edge>());
+    QCOMPARE(grid.findClosest(10, 10, 100), -1);
+}
+
 QTEST_GUILESS_MAIN(TestStarCorrespondence)
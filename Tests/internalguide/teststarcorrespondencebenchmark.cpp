@@ -0,0 +1,102 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ekos/guide/internalguide/starcorrespondence.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include <QObject>
+#include "Options.h"
+
+#include <algorithm>
+#include <random>
+
+class TestStarCorrespondenceBenchmark : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** @short Constructor */
+        TestStarCorrespondenceBenchmark();
+
+        /** @short Destructor */
+        ~TestStarCorrespondenceBenchmark() override = default;
+
+    private slots:
+        void findBenchmark();
+};
+
+#include "teststarcorrespondencebenchmark.moc"
+
+namespace
+{
+Edge makeEdge(float x, float y)
+{
+    Edge e;
+    e.x = x;
+    e.y = y;
+    return e;
+}
+}
+
+TestStarCorrespondenceBenchmark::TestStarCorrespondenceBenchmark() : QObject()
+{
+}
+
+// Times star correspondence on a wide field with many detections, as the guide star drifts.
+void TestStarCorrespondenceBenchmark::findBenchmark()
+{
+    Options::setAlwaysInventGuideStar(false);
+    constexpr int numStars = 400;
+    constexpr int numFrames = 100;
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<float> x(0, 1280), y(0, 960);
+    std::normal_distribution<float> noise(0, 0.5);
+
+    QList<Edge> field;
+    for (int i = 0; i < numStars; ++i)
+        field.append(makeEdge(x(generator), y(generator)));
+    StarCorrespondence c(field.mid(0, 100), 3);
+    c.setImageSize(1280, 960);
+
+    QList<QList<Edge>> frames;
+    float driftX = 0, driftY = 0;
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        driftX += noise(generator);
+        driftY += noise(generator);
+        QList<Edge> stars;
+        for (const auto &star : field)
+        {
+            // Lose some of the stars in each frame.
+            if (generator() % 10 == 0) continue;
+            stars.append(makeEdge(star.x + driftX + noise(generator), star.y + driftY + noise(generator)));
+        }
+        std::shuffle(stars.begin(), stars.end(), generator);
+        frames.append(stars);
+    }
+
+    QVector<int> output;
+    int found = 0;
+    QBENCHMARK
+    {
+        found = 0;
+        for (const auto &stars : frames)
+        {
+            if (c.find(stars, 5.0, &output, true).x >= 0)
+                found++;
+        }
+    }
+    // The guide star is dropped in about 10% of the frames.
+    QVERIFY(found >= numFrames * 0.8);
+}
+
+QTEST_GUILESS_MAIN(TestStarCorrespondenceBenchmark)
@@ -0,0 +1,78 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PROJECTORTESTDATA_H
+#define PROJECTORTESTDATA_H
+
+#include "projections/projector.h"
+#include "projections/azimuthalequidistantprojector.h"
+#include "projections/equirectangularprojector.h"
+#include "projections/gnomonicprojector.h"
+#include "projections/lambertprojector.h"
+#include "projections/orthographicprojector.h"
+#include "projections/stereographicprojector.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Shared by the projector batch tests and benchmarks
+namespace ProjectorTestData
+{
+inline std::unique_ptr<Projector> makeProjector(Projector::Projection type, const ViewParams &vp)
+{
+    switch (type)
+    {
+        case Projector::Gnomonic:
+            return std::unique_ptr<Projector>(new GnomonicProjector(vp));
+        case Projector::Stereographic:
+            return std::unique_ptr<Projector>(new StereographicProjector(vp));
+        case Projector::Orthographic:
+            return std::unique_ptr<Projector>(new OrthographicProjector(vp));
+        case Projector::AzimuthalEquidistant:
+            return std::unique_ptr<Projector>(new AzimuthalEquidistantProjector(vp));
+        case Projector::Equirectangular:
+            return std::unique_ptr<Projector>(new EquirectangularProjector(vp));
+        default:
+            return std::unique_ptr<Projector>(new LambertProjector(vp));
+    }
+}
+
+// A 1200x800 sky map about 70 degrees wide, rotated a little
+inline ViewParams makeViewParams(SkyPoint *focus, bool altAz, bool mirror)
+{
+    ViewParams vp;
+    vp.width = 1200;
+    vp.height = 800;
+    vp.zoomFactor = 1000;
+    vp.rotationAngle = CachingDms(20.0);
+    vp.useRefraction = true;
+    vp.useAltAz = altAz;
+    vp.mirror = mirror;
+    vp.focus = focus;
+    return vp;
+}
+
+// Points spread uniformly over the sphere, with unrelated horizontal coordinates
+inline std::vector<SkyPoint> randomPoints(int count)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<SkyPoint> points;
+    points.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        SkyPoint p(24 * uniform(generator), std::asin(2 * uniform(generator) - 1) / dms::DegToRad);
+        p.setAz(360 * uniform(generator));
+        p.setAlt(std::asin(2 * uniform(generator) - 1) / dms::DegToRad);
+        points.push_back(p);
+    }
+    return points;
+}
+}
+
+#endif // PROJECTORTESTDATA_H
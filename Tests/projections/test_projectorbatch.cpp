@@ -0,0 +1,158 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "projectortestdata.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include <QMetaEnum>
+#include <QObject>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+class TestProjectorBatch : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** @short Constructor */
+        TestProjectorBatch();
+
+        /** @short Destructor */
+        ~TestProjectorBatch() override = default;
+
+    private slots:
+        void toScreenBatchTest_data();
+        void toScreenBatchTest();
+        void fromScreenBatchTest_data();
+        void fromScreenBatchTest();
+};
+
+#include "test_projectorbatch.moc"
+
+using namespace ProjectorTestData;
+
+namespace
+{
+void addProjectionRows()
+{
+    QTest::addColumn<Projector::Projection>("type");
+    QTest::addColumn<bool>("altAz");
+    QTest::addColumn<bool>("mirror");
+
+    const QList<Projector::Projection> types = {Projector::Lambert, Projector::AzimuthalEquidistant,
+                                                Projector::Orthographic, Projector::Equirectangular,
+                                                Projector::Stereographic, Projector::Gnomonic
+                                               };
+    for (const auto type : types)
+    {
+        const QByteArray name = QMetaEnum::fromType<Projector::Projection>().valueToKey(type);
+        QTest::addRow("%s equatorial", name.constData()) << type << false << false;
+        QTest::addRow("%s horizontal", name.constData()) << type << true << false;
+        QTest::addRow("%s mirrored", name.constData()) << type << true << true;
+    }
+}
+}
+
+TestProjectorBatch::TestProjectorBatch() : QObject()
+{
+}
+
+void TestProjectorBatch::toScreenBatchTest_data()
+{
+    addProjectionRows();
+}
+
+void TestProjectorBatch::toScreenBatchTest()
+{
+    QFETCH(Projector::Projection, type);
+    QFETCH(bool, altAz);
+    QFETCH(bool, mirror);
+
+    SkyPoint focus(5.5, 30);
+    focus.setAz(120);
+    focus.setAlt(40);
+    const auto projector = makeProjector(type, makeViewParams(&focus, altAz, mirror));
+
+    // More than one block of points
+    const std::vector<SkyPoint> points = randomPoints(1000);
+    std::vector<const SkyPoint *> pointers;
+    for (const auto &p : points)
+        pointers.push_back(&p);
+    std::vector<float> x(points.size()), y(points.size());
+    std::vector<quint8> flags(points.size());
+
+    for (const bool refract : {true, false})
+    {
+        projector->toScreenBatch(pointers.data(), pointers.size(), x.data(), y.data(), flags.data(), refract);
+
+        int onScreen = 0;
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            bool visible = false;
+            const Eigen::Vector2f p = projector->toScreenVec(&points[i], refract, &visible);
+            QCOMPARE(bool(flags[i] & Projector::OnVisibleHemisphere), visible);
+            QCOMPARE(bool(flags[i] & Projector::OnScreen), visible && projector->onScreen(p));
+            if (!visible)
+                continue;
+            onScreen += (flags[i] & Projector::OnScreen) ? 1 : 0;
+            QVERIFY2(std::fabs(x[i] - p.x()) < 1e-3 * std::max(1.0f, std::fabs(p.x())), qPrintable(QString::number(i)));
+            QVERIFY2(std::fabs(y[i] - p.y()) < 1e-3 * std::max(1.0f, std::fabs(p.y())), qPrintable(QString::number(i)));
+        }
+        QVERIFY(onScreen > 0);
+    }
+}
+
+void TestProjectorBatch::fromScreenBatchTest_data()
+{
+    addProjectionRows();
+}
+
+void TestProjectorBatch::fromScreenBatchTest()
+{
+    QFETCH(Projector::Projection, type);
+    QFETCH(bool, altAz);
+    QFETCH(bool, mirror);
+
+    SkyPoint focus(5.5, 30);
+    focus.setAz(120);
+    focus.setAlt(40);
+    const auto projector = makeProjector(type, makeViewParams(&focus, altAz, mirror));
+
+    const std::vector<SkyPoint> points = randomPoints(1000);
+    std::vector<double> longitudes, latitudes;
+    for (const auto &p : points)
+    {
+        longitudes.push_back(altAz ? p.az().radians() : p.ra().radians());
+        latitudes.push_back(altAz ? p.alt().radians() : p.dec().radians());
+    }
+    std::vector<float> x(points.size()), y(points.size());
+    std::vector<quint8> flags(points.size());
+    projector->toScreenBatch(longitudes.data(), latitudes.data(), points.size(), x.data(), y.data(), flags.data());
+
+    std::vector<double> lon(points.size()), lat(points.size());
+    projector->fromScreenBatch(x.data(), y.data(), points.size(), lon.data(), lat.data());
+
+    // Points on screen map back to where they came from
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        if (!(flags[i] & Projector::OnScreen))
+            continue;
+        QVERIFY(lon[i] >= 0 && lon[i] < 2 * dms::PI);
+        const double cosDistance = std::sin(lat[i]) * std::sin(latitudes[i]) +
+                                   std::cos(lat[i]) * std::cos(latitudes[i]) * std::cos(lon[i] - longitudes[i]);
+        QVERIFY2(std::acos(std::min(1.0, cosDistance)) < 1e-5, qPrintable(QString::number(i)));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestProjectorBatch)
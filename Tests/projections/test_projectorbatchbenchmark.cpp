@@ -0,0 +1,89 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "projectortestdata.h"
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include <QObject>
+
+#include <vector>
+
+class TestProjectorBatchBenchmark : public QObject
+{
+        Q_OBJECT
+
+    public:
+        /** @short Constructor */
+        TestProjectorBatchBenchmark();
+
+        /** @short Destructor */
+        ~TestProjectorBatchBenchmark() override = default;
+
+    private slots:
+        void toScreenBatchBenchmark_data();
+        void toScreenBatchBenchmark();
+};
+
+#include "test_projectorbatchbenchmark.moc"
+
+using namespace ProjectorTestData;
+
+TestProjectorBatchBenchmark::TestProjectorBatchBenchmark() : QObject()
+{
+}
+
+void TestProjectorBatchBenchmark::toScreenBatchBenchmark_data()
+{
+    QTest::addColumn<bool>("batch");
+
+    QTest::addRow("toScreenVec") << false;
+    QTest::addRow("toScreenBatch") << true;
+}
+
+void TestProjectorBatchBenchmark::toScreenBatchBenchmark()
+{
+    QFETCH(bool, batch);
+
+    SkyPoint focus(5.5, 30);
+    focus.setAz(120);
+    focus.setAlt(40);
+    const auto projector = makeProjector(Projector::Lambert, makeViewParams(&focus, true, false));
+
+    // About as many stars as the sky map draws at a moderate zoom
+    const std::vector<SkyPoint> points = randomPoints(100000);
+    std::vector<const SkyPoint *> pointers;
+    for (const auto &p : points)
+        pointers.push_back(&p);
+    std::vector<float> x(points.size()), y(points.size());
+    std::vector<quint8> flags(points.size());
+
+    if (batch)
+    {
+        QBENCHMARK { projector->toScreenBatch(pointers.data(), pointers.size(), x.data(), y.data(), flags.data()); }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            for (size_t i = 0; i < points.size(); i++)
+            {
+                bool visible = false;
+                const Eigen::Vector2f p = projector->toScreenVec(pointers[i], true, &visible);
+                x[i] = p.x();
+                y[i] = p.y();
+                flags[i] = visible && projector->onScreen(p);
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestProjectorBatchBenchmark)
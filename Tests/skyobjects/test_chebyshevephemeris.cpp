@@ -0,0 +1,204 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_chebyshevephemeris.h"
+
+#include "auxiliary/chebyshevephemeris.h"
+#include "auxiliary/dms.h"
+#include "kspaths.h"
+#include "ksnumbers.h"
+#include "skyobjects/ksmoon.h"
+#include "skyobjects/ksplanet.h"
+#include "Options.h"
+#include "time/kstarsdatetime.h"
+#include "../testhelpers.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+#include <cmath>
+
+namespace
+{
+// Dates spread over 1900 - 2100, in Julian Days
+QVector<double> testDates()
+{
+    QVector<double> dates;
+    for (double jd = 2415020.5; jd < 2488070.5; jd += 1234.567)
+        dates.append(jd);
+    return dates;
+}
+
+// Angular distance between two ecliptic positions, in arcseconds
+double separation(const dms &lon1, const dms &lat1, const dms &lon2, const dms &lat2)
+{
+    double sinB1, cosB1, sinB2, cosB2;
+    lat1.SinCos(sinB1, cosB1);
+    lat2.SinCos(sinB2, cosB2);
+    const double dL = (lon1 - lon2).radians();
+    const double c  = sinB1 * sinB2 + cosB1 * cosB2 * cos(dL);
+    return acos(qBound(-1.0, c, 1.0)) / dms::DegToRad * 3600.0;
+}
+}
+
+TestChebyshevEphemeris::TestChebyshevEphemeris() : QObject()
+{
+}
+
+TestChebyshevEphemeris::~TestChebyshevEphemeris()
+{
+}
+
+void TestChebyshevEphemeris::initTestCase()
+{
+    KTEST_BEGIN();
+    useChebyshevEphemeris = Options::useChebyshevEphemeris();
+}
+
+void TestChebyshevEphemeris::cleanupTestCase()
+{
+    Options::setUseChebyshevEphemeris(useChebyshevEphemeris);
+    KTEST_END();
+}
+
+void TestChebyshevEphemeris::testAnalyticFunction()
+{
+    auto reference = [](double t, double xyz[3])
+    {
+        xyz[0] = cos(t);
+        xyz[1] = sin(3 * t);
+        xyz[2] = exp(-t * t / 100.0);
+    };
+
+    // No disk cache for this one
+    ChebyshevEphemeris ephemeris(QString(), 0.5, 13, 0, reference);
+
+    for (double t = -20.0; t < 20.0; t += 0.0137)
+    {
+        double expected[3], actual[3];
+        reference(t, expected);
+        ephemeris.evaluate(t, actual);
+        for (int i = 0; i < 3; ++i)
+            QVERIFY2(fabs(expected[i] - actual[i]) < 1e-12, qPrintable(QString("t = %1, component %2: %3 vs %4")
+                     .arg(t).arg(i).arg(expected[i]).arg(actual[i])));
+    }
+
+    // 80 segments of 0.5 cover [-20, 20)
+    QCOMPARE(ephemeris.segmentCount(), 80);
+    ephemeris.fitRange(-20.0, 19.99);
+    QCOMPARE(ephemeris.segmentCount(), 80);
+}
+
+void TestChebyshevEphemeris::testCacheTrimming()
+{
+    auto reference = [](double t, double xyz[3])
+    {
+        xyz[0] = cos(t);
+        xyz[1] = sin(t);
+        xyz[2] = t;
+    };
+
+    const QString cacheFile = QDir(KSPaths::writableLocation(QStandardPaths::AppLocalDataLocation))
+                              .filePath("ephemerides/test_trimming.cheb");
+    QFile::remove(cacheFile);
+
+    // Fit more segments than the cache holds, each segment taking 3 * 14 doubles and 12 bytes
+    const int segments = 2 * ChebyshevEphemeris::MaxCacheSize / (3 * 14 * 8 + 12);
+    int kept = 0;
+    {
+        ChebyshevEphemeris ephemeris("test_trimming", 1.0, 13, 0, reference);
+        ephemeris.fitRange(0.0, segments - 0.5);
+
+        kept = ephemeris.segmentCount();
+        QVERIFY(kept > 0);
+        QVERIFY(kept < segments);
+        QVERIFY(QFileInfo(cacheFile).size() <= ChebyshevEphemeris::MaxCacheSize);
+
+        // The latest segments are kept, the earliest were dropped and are fitted again
+        double xyz[3];
+        ephemeris.evaluate(segments - 0.5, xyz);
+        QCOMPARE(ephemeris.segmentCount(), kept);
+        ephemeris.evaluate(0.5, xyz);
+        QCOMPARE(ephemeris.segmentCount(), kept + 1);
+        QVERIFY(fabs(xyz[2] - 0.5) < 1e-12);
+        kept++;
+    }
+
+    // The trimmed cache file is read back in full
+    ChebyshevEphemeris ephemeris("test_trimming", 1.0, 13, 0, reference);
+    QCOMPARE(ephemeris.segmentCount(), kept);
+    double xyz[3];
+    ephemeris.evaluate(segments - 0.5, xyz);
+    QVERIFY(fabs(xyz[2] - (segments - 0.5)) < 1e-9);
+    QCOMPARE(ephemeris.segmentCount(), kept);
+
+    QFile::remove(cacheFile);
+}
+
+void TestChebyshevEphemeris::testPlanetsAgainstVSOP_data()
+{
+    QTest::addColumn<int>("planet");
+
+    QTest::newRow("Mercury") << int(KSPlanetBase::MERCURY);
+    QTest::newRow("Venus") << int(KSPlanetBase::VENUS);
+    QTest::newRow("Mars") << int(KSPlanetBase::MARS);
+    QTest::newRow("Jupiter") << int(KSPlanetBase::JUPITER);
+    QTest::newRow("Saturn") << int(KSPlanetBase::SATURN);
+    QTest::newRow("Uranus") << int(KSPlanetBase::URANUS);
+    QTest::newRow("Neptune") << int(KSPlanetBase::NEPTUNE);
+}
+
+void TestChebyshevEphemeris::testPlanetsAgainstVSOP()
+{
+    QFETCH(int, planet);
+
+    KSPlanet p(planet);
+    if (!p.loadData())
+        QSKIP("VSOP87 data files are not available");
+
+    Options::setUseChebyshevEphemeris(true);
+
+    for (double jd : testDates())
+    {
+        const double jm = (jd - J2000) / 365250.0;
+        EclipticPosition fit, vsop;
+        p.calcEcliptic(jm, fit);
+        p.calcEclipticVSOP(jm, vsop);
+
+        // One milliarcsecond, and a relative distance error of 1e-9
+        const double error = separation(fit.longitude, fit.latitude, vsop.longitude, vsop.latitude);
+        QVERIFY2(error < 0.001, qPrintable(QString("%1 at JD %2 is off by %3\"").arg(p.name()).arg(jd, 0, 'f', 1).arg(error)));
+        QVERIFY(fabs(fit.radius - vsop.radius) < 1e-9 * vsop.radius);
+    }
+}
+
+void TestChebyshevEphemeris::testMoonAgainstSeries()
+{
+    KSMoon moon;
+    if (!moon.loadData())
+        QSKIP("Lunar series data files are not available");
+
+    for (double jd : testDates())
+    {
+        KSNumbers num(jd);
+
+        Options::setUseChebyshevEphemeris(false);
+        QVERIFY(moon.findGeocentricPosition(&num, nullptr));
+        const dms lon = moon.ecLong(), lat = moon.ecLat();
+        const double distance = moon.rearth();
+
+        Options::setUseChebyshevEphemeris(true);
+        QVERIFY(moon.findGeocentricPosition(&num, nullptr));
+
+        const double error = separation(moon.ecLong(), moon.ecLat(), lon, lat);
+        QVERIFY2(error < 0.001, qPrintable(QString("Moon at JD %1 is off by %2\"").arg(jd, 0, 'f', 1).arg(error)));
+        QVERIFY(fabs(moon.rearth() - distance) < 1e-9 * distance);
+        // The longitude is not reduced by the series, the fit must land on the same turn
+        QVERIFY(fabs(moon.ecLong().Degrees() - lon.Degrees()) < 1.0);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestChebyshevEphemeris)
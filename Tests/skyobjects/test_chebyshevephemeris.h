@@ -0,0 +1,46 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TEST_CHEBYSHEVEPHEMERIS_H
+#define TEST_CHEBYSHEVEPHEMERIS_H
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include <QDebug>
+
+/**
+ * @class TestChebyshevEphemeris
+ * @short Checks the Chebyshev ephemeris cache against the series it approximates
+ */
+
+class TestChebyshevEphemeris : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestChebyshevEphemeris();
+        ~TestChebyshevEphemeris() override;
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testAnalyticFunction();
+        void testCacheTrimming();
+        void testPlanetsAgainstVSOP_data();
+        void testPlanetsAgainstVSOP();
+        void testMoonAgainstSeries();
+
+    private:
+        bool useChebyshevEphemeris { true };
+};
+
+#endif
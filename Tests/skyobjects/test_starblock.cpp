@@ -0,0 +1,156 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_starblock.h"
+
+#include "kstarsdata.h"
+#include "ksnumbers.h"
+#include "skycomponents/starblock.h"
+#include "skyobjects/stardata.h"
+#include "skyobjects/starobject.h"
+#include "Options.h"
+
+#include <QRandomGenerator>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+constexpr int numStars = 200;
+
+// Catalog entries sorted by magnitude, as they are in a StarBlock. They are spread over the whole sky, with
+// proper motions from none to that of the fastest stars, so that some are below the threshold where
+// StarObject ignores them.
+std::vector<StarData> makeStars()
+{
+    QRandomGenerator generator(7);
+    std::vector<StarData> stars(numStars);
+    for (int i = 0; i < numStars; i++)
+    {
+        StarData &star = stars[i];
+        star.RA = static_cast<qint32>(generator.bounded(24.0) * 1e6);
+        star.Dec = static_cast<qint32>(std::asin(generator.bounded(2.0) - 1) * 180.0 / M_PI * 1e5);
+        // Near the poles, where the RA of the proper motion changes fastest
+        if (i % 20 == 0)
+            star.Dec = (i % 40 == 0 ? 1 : -1) * static_cast<qint32>(89.99 * 1e5);
+        const double pm = (i % 4 == 0) ? 0.0 : std::pow(10.0, generator.bounded(4.0));
+        const double angle = generator.bounded(2 * M_PI);
+        star.dRA = static_cast<qint32>(pm * std::sin(angle) * 10);
+        star.dDec = static_cast<qint32>(pm * std::cos(angle) * 10);
+        star.mag = static_cast<qint16>((4.0 + 10.0 * i / numStars) * 100);
+        star.spec_type[0] = 'G';
+        star.spec_type[1] = '2';
+    }
+    return stars;
+}
+
+// Difference between two angles in degrees, taking the wrap around into account
+double angleDifference(double a, double b)
+{
+    return std::fabs(std::remainder(a - b, 360.0));
+}
+}
+
+TestStarBlock::TestStarBlock() : QObject()
+{
+}
+
+TestStarBlock::~TestStarBlock()
+{
+}
+
+void TestStarBlock::initTestCase()
+{
+    // StarBlock and StarObject take the time and location from KStarsData
+    KStarsData::Create();
+    useRelativistic = Options::useRelativistic();
+    alwaysRecomputeCoordinates = Options::alwaysRecomputeCoordinates();
+}
+
+void TestStarBlock::cleanupTestCase()
+{
+    Options::setUseRelativistic(useRelativistic);
+    Options::setAlwaysRecomputeCoordinates(alwaysRecomputeCoordinates);
+}
+
+void TestStarBlock::testJITupdateMatchesStarObject_data()
+{
+    QTest::addColumn<double>("years");
+    QTest::addColumn<float>("maglim");
+    QTest::addColumn<bool>("relativistic");
+
+    QTest::newRow("J2000") << 0.0 << 20.0f << false;
+    QTest::newRow("+10 years") << 10.0 << 20.0f << false;
+    QTest::newRow("-50 years") << -50.0 << 20.0f << false;
+    QTest::newRow("+500 years") << 500.0 << 20.0f << false;
+    QTest::newRow("+26 years, maglim 9") << 26.0 << 9.0f << false;
+    QTest::newRow("+26 years, relativistic") << 26.0 << 20.0f << true;
+}
+
+void TestStarBlock::testJITupdateMatchesStarObject()
+{
+    QFETCH(double, years);
+    QFETCH(float, maglim);
+    QFETCH(bool, relativistic);
+
+    Options::setUseRelativistic(relativistic);
+    Options::setAlwaysRecomputeCoordinates(false);
+
+    const std::vector<StarData> catalog = makeStars();
+    StarBlock block(numStars);
+    std::vector<StarObject> stars(numStars);
+    for (int i = 0; i < numStars; i++)
+    {
+        QVERIFY(block.addStar(catalog[i]) != nullptr);
+        stars[i].init(&catalog[i]);
+    }
+    QVERIFY(block.isFull());
+
+    // Two updates, so the second one starts from stars that were updated before
+    KStarsData *data = KStarsData::Instance();
+    for (const double offset : { 0.0, 1.0 })
+    {
+        data->incUpdateID();
+        data->updateNum()->updateValues(J2000 + (years + offset) * 365.25);
+
+        block.JITupdate(maglim);
+        for (int i = 0; i < numStars; i++)
+        {
+            if (stars[i].mag() <= maglim)
+                stars[i].JITupdate();
+        }
+
+        for (int i = 0; i < numStars; i++)
+        {
+            const StarObject *actual = block.star(i);
+            const StarObject &expected = stars[i];
+            if (expected.mag() > maglim)
+            {
+                // Stars beyond the magnitude limit are left alone
+                QCOMPARE(actual->updateID, static_cast<quint64>(0));
+                continue;
+            }
+
+            QCOMPARE(actual->updateID, expected.updateID);
+            QCOMPARE(actual->updateNumID, expected.updateNumID);
+            QVERIFY2(angleDifference(actual->ra().Degrees(), expected.ra().Degrees()) *
+                     std::cos(expected.dec().radians()) < 1e-7 &&
+                     angleDifference(actual->dec().Degrees(), expected.dec().Degrees()) < 1e-7,
+                     qPrintable(QString("Star %1: RA/Dec %2 %3 != %4 %5").arg(i)
+                                .arg(actual->ra().Degrees(), 0, 'f', 9).arg(actual->dec().Degrees(), 0, 'f', 9)
+                                .arg(expected.ra().Degrees(), 0, 'f', 9).arg(expected.dec().Degrees(), 0, 'f', 9)));
+            QVERIFY2(angleDifference(actual->az().Degrees(), expected.az().Degrees()) *
+                     std::cos(expected.alt().radians()) < 1e-7 &&
+                     angleDifference(actual->alt().Degrees(), expected.alt().Degrees()) < 1e-7,
+                     qPrintable(QString("Star %1: Az/Alt %2 %3 != %4 %5").arg(i)
+                                .arg(actual->az().Degrees(), 0, 'f', 9).arg(actual->alt().Degrees(), 0, 'f', 9)
+                                .arg(expected.az().Degrees(), 0, 'f', 9).arg(expected.alt().Degrees(), 0, 'f', 9)));
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestStarBlock)
@@ -0,0 +1,44 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TEST_STARBLOCK_H
+#define TEST_STARBLOCK_H
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QtTest/QTest>
+#else
+#include <QTest>
+#endif
+
+#include <QDebug>
+
+/**
+ * @class TestStarBlock
+ * @short Checks the block JITupdate of StarBlock against StarObject::JITupdate
+ */
+
+class TestStarBlock : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TestStarBlock();
+        ~TestStarBlock() override;
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testJITupdateMatchesStarObject_data();
+        void testJITupdateMatchesStarObject();
+
+    private:
+        bool useRelativistic { false };
+        bool alwaysRecomputeCoordinates { false };
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "byteorder.h"
 #include "auxiliary/kspaths.h"
 
+#include <QFile>
 #include <QStandardPaths>
 
 class BinFileHelper;
@@ -28,10 +29,12 @@ BinFileHelper::~BinFileHelper()
 
 void BinFileHelper::init()
 {
+    unmapFile();
     if (fileHandle)
         fclose(fileHandle);
 
     fileHandle      = nullptr;
+    filePath.clear();
     indexUpdated    = false;
     FDUpdated       = false;
     RSUpdated       = false;
@@ -83,6 +86,7 @@ FILE *BinFileHelper::openFile(const QString &fileName)
         errnum = ERR_FILEOPEN;
         return nullptr;
     }
+    filePath = FilePath;
     return fileHandle;
 }
 
@@ -275,10 +279,49 @@ bool BinFileHelper::readHeader()
 
 void BinFileHelper::closeFile()
 {
+    unmapFile();
     fclose(fileHandle);
     fileHandle = nullptr;
 }
 
+bool BinFileHelper::mapFile()
+{
+    if (mappedData)
+        return true;
+    if (!fileHandle || filePath.isEmpty())
+        return false;
+
+    mappedFile = new QFile(filePath);
+    if (!mappedFile->open(QIODevice::ReadOnly))
+    {
+        unmapFile();
+        return false;
+    }
+
+    mappedSize = mappedFile->size();
+    mappedData = (mappedSize > 0) ? mappedFile->map(0, mappedSize) : nullptr;
+    if (!mappedData)
+    {
+        unmapFile();
+        return false;
+    }
+    return true;
+}
+
+void BinFileHelper::unmapFile()
+{
+    if (mappedFile)
+    {
+        if (mappedData)
+            mappedFile->unmap(mappedData);
+        mappedFile->close();
+        delete mappedFile;
+    }
+    mappedFile = nullptr;
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
 int BinFileHelper::getErrorNumber()
 {
     int err = errnum;
@@ -11,6 +11,7 @@
 
 #include <cstdio>
 
+class QFile;
 class QString;
 
 /**
@@ -66,9 +67,43 @@ class BinFileHelper
 
     /**
      * @short  Close the binary data file
+     * @note   Also releases the memory mapping, if any
      */
     void closeFile();
 
+    /**
+     * @short  Memory-map the currently open file
+     *
+     * Once mapped, records can be accessed in place with recordAt() instead of going through
+     * fseek / fread on the file handle. The file handle remains open, so callers that do not
+     * know about the mapping keep working unchanged.
+     *
+     * @return True if the file was mapped, false if no file is open or the platform refused the mapping
+     */
+    bool mapFile();
+
+    /**
+     * @short  Release the memory mapping created by mapFile()
+     */
+    void unmapFile();
+
+    /**
+     * @return True if the file is currently memory-mapped
+     */
+    inline bool isMapped() const { return mappedData != nullptr; }
+
+    /**
+     * @short  Returns a pointer to the data at the given offset inside the mapped file
+     * @param  offset Offset from the start of the file, in bytes
+     * @param  size Number of bytes the caller intends to read from the returned pointer
+     * @return Pointer into the mapping, or nullptr if the file is not mapped or the range is out of bounds
+     * @note   The returned pointer is not necessarily aligned for the record structures. Use memcpy to read them.
+     */
+    inline const uchar *recordAt(quint64 offset, quint64 size) const
+    {
+        return (mappedData && offset + size <= mappedSize) ? mappedData + offset : nullptr;
+    }
+
     /**
      * @short   Get error number
      * @return  A number corresponding to the error
@@ -229,6 +264,14 @@ class BinFileHelper
 
     /// Handle to the file.
     FILE *fileHandle { nullptr};
+    /// Path of the currently open file, used to create the memory mapping
+    QString filePath;
+    /// File backing the memory mapping
+    QFile *mappedFile { nullptr };
+    /// Start of the memory mapping, nullptr if the file is not mapped
+    uchar *mappedData { nullptr };
+    /// Size of the memory mapping in bytes
+    quint64 mappedSize { 0 };
     /// Stores offsets corresponding to each index table entry
     QVector<unsigned long> indexOffset;
     /// Stores number of records under each index table entry
@@ -0,0 +1,211 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "chebyshevephemeris.h"
+
+#include "kspaths.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include <kstars_debug.h>
+
+namespace
+{
+// "KSCE"
+const quint32 cacheMagic   = 0x4B534345;
+const quint32 cacheVersion = 1;
+}
+
+ChebyshevEphemeris::ChebyshevEphemeris(const QString &name, double segmentLength, int degree, quint32 fingerprint,
+                                       ReferenceFunction reference)
+    : m_SegmentLength(segmentLength), m_Degree(degree), m_Fingerprint(fingerprint), m_Reference(std::move(reference))
+{
+    if (!name.isEmpty())
+    {
+        QDir dir(KSPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+        dir.mkpath("ephemerides");
+        m_CacheFile = dir.filePath(QString("ephemerides/%1.cheb").arg(name));
+        loadCache();
+    }
+}
+
+double ChebyshevEphemeris::clenshaw(const double *c, int degree, double x)
+{
+    double b1 = 0, b2 = 0;
+    const double x2 = 2.0 * x;
+    for (int j = degree; j >= 1; --j)
+    {
+        const double b0 = c[j] + x2 * b1 - b2;
+        b2 = b1;
+        b1 = b0;
+    }
+    return c[0] + x * b1 - b2;
+}
+
+void ChebyshevEphemeris::evaluate(double t, double xyz[3])
+{
+    const qint64 index = static_cast<qint64>(std::floor(t / m_SegmentLength));
+
+    QMutexLocker locker(&m_Mutex);
+    auto it = m_Segments.constFind(index);
+    const QVector<double> &coefficients = (it != m_Segments.constEnd()) ? it.value() : fitSegment(index);
+
+    // Map t to [-1, 1] within the segment
+    const double x = 2.0 * (t / m_SegmentLength - index) - 1.0;
+    const double *c = coefficients.constData();
+    for (int i = 0; i < 3; ++i)
+        xyz[i] = clenshaw(c + i * (m_Degree + 1), m_Degree, x);
+}
+
+void ChebyshevEphemeris::fitRange(double t0, double t1)
+{
+    const qint64 first = static_cast<qint64>(std::floor(t0 / m_SegmentLength));
+    const qint64 last  = static_cast<qint64>(std::floor(t1 / m_SegmentLength));
+
+    QMutexLocker locker(&m_Mutex);
+    for (qint64 index = first; index <= last; ++index)
+    {
+        if (!m_Segments.contains(index))
+            fitSegment(index);
+    }
+}
+
+int ChebyshevEphemeris::segmentCount()
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Segments.size();
+}
+
+const QVector<double> &ChebyshevEphemeris::fitSegment(qint64 index)
+{
+    const int n         = m_Degree + 1;
+    const double half   = 0.5 * m_SegmentLength;
+    const double middle = (index + 0.5) * m_SegmentLength;
+
+    // Sample the reference function at the Chebyshev nodes of the segment
+    QVector<double> samples(3 * n);
+    for (int k = 0; k < n; ++k)
+    {
+        double xyz[3];
+        m_Reference(middle + half * std::cos(M_PI * (k + 0.5) / n), xyz);
+        for (int i = 0; i < 3; ++i)
+            samples[i * n + k] = xyz[i];
+    }
+
+    // Discrete Chebyshev transform
+    QVector<double> coefficients(3 * n, 0.0);
+    for (int j = 0; j < n; ++j)
+    {
+        for (int k = 0; k < n; ++k)
+        {
+            const double w = std::cos(M_PI * j * (k + 0.5) / n);
+            for (int i = 0; i < 3; ++i)
+                coefficients[i * n + j] += samples[i * n + k] * w;
+        }
+        for (int i = 0; i < 3; ++i)
+            coefficients[i * n + j] *= (j == 0 ? 1.0 : 2.0) / n;
+    }
+
+    m_Segments.insert(index, coefficients);
+    saveSegment(index, coefficients);
+    // Trimming the cache may have rehashed the segments
+    return m_Segments.constFind(index).value();
+}
+
+void ChebyshevEphemeris::loadCache()
+{
+    QFile file(m_CacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    quint32 magic = 0, version = 0, fingerprint = 0;
+    double segmentLength = 0;
+    qint32 degree = 0;
+    in >> magic >> version >> fingerprint >> segmentLength >> degree;
+
+    if (in.status() != QDataStream::Ok || magic != cacheMagic || version != cacheVersion ||
+            fingerprint != m_Fingerprint || segmentLength != m_SegmentLength || degree != m_Degree)
+    {
+        qCInfo(KSTARS) << "Discarding stale ephemeris cache" << m_CacheFile;
+        file.close();
+        file.remove();
+        return;
+    }
+
+    while (!in.atEnd())
+    {
+        qint64 index = 0;
+        QVector<double> coefficients;
+        in >> index >> coefficients;
+        // A truncated last record is simply refitted
+        if (in.status() != QDataStream::Ok || coefficients.size() != 3 * (m_Degree + 1))
+            break;
+        m_Segments.insert(index, coefficients);
+    }
+}
+
+void ChebyshevEphemeris::saveSegment(qint64 index, const QVector<double> &coefficients)
+{
+    if (m_CacheFile.isEmpty())
+        return;
+
+    QFile file(m_CacheFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return;
+
+    QDataStream out(&file);
+    if (file.size() == 0)
+        out << cacheMagic << cacheVersion << m_Fingerprint << m_SegmentLength << qint32(m_Degree);
+    out << index << coefficients;
+
+    if (file.size() > MaxCacheSize)
+    {
+        file.close();
+        trimCache(index);
+    }
+}
+
+void ChebyshevEphemeris::trimCache(qint64 index)
+{
+    // Keep the segments nearest the one in use, filling half of the cache so that it isn't trimmed
+    // again on the next write
+    const qint64 segmentSize = sizeof(qint64) + sizeof(quint32) + 3 * (m_Degree + 1) * sizeof(double);
+    const int keep = (MaxCacheSize / 2) / segmentSize;
+
+    QList<qint64> indexes = m_Segments.keys();
+    std::sort(indexes.begin(), indexes.end(), [index](qint64 a, qint64 b)
+    {
+        return std::llabs(a - index) < std::llabs(b - index);
+    });
+    for (int i = keep; i < indexes.size(); ++i)
+        m_Segments.remove(indexes[i]);
+
+    qCInfo(KSTARS) << "Trimming ephemeris cache" << m_CacheFile << "to" << m_Segments.size() << "segments";
+
+    QSaveFile file(m_CacheFile);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&file);
+    out << cacheMagic << cacheVersion << m_Fingerprint << m_SegmentLength << qint32(m_Degree);
+    for (auto it = m_Segments.constBegin(); it != m_Segments.constEnd(); ++it)
+        out << it.key() << it.value();
+
+    if (out.status() != QDataStream::Ok || !file.commit())
+    {
+        qCWarning(KSTARS) << "Failed to rewrite ephemeris cache" << m_CacheFile;
+        QFile::remove(m_CacheFile);
+    }
+}
@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @class ChebyshevEphemeris
+ * @short Piecewise Chebyshev approximation of a smooth 3-vector function of time, cached on disk
+ *
+ * The time axis is cut into segments of fixed length anchored at t = 0. A segment is fitted the
+ * first time it is needed, by sampling the reference function at the Chebyshev nodes of the
+ * segment, and it is appended to a cache file so that later sessions only evaluate polynomials.
+ * When the cache file grows beyond MaxCacheSize, only the segments nearest the one just fitted
+ * are kept, in memory and on disk.
+ * Evaluating a fitted segment costs O(degree), independently of how expensive the reference
+ * function is.
+ *
+ * The unit of time is whatever the reference function uses (e.g. Julian millennia for VSOP87).
+ * Functions with angular components should be fitted in Cartesian form, so that the fit does
+ * not see any wrap-around.
+ *
+ * This class is thread-safe.
+ */
+class ChebyshevEphemeris
+{
+    public:
+        /** Reference function: fills xyz with the value of the function at time t */
+        typedef std::function<void(double t, double xyz[3])> ReferenceFunction;
+
+        /**
+         * @param name Name of the cache file, without extension. Empty to disable the disk cache.
+         * @param segmentLength Length of a segment, in units of time of the reference function
+         * @param degree Degree of the Chebyshev polynomials
+         * @param fingerprint Value identifying the reference data. Cached fits with a different
+         * fingerprint, segment length or degree are discarded.
+         * @param reference The function to approximate
+         */
+        ChebyshevEphemeris(const QString &name, double segmentLength, int degree, quint32 fingerprint,
+                           ReferenceFunction reference);
+
+        /**
+         * @short Evaluate the approximation at time t, fitting the enclosing segment if required
+         */
+        void evaluate(double t, double xyz[3]);
+
+        /**
+         * @short Fit all the segments covering [t0, t1] ahead of time
+         */
+        void fitRange(double t0, double t1);
+
+        /** @return the number of segments currently fitted */
+        int segmentCount();
+
+        /**
+         * @short Evaluate a Chebyshev series at x in [-1, 1] using Clenshaw's recurrence
+         * @param c Coefficients c[0] ... c[degree], with c[0] already halved
+         */
+        static double clenshaw(const double *c, int degree, double x);
+
+        /// Size of a cache file, in bytes, beyond which it is trimmed to half of it
+        static constexpr qint64 MaxCacheSize = 2 * 1024 * 1024;
+
+    private:
+        /** @short Fit the given segment and append it to the cache file. Call with m_Mutex held. */
+        const QVector<double> &fitSegment(qint64 index);
+
+        /** @short Load the fits from the cache file, discarding it if it does not match. */
+        void loadCache();
+
+        /** @short Append a fitted segment to the cache file */
+        void saveSegment(qint64 index, const QVector<double> &coefficients);
+
+        /**
+         * @short Drop the segments furthest from the given one and rewrite the cache file with the others.
+         * Call with m_Mutex held.
+         */
+        void trimCache(qint64 index);
+
+        QString m_CacheFile;
+        double m_SegmentLength { 1 };
+        int m_Degree { 12 };
+        quint32 m_Fingerprint { 0 };
+        ReferenceFunction m_Reference;
+
+        /// Coefficients of each fitted segment: (degree + 1) for x, then y, then z
+        QHash<qint64, QVector<double>> m_Segments;
+        QMutex m_Mutex;
+};
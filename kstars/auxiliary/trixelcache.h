@@ -70,7 +70,7 @@ class TrixelCache
     {
       public:
         /** @return whether the element contains a cached object */
-        bool is_set() { return _set; }
+        bool is_set() const { return _set; }
 
         /** @return the data held by element */
         content &data() { return _data; }
@@ -123,6 +123,12 @@ class TrixelCache
         return _data[index];
     }
 
+    /**
+     * @return whether the element at \p index is set, without
+     * counting it as used
+     */
+    bool is_set(const size_t index) const { return _data[index].is_set(); }
+
     /**
      * Remove excess elements from the cache
      * The capacity can be temporarily readjusted to \p keep.
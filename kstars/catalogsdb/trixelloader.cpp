@@ -0,0 +1,131 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "trixelloader.h"
+
+#include <QMutexLocker>
+#include <QThread>
+
+#include <algorithm>
+
+using namespace CatalogsDB;
+
+TrixelLoader::TrixelLoader(const QString &filename) : QObject(nullptr), m_filename{ filename }
+{
+    m_thread.reset(QThread::create([this]() { run(); }));
+    m_thread->start();
+}
+
+TrixelLoader::~TrixelLoader()
+{
+    {
+        QMutexLocker _{ &m_mutex };
+        m_stop = true;
+        m_requested.wakeAll();
+    }
+    m_thread->wait();
+}
+
+void TrixelLoader::request(const std::vector<Request> &requests)
+{
+    QMutexLocker _{ &m_mutex };
+    m_requests.clear();
+    for (const auto &request : requests)
+    {
+        if (m_loading && m_current.trixel == request.trixel && m_current.query == request.query)
+            continue;
+
+        if (std::any_of(m_results.cbegin(), m_results.cend(), [&](const Result &result) {
+                return result.trixel == request.trixel && result.query == request.query;
+            }))
+            continue;
+
+        m_requests.push_back(request);
+    }
+
+    if (!m_requests.empty())
+        m_requested.wakeAll();
+}
+
+std::vector<TrixelLoader::Result> TrixelLoader::takeResults()
+{
+    QMutexLocker _{ &m_mutex };
+    std::vector<Result> results;
+    results.swap(m_results);
+    return results;
+}
+
+void TrixelLoader::clear()
+{
+    QMutexLocker _{ &m_mutex };
+    m_requests.clear();
+    m_results.clear();
+    m_generation++;
+}
+
+void TrixelLoader::run()
+{
+    // The connection belongs to this thread, so it is opened here
+    std::unique_ptr<DBManager> manager;
+    try
+    {
+        manager = std::make_unique<DBManager>(m_filename);
+    }
+    catch (const DatabaseError &e)
+    {
+        qCCritical(KSTARS_CATALOGS)
+            << "Could not open the catalog database for loading trixels: " << e.what();
+        return;
+    }
+
+    while (true)
+    {
+        Request request;
+        int generation;
+        {
+            QMutexLocker _{ &m_mutex };
+            m_loading = false;
+            while (m_requests.empty() && !m_stop)
+                m_requested.wait(&m_mutex);
+
+            if (m_stop)
+                return;
+
+            request = m_requests.front();
+            m_requests.pop_front();
+            m_current  = request;
+            m_loading  = true;
+            generation = m_generation;
+        }
+
+        Result result{ request.trixel, request.query, {} };
+        try
+        {
+            result.objects = request.query == Query::KnownMag ?
+                                 manager->get_objects_in_trixel_no_nulls(request.trixel) :
+                                 manager->get_objects_in_trixel_null_mag(request.trixel);
+        }
+        catch (const DatabaseError &e)
+        {
+            // The trixel stays empty rather than being asked for over and over
+            qCCritical(KSTARS_CATALOGS) << "Could not load catalog objects in trixel: "
+                                        << request.trixel << ", " << e.what();
+        }
+
+        bool first = false;
+        {
+            QMutexLocker _{ &m_mutex };
+            if (generation != m_generation)
+                continue;
+
+            first = m_results.empty();
+            m_results.push_back(std::move(result));
+        }
+
+        if (first)
+            emit trixelsLoaded();
+    }
+}
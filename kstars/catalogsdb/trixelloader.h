@@ -0,0 +1,112 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "catalogsdb.h"
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QWaitCondition>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+class QThread;
+
+namespace CatalogsDB
+{
+/**
+ * Loads the objects in trixels of the catalog database on a thread of
+ * its own, so that drawing never has to wait for the database.
+ *
+ * The thread opens its own connection to the database and only runs
+ * the by-trixel queries on it. The owner asks for trixels with
+ * `request()` and collects them with `takeResults()` once
+ * `trixelsLoaded()` was emitted.
+ *
+ * \sa CatalogsComponent
+ */
+class TrixelLoader : public QObject
+{
+    Q_OBJECT
+
+  public:
+    /** The query to load a trixel with. */
+    enum class Query
+    {
+        /** \sa DBManager::get_objects_in_trixel_no_nulls */
+        KnownMag,
+        /** \sa DBManager::get_objects_in_trixel_null_mag */
+        UnknownMag
+    };
+
+    struct Request
+    {
+        Trixel trixel;
+        Query query;
+    };
+
+    struct Result
+    {
+        Trixel trixel;
+        Query query;
+        CatalogObjectVector objects;
+    };
+
+    /**
+     * Starts the loader thread, which opens the database \p filename.
+     */
+    explicit TrixelLoader(const QString &filename);
+    ~TrixelLoader() override;
+
+    /**
+     * Loads the trixels in \p requests, in that order. They replace
+     * the trixels of the previous call which have not been loaded
+     * yet. Trixels which are being loaded or waiting in
+     * `takeResults()` are skipped.
+     */
+    void request(const std::vector<Request> &requests);
+
+    /**
+     * \returns the trixels loaded since the last call.
+     */
+    std::vector<Result> takeResults();
+
+    /**
+     * Drops the waiting requests and results, as well as the trixel
+     * being loaded right now. To be called when the catalogs have
+     * changed.
+     */
+    void clear();
+
+  signals:
+    /**
+     * Emitted from the loader thread when results are ready and
+     * there were none before.
+     */
+    void trixelsLoaded();
+
+  private:
+    void run();
+
+    const QString m_filename;
+    std::unique_ptr<QThread> m_thread;
+
+    QMutex m_mutex;
+    QWaitCondition m_requested;
+    std::deque<Request> m_requests;
+    std::vector<Result> m_results;
+    /** The request being loaded, if `m_loading` is set. */
+    Request m_current{ 0, Query::KnownMag };
+    bool m_loading{ false };
+    /** Bumped by `clear()` to drop the request being loaded. */
+    int m_generation{ 0 };
+    bool m_stop{ false };
+};
+} // namespace CatalogsDB
@@ -12,6 +12,9 @@
 #include <QtGlobal>
 #include <QColor>
 
+#include <algorithm>
+#include <cmath>
+
 #include "auxiliary/kspaths.h"
 #include "dms.h"
 #include "ekos/manager.h"
@@ -78,6 +81,10 @@ int ECCENTRICITY_GRAPH = -1;
 int NUMSTARS_GRAPH = -1;
 int SKYBG_GRAPH = -1;
 int SNR_GRAPH = -1;
+int GUIDE_LATENCY_GRAPH = -1;
+int GUIDE_LATENCY_IO_GRAPH = -1;
+int GUIDE_LATENCY_CPU_GRAPH = -1;
+int GUIDE_LATENCY_MOUNT_GRAPH = -1;
 int RA_GRAPH = -1;
 int DEC_GRAPH = -1;
 int RA_PULSE_GRAPH = -1;
@@ -1125,6 +1132,20 @@ double Analyze::processInputLine(const QString &line)
             return 0;
         processGuideStats(time, ra, dec, raPulse, decPulse, snr, skyBg, numStars, true);
     }
+    else if ((list[0] == "GuideLatency") && list.size() == 5)
+    {
+        // Parts that weren't measured are saved as nan
+        const double io = QString(list[2]).toDouble(&ok);
+        if (!ok)
+            return 0;
+        const double cpu = QString(list[3]).toDouble(&ok);
+        if (!ok)
+            return 0;
+        const double mount = QString(list[4]).toDouble(&ok);
+        if (!ok)
+            return 0;
+        processGuideLatency(time, io, cpu, mount, true);
+    }
     else if ((list[0] == "Temperature") && list.size() == 3)
     {
         const double temperature = QString(list[2]).toDouble(&ok);
@@ -1518,10 +1539,40 @@ void Analyze::focusSessionClicked(FocusSession &c, bool doubleClick)
         displayFocusGraphics(c.positions, c.hfrs, c.useWeights, c.weights, c.outliers, c.curve, c.title, c.success);
 }
 
+namespace
+{
+// Returns "p50 / p90 / p99" of the values plotted by graph between start and end,
+// or an empty string if there are none.
+QString percentiles(QCPGraph *graph, double start, double end)
+{
+    std::vector<double> values;
+    const auto last = graph->data()->findEnd(end, false);
+    for (auto it = graph->data()->findBegin(start, false); it != last; ++it)
+    {
+        if (!qIsNaN(it->mainValue()))
+            values.push_back(it->mainValue());
+    }
+    if (values.empty())
+        return QString();
+
+    // Linear interpolation between the closest ranks, as GuideLatency does
+    std::sort(values.begin(), values.end());
+    auto percentile = [&values](double p)
+    {
+        const double rank = p / 100.0 * (values.size() - 1);
+        const size_t below = static_cast<size_t>(std::floor(rank));
+        const size_t above = std::min(below + 1, values.size() - 1);
+        return values[below] + (rank - below) * (values[above] - values[below]);
+    };
+    return QString("%1 / %2 / %3").arg(percentile(50), 0, 'f', 0).arg(percentile(90), 0, 'f', 0)
+           .arg(percentile(99), 0, 'f', 0);
+}
+}  // namespace
+
 // When the user clicks on a guide session in the timeline,
 // a table is rendered in the details section. If it has a G_GUIDING state
 // then a drift plot is generated and  RMS values are calculated
-// for the guiding session's time interval.
+// for the guiding session's time interval, along with the guide latency percentiles.
 void Analyze::guideSessionClicked(GuideSession &c, bool doubleClick)
 {
     Q_UNUSED(doubleClick);
@@ -1553,6 +1604,20 @@ void Analyze::guideSessionClicked(GuideSession &c, bool doubleClick)
             c.addRow("dec RMS", QString::number(decRMS, 'f', 2));
         }
         c.addRow("Num Samples", QString::number(numSamples));
+
+        const QList<QPair<QString, int>> latencies =
+        {
+            {"latency p50/90/99", GUIDE_LATENCY_GRAPH},
+            {"io p50/90/99", GUIDE_LATENCY_IO_GRAPH},
+            {"cpu p50/90/99", GUIDE_LATENCY_CPU_GRAPH},
+            {"mount p50/90/99", GUIDE_LATENCY_MOUNT_GRAPH}
+        };
+        for (const auto &latency : latencies)
+        {
+            const QString values = percentiles(statsPlot->graph(latency.second), c.start, c.end);
+            if (!values.isEmpty())
+                c.addRow(latency.first, values + " ms");
+        }
     }
 }
 
@@ -2161,6 +2226,10 @@ void Analyze::updateStatsValues()
     updateStat(time, eccentricityOut, statsPlot->graph(ECCENTRICITY_GRAPH), d2Fcn, statsFontMap, true);
     updateStat(time, skyBgOut, statsPlot->graph(SKYBG_GRAPH), d1Fcn, statsFontMap);
     updateStat(time, snrOut, statsPlot->graph(SNR_GRAPH), d1Fcn, statsFontMap);
+    updateStat(time, latencyOut, statsPlot->graph(GUIDE_LATENCY_GRAPH), d1Fcn, statsFontMap);
+    updateStat(time, latencyIOOut, statsPlot->graph(GUIDE_LATENCY_IO_GRAPH), d1Fcn, statsFontMap);
+    updateStat(time, latencyCPUOut, statsPlot->graph(GUIDE_LATENCY_CPU_GRAPH), d1Fcn, statsFontMap);
+    updateStat(time, latencyMountOut, statsPlot->graph(GUIDE_LATENCY_MOUNT_GRAPH), d1Fcn, statsFontMap);
     updateStat(time, raOut, statsPlot->graph(RA_GRAPH), d2Fcn, statsFontMap);
     updateStat(time, decOut, statsPlot->graph(DEC_GRAPH), d2Fcn, statsFontMap);
     updateStat(time, driftOut, statsPlot->graph(DRIFT_GRAPH), d2Fcn, statsFontMap);
@@ -2223,6 +2292,10 @@ void Analyze::initStatsCheckboxes()
     numStarsCB->setChecked(Options::analyzeNumStars());
     skyBgCB->setChecked(Options::analyzeSkyBg());
     snrCB->setChecked(Options::analyzeSNR());
+    latencyCB->setChecked(Options::analyzeGuideLatency());
+    latencyIOCB->setChecked(Options::analyzeGuideLatencyIO());
+    latencyCPUCB->setChecked(Options::analyzeGuideLatencyCPU());
+    latencyMountCB->setChecked(Options::analyzeGuideLatencyMount());
     temperatureCB->setChecked(Options::analyzeTemperature());
     focusPositionCB->setChecked(Options::focusPosition());
     targetDistanceCB->setChecked(Options::analyzeTargetDistance());
@@ -2659,6 +2732,25 @@ void Analyze::initStatsPlot()
     QCPAxis *snrAxis = newStatsYAxis(shortName, -100, 100);
     SNR_GRAPH = initGraphAndCB(statsPlot, snrAxis, QCPGraph::lsLine, Qt::yellow, "Guider SNR", shortName, snrCB,
                                Options::setAnalyzeSNR, snrOut);
+    shortName = "lat";
+    QCPAxis *latencyAxis = newStatsYAxis(shortName, 0, 2000);
+    GUIDE_LATENCY_GRAPH = initGraphAndCB(statsPlot, latencyAxis, QCPGraph::lsLine, Qt::cyan, "Guide Latency (ms)",
+                                         shortName, latencyCB, Options::setAnalyzeGuideLatency, latencyOut);
+    shortName = "io";
+    QCPAxis *latencyIOAxis = newStatsYAxis(shortName, 0, 2000);
+    GUIDE_LATENCY_IO_GRAPH = initGraphAndCB(statsPlot, latencyIOAxis, QCPGraph::lsLine, QColor(0, 160, 255),
+                                            "Guide Latency I/O (ms)", shortName, latencyIOCB,
+                                            Options::setAnalyzeGuideLatencyIO, latencyIOOut);
+    shortName = "cpu";
+    QCPAxis *latencyCPUAxis = newStatsYAxis(shortName, 0, 2000);
+    GUIDE_LATENCY_CPU_GRAPH = initGraphAndCB(statsPlot, latencyCPUAxis, QCPGraph::lsLine, QColor(0, 255, 160),
+                                             "Guide Latency CPU (ms)", shortName, latencyCPUCB,
+                                             Options::setAnalyzeGuideLatencyCPU, latencyCPUOut);
+    shortName = "mnt";
+    QCPAxis *latencyMountAxis = newStatsYAxis(shortName, 0, 2000);
+    GUIDE_LATENCY_MOUNT_GRAPH = initGraphAndCB(statsPlot, latencyMountAxis, QCPGraph::lsLine, QColor(160, 255, 255),
+                                               "Guide Latency Mount (ms)", shortName, latencyMountCB,
+                                               Options::setAnalyzeGuideLatencyMount, latencyMountOut);
     shortName = "RA";
     auto raColor = KStarsData::Instance()->colorScheme()->colorNamed("RAGuideError");
     RA_GRAPH = initGraphAndCB(statsPlot, statsPlot->yAxis, QCPGraph::lsLine, raColor, "Guider RA Drift", shortName, raCB,
@@ -2771,6 +2863,10 @@ void Analyze::reset()
     numStarsOut->setText("");
     skyBgOut->setText("");
     snrOut->setText("");
+    latencyOut->setText("");
+    latencyIOOut->setText("");
+    latencyCPUOut->setText("");
+    latencyMountOut->setText("");
     temperatureOut->setText("");
     focusPositionOut->setText("");
     targetDistanceOut->setText("");
@@ -3696,6 +3792,34 @@ void Analyze::processGuideStats(double time, double raError, double decError,
         replot();
 }
 
+void Analyze::guideLatency(double io, double cpu, double mount)
+{
+    saveMessage("GuideLatency", QString("%1,%2,%3")
+                .arg(QString::number(io, 'f', 1), QString::number(cpu, 'f', 1), QString::number(mount, 'f', 1)));
+
+    if (runtimeDisplay)
+        processGuideLatency(logTime(), io, cpu, mount);
+}
+
+void Analyze::processGuideLatency(double time, double io, double cpu, double mount, bool batchMode)
+{
+    // The total and each part are plotted, to tell I/O, CPU and mount limits apart.
+    // Parts that weren't measured leave a gap in their graph.
+    double total = 0;
+    for (const double part : {io, cpu, mount})
+    {
+        if (!qIsNaN(part))
+            total += part;
+    }
+    statsPlot->graph(GUIDE_LATENCY_GRAPH)->addData(time, total);
+    statsPlot->graph(GUIDE_LATENCY_IO_GRAPH)->addData(time, io);
+    statsPlot->graph(GUIDE_LATENCY_CPU_GRAPH)->addData(time, cpu);
+    statsPlot->graph(GUIDE_LATENCY_MOUNT_GRAPH)->addData(time, mount);
+    updateMaxX(time);
+    if (!batchMode)
+        replot();
+}
+
 void Analyze::resetGuideStats()
 {
     lastGuideStatsTime = -1;
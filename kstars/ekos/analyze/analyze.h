@@ -209,6 +209,7 @@ class Analyze : public QWidget, public Ui::Analyze
         void guideState(Ekos::GuideState status);
         void guideStats(double raError, double decError, int raPulse, int decPulse,
                         double snr, double skyBg, int numStars);
+        void guideLatency(double io, double cpu, double mount);
 
         // From Focus
         void autofocusStarting(double temperature, const QString &filter, const AutofocusReason reason, const QString &reasonInfo);
@@ -271,6 +272,7 @@ class Analyze : public QWidget, public Ui::Analyze
         void processGuideState(double time, const QString &state, bool batchMode = false);
         void processGuideStats(double time, double raError, double decError, int raPulse,
                                int decPulse, double snr, double skyBg, int numStars, bool batchMode = false);
+        void processGuideLatency(double time, double io, double cpu, double mount, bool batchMode = false);
         void processMountCoords(double time, double ra, double dec, double az, double alt,
                                 int pierSide, double ha, bool batchMode = false);
 
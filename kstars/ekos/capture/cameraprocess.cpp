@@ -331,6 +331,8 @@ void CameraProcess::stopCapturing(CaptureState targetState)
 {
     clearFlatCache();
 
+    m_WaitingForImageWrites = false;
+
     m_CaptureOperationsTimer.invalidate();
 
     state()->resetAlignmentRetries();
@@ -1039,20 +1041,15 @@ bool Ekos::CameraProcess::checkSavingReceivedImage(const QSharedPointer<FITSData
         {
             if (state()->generateFilename(extension, &filename) && activeCamera()->saveCurrentImage(filename))
             {
+                // The image is written in the background, but its destination is known already, so that
+                // the capture history and scripts refer to the right file
                 data->setFilename(filename);
-                KStars::Instance()->statusBar()->showMessage(i18n("file saved to %1", filename), 0);
                 return true;
             }
             else
             {
                 qCWarning(KSTARS_EKOS_CAPTURE) << "Saving current image failed!";
-                connect(KSMessageBox::Instance(), &KSMessageBox::accepted, this, [ = ]()
-                {
-                    KSMessageBox::Instance()->disconnect(this);
-                });
-                KSMessageBox::Instance()->error(i18n("Failed writing image to %1\nPlease check folder, filename & permissions.",
-                                                     filename),
-                                                i18n("Image Write Failed"), 30);
+                showImageWriteFailure(filename);
                 return false;
             }
         }
@@ -1287,6 +1284,55 @@ void CameraProcess::processNewRemoteFile(QString file)
     }
 }
 
+void CameraProcess::updateImageWriteQueue(int pending, double throughput)
+{
+    qCDebug(KSTARS_EKOS_CAPTURE) << "Image write queue:" << pending << "pending," <<
+                                 QString::number(throughput / 1e6, 'f', 1) << "MB/s";
+
+    // Warn once when the disk can't keep up and capture is about to wait for it
+    if (pending >= static_cast<int>(Options::imageWriteQueueDepth()) && !m_ImageWriteQueueFull)
+        emit newLog(i18n("Image write queue is full (%1 MB/s). Capture waits for the disk.",
+                         QString::number(throughput / 1e6, 'f', 1)));
+    m_ImageWriteQueueFull = pending >= static_cast<int>(Options::imageWriteQueueDepth());
+
+    // Resume the capture held back by a full queue
+    if (m_WaitingForImageWrites && activeCamera() && !activeCamera()->isImageWriteQueueFull())
+    {
+        m_WaitingForImageWrites = false;
+        captureImage();
+    }
+}
+
+void CameraProcess::processImageWritten(const QString &file)
+{
+    KStars::Instance()->statusBar()->showMessage(i18n("file saved to %1", file), 0);
+}
+
+void CameraProcess::processImageWriteFailure(const QString &file)
+{
+    qCWarning(KSTARS_EKOS_CAPTURE) << "Writing image" << file << "failed!";
+    showImageWriteFailure(file);
+
+    if (activeJob() != nullptr)
+    {
+        emit newLog(i18n("Failed to save image %1, aborting capture.", file));
+        emit stopCapture(CAPTURE_ABORTED);
+    }
+    else
+        emit newLog(i18n("Failed to save image %1", file));
+}
+
+void CameraProcess::showImageWriteFailure(const QString &filename)
+{
+    connect(KSMessageBox::Instance(), &KSMessageBox::accepted, this, [ = ]()
+    {
+        KSMessageBox::Instance()->disconnect(this);
+    });
+    KSMessageBox::Instance()->error(i18n("Failed writing image to %1\nPlease check folder, filename & permissions.",
+                                         filename),
+                                    i18n("Image Write Failed"), 30);
+}
+
 IPState CameraProcess::processPreCaptureCalibrationStage()
 {
     // in some rare cases it might happen that activeJob() has been cleared by a concurrent thread
@@ -1463,6 +1509,16 @@ void CameraProcess::captureImage()
 
     state()->getCaptureTimeout().stop();
     state()->getCaptureDelayTimer().stop();
+
+    // Wait for the disk instead of queuing more images than it can take, updateImageWriteQueue() resumes
+    if (activeCamera()->isImageWriteQueueFull())
+    {
+        if (!m_WaitingForImageWrites)
+            qCDebug(KSTARS_EKOS_CAPTURE) << "Image write queue is full, holding back the next capture.";
+        m_WaitingForImageWrites = true;
+        return;
+    }
+
     if (activeCamera()->isFastExposureEnabled())
     {
         int remaining = state()->isLooping() ? 100000 : (activeJob()->getCoreProperty(
@@ -1866,6 +1922,10 @@ IPState CameraProcess::runCaptureScript(ScriptTypes scriptType, bool precond)
         const QString captureScript = activeJob()->getScript(scriptType);
         if (captureScript.isEmpty() == false && precond)
         {
+            // Post capture and post job scripts may read the images, so they have to be on disk
+            if ((scriptType == SCRIPT_POST_CAPTURE || scriptType == SCRIPT_POST_JOB) && activeCamera())
+                activeCamera()->waitForImageWrites();
+
             state()->setCaptureScriptType(scriptType);
             m_CaptureScript.start(captureScript);
             m_CaptureScript.write(generateScriptInput());
@@ -2630,6 +2690,12 @@ void CameraProcess::setCamera(bool connection)
         connect(activeCamera(), &ISD::Camera::newExposureValue, this, &CameraProcess::setExposureProgress, Qt::UniqueConnection);
         connect(activeCamera(), &ISD::Camera::newImage, this, &CameraProcess::processFITSData, Qt::UniqueConnection);
         connect(activeCamera(), &ISD::Camera::newRemoteFile, this, &CameraProcess::processNewRemoteFile, Qt::UniqueConnection);
+        connect(activeCamera(), &ISD::Camera::imageWriteQueueUpdated, this, &CameraProcess::updateImageWriteQueue,
+                Qt::UniqueConnection);
+        connect(activeCamera(), &ISD::Camera::imageWritten, this, &CameraProcess::processImageWritten,
+                Qt::UniqueConnection);
+        connect(activeCamera(), &ISD::Camera::imageWriteFailed, this, &CameraProcess::processImageWriteFailure,
+                Qt::UniqueConnection);
         connect(activeCamera(), &ISD::Camera::ready, this, &CameraProcess::cameraReady, Qt::UniqueConnection);
         connect(activeCamera(), &ISD::Camera::videoRecordToggled, this, &CameraProcess::updateVideoRecordStatus,
                 Qt::UniqueConnection);
@@ -2644,6 +2710,9 @@ void CameraProcess::setCamera(bool connection)
         disconnect(activeCamera(), &ISD::Camera::newExposureValue, this, &CameraProcess::setExposureProgress);
         disconnect(activeCamera(), &ISD::Camera::newImage, this, &CameraProcess::processFITSData);
         disconnect(activeCamera(), &ISD::Camera::newRemoteFile, this, &CameraProcess::processNewRemoteFile);
+        disconnect(activeCamera(), &ISD::Camera::imageWriteQueueUpdated, this, &CameraProcess::updateImageWriteQueue);
+        disconnect(activeCamera(), &ISD::Camera::imageWritten, this, &CameraProcess::processImageWritten);
+        disconnect(activeCamera(), &ISD::Camera::imageWriteFailed, this, &CameraProcess::processImageWriteFailure);
         //    disconnect(m_Camera, &ISD::Camera::previewFITSGenerated, this, &Capture::setGeneratedPreviewFITS);
         disconnect(activeCamera(), &ISD::Camera::ready, this, &CameraProcess::cameraReady);
     }
@@ -429,6 +429,25 @@ class CameraProcess : public QObject
          */
         void processNewRemoteFile(QString file);
 
+        /**
+         * @brief updateImageWriteQueue Track the camera's queue of images waiting to be written to disk
+         * @param pending number of images queued or being written
+         * @param throughput recent write throughput in bytes per second
+         */
+        void updateImageWriteQueue(int pending, double throughput);
+
+        /**
+         * @brief processImageWritten A queued image has been written to disk
+         * @param file path of the image
+         */
+        void processImageWritten(const QString &file);
+
+        /**
+         * @brief processImageWriteFailure A queued image could not be written to disk, capture is aborted
+         * @param file path of the image
+         */
+        void processImageWriteFailure(const QString &file);
+
         /**
          * @brief processJobCompletionStage1 Process job completion. In stage 1 when simply check if the is a post-job script to be running
          * if yes, we run it and wait until it is done before we move to stage2
@@ -745,6 +764,10 @@ class CameraProcess : public QObject
         QSharedPointer<StreamWG> m_VideoWindow;
         FitsvViewerTabIDs m_fitsvViewerTabIDs = {-1, -1, -1, -1, -1};
         QElapsedTimer m_CaptureOperationsTimer;
+        // Has the camera's image write queue filled up?
+        bool m_ImageWriteQueueFull { false };
+        // Is the next capture held back until the image write queue has room?
+        bool m_WaitingForImageWrites { false };
 
         // Pre-/post capture script process
         QProcess m_CaptureScript;
@@ -819,6 +842,11 @@ class CameraProcess : public QObject
          */
         bool checkSavingReceivedImage(const QSharedPointer<FITSData> &data, const QString &extension, QString &filename);
 
+        /**
+         * @brief showImageWriteFailure Alert the user that an image could not be written to filename
+         */
+        void showImageWriteFailure(const QString &filename);
+
         /**
          * @brief createTabText Create the tab to be displayed in the FITSViewer tab
          */
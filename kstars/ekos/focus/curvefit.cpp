@@ -643,7 +643,9 @@ int gau2DFxx(const gsl_vector* X, const gsl_vector* v, void* inParams, gsl_vecto
 // Function to calculate f(x,y) for a 2-D gaussian.
 double gaufxy(double x, double y, double a, double x0, double y0, double A, double B, double C, double b)
 {
-    return b + a * exp(-(A * (pow(x - x0, 2.0)) + 2.0 * B * (x - x0) * (y - y0) + C * (pow(y - y0, 2.0))));
+    const double xmx0 = x - x0;
+    const double ymy0 = y - y0;
+    return b + a * exp(-(A * xmx0 * xmx0 + 2.0 * B * xmx0 * ymy0 + C * ymy0 * ymy0));
 }
 
 // Calculates f(x,y) for each data point in the gaussian.
@@ -659,11 +661,15 @@ int gauFxy(const gsl_vector * X, void * inParams, gsl_vector * outResultVec)
     double C  = gsl_vector_get (X, F_IDX);
     double b  = gsl_vector_get (X, G_IDX);
 
+    // This runs for every pixel of the star box on each solver iteration, so avoid the bounds checked accessors
+    const CurveFitting::DataPT3D * dps = DataPoint->dps.constData();
+    double * result = gsl_vector_ptr(outResultVec, 0);
+    const size_t stride = outResultVec->stride;
     for(int i = 0; i < DataPoint->dps.size(); ++i)
     {
         // Gaussian equation
-        double zij = gaufxy(DataPoint->dps[i].x, DataPoint->dps[i].y, a, x0, y0, A, B, C, b);
-        gsl_vector_set(outResultVec, i, (zij - DataPoint->dps[i].z));
+        double zij = gaufxy(dps[i].x, dps[i].y, a, x0, y0, A, B, C, b);
+        result[i * stride] = zij - dps[i].z;
     }
 
     return GSL_SUCCESS;
@@ -692,25 +698,28 @@ int gauJxy(const gsl_vector * X, void * inParams, gsl_matrix * J)
     const double C  = gsl_vector_get (X, F_IDX);
     // b is not used ... const double b  = gsl_vector_get (X, G_IDX);
 
+    const CurveFitting::DataPT3D * dps = DataPoint->dps.constData();
     for(int i = 0; i < DataPoint->dps.size(); ++i)
     {
         // Calculate the Jacobian Matrix
-        const double x = DataPoint->dps[i].x;
+        const double x = dps[i].x;
         const double xmx0 = x - x0;
         const double xmx02 = xmx0 * xmx0;
-        const double y = DataPoint->dps[i].y;
+        const double y = dps[i].y;
         const double ymy0 = y - y0;
         const double ymy02 = ymy0 * ymy0;
         const double phi = exp(-((A * xmx02) + (2.0 * B * xmx0 * ymy0) + (C * ymy02)));
         const double aphi = a * phi;
 
-        gsl_matrix_set(J, i, A_IDX, phi);
-        gsl_matrix_set(J, i, B_IDX, 2.0 * aphi * ((A * xmx0) + (B * ymy0)));
-        gsl_matrix_set(J, i, C_IDX, 2.0 * aphi * ((B * xmx0) + (C * ymy0)));
-        gsl_matrix_set(J, i, D_IDX, -1.0 * aphi * xmx02);
-        gsl_matrix_set(J, i, E_IDX, -2.0 * aphi * xmx0 * ymy0);
-        gsl_matrix_set(J, i, F_IDX, -1.0 * aphi * ymy02);
-        gsl_matrix_set(J, i, G_IDX, 1.0);
+        // Fill the row directly rather than through the bounds checked gsl_matrix_set
+        double * row = gsl_matrix_ptr(J, i, 0);
+        row[A_IDX] = phi;
+        row[B_IDX] = 2.0 * aphi * ((A * xmx0) + (B * ymy0));
+        row[C_IDX] = 2.0 * aphi * ((B * xmx0) + (C * ymy0));
+        row[D_IDX] = -1.0 * aphi * xmx02;
+        row[E_IDX] = -2.0 * aphi * xmx0 * ymy0;
+        row[F_IDX] = -1.0 * aphi * ymy02;
+        row[G_IDX] = 1.0;
     }
 
     return GSL_SUCCESS;
@@ -1960,12 +1969,15 @@ void CurveFitting::gau2DMakeGuess(const int attempt, const DataPointT &dataPoint
     }
 }
 
-QVector<double> CurveFitting::gaussian3D_fit(DataPoint3DT data, const StarParams &starParams)
+QVector<double> CurveFitting::gaussian3D_fit(DataPoint3DT data, const StarParams &starParams, const bool gslErrorHandlerOff)
 {
     QVector<double> vc;
 
-    // Set the gsl error handler off as it aborts the program on error.
-    auto const oldErrorHandler = gsl_set_error_handler_off();
+    // Set the gsl error handler off as it aborts the program on error. The handler is global, so leave it to the
+    // caller if they have switched it off already, for fits on several threads at once.
+    gsl_error_handler_t *oldErrorHandler = nullptr;
+    if (!gslErrorHandlerOff)
+        oldErrorHandler = gsl_set_error_handler_off();
 
     // Setup variables to be used by the solver
     gsl_multifit_nlinear_parameters params = gsl_multifit_nlinear_default_parameters();
@@ -2085,7 +2097,8 @@ QVector<double> CurveFitting::gaussian3D_fit(DataPoint3DT data, const StarParams
     gsl_vector_free(weights);
 
     // Restore old GSL error handler
-    gsl_set_error_handler(oldErrorHandler);
+    if (!gslErrorHandlerOff)
+        gsl_set_error_handler(oldErrorHandler);
 
     return vc;
 }
@@ -115,9 +115,12 @@ class CurveFitting
         // Data is passed in in imageBuffer - a 2D array of width x height
         // Approx star information is passed in to seed the LM solver initial parameters.
         // Start and end define the x,y coordinates of a box around the star, start is top left corner, end is bottom right
+        // Set gslErrorHandlerOff if the caller has already switched the global GSL error handler off, e.g. around
+        // fits running on several threads, so the solver leaves it alone.
         template <typename T>
         void fitCurve3D(const T *imageBuffer, const int imageWidth, const QPair<int, int> start, const QPair<int, int> end,
-                        const StarParams &starParams, const CurveFit curveFit, const bool useWeights)
+                        const StarParams &starParams, const CurveFit curveFit, const bool useWeights,
+                        const bool gslErrorHandlerOff = false)
         {
             if (imageBuffer == nullptr)
             {
@@ -157,7 +160,7 @@ class CurveFitting
             switch (m_CurveType)
             {
                 case FOCUS_3DGAUSSIAN :
-                    m_coefficients = gaussian3D_fit(m_dataPoints, starParams);
+                    m_coefficients = gaussian3D_fit(m_dataPoints, starParams, gslErrorHandlerOff);
                     break;
                 default :
                     // Something went wrong, log an error and reset state so solver starts from scratch if called again
@@ -230,7 +233,7 @@ class CurveFitting
         QVector<double> gaussian2D_fit(FittingGoal goal, const QVector<double> data_x, const QVector<double> data_y,
                                        const QVector<double> data_weights,
                                        const QVector<bool> outliers, bool useWeights, const OptimisationDirection optDir);
-        QVector<double> gaussian3D_fit(DataPoint3DT data, const StarParams &starParams);
+        QVector<double> gaussian3D_fit(DataPoint3DT data, const StarParams &starParams, const bool gslErrorHandlerOff = false);
         QVector<double> plane_fit(const DataPoint3DT data);
 
         bool minimumQuadratic(double expected, double minPosition, double maxPosition, double *position, double *value);
@@ -1,6 +1,12 @@
 #include "focusfwhm.h"
 #include <ekos_focus_debug.h>
 
+#include <QHash>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+
 namespace Ekos
 {
 
@@ -13,6 +19,96 @@ FocusFWHM::~FocusFWHM()
 {
 }
 
+void FocusFWHM::fitStars(const int numFits, std::unique_ptr<CurveFitting> &starFitting, const int maxThreads,
+                         const std::function<void(CurveFitting *, int)> &fitStar)
+{
+    // Several chunks per thread, to even out stars that take longer to solve
+    const int threads = (maxThreads > 0) ? maxThreads : QThread::idealThreadCount();
+    const int numChunks = std::max(1, std::min(numFits, (threads > 1) ? threads * 4 : 1));
+    QVector<QPair<int, int>> chunks;
+    for (int c = 0; c < numChunks; c++)
+        chunks.push_back(qMakePair(c * numFits / numChunks, (c + 1) * numFits / numChunks));
+
+    auto fitChunk = [&](const QPair<int, int> &chunk)
+    {
+        std::unique_ptr<CurveFitting> ownFitting;
+        CurveFitting *fitting = starFitting.get();
+        if (chunk.first != 0 || fitting == nullptr)
+        {
+            ownFitting.reset(new CurveFitting());
+            fitting = ownFitting.get();
+        }
+
+        for (int f = chunk.first; f < chunk.second; f++)
+            fitStar(fitting, f);
+    };
+
+    // The GSL error handler is global, so switch it off once around all the threads rather than
+    // letting each solve switch it off and back on while the others run
+    auto const oldErrorHandler = gsl_set_error_handler_off();
+    if (chunks.size() == 1)
+        fitChunk(chunks[0]);
+    else
+        QtConcurrent::blockingMap(chunks, fitChunk);
+    gsl_set_error_handler(oldErrorHandler);
+}
+
+// Marks both stars of every overlapping pair as invalid, in the same order as comparing every pair would.
+// Each box is placed in the grid cells it covers. Cells are as large as the largest box, so a box covers at most 2x2
+// cells and only stars sharing a cell need to be compared, rather than all n² pairs.
+void FocusFWHM::rejectOverlappingStars(QVector<StarBox> &stars)
+{
+    if (stars.size() < 2)
+        return;
+
+    int cellSize = 1;
+    for (const auto &star : stars)
+        cellSize = std::max({cellSize, star.end.first - star.start.first + 1, star.end.second - star.start.second + 1});
+
+    QHash<QPair<int, int>, QVector<int>> grid;
+    for (int s = 0; s < stars.size(); s++)
+    {
+        for (int cellX = stars[s].start.first / cellSize; cellX <= stars[s].end.first / cellSize; cellX++)
+            for (int cellY = stars[s].start.second / cellSize; cellY <= stars[s].end.second / cellSize; cellY++)
+                grid[qMakePair(cellX, cellY)].push_back(s);
+    }
+
+    QVector<int> neighbours;
+    for (int s1 = 0; s1 < stars.size(); s1++)
+    {
+        if (!stars[s1].isValid)
+            continue;
+
+        // Later stars sharing a cell with this one, each once and in order
+        neighbours.clear();
+        for (int cellX = stars[s1].start.first / cellSize; cellX <= stars[s1].end.first / cellSize; cellX++)
+        {
+            for (int cellY = stars[s1].start.second / cellSize; cellY <= stars[s1].end.second / cellSize; cellY++)
+            {
+                for (const int s2 : grid.value(qMakePair(cellX, cellY)))
+                {
+                    if (s2 > s1)
+                        neighbours.push_back(s2);
+                }
+            }
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+        for (const int s2 : neighbours)
+        {
+            if (!stars[s2].isValid)
+                continue;
+
+            if (boxOverlap(stars[s1].start, stars[s1].end, stars[s2].start, stars[s2].end))
+            {
+                stars[s1].isValid = false;
+                stars[s2].isValid = false;
+            }
+        }
+    }
+}
+
 // Returns true if two rectangular boxes (b1, b2) overlap.
 bool FocusFWHM::boxOverlap(const QPair<int, int> b1Start, const QPair<int, int> b1End, const QPair<int, int> b2Start,
                            const QPair<int, int> b2End)
@@ -14,6 +14,7 @@
 #include "../ekos.h"
 #include <ekos_focus_debug.h>
 
+#include <functional>
 
 namespace Ekos
 {
@@ -32,11 +33,19 @@ class FocusFWHM
                          std::unique_ptr<CurveFitting> &starFitting,
                          double *FWHM, double *weight)
         {
-            CurveFitting::StarParams starParams, starParams2;
-            std::vector<double> FWHMs, R2s;
-
-            auto skyBackground = imageData->getSkyBackground();
             auto stats = imageData->getStatistics();
+            processFWHM(imageBuffer, stats.width, stats.height, imageData->getSkyBackground().mean, focusStars, starFitting,
+                        FWHM, weight);
+        }
+
+        // Fits a 3D Gaussian to each star in imageBuffer, which is imageWidth x imageHeight pixels, in parallel on up to
+        // maxThreads threads (by default one per core). Each thread uses its own CurveFitting; starFitting is used by one of them.
+        template <typename T>
+        void processFWHM(const T &imageBuffer, const int imageWidth, const int imageHeight, const double skyBackground,
+                         const QList<Edge *> &focusStars, std::unique_ptr<CurveFitting> &starFitting,
+                         double *FWHM, double *weight, const int maxThreads = 0)
+        {
+            std::vector<double> FWHMs, R2s;
 
             // Setup a vector for each of the stars to be processed
             QVector<StarBox> stars;
@@ -66,7 +75,7 @@ class FocusFWHM
                 star.end.second = focusStars[s]->y + height / 2.0;
 
                 // Check star box does not go over image edge, drop star if so
-                if (star.start.first < 0 || star.end.first > stats.width || star.start.second < 0 || star.end.second > stats.height)
+                if (star.start.first < 0 || star.end.first > imageWidth || star.start.second < 0 || star.end.second > imageHeight)
                     continue;
 
                 stars.push_back(star);
@@ -74,60 +83,68 @@ class FocusFWHM
 
             // Ideally we would deblend where another star encroaches into this star's box
             // For now we'll just exclude stars in this situation by marking isValid as false
-            for (int s1 = 0; s1 < stars.size(); s1++)
-            {
-                if (!stars[s1].isValid)
-                    continue;
-
-                for (int s2 = s1 + 1; s2 < stars.size(); s2++)
-                {
-                    if (!stars[s2].isValid)
-                        continue;
-
-                    if (boxOverlap(stars[s1].start, stars[s1].end, stars[s2].start, stars[s2].end))
-                    {
-                        stars[s1].isValid = false;
-                        stars[s2].isValid = false;
-                    }
-                }
-            }
+            rejectOverlappingStars(stars);
 
-            // We have the list of stars to process now so iterate through the list fitting a curve, etc
+            // We have the list of stars to process now so fit a curve to each. The fits are independent, so split
+            // them between threads, each with its own solver, and keep the results in star order.
+            struct StarFit
+            {
+                int box;
+                bool solved;
+                double FWHM;
+                double R2;
+            };
+            QVector<StarFit> fits;
             for (int s = 0; s < stars.size(); s++)
             {
-                if (!stars[s].isValid)
-                    continue;
+                if (stars[s].isValid)
+                    fits.push_back({s, false, 0.0, 0.0});
+            }
 
-                starParams.background = skyBackground.mean;
-                starParams.peak = focusStars[stars[s].star]->val;
-                starParams.centroid_x = focusStars[stars[s].star]->x - stars[s].start.first;
-                starParams.centroid_y = focusStars[stars[s].star]->y - stars[s].start.second;
-                starParams.HFR = focusStars[stars[s].star]->HFR;
+            auto fitStar = [&](CurveFitting *fitting, const int f)
+            {
+                CurveFitting::StarParams starParams, starParams2;
+                const StarBox &box = stars[fits[f].box];
+                const Edge *focusStar = focusStars[box.star];
+
+                starParams.background = skyBackground;
+                starParams.peak = focusStar->val;
+                starParams.centroid_x = focusStar->x - box.start.first;
+                starParams.centroid_y = focusStar->y - box.start.second;
+                starParams.HFR = focusStar->HFR;
                 starParams.theta = 0.0;
                 starParams.FWHMx = -1;
                 starParams.FWHMy = -1;
                 starParams.FWHM = -1;
 
-                starFitting->fitCurve3D(imageBuffer, stats.width, stars[s].start, stars[s].end, starParams, CurveFitting::FOCUS_3DGAUSSIAN,
-                                        false);
-                if (starFitting->getStarParams(CurveFitting::FOCUS_3DGAUSSIAN, &starParams2))
+                fitting->fitCurve3D(imageBuffer, imageWidth, box.start, box.end, starParams, CurveFitting::FOCUS_3DGAUSSIAN, false,
+                                    true);
+                if (fitting->getStarParams(CurveFitting::FOCUS_3DGAUSSIAN, &starParams2))
+                {
+                    starParams2.centroid_x += box.start.first;
+                    starParams2.centroid_y += box.start.second;
+                    fits[f].solved = true;
+                    fits[f].FWHM = starParams2.FWHM;
+                    fits[f].R2 = fitting->calculateR2(CurveFitting::FOCUS_3DGAUSSIAN);
+
+                    qCDebug(KSTARS_EKOS_FOCUS) << "Star" << box.star << " R2=" << fits[f].R2
+                                               << " x=" << focusStar->x << " vs " << starParams2.centroid_x
+                                               << " y=" << focusStar->y << " vs " << starParams2.centroid_y
+                                               << " HFR=" << focusStar->HFR << " FWHM=" << starParams2.FWHM
+                                               << " Background=" << skyBackground << " vs " << starParams2.background
+                                               << " Peak=" << focusStar->val << "vs" << starParams2.peak;
+                }
+            };
+
+            fitStars(static_cast<int>(fits.size()), starFitting, maxThreads, fitStar);
+
+            for (const auto &fit : fits)
+            {
+                // Filter stars - 0.25 works OK on Sim
+                if (fit.solved && fit.R2 >= 0.25)
                 {
-                    starParams2.centroid_x += stars[s].start.first;
-                    starParams2.centroid_y += stars[s].start.second;
-                    double R2 = starFitting->calculateR2(CurveFitting::FOCUS_3DGAUSSIAN);
-                    if (R2 >= 0.25)
-                    {
-                        // Filter stars - 0.25 works OK on Sim
-                        FWHMs.push_back(starParams2.FWHM);
-                        R2s.push_back(R2);
-
-                        qCDebug(KSTARS_EKOS_FOCUS) << "Star" << s << " R2=" << R2
-                                                   << " x=" << focusStars[s]->x << " vs " << starParams2.centroid_x
-                                                   << " y=" << focusStars[s]->y << " vs " << starParams2.centroid_y
-                                                   << " HFR=" << focusStars[s]->HFR << " FWHM=" << starParams2.FWHM
-                                                   << " Background=" << skyBackground.mean << " vs " << starParams2.background
-                                                   << " Peak=" << focusStars[s]->val << "vs" << starParams2.peak;
-                    }
+                    FWHMs.push_back(fit.FWHM);
+                    R2s.push_back(fit.R2);
                 }
             }
 
@@ -163,10 +180,6 @@ class FocusFWHM
         static double constexpr INVALID_STAR_MEASURE = -1.0;
 
     private:
-
-        bool boxOverlap(const QPair<int, int> b1Start, const QPair<int, int> b1End, const QPair<int, int> b2Start,
-                        const QPair<int, int> b2End);
-
         // Structure to hold parameters for box around a star for FWHM calcs
         struct StarBox
         {
@@ -176,6 +189,18 @@ class FocusFWHM
             QPair<int, int> end; // bottom right of box. x = first element, y = second element
         };
 
+        // Calls fitStar for each of numFits stars, split into chunks on up to maxThreads threads. Each chunk has its own
+        // CurveFitting, except the first which uses starFitting if there is one. The GSL error handler is switched off
+        // around all of them, so fitStar must ask the solver to leave it alone.
+        void fitStars(const int numFits, std::unique_ptr<CurveFitting> &starFitting, const int maxThreads,
+                      const std::function<void(CurveFitting *, int)> &fitStar);
+
+        // Marks stars whose boxes overlap as invalid, looking for overlaps among neighbours in a grid
+        void rejectOverlappingStars(QVector<StarBox> &stars);
+
+        bool boxOverlap(const QPair<int, int> b1Start, const QPair<int, int> b1End, const QPair<int, int> b2Start,
+                        const QPair<int, int> b2End);
+
         Mathematics::RobustStatistics::ScaleCalculation m_ScaleCalc;
 };
 }
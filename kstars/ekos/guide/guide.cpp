@@ -42,6 +42,9 @@
 
 #include "ui_manualdither.h"
 
+#include <cmath>
+#include <initializer_list>
+#include <limits>
 #include <random>
 
 #define CAPTURE_TIMEOUT_THRESHOLD 30000
@@ -745,6 +748,7 @@ bool Guide::setGuider(ISD::Guider * device)
         {
             guideB->setEnabled(false);
         });
+        connect(m_Guider, &ISD::ConcreteDevice::propertyUpdated, this, &Guide::processGuiderProperty);
     }
 
     guideB->setEnabled(m_Guider && m_Guider->isConnected());
@@ -857,6 +861,9 @@ bool Guide::captureOneFrame()
     // Timeout is exposure duration + timeout threshold in seconds
     captureTimeout.start(finalExposure * 1000 + CAPTURE_TIMEOUT_THRESHOLD);
 
+    if (m_Latency.startFrame(finalExposure))
+        reportLatency();
+
     targetChip->capture(finalExposure);
 
     return true;
@@ -907,6 +914,11 @@ bool Guide::abort()
 
     setBusy(false);
 
+    if (m_Latency.finishFrame())
+        reportLatency();
+    if (m_Latency.size() > 0)
+        qCInfo(KSTARS_EKOS_GUIDE).noquote() << m_Latency.summary();
+
     switch (m_State)
     {
         case GUIDE_IDLE:
@@ -1111,6 +1123,13 @@ void Guide::processData(const QSharedPointer<FITSData> &data)
     captureTimeout.stop();
     m_CaptureTimeoutCounter = 0;
 
+    if (data)
+    {
+        m_Latency.mark(GuideLatency::BLOB_RECEIVED, data->property("blobReceived").toLongLong());
+        m_Latency.mark(GuideLatency::IMAGE_LOADED, data->property("blobLoaded").toLongLong());
+    }
+    m_Latency.mark(GuideLatency::IMAGE_RECEIVED);
+
     if (data && (!guideShowFrame->isEnabled() || guideShowFrame->isChecked()))
     {
         m_GuideView->loadData(data);
@@ -1280,6 +1299,10 @@ bool Guide::sendMultiPulse(GuideDirection ra_dir, int ra_msecs, GuideDirection d
 
         m_PulseTimer.start(delay);
     }
+
+    m_Latency.mark(GuideLatency::PULSE_SENT);
+    m_Latency.setPulse(std::max(ra_dir == NO_DIR ? 0 : ra_msecs, dec_dir == NO_DIR ? 0 : dec_msecs),
+                       (ra_dir != NO_DIR) + (dec_dir != NO_DIR));
     return m_Guider->doPulse(ra_dir, ra_msecs, dec_dir, dec_msecs);
 }
 
@@ -1298,6 +1321,8 @@ bool Guide::sendSinglePulse(GuideDirection dir, int msecs, CaptureAfterPulses fo
         m_PulseTimer.start(delay);
     }
 
+    m_Latency.mark(GuideLatency::PULSE_SENT);
+    m_Latency.setPulse(msecs, 1);
     return m_Guider->doPulse(dir, msecs);
 }
 
@@ -1860,6 +1885,8 @@ void Guide::saveDefaultGuideExposure()
 
 void Guide::setStarPosition(const QVector3D &newCenter, bool updateNow)
 {
+    m_Latency.mark(GuideLatency::STAR_FOUND);
+
     starCenter.setX(newCenter.x());
     starCenter.setY(newCenter.y());
     if (newCenter.z() > 0)
@@ -2307,6 +2334,54 @@ QList<double> Guide::axisDelta()
     return delta;
 }
 
+bool Guide::exportLatencyTrace(const QString &filename)
+{
+    if (!m_Latency.exportChromeTrace(filename))
+    {
+        qCWarning(KSTARS_EKOS_GUIDE) << "Failed to write guide latency trace to" << filename;
+        return false;
+    }
+    return true;
+}
+
+void Guide::processGuiderProperty(INDI::Property prop)
+{
+    // The timed guide properties go back to OK once the mount has finished the pulse
+    if ((prop.isNameMatch("TELESCOPE_TIMED_GUIDE_WE") || prop.isNameMatch("TELESCOPE_TIMED_GUIDE_NS"))
+            && prop.getState() == IPS_OK)
+        m_Latency.pulseCompleted();
+}
+
+void Guide::reportLatency()
+{
+    const GuideLatency::Frame &frame = m_Latency.lastFrame();
+    auto sum = [&frame](std::initializer_list<GuideLatency::Stage> stages)
+    {
+        double total = 0;
+        bool any = false;
+        for (const auto stage : stages)
+        {
+            const double ms = GuideLatency::stageMs(frame, stage);
+            if (std::isfinite(ms))
+            {
+                total += ms;
+                any = true;
+            }
+        }
+        return any ? total : std::numeric_limits<double>::quiet_NaN();
+    };
+
+    const double io = sum({GuideLatency::DOWNLOAD, GuideLatency::LOAD});
+    const double cpu = sum({GuideLatency::DISPATCH, GuideLatency::DETECTION, GuideLatency::CALCULATION});
+    double mount = GuideLatency::stageMs(frame, GuideLatency::PULSE);
+    if (std::isfinite(mount))
+        mount = std::max(0.0, mount - frame.pulseMs);
+
+    // Frames that never got to the guide calculation, e.g. aborted ones, aren't worth reporting
+    if (std::isfinite(io) || std::isfinite(cpu))
+        emit guideLatency(io, cpu, mount);
+}
+
 QList<double> Guide::axisSigma()
 {
     QList<double> sigma;
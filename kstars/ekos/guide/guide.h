@@ -8,6 +8,7 @@
 
 #include "ui_guide.h"
 #include "guideinterface.h"
+#include "guidelatency.h"
 #include "ekos/ekos.h"
 #include "indi/indicamera.h"
 #include "indi/indimount.h"
@@ -304,6 +305,13 @@ class Guide : public QWidget, public Ui::Guide
          */
         Q_SCRIPTABLE QList<double> axisSigma();
 
+        /** DBUS interface function.
+         * @brief exportLatencyTrace writes the timing of the recent guide cycles as a Chrome trace, which can be opened in chrome://tracing or Perfetto.
+         * @param filename Path of the JSON file to write.
+         * @return True if the file was written.
+         */
+        Q_SCRIPTABLE bool exportLatencyTrace(const QString &filename);
+
         /**
               * @brief checkCamera Check all CCD parameters and ensure all variables are updated to reflect the selected CCD
               * @param ccdNum CCD index number in the CCD selection combo box
@@ -460,6 +468,10 @@ class Guide : public QWidget, public Ui::Guide
         void guideStats(double raError, double decError, int raPulse, int decPulse,
                         double snr, double skyBg, int numStars);
 
+        // Latency of a guide cycle in milliseconds: image download and load, image processing and guide
+        // calculation, and the time the mount took beyond the length of the guide pulse.
+        void guideLatency(double io, double cpu, double mount);
+
         void guideChipUpdated(ISD::CameraChip *);
         void settingsUpdated(const QVariantMap &settings);
         void driverTimedout(const QString &deviceName);
@@ -478,6 +490,16 @@ class Guide : public QWidget, public Ui::Guide
          */
         void checkUseGuideHead();
 
+        /**
+         * @brief processGuiderProperty marks the guide pulse as done when the mount reports it.
+         */
+        void processGuiderProperty(INDI::Property prop);
+
+        /**
+         * @brief reportLatency sends the stages of the last finished guide cycle to Analyze.
+         */
+        void reportLatency();
+
         /**
              * @brief syncTrackingBoxPosition Sync the tracking box to the current selected star center
              */
@@ -639,6 +661,9 @@ class Guide : public QWidget, public Ui::Guide
         // Pulse Timer
         QTimer m_PulseTimer;
 
+        // Timing of the guide cycles
+        GuideLatency m_Latency;
+
         // Log
         QStringList m_LogText;
 
@@ -0,0 +1,266 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "guidelatency.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+// Marks starting and ending a stage, in nanoseconds
+bool stageBounds(const Ekos::GuideLatency::Frame &frame, Ekos::GuideLatency::Stage stage, qint64 *start, qint64 *end)
+{
+    typedef Ekos::GuideLatency L;
+    const auto &marks = frame.marks;
+    switch (stage)
+    {
+        case L::EXPOSURE:
+            *start = marks[L::CAPTURE_STARTED];
+            *end = *start + static_cast<qint64>(frame.exposure * 1e9);
+            return *start != 0;
+        case L::DOWNLOAD:
+            *start = marks[L::CAPTURE_STARTED] + static_cast<qint64>(frame.exposure * 1e9);
+            *end = marks[L::BLOB_RECEIVED];
+            return marks[L::CAPTURE_STARTED] != 0 && *end != 0;
+        case L::LOAD:
+            *start = marks[L::BLOB_RECEIVED];
+            *end = marks[L::IMAGE_LOADED];
+            break;
+        case L::DISPATCH:
+            *start = marks[L::IMAGE_LOADED];
+            *end = marks[L::IMAGE_RECEIVED];
+            break;
+        case L::DETECTION:
+            *start = marks[L::IMAGE_RECEIVED];
+            *end = marks[L::STAR_FOUND];
+            break;
+        case L::CALCULATION:
+            *start = marks[L::STAR_FOUND];
+            *end = marks[L::PULSE_SENT];
+            break;
+        case L::PULSE:
+            *start = marks[L::PULSE_SENT];
+            *end = marks[L::PULSE_DONE];
+            break;
+        default:
+            return false;
+    }
+    return *start != 0 && *end != 0;
+}
+}
+
+namespace Ekos
+{
+GuideLatency::GuideLatency(int capacity) : m_Capacity(std::max(1, capacity))
+{
+    m_Frames.reserve(m_Capacity);
+}
+
+qint64 GuideLatency::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+QString GuideLatency::stageName(Stage stage)
+{
+    switch (stage)
+    {
+        case EXPOSURE:
+            return "Exposure";
+        case DOWNLOAD:
+            return "Download";
+        case LOAD:
+            return "Load";
+        case DISPATCH:
+            return "Dispatch";
+        case DETECTION:
+            return "Detection";
+        case CALCULATION:
+            return "Calculation";
+        case PULSE:
+            return "Pulse";
+        default:
+            return QString();
+    }
+}
+
+bool GuideLatency::startFrame(double exposure, qint64 time)
+{
+    const bool finished = finishFrame();
+    m_Current = Frame();
+    m_Current.number = ++m_FrameCount;
+    m_Current.exposure = exposure;
+    m_Current.marks[CAPTURE_STARTED] = time;
+    m_PendingAxes = 0;
+    m_Timing = true;
+    return finished;
+}
+
+void GuideLatency::mark(Mark point, qint64 time)
+{
+    if (!m_Timing || point < 0 || point >= MARK_COUNT || m_Current.marks[point] != 0)
+        return;
+    m_Current.marks[point] = time;
+}
+
+void GuideLatency::setPulse(int ms, int axes)
+{
+    if (!m_Timing)
+        return;
+    m_Current.pulseMs = std::max(m_Current.pulseMs, ms);
+    m_PendingAxes = axes;
+}
+
+void GuideLatency::pulseCompleted(qint64 time)
+{
+    if (!m_Timing || m_PendingAxes <= 0)
+        return;
+    if (--m_PendingAxes == 0)
+        mark(PULSE_DONE, time);
+}
+
+bool GuideLatency::finishFrame()
+{
+    if (!m_Timing)
+        return false;
+    m_Timing = false;
+
+    if (m_Frames.size() < m_Capacity)
+    {
+        m_Frames.append(m_Current);
+        m_Last = m_Frames.size() - 1;
+    }
+    else
+    {
+        m_Frames[m_Oldest] = m_Current;
+        m_Last = m_Oldest;
+        m_Oldest = (m_Oldest + 1) % m_Capacity;
+    }
+    return true;
+}
+
+const GuideLatency::Frame &GuideLatency::lastFrame() const
+{
+    static const Frame none;
+    return (m_Last < 0) ? none : m_Frames[m_Last];
+}
+
+double GuideLatency::stageMs(const Frame &frame, Stage stage)
+{
+    qint64 start = 0, end = 0;
+    if (!stageBounds(frame, stage, &start, &end))
+        return std::numeric_limits<double>::quiet_NaN();
+    // The camera may deliver the image slightly before the nominal end of the exposure
+    return std::max<qint64>(0, end - start) / 1e6;
+}
+
+double GuideLatency::percentile(Stage stage, double p) const
+{
+    std::vector<double> values;
+    values.reserve(m_Frames.size());
+    for (const auto &frame : m_Frames)
+    {
+        const double ms = stageMs(frame, stage);
+        if (std::isfinite(ms))
+            values.push_back(ms);
+    }
+    if (values.empty())
+        return std::numeric_limits<double>::quiet_NaN();
+
+    // Linear interpolation between the closest ranks
+    std::sort(values.begin(), values.end());
+    const double rank = std::min(std::max(p, 0.0), 100.0) / 100.0 * (values.size() - 1);
+    const size_t below = static_cast<size_t>(std::floor(rank));
+    const size_t above = std::min(below + 1, values.size() - 1);
+    return values[below] + (rank - below) * (values[above] - values[below]);
+}
+
+QString GuideLatency::summary() const
+{
+    QStringList lines;
+    lines << QString("Guide latency over %1 frames (ms, p50/p90/p99):").arg(m_Frames.size());
+    for (int stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        const Stage s = static_cast<Stage>(stage);
+        const double p50 = percentile(s, 50);
+        if (!std::isfinite(p50))
+            continue;
+        lines << QString("  %1: %2 / %3 / %4").arg(stageName(s), -12).arg(p50, 0, 'f', 1)
+              .arg(percentile(s, 90), 0, 'f', 1).arg(percentile(s, 99), 0, 'f', 1);
+    }
+    return lines.join('\n');
+}
+
+QJsonDocument GuideLatency::chromeTrace() const
+{
+    // Times are in microseconds from the start of the oldest frame kept
+    qint64 origin = 0;
+    for (const auto &frame : m_Frames)
+    {
+        if (frame.marks[CAPTURE_STARTED] != 0 && (origin == 0 || frame.marks[CAPTURE_STARTED] < origin))
+            origin = frame.marks[CAPTURE_STARTED];
+    }
+
+    QJsonArray events;
+    events.append(QJsonObject
+    {
+        {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", 1},
+        {"args", QJsonObject{{"name", "Guide cycle"}}}
+    });
+
+    for (int i = 0; i < m_Frames.size(); i++)
+    {
+        const Frame &frame = m_Frames[(m_Oldest + i) % m_Frames.size()];
+        for (int stage = 0; stage < STAGE_COUNT; stage++)
+        {
+            const Stage s = static_cast<Stage>(stage);
+            qint64 start = 0, end = 0;
+            if (!stageBounds(frame, s, &start, &end))
+                continue;
+
+            QJsonObject args{{"frame", frame.number}};
+            if (s == PULSE)
+                args["pulse_ms"] = frame.pulseMs;
+            events.append(QJsonObject
+            {
+                {"name", stageName(s)}, {"cat", "guide"}, {"ph", "X"}, {"pid", 1}, {"tid", 1},
+                {"ts", (start - origin) / 1e3}, {"dur", std::max<qint64>(0, end - start) / 1e3}, {"args", args}
+            });
+        }
+    }
+
+    return QJsonDocument(QJsonObject{{"traceEvents", events}, {"displayTimeUnit", "ms"}});
+}
+
+bool GuideLatency::exportChromeTrace(const QString &filename) const
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return file.write(chromeTrace().toJson(QJsonDocument::Compact)) >= 0;
+}
+
+void GuideLatency::clear()
+{
+    m_Frames.clear();
+    m_Oldest = 0;
+    m_Last = -1;
+    m_Current = Frame();
+    m_Timing = false;
+    m_PendingAxes = 0;
+    m_FrameCount = 0;
+}
+}
@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QJsonDocument>
+#include <QString>
+#include <QVector>
+
+#include <array>
+
+namespace Ekos
+{
+/**
+ * @class GuideLatency
+ * @brief Timestamps each guide cycle from the start of the exposure to the end of the guide pulse.
+ *
+ * The guide module marks every step of a frame as it passes through it: the camera receiving and loading the BLOB,
+ * the guide module receiving the image, the guider finding the star, the pulse being sent and the mount reporting
+ * the pulse as done. The time between consecutive marks is the latency of a stage. The stages of the last frames
+ * are kept for percentile statistics, and can be exported as a Chrome trace (chrome://tracing or Perfetto).
+ */
+class GuideLatency
+{
+    public:
+        // Points in the guide cycle, in order
+        typedef enum
+        {
+            CAPTURE_STARTED,
+            BLOB_RECEIVED,
+            IMAGE_LOADED,
+            IMAGE_RECEIVED,
+            STAR_FOUND,
+            PULSE_SENT,
+            PULSE_DONE,
+            MARK_COUNT
+        } Mark;
+
+        // Time between marks. The exposure ends at the capture start plus the exposure time.
+        typedef enum
+        {
+            EXPOSURE,       // Capture started to end of exposure
+            DOWNLOAD,       // End of exposure to BLOB received
+            LOAD,           // BLOB received to image loaded
+            DISPATCH,       // Image loaded to image received by the guide module
+            DETECTION,      // Image received to guide star found
+            CALCULATION,    // Guide star found to guide pulse sent
+            PULSE,          // Guide pulse sent to the mount reporting it done
+            STAGE_COUNT
+        } Stage;
+
+        // A completed guide cycle
+        struct Frame
+        {
+            int number { 0 };
+            // Nanoseconds on the monotonic clock, 0 if not reached
+            std::array<qint64, MARK_COUNT> marks {};
+            double exposure { 0 };
+            int pulseMs { 0 };
+        };
+
+        explicit GuideLatency(int capacity = 1000);
+
+        /** @return Nanoseconds on the monotonic clock used for all marks */
+        static qint64 now();
+
+        static QString stageName(Stage stage);
+
+        /**
+         * @brief Start timing a new guide cycle, finishing the previous one.
+         * @param exposure exposure time in seconds
+         * @return true if a previous frame was finished and can be read with lastFrame()
+         */
+        bool startFrame(double exposure, qint64 time = now());
+
+        /**
+         * @brief Record a point of the current frame. Only the first time a mark is reached is kept.
+         */
+        void mark(Mark point, qint64 time = now());
+
+        /**
+         * @brief Record the longest guide pulse sent, and on how many axes the mount has to report it done.
+         */
+        void setPulse(int ms, int axes);
+
+        /**
+         * @brief One pulsed axis reported done. The pulse is done when all the axes are.
+         */
+        void pulseCompleted(qint64 time = now());
+
+        /**
+         * @brief Finish the current frame, if any, and add it to the statistics.
+         * @return true if there was a frame to finish.
+         */
+        bool finishFrame();
+
+        bool isTiming() const
+        {
+            return m_Timing;
+        }
+
+        /** @return number of finished frames kept */
+        int size() const
+        {
+            return m_Frames.size();
+        }
+
+        const Frame &lastFrame() const;
+
+        /** @return duration of a stage of a frame in milliseconds, NaN if one of its marks is missing */
+        static double stageMs(const Frame &frame, Stage stage);
+
+        /**
+         * @brief Percentile of a stage over the finished frames kept.
+         * @param p percentile between 0 and 100
+         * @return milliseconds, NaN if no frame has the stage
+         */
+        double percentile(Stage stage, double p) const;
+
+        /** @return one line per stage with the 50th, 90th and 99th percentiles */
+        QString summary() const;
+
+        /** @return the finished frames as Chrome trace events, one complete event per stage */
+        QJsonDocument chromeTrace() const;
+
+        bool exportChromeTrace(const QString &filename) const;
+
+        void clear();
+
+    private:
+        int m_Capacity { 1000 };
+        // Ring of the finished frames, oldest first from m_Oldest
+        QVector<Frame> m_Frames;
+        int m_Oldest { 0 };
+        int m_Last { -1 };
+
+        Frame m_Current;
+        bool m_Timing { false };
+        int m_PendingAxes { 0 };
+        int m_FrameCount { 0 };
+};
+}
@@ -54,6 +54,8 @@ GaussianProcessGuider::GaussianProcessGuider(guide_parameters parameters) :
     output_covariance_function_(),
     gp_(covariance_function_),
     learning_rate_(DEFAULT_LEARNING_RATE),
+    asynchronous_update_(false),
+    model_requested_(false),
     parameters(parameters)
 {
     circular_buffer_data_.push_front(data_point()); // add first point
@@ -139,17 +141,19 @@ double GaussianProcessGuider::CalculateVariance(double SNR)
 
 void GaussianProcessGuider::UpdateGP(double prediction_point /*= std::numeric_limits<double>::quiet_NaN()*/)
 {
-#if PRINT_TIMINGS_
-    clock_t begin = std::clock(); // this is for timing the method in a simple way
-#endif
+    UpdateModel(gp_, GetModelInput(prediction_point));
+}
 
+GaussianProcessGuider::model_input GaussianProcessGuider::GetModelInput(double prediction_point) const
+{
     size_t N = get_number_of_measurements();
 
     // initialize the different vectors needed for the GP
-    Eigen::VectorXd timestamps(N - 1);
-    Eigen::VectorXd measurements(N - 1);
-    Eigen::VectorXd variances(N - 1);
-    Eigen::VectorXd sum_controls(N - 1);
+    model_input input;
+    input.timestamps.resize(N - 1);
+    input.measurements.resize(N - 1);
+    input.variances.resize(N - 1);
+    input.sum_controls.resize(N - 1);
 
     double sum_control = 0;
 
@@ -157,24 +161,42 @@ void GaussianProcessGuider::UpdateGP(double prediction_point /*= std::numeric_li
     for (size_t i = 0; i < N - 1; i++)
     {
         sum_control += circular_buffer_data_[i].control; // sum over the control signals
-        timestamps(i) = circular_buffer_data_[i].timestamp;
-        measurements(i) = circular_buffer_data_[i].measurement;
-        variances(i) = circular_buffer_data_[i].variance;
-        sum_controls(i) = sum_control; // store current accumulated control signal
+        input.timestamps(i) = circular_buffer_data_[i].timestamp;
+        input.measurements(i) = circular_buffer_data_[i].measurement;
+        input.variances(i) = circular_buffer_data_[i].variance;
+        input.sum_controls(i) = sum_control; // store current accumulated control signal
     }
 
-    Eigen::VectorXd gear_error(N - 1);
-    Eigen::VectorXd linear_fit(N - 1);
+    // calculate period length if we have enough points already
+    input.estimate_period = GetBoolComputePeriod()
+                            && get_last_point().timestamp > parameters.min_periods_for_period_estimation_ * GetGPHyperparameters()[PKPeriodLength];
+    input.learning_rate = learning_rate_;
+    input.points_for_approximation = parameters.points_for_approximation_;
+    input.prediction_point = prediction_point;
+    return input;
+}
 
-    // calculate the accumulated gear error
-    gear_error = sum_controls + measurements; // for each time step, add the residual error
+GP GaussianProcessGuider::ComputeModel(const GP &gp, const model_input &input)
+{
+    GP model(gp);
+    UpdateModel(model, input);
+    return model;
+}
 
+void GaussianProcessGuider::UpdateModel(GP &gp, const model_input &input)
+{
 #if PRINT_TIMINGS_
-    clock_t end = std::clock();
-    double time_init = double(end - begin) / CLOCKS_PER_SEC;
-    begin = std::clock();
+    clock_t begin = std::clock(); // this is for timing the method in a simple way
 #endif
 
+    Eigen::VectorXd timestamps = input.timestamps;
+    Eigen::VectorXd variances = input.variances;
+    Eigen::VectorXd gear_error(timestamps.rows());
+    Eigen::VectorXd linear_fit(timestamps.rows());
+
+    // calculate the accumulated gear error
+    gear_error = input.sum_controls + input.measurements; // for each time step, add the residual error
+
     // regularize the measurements
     Eigen::MatrixXd result = regularize_dataset(timestamps, gear_error, variances);
 
@@ -184,7 +206,7 @@ void GaussianProcessGuider::UpdateGP(double prediction_point /*= std::numeric_li
     variances = result.row(2);
 
 #if PRINT_TIMINGS_
-    end = std::clock();
+    clock_t end = std::clock();
     double time_regularize = double(end - begin) / CLOCKS_PER_SEC;
     begin = std::clock();
 #endif
@@ -211,13 +233,11 @@ void GaussianProcessGuider::UpdateGP(double prediction_point /*= std::numeric_li
     double time_fft = 0; // need to initialize in case the FFT isn't calculated
 #endif
 
-    // calculate period length if we have enough points already
-    double period_length = GetGPHyperparameters()[PKPeriodLength];
-    if (GetBoolComputePeriod() && get_last_point().timestamp > parameters.min_periods_for_period_estimation_ * period_length)
+    if (input.estimate_period)
     {
         // find periodicity parameter with FFT
-        period_length = EstimatePeriodLength(timestamps, gear_error_detrend);
-        UpdatePeriodLength(period_length);
+        double period_length = EstimatePeriodLength(timestamps, gear_error_detrend);
+        UpdatePeriodLength(gp, period_length, input.learning_rate);
 
 #if PRINT_TIMINGS_
         end = std::clock();
@@ -230,18 +250,50 @@ void GaussianProcessGuider::UpdateGP(double prediction_point /*= std::numeric_li
 #endif
 
     // inference of the GP with the new points, maximum accuracy should be reached around current time
-    gp_.inferSD(timestamps, gear_error, parameters.points_for_approximation_, variances, prediction_point);
+    gp.inferSD(timestamps, gear_error, input.points_for_approximation, variances, input.prediction_point);
 
 #if PRINT_TIMINGS_
     end = std::clock();
     double time_gp = double(end - begin) / CLOCKS_PER_SEC;
 
-    printf("timings: init: %f, regularize: %f, detrend: %f, fft: %f, gp: %f, total: %f\n",
-           time_init, time_regularize, time_detrend, time_fft, time_gp,
-           time_init + time_regularize + time_detrend + time_fft + time_gp);
+    printf("timings: regularize: %f, detrend: %f, fft: %f, gp: %f, total: %f\n",
+           time_regularize, time_detrend, time_fft, time_gp,
+           time_regularize + time_detrend + time_fft + time_gp);
 #endif
 }
 
+void GaussianProcessGuider::RefreshGP(double prediction_point)
+{
+    if (!asynchronous_update_)
+    {
+        UpdateGP(prediction_point);
+        return;
+    }
+    // Only the latest request matters, an older one that wasn't taken yet is replaced.
+    model_request_ = GetModelInput(prediction_point);
+    model_requested_ = true;
+}
+
+void GaussianProcessGuider::SetModel(const GP &model)
+{
+    gp_ = model;
+}
+
+void GaussianProcessGuider::SetAsynchronousUpdate(bool active)
+{
+    asynchronous_update_ = active;
+    model_requested_ = false;
+}
+
+bool GaussianProcessGuider::TakeModelRequest(model_input *input)
+{
+    if (!model_requested_)
+        return false;
+    *input = model_request_;
+    model_requested_ = false;
+    return true;
+}
+
 double GaussianProcessGuider::PredictGearError(double prediction_location)
 {
     // in the first step of each sequence, use the current time stamp as last prediction end
@@ -335,7 +387,7 @@ double GaussianProcessGuider::result(double input, double SNR, double time_step,
             prediction_point = std::chrono::duration<double>(std::chrono::system_clock::now() - start_time_).count();
         }
         // the point of highest precision should be between now and the next step
-        UpdateGP(prediction_point + 0.5 * time_step);
+        RefreshGP(prediction_point + 0.5 * time_step);
 
         // the prediction should end after one time step
         prediction_ = PredictGearError(prediction_point + time_step);
@@ -398,7 +450,7 @@ double GaussianProcessGuider::deduceResult(double time_step, double prediction_p
             prediction_point = std::chrono::duration<double>(std::chrono::system_clock::now() - start_time_).count();
         }
         // the point of highest precision should be between now and the next step
-        UpdateGP(prediction_point + 0.5 * time_step);
+        RefreshGP(prediction_point + 0.5 * time_step);
 
         // the prediction should end after one time step
         prediction_ = PredictGearError(prediction_point + time_step);
@@ -425,6 +477,7 @@ void GaussianProcessGuider::reset()
     qCDebug(KSTARS_EKOS_GUIDE) << QString("GPG::reset()");
     circular_buffer_data_.clear();
     gp_.clearData();
+    model_requested_ = false;
 
     // We need to add a first data point because the measurements are always relative to the control.
     // For the first measurement, we therefore need to add a point with zero control.
@@ -495,9 +548,20 @@ bool GaussianProcessGuider::SetBoolComputePeriod(bool active)
 }
 
 std::vector<double> GaussianProcessGuider::GetGPHyperparameters() const
+{
+    return GetHyperparameters(gp_);
+}
+
+bool GaussianProcessGuider::SetGPHyperparameters(std::vector<double> const &hyperparameters)
+{
+    SetHyperparameters(gp_, hyperparameters);
+    return false;
+}
+
+std::vector<double> GaussianProcessGuider::GetHyperparameters(const GP &gp)
 {
     // since the GP class works in log space, we have to exp() the parameters first.
-    Eigen::VectorXd hyperparameters_full = gp_.getHyperParameters().array().exp();
+    Eigen::VectorXd hyperparameters_full = gp.getHyperParameters().array().exp();
     // remove first parameter, which is unused here
     Eigen::VectorXd hyperparameters = hyperparameters_full.tail(NumParameters);
 
@@ -509,7 +573,7 @@ std::vector<double> GaussianProcessGuider::GetGPHyperparameters() const
                                hyperparameters.data() + NumParameters);
 }
 
-bool GaussianProcessGuider::SetGPHyperparameters(std::vector<double> const &hyperparameters)
+void GaussianProcessGuider::SetHyperparameters(GP &gp, std::vector<double> const &hyperparameters)
 {
     Eigen::VectorXd hyperparameters_eig = Eigen::VectorXd::Map(&hyperparameters[0], hyperparameters.size());
 
@@ -530,8 +594,7 @@ bool GaussianProcessGuider::SetGPHyperparameters(std::vector<double> const &hype
     hyperparameters_full << 1.0, hyperparameters_eig;
 
     // the GP works in log space, therefore we need to convert
-    gp_.setHyperParameters(hyperparameters_full.array().log());
-    return false;
+    gp.setHyperParameters(hyperparameters_full.array().log());
 }
 
 double GaussianProcessGuider::GetMinMove() const
@@ -689,7 +752,12 @@ double GaussianProcessGuider::EstimatePeriodLength(const Eigen::VectorXd &time,
 
 void GaussianProcessGuider::UpdatePeriodLength(double period_length)
 {
-    std::vector<double> hypers = GetGPHyperparameters();
+    UpdatePeriodLength(gp_, period_length, learning_rate_);
+}
+
+void GaussianProcessGuider::UpdatePeriodLength(GP &gp, double period_length, double learning_rate)
+{
+    std::vector<double> hypers = GetHyperparameters(gp);
 
     // assert for the developers...
     assert(!math_tools::isNaN(period_length));
@@ -701,15 +769,15 @@ void GaussianProcessGuider::UpdatePeriodLength(double period_length)
     }
 
     // we just apply a simple learning rate to slow down parameter jumps
-    hypers[PKPeriodLength] = (1 - learning_rate_) * hypers[PKPeriodLength] + learning_rate_ * period_length;
+    hypers[PKPeriodLength] = (1 - learning_rate) * hypers[PKPeriodLength] + learning_rate * period_length;
 
-    SetGPHyperparameters(hypers); // the setter function is needed to convert parameters
+    SetHyperparameters(gp, hypers); // the setter function is needed to convert parameters
 }
 
 Eigen::MatrixXd GaussianProcessGuider::regularize_dataset(const Eigen::VectorXd &timestamps,
         const Eigen::VectorXd &gear_error, const Eigen::VectorXd &variances)
 {
-    size_t N = get_number_of_measurements();
+    int N = timestamps.rows();
     double grid_interval = GRID_INTERVAL;
     double last_cell_end = -grid_interval;
     double last_timestamp = -grid_interval;
@@ -723,7 +791,7 @@ Eigen::MatrixXd GaussianProcessGuider::regularize_dataset(const Eigen::VectorXd
     Eigen::VectorXd reg_gear_error(grid_size);
     Eigen::VectorXd reg_variances(grid_size);
     int j = 0;
-    for (size_t i = 0; i < N - 1; ++i)
+    for (int i = 0; i < N; ++i)
     {
         if (timestamps(i) < last_cell_end + grid_interval)
         {
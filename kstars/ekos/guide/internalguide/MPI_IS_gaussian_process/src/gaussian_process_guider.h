@@ -151,6 +151,31 @@ class GaussianProcessGuider
 
         };
 
+        /**
+         * The data a GP update works on. It is copied out of the guider, so
+         * that the update can run on another thread while the guider keeps
+         * collecting data (added for KStars).
+         */
+        struct model_input
+        {
+            Eigen::VectorXd timestamps;
+            Eigen::VectorXd measurements;
+            Eigen::VectorXd variances;
+            Eigen::VectorXd sum_controls;
+            double prediction_point;
+            bool estimate_period;
+            double learning_rate;
+            int points_for_approximation;
+
+            model_input() :
+                prediction_point(std::numeric_limits<double>::quiet_NaN()),
+                estimate_period(false),
+                learning_rate(0.0),
+                points_for_approximation(0)
+            {
+            }
+        };
+
     private:
 
         std::chrono::system_clock::time_point start_time_; // reference time
@@ -177,6 +202,15 @@ class GaussianProcessGuider
          */
         double learning_rate_;
 
+        /**
+         * In asynchronous mode, result() and deduceResult() don't update the
+         * GP themselves. They leave a model request, and predict with the last
+         * model given to SetModel().
+         */
+        bool asynchronous_update_;
+        bool model_requested_;
+        model_input model_request_;
+
         /**
          * Guiding parameters of this instance.
          */
@@ -211,7 +245,29 @@ class GaussianProcessGuider
         /**
          * Estimates the main period length for a given dataset.
          */
-        double EstimatePeriodLength(const Eigen::VectorXd &time, const Eigen::VectorXd &data);
+        static double EstimatePeriodLength(const Eigen::VectorXd &time, const Eigen::VectorXd &data);
+
+        /**
+         * Brings the GP up to date, or in asynchronous mode, requests an update.
+         */
+        void RefreshGP(double prediction_point);
+
+        /**
+         * Runs the inference machinery of UpdateGP() on the given GP.
+         */
+        static void UpdateModel(GP &gp, const model_input &input);
+
+        /**
+         * Conversions between the hyperparameters in natural units and the
+         * log-space parameters of the given GP.
+         */
+        static std::vector<double> GetHyperparameters(const GP &gp);
+        static void SetHyperparameters(GP &gp, const std::vector<double> &hyperparameters);
+
+        /**
+         * Filters the period length with the learning rate and sets it on the given GP.
+         */
+        static void UpdatePeriodLength(GP &gp, double period_length, double learning_rate);
 
         /**
          * Calculates the difference in gear error for the time between the last
@@ -329,6 +385,42 @@ class GaussianProcessGuider
          */
         void UpdatePeriodLength(double period_length);
 
+        /**
+         * Copies the data for a GP update out of the circular buffer.
+         */
+        model_input GetModelInput(double prediction_point) const;
+
+        /**
+         * Returns a copy of the given GP, updated with the input. This is the
+         * expensive part of UpdateGP(). It doesn't touch any guider, so it can
+         * run on a worker thread.
+         */
+        static GP ComputeModel(const GP &gp, const model_input &input);
+
+        /**
+         * Returns the GP used for predictions.
+         */
+        const GP &GetModel() const
+        {
+            return gp_;
+        }
+
+        /**
+         * Replaces the GP used for predictions with one from ComputeModel().
+         */
+        void SetModel(const GP &model);
+
+        /**
+         * Enables asynchronous mode, where the GP updates are left to the caller.
+         */
+        void SetAsynchronousUpdate(bool active);
+
+        /**
+         * In asynchronous mode, returns true and fills input with the data for
+         * the latest requested GP update, if there is one that wasn't taken yet.
+         */
+        bool TakeModelRequest(model_input *input);
+
         data_point &get_last_point() const
         {
             return circular_buffer_data_[circular_buffer_data_.size() - 1];
@@ -357,8 +449,8 @@ class GaussianProcessGuider
         /**
          * Takes timestamps, measurements and SNRs and returns them regularized in a matrix.
          */
-        Eigen::MatrixXd regularize_dataset(const Eigen::VectorXd &timestamps, const Eigen::VectorXd &gear_error,
-                                           const Eigen::VectorXd &variances);
+        static Eigen::MatrixXd regularize_dataset(const Eigen::VectorXd &timestamps, const Eigen::VectorXd &gear_error,
+                const Eigen::VectorXd &variances);
 
         /**
          * Saves the GP data to a csv file for external analysis. Expensive!
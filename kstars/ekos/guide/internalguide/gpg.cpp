@@ -14,6 +14,7 @@
 #include "calibration.h"
 
 #include <QElapsedTimer>
+#include <QtConcurrent>
 
 namespace
 {
@@ -95,6 +96,7 @@ void GPG::updateParameters()
 {
     // Parameters would be set when the gpg stars up.
     if (gpg.get() == nullptr) return;
+    m_Generation++;
 
     GaussianProcessGuider::guide_parameters parameters;
     getGPGParameters(&parameters);
@@ -125,6 +127,7 @@ GPG::GPG()
     GaussianProcessGuider::guide_parameters parameters;
     getGPGParameters(&parameters);
     gpg.reset(new GaussianProcessGuider(parameters));
+    gpg->SetAsynchronousUpdate(true);
     reset();
 }
 
@@ -132,6 +135,7 @@ void GPG::reset()
 {
     gpgSamples = 0;
     gpgSkippedSamples = 0;
+    m_Generation++;
     gpg->reset();
     qCDebug(KSTARS_EKOS_GUIDE) << "Resetting GPG";
 }
@@ -199,7 +203,9 @@ void GPG::suspended(const GuiderUtils::Vector &guideStarPosition,
 
     QElapsedTimer gpgTimer;
     gpgTimer.restart();
+    collectModel();
     const double gpgResult = gpg->result(gpgInput, getSNR(guideStars, gpgInput), Options::guideExposure());
+    requestModel();
     // Store the updated period length.
     std::vector<double> gpgParams = gpg->GetGPHyperparameters();
     Options::setGPGPeriod(gpgParams[PKPeriodLength]);
@@ -255,7 +261,9 @@ bool GPG::computePulse(double raArcsecError, GuideStars *guideStars,
     // Cast back to a raw double
     auto const rawTime = timeStep.count();
 
+    collectModel();
     const double gpgResult = gpg->result(raArcsecError, getSNR(guideStars, raArcsecError), rawTime);
+    requestModel();
     const double gpgTime = gpgTimer.elapsed();
     gpgSamples++;
 
@@ -279,6 +287,38 @@ bool GPG::computePulse(double raArcsecError, GuideStars *guideStars,
     return true;
 }
 
+void GPG::collectModel()
+{
+    if (!m_ModelUpdateRunning || !m_ModelUpdate.isFinished())
+        return;
+    m_ModelUpdateRunning = false;
+    if (m_ModelGeneration == m_Generation)
+        gpg->SetModel(m_ModelUpdate.result());
+}
+
+void GPG::requestModel()
+{
+    // If the worker is busy, the request stays with the guider, and is replaced
+    // by a newer one on the next guide cycle.
+    GaussianProcessGuider::model_input input;
+    if (m_ModelUpdateRunning || !gpg->TakeModelRequest(&input))
+        return;
+
+    m_ModelGeneration = m_Generation;
+    m_ModelUpdateRunning = true;
+    const GP model = gpg->GetModel();
+    m_ModelUpdate = QtConcurrent::run([model, input]() -> GP
+    {
+        QElapsedTimer timer;
+        timer.start();
+        GP updated = GaussianProcessGuider::ComputeModel(model, input);
+        qCDebug(KSTARS_EKOS_GUIDE) << QString("GPG model update: %1 samples, elapsed %2s")
+                                   .arg(input.timestamps.rows())
+                                   .arg(timer.elapsed() / 1000.0);
+        return updated;
+    });
+}
+
 double GPG::convertCorrectionToPulseMilliseconds(const Calibration &cal, int *pulseLength,
         GuideDirection *pulseDir, const double gpgResult)
 {
@@ -304,7 +344,9 @@ bool GPG::darkGuiding(int *pulseLength, GuideDirection *pulseDir, const Calibrat
 
     QElapsedTimer gpgTimer;
     gpgTimer.restart();
+    collectModel();
     const double gpgResult = gpg->deduceResult(timeStep.count());
+    requestModel();
     const double gpgTime = gpgTimer.elapsed();
 
     // GPG output is in RA arcseconds.
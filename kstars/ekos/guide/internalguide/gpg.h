@@ -10,12 +10,18 @@
 #include "indi/indicommon.h"
 #include "MPI_IS_gaussian_process/src/gaussian_process_guider.h"
 #include "ekos_guide_debug.h"
+
+#include <QFuture>
+
 class GuideStars;
 class GaussianProcessGuider;
 class Calibration;
 
 // This is a wrapper class around the GaussianProcessGuider contributed class
 // to make integration with EKos easier.
+// The GP model is updated on a worker thread, so the guide cycle only has to evaluate
+// the latest model. The guider predicts with one copy of the model while the worker
+// fits the next one, and the two are swapped when the worker is done.
 class GPG
 {
     public:
@@ -62,6 +68,20 @@ class GPG
         std::unique_ptr<GaussianProcessGuider> gpg;
         int gpgSamples = 0;
         int gpgSkippedSamples = 0;
+
+        // Swaps in the model from the worker, if it finished since the last guide cycle.
+        void collectModel();
+        // Starts the worker on the model update requested by the guider, unless it is busy.
+        void requestModel();
+
+        QFuture<GP> m_ModelUpdate;
+        bool m_ModelUpdateRunning = false;
+        // Incremented when the gpg is reset or its parameters change. A model started
+        // before that is discarded when it finishes.
+        int m_Generation = 0;
+        int m_ModelGeneration = 0;
         // Converts the gpg output to pulse milliseconds
         double convertCorrectionToPulseMilliseconds(const Calibration &cal, int *pulseLength, GuideDirection *pulseDir, const double gpgResult);
+
+        friend class TestGPG;
 };
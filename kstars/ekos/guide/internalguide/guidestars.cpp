@@ -11,6 +11,7 @@
 #include "fitsviewer/fitsdata.h"
 #include "fitsviewer/fitssepdetector.h"
 #include "Options.h"
+#include "stargrid.h"
 
 #include <math.h>
 #include <stellarsolver.h>
@@ -19,6 +20,10 @@
 #include <QTime>
 #include <QElapsedTimer>
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #define DLOG if (false) qCDebug
 
 // Then when looking for the guide star, gets this many candidates.
@@ -35,6 +40,16 @@
 // margin below (e.g. if a guide star was selected that was near the max guide-star hfr, the later
 // the hfr increased a little, we still want to be able to find it.
 constexpr double HFR_MARGIN = 2.0;
+
+// When guiding on ROIs, stars are searched for this far from their expected positions,
+// the same distance star correspondence allows below.
+constexpr double ROI_SEARCH_DISTANCE = 10.0;
+// Width of the border of each ROI used to estimate its background.
+constexpr int ROI_BACKGROUND_BORDER = 2;
+// A star's peak must be this many background sigmas above the background,
+// and its pixels this many to be included in its centroid.
+constexpr double ROI_DETECTION_SIGMA = 5.0;
+constexpr double ROI_THRESHOLD_SIGMA = 2.0;
 /*
  Start with a set of reference (x,y) positions from stars, where one is designated a guide star.
  Given these and a set of new input stars, determine a mapping of new stars to the references.
@@ -119,6 +134,7 @@ void GuideStars::setupStarCorrespondence(const QList<Edge> &neighbors, int guide
     }
     else
         starCorrespondence.reset();
+    m_RoiLocked = false;
 }
 
 // Calls SEP to generate a set of star detections and score them,
@@ -323,59 +339,86 @@ GuiderUtils::Vector GuideStars::findGuideStar(const QSharedPointer<FITSData> &im
     const double maxHFR = Options::guideMaxHFR() + HFR_MARGIN;
     if (starCorrespondence.size() > 0)
     {
+        // Once locked, first look for the references only near their last positions,
+        // and search the full frame if that doesn't find the guide star.
+        const bool tryRoi = m_RoiLocked && !firstFrame && Options::guideRoiOnly();
+        m_RoiLocked = false;
+        for (int pass = tryRoi ? 0 : 1; pass < 2; ++pass)
+        {
+            const bool roiPass = pass == 0;
+            if (roiPass)
+            {
+                if (!findRoiStars(imageData, maxHFR))
+                {
+                    qCDebug(KSTARS_EKOS_GUIDE) << "ROI search found too few reference stars, searching the full frame.";
+                    continue;
+                }
+            }
+            else
+            {
+                findTopStars(imageData, STARS_TO_SEARCH, &detectedStars, maxHFR);
+                if (detectedStars.empty())
+                    return GuiderUtils::Vector(-1, -1, -1);
+            }
 
-        findTopStars(imageData, STARS_TO_SEARCH, &detectedStars, maxHFR);
-        if (detectedStars.empty())
-            return GuiderUtils::Vector(-1, -1, -1);
-
-        // Allow it to guide even if the main guide star isn't detected (as long as enough reference stars are).
-        starCorrespondence.setAllowMissingGuideStar(allowMissingGuideStar);
+            // Allow it to guide even if the main guide star isn't detected (as long as enough reference stars are).
+            starCorrespondence.setAllowMissingGuideStar(allowMissingGuideStar);
 
-        // Star correspondence can run quicker if it knows the image size.
-        starCorrespondence.setImageSize(imageData->width(), imageData->height());
+            // Star correspondence can run quicker if it knows the image size.
+            starCorrespondence.setImageSize(imageData->width(), imageData->height());
 
-        // When using large star-correspondence sets and filtering with a StellarSolver profile,
-        // the stars at the edge of detection can be lost. Best not to filter, but...
-        double minFraction = 0.5;
-        if (starCorrespondence.size() > 25) minFraction =  0.33;
-        else if (starCorrespondence.size() > 15) minFraction =  0.4;
+            // When using large star-correspondence sets and filtering with a StellarSolver profile,
+            // the stars at the edge of detection can be lost. Best not to filter, but...
+            double minFraction = 0.5;
+            if (starCorrespondence.size() > 25) minFraction =  0.33;
+            else if (starCorrespondence.size() > 15) minFraction =  0.4;
 
-        Edge foundStar = starCorrespondence.find(detectedStars, maxStarAssociationDistance, &starMap, false, minFraction);
+            Edge foundStar = starCorrespondence.find(detectedStars, maxStarAssociationDistance, &starMap, false, minFraction);
 
-        // Is there a correspondence to the guide star
-        // Should we also weight distance to the tracking box?
-        for (int i = 0; i < detectedStars.size(); ++i)
-        {
-            if (getStarMap(i) == starCorrespondence.guideStar())
+            // Is there a correspondence to the guide star
+            // Should we also weight distance to the tracking box?
+            for (int i = 0; i < detectedStars.size(); ++i)
             {
-                auto &star = detectedStars[i];
-                double SNR = skyBackground.SNR(star.sum, star.numPixels);
-                guideStarSNR = SNR;
-                guideStarMass = star.sum;
-                unreliableDectionCounter = 0;
-                qCDebug(KSTARS_EKOS_GUIDE) << QString("StarCorrespondence found star %1 at %2 %3 SNR %4")
-                                           .arg(i).arg(star.x, 0, 'f', 1).arg(star.y, 0, 'f', 1).arg(SNR, 0, 'f', 1);
-
+                if (getStarMap(i) == starCorrespondence.guideStar())
+                {
+                    auto &star = detectedStars[i];
+                    double SNR = skyBackground.SNR(star.sum, star.numPixels);
+                    guideStarSNR = SNR;
+                    guideStarMass = star.sum;
+                    unreliableDectionCounter = 0;
+                    m_RoiLocked = true;
+                    m_RoiGuideStar = QPointF(star.x, star.y);
+                    qCDebug(KSTARS_EKOS_GUIDE) << QString("StarCorrespondence found star %1 at %2 %3 SNR %4%5")
+                                               .arg(i).arg(star.x, 0, 'f', 1).arg(star.y, 0, 'f', 1).arg(SNR, 0, 'f', 1)
+                                               .arg(roiPass ? " (ROI)" : "");
+
+                    if (guideView != nullptr)
+                        plotStars(guideView, trackingBox);
+                    qCDebug(KSTARS_EKOS_GUIDE) << QString("StarCorrespondence. findGuideStar took %1s").arg(timer.elapsed() / 1000.0, 0, 'f',
+                                               3);
+                    return GuiderUtils::Vector(star.x, star.y, 0);
+                }
+            }
+            // None of the stars matched the guide star, but it's possible star correspondence
+            // invented a guide star position.
+            if (foundStar.x >= 0 && foundStar.y >= 0)
+            {
+                guideStarSNR = skyBackground.SNR(foundStar.sum, foundStar.numPixels);
+                guideStarMass = foundStar.sum;
+                unreliableDectionCounter = 0;  // debating this
+                m_RoiLocked = true;
+                m_RoiGuideStar = QPointF(foundStar.x, foundStar.y);
+                qCDebug(KSTARS_EKOS_GUIDE) << "StarCorrespondence invented at" << foundStar.x << foundStar.y << "SNR" << guideStarSNR
+                                           << (roiPass ? "(ROI)" : "");
                 if (guideView != nullptr)
                     plotStars(guideView, trackingBox);
-                qCDebug(KSTARS_EKOS_GUIDE) << QString("StarCorrespondence. findGuideStar took %1s").arg(timer.elapsed() / 1000.0, 0, 'f',
-                                           3);
-                return GuiderUtils::Vector(star.x, star.y, 0);
+                qCDebug(KSTARS_EKOS_GUIDE) << QString("StarCorrespondence. findGuideStar/invent took %1s").arg(timer.elapsed() / 1000.0, 0,
+                                           'f', 3);
+                return GuiderUtils::Vector(foundStar.x, foundStar.y, 0);
             }
-        }
-        // None of the stars matched the guide star, but it's possible star correspondence
-        // invented a guide star position.
-        if (foundStar.x >= 0 && foundStar.y >= 0)
-        {
-            guideStarSNR = skyBackground.SNR(foundStar.sum, foundStar.numPixels);
-            guideStarMass = foundStar.sum;
-            unreliableDectionCounter = 0;  // debating this
-            qCDebug(KSTARS_EKOS_GUIDE) << "StarCorrespondence invented at" << foundStar.x << foundStar.y << "SNR" << guideStarSNR;
-            if (guideView != nullptr)
-                plotStars(guideView, trackingBox);
-            qCDebug(KSTARS_EKOS_GUIDE) << QString("StarCorrespondence. findGuideStar/invent took %1s").arg(timer.elapsed() / 1000.0, 0,
-                                       'f', 3);
-            return GuiderUtils::Vector(foundStar.x, foundStar.y, 0);
+
+            if (roiPass)
+                qCDebug(KSTARS_EKOS_GUIDE) << "ROI search lost the guide star, searching the full frame.";
         }
     }
 
@@ -439,6 +482,202 @@ GuiderUtils::Vector GuideStars::findGuideStar(const QSharedPointer<FITSData> &im
     return GuiderUtils::Vector(-1, -1, -1);
 }
 
+bool GuideStars::findRoiStars(const QSharedPointer<FITSData> &imageData, const double maxHFR)
+{
+    QElapsedTimer timer;
+    timer.start();
+    detectedStars.clear();
+
+    const int width = imageData->width();
+    const int height = imageData->height();
+    const QRect frame(0, 0, width, height);
+    // Large enough for the star to have moved as far as star correspondence allows,
+    // plus its halo and a border for the background.
+    const double searchRadius = ROI_SEARCH_DISTANCE;
+    const int halfSize = static_cast<int>(std::ceil(searchRadius + 2 * maxHFR)) + ROI_BACKGROUND_BORDER;
+
+    double backgroundSum = 0, varianceSum = 0;
+    int backgroundPixels = 0;
+    for (int i = 0; i < starCorrespondence.size(); ++i)
+    {
+        const QVector2D offset = starCorrespondence.offset(i);
+        const int x = qRound(m_RoiGuideStar.x() + offset.x());
+        const int y = qRound(m_RoiGuideStar.y() + offset.y());
+        const QRect box = QRect(x - halfSize, y - halfSize, 2 * halfSize + 1, 2 * halfSize + 1).intersected(frame);
+        // Skip references that have moved (mostly) out of the frame
+        if (box.width() <= halfSize || box.height() <= halfSize)
+            continue;
+
+        Edge star;
+        SkyBackground background;
+        if (!measureRoiStar(imageData->getImageBuffer(), imageData->dataType(), width, box, searchRadius, &star, &background))
+            continue;
+        backgroundSum += background.mean * background.numPixelsInSkyEstimate;
+        varianceSum += background.sigma * background.sigma * background.numPixelsInSkyEstimate;
+        backgroundPixels += background.numPixelsInSkyEstimate;
+
+        if (star.HFR > maxHFR)
+            continue;
+        // Neighboring subframes may overlap and find the same star.
+        const bool duplicate = std::any_of(detectedStars.cbegin(), detectedStars.cend(), [&star](const Edge & other)
+        {
+            return std::fabs(other.x - star.x) < 1 && std::fabs(other.y - star.y) < 1;
+        });
+        if (!duplicate)
+            detectedStars.append(star);
+    }
+
+    if (backgroundPixels > 0)
+        skyBackground.initialize(backgroundSum / backgroundPixels, std::sqrt(varianceSum / backgroundPixels),
+                                 backgroundPixels, detectedStars.size());
+    m_NumStarsDetected = detectedStars.size();
+
+    qCDebug(KSTARS_EKOS_GUIDE) << QString("ROI star detection found %1 of %2 references, took %3s")
+                               .arg(detectedStars.size()).arg(starCorrespondence.size()).arg(timer.elapsed() / 1000.0, 0, 'f', 3);
+    return backgroundPixels > 0 && detectedStars.size() >= std::max(2, starCorrespondence.size() / 2);
+}
+
+template <typename T>
+bool GuideStars::measureRoiStar(const T *buffer, int imageWidth, const QRect &box, double searchRadius,
+                                Edge *star, SkyBackground *background)
+{
+    const auto pixel = [&](int x, int y) -> double
+    {
+        return buffer[static_cast<size_t>(y) * imageWidth + x];
+    };
+    const auto onBorder = [&](int x, int y)
+    {
+        return x < box.left() + ROI_BACKGROUND_BORDER || x > box.right() - ROI_BACKGROUND_BORDER ||
+               y < box.top() + ROI_BACKGROUND_BORDER || y > box.bottom() - ROI_BACKGROUND_BORDER;
+    };
+
+    // Background from the median and MAD of the border, which ignore parts of neighboring stars.
+    std::vector<double> border;
+    for (int y = box.top(); y <= box.bottom(); ++y)
+    {
+        for (int x = box.left(); x <= box.right(); ++x)
+        {
+            if (onBorder(x, y))
+                border.push_back(pixel(x, y));
+        }
+    }
+    const int count = border.size();
+    if (count == 0)
+        return false;
+    const auto middle = border.begin() + count / 2;
+    std::nth_element(border.begin(), middle, border.end());
+    const double mean = *middle;
+    for (auto &value : border)
+        value = std::fabs(value - mean);
+    std::nth_element(border.begin(), middle, border.end());
+    const double sigma = 1.4826 * *middle;
+    background->initialize(mean, sigma, count);
+
+    // The brightest pixel near the center is the star.
+    const double centerX = box.left() + (box.width() - 1) / 2.0;
+    const double centerY = box.top() + (box.height() - 1) / 2.0;
+    const double searchRadiusSq = searchRadius * searchRadius;
+    double peak = -std::numeric_limits<double>::max();
+    int peakX = -1, peakY = -1;
+    for (int y = box.top(); y <= box.bottom(); ++y)
+    {
+        for (int x = box.left(); x <= box.right(); ++x)
+        {
+            const double dx = x - centerX, dy = y - centerY;
+            if (dx * dx + dy * dy > searchRadiusSq || onBorder(x, y))
+                continue;
+            const double value = pixel(x, y);
+            if (value > peak)
+            {
+                peak = value;
+                peakX = x;
+                peakY = y;
+            }
+        }
+    }
+    if (peakX < 0 || peak - mean < ROI_DETECTION_SIGMA * std::max(sigma, 1.0))
+        return false;
+
+    // Centroid and flux of the pixels above the threshold around the peak.
+    const double threshold = mean + ROI_THRESHOLD_SIGMA * sigma;
+    double flux = 0, sumX = 0, sumY = 0;
+    int numPixels = 0;
+    for (int y = box.top(); y <= box.bottom(); ++y)
+    {
+        for (int x = box.left(); x <= box.right(); ++x)
+        {
+            const double dx = x - peakX, dy = y - peakY;
+            const double value = pixel(x, y);
+            if (value <= threshold || dx * dx + dy * dy > searchRadiusSq || onBorder(x, y))
+                continue;
+            const double weight = value - mean;
+            flux += weight;
+            sumX += weight * x;
+            sumY += weight * y;
+            numPixels++;
+        }
+    }
+    if (flux <= 0)
+        return false;
+    const double starX = sumX / flux, starY = sumY / flux;
+
+    // Flux weighted mean radius, an estimate of the HFR.
+    double sumR = 0;
+    for (int y = box.top(); y <= box.bottom(); ++y)
+    {
+        for (int x = box.left(); x <= box.right(); ++x)
+        {
+            const double dx = x - peakX, dy = y - peakY;
+            const double value = pixel(x, y);
+            if (value <= threshold || dx * dx + dy * dy > searchRadiusSq || onBorder(x, y))
+                continue;
+            sumR += (value - mean) * std::hypot(x - starX, y - starY);
+        }
+    }
+
+    star->x = starX;
+    star->y = starY;
+    star->val = static_cast<int>(peak);
+    star->sum = flux;
+    star->numPixels = numPixels;
+    star->HFR = sumR / flux;
+    star->width = 2 * star->HFR;
+    return true;
+}
+
+bool GuideStars::measureRoiStar(const uint8_t *buffer, uint32_t dataType, int imageWidth, const QRect &box,
+                                double searchRadius, Edge *star, SkyBackground *background)
+{
+    switch (dataType)
+    {
+        case TBYTE:
+            return measureRoiStar<uint8_t>(buffer, imageWidth, box, searchRadius, star, background);
+        case TSHORT:
+            return measureRoiStar<int16_t>(reinterpret_cast<const int16_t *>(buffer), imageWidth, box, searchRadius, star,
+                                           background);
+        case TUSHORT:
+            return measureRoiStar<uint16_t>(reinterpret_cast<const uint16_t *>(buffer), imageWidth, box, searchRadius, star,
+                                            background);
+        case TLONG:
+            return measureRoiStar<int32_t>(reinterpret_cast<const int32_t *>(buffer), imageWidth, box, searchRadius, star,
+                                           background);
+        case TULONG:
+            return measureRoiStar<uint32_t>(reinterpret_cast<const uint32_t *>(buffer), imageWidth, box, searchRadius, star,
+                                            background);
+        case TFLOAT:
+            return measureRoiStar<float>(reinterpret_cast<const float *>(buffer), imageWidth, box, searchRadius, star,
+                                         background);
+        case TLONGLONG:
+            return measureRoiStar<int64_t>(reinterpret_cast<const int64_t *>(buffer), imageWidth, box, searchRadius, star,
+                                           background);
+        case TDOUBLE:
+            return measureRoiStar<double>(reinterpret_cast<const double *>(buffer), imageWidth, box, searchRadius, star,
+                                          background);
+        default:
+            return false;
+    }
+}
+
 SSolver::Parameters GuideStars::getStarExtractionParameters(int num)
 {
     SSolver::Parameters params;
@@ -487,19 +726,9 @@ int GuideStars::findAllSEPStars(const QSharedPointer<FITSData> &imageData, QList
 
 double GuideStars::findMinDistance(int index, const QList<Edge*> &stars)
 {
-    double closestDistanceSqr = 1e10;
-    const Edge &star = *stars[index];
-    for (int i = 0; i < stars.size(); ++i)
-    {
-        if (i == index) continue;
-        const Edge &thisStar = *stars[i];
-        const double xDist = star.x - thisStar.x;
-        const double yDist = star.y - thisStar.y;
-        const double distanceSqr = xDist * xDist + yDist * yDist;
-        if (distanceSqr < closestDistanceSqr)
-            closestDistanceSqr = distanceSqr;
-    }
-    return sqrt(closestDistanceSqr);
+    StarGrid grid;
+    grid.build(stars);
+    return grid.nearestNeighborDistance(index);
 }
 
 // Returns a list of 'num' stars, sorted according to evaluateSEPStars().
@@ -544,6 +773,10 @@ void GuideStars::findTopStars(const QSharedPointer<FITSData> &imageData, int num
     {
         return a.second > b.second;
     });
+    // Index the stars once for the neighbor distances, rather than comparing every pair.
+    StarGrid grid;
+    if (minDistances != nullptr)
+        grid.build(sepStars);
     // Copy the top num results.
     for (int i = 0; i < std::min(num, (int)scores.size()); ++i)
     {
@@ -555,7 +788,7 @@ void GuideStars::findTopStars(const QSharedPointer<FITSData> &imageData, int num
             if (outputScores != nullptr)
                 outputScores->append(starScore);
             if (minDistances != nullptr)
-                minDistances->append(findMinDistance(starIndex, sepStars));
+                minDistances->append(grid.nearestNeighborDistance(starIndex));
         }
     }
     DLOG(KSTARS_EKOS_GUIDE)
@@ -8,6 +8,7 @@
 
 #include <QObject>
 #include <QList>
+#include <QPointF>
 #include <QVector3D>
 
 #include "starcorrespondence.h"
@@ -102,6 +103,7 @@ class GuideStars
         void reset()
         {
             starCorrespondence.reset();
+            m_RoiLocked = false;
         }
 
         // Used to initialize the StarCorrespondence object, which ultimately finds
@@ -126,6 +128,19 @@ private:
         // The interface to the SEP star detection algorithms.
         int findAllSEPStars(const QSharedPointer<FITSData> &imageData, QList<Edge*> *sepStars, int num);
 
+        // Detects the reference stars in small subframes around where they were in the last frame,
+        // instead of running SEP on the full frame. Fills in detectedStars and skyBackground.
+        // Returns false if too few of the references were found.
+        bool findRoiStars(const QSharedPointer<FITSData> &imageData, const double maxHFR);
+
+        // Measures the brightest star within searchRadius of the center of box, using the pixels on
+        // the border of the box as the background. Returns false if there is no star.
+        static bool measureRoiStar(const uint8_t *buffer, uint32_t dataType, int imageWidth, const QRect &box,
+                                   double searchRadius, Edge *star, SkyBackground *background);
+        template <typename T>
+        static bool measureRoiStar(const T *buffer, int imageWidth, const QRect &box, double searchRadius,
+                                   Edge *star, SkyBackground *background);
+
         // Convert from input image coordinates to output RA and DEC coordinates.
         GuiderUtils::Vector point2arcsec(const GuiderUtils::Vector &p) const;
 
@@ -187,5 +202,10 @@ private:
 
         int m_NumStarsDetected { 0 };
 
+        // Set once star correspondence has found the guide star, so the next frame may be
+        // searched around its last position, m_RoiGuideStar, when Options::guideRoiOnly() is set.
+        bool m_RoiLocked { false };
+        QPointF m_RoiGuideStar;
+
         friend class TestGuideStars;
 };
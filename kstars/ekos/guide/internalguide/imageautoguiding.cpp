@@ -6,450 +6,309 @@
 
 #include "imageautoguiding.h"
 
-#include <qglobal.h>
-
+#include <algorithm>
 #include <cmath>
-
-#define SWAP(a, b) \
-    tempr = (a);   \
-    (a)   = (b);   \
-    (b)   = tempr
-#define NR_END   1
-#define FREE_ARG char *
+#include <limits>
+#include <memory>
 
 #define TWOPI   6.28318530717959
 #define FFITMAX 0.05
 
-//void ImageAutoGuiding1(float *ref,float *im,int n,float *xshift,float *yshift);
-
-float ***f3tensorSP(long nrl, long nrh, long ncl, long nch, long ndl, long ndh);
-void free_f3tensorSP(float ***t, long nrl, long nrh, long ncl, long nch, long ndl, long ndh);
-
-float **matrixSP(long nrl, long nrh, long ncl, long nch);
-
-void free_matrixSP(float **m, long nrl, long nrh, long ncl, long nch);
-void nrerrorNR(void);
+namespace
+{
+typedef std::complex<float> Complex;
 
-void fournNR(float data[], unsigned long nn[], long ndim, long isign);
+// std::complex multiplication checks for infinities and NaNs, which stops the butterflies being vectorised
+inline Complex multiply(const Complex a, const Complex b)
+{
+    return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
 
-void rlft3NR(float ***data, float **speq, unsigned long nn1, unsigned long nn2, unsigned long nn3, long isign);
+inline Complex multiplyConjugate(const Complex a, const Complex b)
+{
+    return Complex(a.real() * b.real() + a.imag() * b.imag(), a.real() * b.imag() - a.imag() * b.real());
+}
 
-void ShiftEST(float ***testimage, float ***refimage, int n, float *xshift, float *yshift, int k);
+inline Complex twiddle(const Complex w, const bool forward)
+{
+    return forward ? w : std::conj(w);
+}
+}
 
 namespace ImageAutoGuiding
 {
 void ImageAutoGuiding1(float *ref, float *im, int n, float *xshift, float *yshift)
 {
-    float ***RefImage, ***TestImage;
-    int i, j, k;
-    float x, y;
-
-    /* Allocate memory */
-
-    RefImage  = f3tensorSP(1, 1, 1, n, 1, n);
-    TestImage = f3tensorSP(1, 1, 1, n, 1, n);
-
-    /* Load Data */
+    // Keep the FFT tables and buffers for the next call, which is almost always the same size.
+    // The reference may differ between calls, so it is transformed again every time.
+    thread_local std::unique_ptr<CrossCorrelator> correlator;
+    if (!correlator || correlator->size() != n)
+        correlator.reset(new CrossCorrelator(n));
 
-    k = 0;
-
-    for (j = 1; j <= n; ++j)
+    if (!correlator->setReference(ref) || !correlator->findShift(im, xshift, yshift))
     {
-        for (i = 1; i <= n; ++i)
-        {
-            RefImage[1][j][i]  = ref[k];
-            TestImage[1][j][i] = im[k];
-
-            k += 1;
-        }
+        *xshift = 0;
+        *yshift = 0;
     }
-
-    /* Calculate Image Shifts  */
-
-    ShiftEST(TestImage, RefImage, n, &x, &y, 1);
-
-    *xshift = x;
-    *yshift = y;
-
-    /* free memory */
-
-    free_f3tensorSP(RefImage, 1, 1, 1, n, 1, n);
-    free_f3tensorSP(TestImage, 1, 1, 1, n, 1, n);
-}
 }
 
-// Calculates Image Shifts
-
-void ShiftEST(float ***testimage, float ***refimage, int n, float *xshift, float *yshift, int k)
+CrossCorrelator::CrossCorrelator(int n)
 {
-    int ix, iy, nh, nhplusone;
-    double deltax, deltay, fx2sum, fy2sum, phifxsum, phifysum, fxfysum;
-    double fx, fy, ff, fn, re, im, testre, testim, rev, imv, phi;
-    double power, dem, f2, f2limit;
-    float **speq;
+    if (n < 2 || (n & (n - 1)) != 0)
+        return;
 
-    f2limit = FFITMAX * FFITMAX;
+    m_Size = n;
 
-    speq = matrixSP(1, 1, 1, 2 * n);
+    int bits = 0;
+    while ((1 << bits) < n)
+        bits++;
+    m_BitReversed.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        int reversed = 0;
+        for (int b = 0; b < bits; b++)
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        m_BitReversed[i] = reversed;
+    }
 
-    nh        = n / 2;
-    nhplusone = nh + 1;
+    m_Twiddles.resize(n / 2);
+    for (int k = 0; k < n / 2; k++)
+        m_Twiddles[k] = Complex(std::cos(TWOPI * k / n), std::sin(TWOPI * k / n));
 
-    fn = ((float)n);
-    ff = 1.0 / fn;
+    m_Width = n / 2 + 1;
+    m_Row.resize(n);
+    m_Spectrum.resize(static_cast<size_t>(n) * m_Width);
+    m_Reference.resize(m_Spectrum.size());
+    m_Cross.resize(m_Spectrum.size());
+}
 
-    /* FFT of Reference */
+bool CrossCorrelator::setReference(const float *ref)
+{
+    if (m_Size == 0)
+        return false;
 
-    for (ix = 1; ix <= 2 * n; ++ix)
-    {
-        speq[1][ix] = 0.0;
-    }
+    forwardTransform(ref);
+    std::copy(m_Spectrum.begin(), m_Spectrum.end(), m_Reference.begin());
+    m_HasReference = true;
+    return true;
+}
 
-    rlft3NR(refimage, speq, 1, n, n, 1);
+bool CrossCorrelator::findShift(const float *im, float *xshift, float *yshift)
+{
+    if (!m_HasReference)
+        return false;
 
-    /* FFT of Test Image */
+    forwardTransform(im);
 
-    for (ix = 1; ix <= 2 * n; ++ix)
+    // Phase correlation, with the mean level removed
+    for (size_t k = 0; k < m_Spectrum.size(); k++)
     {
-        speq[1][ix] = 0.0;
+        const Complex cross = multiplyConjugate(m_Reference[k], m_Spectrum[k]);
+        m_Cross[k] = cross;
+        const float power = cross.real() * cross.real() + cross.imag() * cross.imag();
+        m_Spectrum[k] = (power > 0) ? cross * (1 / std::sqrt(power)) : Complex(0, 0);
     }
+    m_Spectrum[0] = Complex(0, 0);
 
-    rlft3NR(testimage, speq, 1, n, n, 1);
+    int x0 = 0, y0 = 0;
+    findPeak(&x0, &y0);
 
-    /* Solving for slopes  */
+    double deltax = 0, deltay = 0;
+    refineShift(x0, y0, &deltax, &deltay);
 
-    fx2sum = 0.0;
-    fy2sum = 0.0;
-
-    phifxsum = 0.0;
-    phifysum = 0.0;
+    /* You can change the shift mapping here */
 
-    fxfysum = 0.0;
+    *xshift = x0 + deltax;
+    *yshift = y0 + deltay;
+    return true;
+}
 
-    for (ix = 1; ix <= n; ++ix)
+void CrossCorrelator::transformRow(Complex *row, bool forward) const
+{
+    const int n = m_Size;
+    for (int i = 0; i < n; i++)
     {
-        if (ix <= nhplusone)
-        {
-            fx = ff * ((float)(ix - 1));
-        }
-        else
-        {
-            fx = -ff * ((float)(n + 1 - ix));
-        }
+        if (i < m_BitReversed[i])
+            std::swap(row[i], row[m_BitReversed[i]]);
+    }
 
-        for (iy = 1; iy <= nh; ++iy)
+    for (int length = 2; length <= n; length <<= 1)
+    {
+        const int half = length / 2;
+        const int step = n / length;
+        for (int start = 0; start < n; start += length)
         {
-            fy = ff * ((float)(iy - 1));
-
-            f2 = fx * fx + fy * fy;
-
-            /* Limit to Low Spatial Frequencies */
-
-            if (f2 < f2limit)
+            for (int k = 0; k < half; k++)
             {
-                /* Real part reference image */
-
-                re = refimage[k][ix][2 * iy - 1];
-
-                /* Imaginary part reference image */
-
-                im = refimage[k][ix][2 * iy];
-
-                power = re * re + im * im;
-
-                /* Real part test image */
-
-                testre = testimage[k][ix][2 * iy - 1];
-
-                /* Imaginary part image */
-
-                testim = testimage[k][ix][2 * iy];
-
-                rev = re * testre + im * testim;
-                imv = re * testim - im * testre;
-
-                /* Find Phase */
-
-                phi = atan2(imv, rev);
-
-                fx2sum += power * fx * fx;
-                fy2sum += power * fy * fy;
-
-                phifxsum += power * fx * phi;
-                phifysum += power * fy * phi;
-
-                fxfysum += power * fx * fy;
+                const Complex t = multiply(twiddle(m_Twiddles[k * step], forward), row[start + k + half]);
+                row[start + k + half] = row[start + k] - t;
+                row[start + k] += t;
             }
         }
     }
-
-    /* calculate subpixel shift */
-
-    dem = fx2sum * fy2sum - fxfysum * fxfysum;
-
-    deltax = (phifxsum * fy2sum - fxfysum * phifysum) / (dem * TWOPI);
-    deltay = (phifysum * fx2sum - fxfysum * phifxsum) / (dem * TWOPI);
-
-    free_matrixSP(speq, 1, 1, 1, 2 * n);
-
-    /* You can change the shift mapping here */
-
-    *xshift = deltax;
-    *yshift = deltay;
 }
 
-// 2 and 3 Dimensional FFT Routine for Real Data
-// Numerical Recipes in C Second Edition
-// The Art of Scientific Computing
-// 1999
-
-void rlft3NR(float ***data, float **speq, unsigned long nn1, unsigned long nn2, unsigned long nn3, long isign)
+void CrossCorrelator::transformColumns(Complex *data, bool forward) const
 {
-    void fournNR(float data[], unsigned long nn[], long ndim, long isign);
-    void nrerror();
-    unsigned long i1, i2, i3, j1, j2, j3, nn[4], ii3;
-    double theta, wpi, wpr, wtemp;
-    float c1, c2, h1r, h1i, h2r, h2i;
-    float wi, wr;
-
-    if ((unsigned long)(1 + &data[nn1][nn2][nn3] - &data[1][1][1]) != nn1 * nn2 * nn3)
-        nrerrorNR();
-    c1    = 0.5;
-    c2    = -0.5 * isign;
-    theta = isign * (6.28318530717959 / nn3);
-    wtemp = sin(0.5 * theta);
-    wpr   = -2.0 * wtemp * wtemp;
-    wpi   = sin(theta);
-    nn[1] = nn1;
-    nn[2] = nn2;
-    nn[3] = nn3 >> 1;
-    if (isign == 1)
+    const int n = m_Size;
+    const size_t width = m_Width;
+
+    // Whole rows are moved and combined at a time, so the inner loops run along contiguous memory
+    for (int j = 0; j < n; j++)
     {
-        fournNR(&data[1][1][1] - 1, nn, 3, isign);
-        for (i1 = 1; i1 <= nn1; i1++)
-            for (i2 = 1, j2 = 0; i2 <= nn2; i2++)
-            {
-                speq[i1][++j2] = data[i1][i2][1];
-                speq[i1][++j2] = data[i1][i2][2];
-            }
+        if (j < m_BitReversed[j])
+            std::swap_ranges(data + j * width, data + (j + 1) * width, data + m_BitReversed[j] * width);
     }
-    for (i1 = 1; i1 <= nn1; i1++)
+
+    for (int length = 2; length <= n; length <<= 1)
     {
-        j1 = (i1 != 1 ? nn1 - i1 + 2 : 1);
-        wr = 1.0;
-        wi = 0.0;
-        for (ii3 = 1, i3 = 1; i3 <= (nn3 >> 2) + 1; i3++, ii3 += 2)
+        const int half = length / 2;
+        const int step = n / length;
+        for (int start = 0; start < n; start += length)
         {
-            for (i2 = 1; i2 <= nn2; i2++)
+            for (int k = 0; k < half; k++)
             {
-                if (i3 == 1)
+                const Complex w = twiddle(m_Twiddles[k * step], forward);
+                Complex *a = data + (start + k) * width;
+                Complex *b = data + (start + k + half) * width;
+                for (size_t i = 0; i < width; i++)
                 {
-                    j2               = (i2 != 1 ? ((nn2 - i2) << 1) + 3 : 1);
-                    h1r              = c1 * (data[i1][i2][1] + speq[j1][j2]);
-                    h1i              = c1 * (data[i1][i2][2] - speq[j1][j2 + 1]);
-                    h2i              = c2 * (data[i1][i2][1] - speq[j1][j2]);
-                    h2r              = -c2 * (data[i1][i2][2] + speq[j1][j2 + 1]);
-                    data[i1][i2][1]  = h1r + h2r;
-                    data[i1][i2][2]  = h1i + h2i;
-                    speq[j1][j2]     = h1r - h2r;
-                    speq[j1][j2 + 1] = h2i - h1i;
-                }
-                else
-                {
-                    j2                    = (i2 != 1 ? nn2 - i2 + 2 : 1);
-                    j3                    = nn3 + 3 - (i3 << 1);
-                    h1r                   = c1 * (data[i1][i2][ii3] + data[j1][j2][j3]);
-                    h1i                   = c1 * (data[i1][i2][ii3 + 1] - data[j1][j2][j3 + 1]);
-                    h2i                   = c2 * (data[i1][i2][ii3] - data[j1][j2][j3]);
-                    h2r                   = -c2 * (data[i1][i2][ii3 + 1] + data[j1][j2][j3 + 1]);
-                    data[i1][i2][ii3]     = h1r + wr * h2r - wi * h2i;
-                    data[i1][i2][ii3 + 1] = h1i + wr * h2i + wi * h2r;
-                    data[j1][j2][j3]      = h1r - wr * h2r + wi * h2i;
-                    data[j1][j2][j3 + 1]  = -h1i + wr * h2i + wi * h2r;
+                    const Complex t = multiply(w, b[i]);
+                    b[i] = a[i] - t;
+                    a[i] += t;
                 }
             }
-            wr = (wtemp = wr) * wpr - wi * wpi + wr;
-            wi = wi * wpr + wtemp * wpi + wi;
         }
     }
-    if (isign == -1)
-        fournNR(&data[1][1][1] - 1, nn, 3, isign);
 }
 
-// Multi-Dimensional FFT Routine for Complex Data
-// Numerical Recipes in C Second Edition
-// The Art of Scientific Computing
-// 1999
-// Used in rlft3
+void CrossCorrelator::forwardTransform(const float *image)
+{
+    const int n = m_Size;
+    const size_t width = m_Width;
+
+    // Transform two real rows at once as the real and imaginary parts of one complex row, then separate them
+    for (int j = 0; j < n; j += 2)
+    {
+        const float *first = image + static_cast<size_t>(j) * n;
+        const float *second = first + n;
+        for (int i = 0; i < n; i++)
+            m_Row[i] = Complex(first[i], second[i]);
+        transformRow(m_Row.data(), true);
+
+        Complex *a = m_Spectrum.data() + j * width;
+        Complex *b = a + width;
+        for (size_t k = 0; k < width; k++)
+        {
+            const Complex z = m_Row[k];
+            const Complex mirror = std::conj(m_Row[(n - k) % n]);
+            const Complex difference = z - mirror;
+            a[k] = 0.5f * (z + mirror);
+            b[k] = 0.5f * Complex(difference.imag(), -difference.real());
+        }
+    }
 
-void fournNR(float data[], unsigned long nn[], long ndim, long isign)
+    transformColumns(m_Spectrum.data(), true);
+}
+
+void CrossCorrelator::findPeak(int *x0, int *y0)
 {
-    long idim;
-    unsigned long i1, i2rev, i3rev, ip1, ip2, ip3, ifp1, ifp2;
-    unsigned long i2, i3;
-    unsigned long ibit, k1 = 0, k2, n, nprev, nrem, ntot;
-    float wi, wr, tempi, tempr;
-    double theta, wpi, wpr, wtemp;
-
-    for (ntot = 1, idim = 1; idim <= ndim; idim++)
-        ntot *= nn[idim];
-    nprev = 1;
-    for (idim = ndim; idim >= 1; idim--)
+    const int n = m_Size;
+    const size_t width = m_Width;
+
+    transformColumns(m_Spectrum.data(), false);
+
+    // Each row is now the Hermitian spectrum of a real row, so two rows are inverted at once
+    float peak = -std::numeric_limits<float>::max();
+    for (int j = 0; j < n; j += 2)
     {
-        n     = nn[idim];
-        nrem  = ntot / (n * nprev);
-        ip1   = nprev << 1;
-        ip2   = ip1 * n;
-        ip3   = ip2 * nrem;
-        i2rev = 1;
-        for (i2 = 1; i2 <= ip2; i2 += ip1)
+        const Complex *a = m_Spectrum.data() + j * width;
+        const Complex *b = a + width;
+        for (size_t k = 0; k < width; k++)
+            m_Row[k] = a[k] + Complex(-b[k].imag(), b[k].real());
+        for (int k = width; k < n; k++)
+            m_Row[k] = std::conj(a[n - k]) + Complex(b[n - k].imag(), b[n - k].real());
+        transformRow(m_Row.data(), false);
+
+        for (int i = 0; i < n; i++)
         {
-            if (i2 < i2rev)
+            if (m_Row[i].real() > peak)
             {
-                for (i1 = i2; i1 <= i2 + ip1 - 2; i1 += 2)
-                {
-                    for (i3 = i1; i3 <= ip3; i3 += ip2)
-                    {
-                        i3rev = i2rev + i3 - i2;
-                        SWAP(data[i3], data[i3rev]);
-                        SWAP(data[i3 + 1], data[i3rev + 1]);
-                    }
-                }
+                peak = m_Row[i].real();
+                *x0 = j;
+                *y0 = i;
             }
-            ibit = ip2 >> 1;
-            while (ibit >= ip1 && i2rev > ibit)
+            if (m_Row[i].imag() > peak)
             {
-                i2rev -= ibit;
-                ibit >>= 1;
+                peak = m_Row[i].imag();
+                *x0 = j + 1;
+                *y0 = i;
             }
-            i2rev += ibit;
         }
-        ifp1 = ip1;
-        while (ifp1 < ip2)
-        {
-            ifp2  = ifp1 << 1;
-            theta = isign * 6.28318530717959 / (ifp2 / ip1);
-            wtemp = sin(0.5 * theta);
-            wpr   = -2.0 * wtemp * wtemp;
-            wpi   = sin(theta);
-            wr    = 1.0;
-            wi    = 0.0;
-            for (i3 = 1; i3 <= ifp1; i3 += ip1)
-            {
-                for (i1 = i3; i1 <= i3 + ip1 - 2; i1 += 2)
-                {
-                    for (i2 = i1; i2 <= ip3; i2 += ifp2)
-                    {
-                        k1           = i2;
-                        k2           = k1 + ifp1;
-                        tempr        = (double)wr * data[k2] - (double)wi * data[k2 + 1];
-                        tempi        = (double)wr * data[k2 + 1] + (double)wi * data[k2];
-                        data[k2]     = data[k1] - tempr;
-                        data[k2 + 1] = data[k1 + 1] - tempi;
-                        data[k1] += tempr;
-                        data[k1 + 1] += tempi;
-                    }
-                }
-                wr = (wtemp = wr) * wpr - wi * wpi + wr;
-                wi = wi * wpr + wtemp * wpi + wi;
-            }
-            ifp1 = ifp2;
-        }
-        nprev *= n;
     }
-}
 
-void nrerrorNR(void)
-{
+    if (*x0 > n / 2)
+        *x0 -= n;
+    if (*y0 > n / 2)
+        *y0 -= n;
 }
 
-// Numerical Recipes memory allocation routines
-// One based arrays
-
-float **matrixSP(long nrl, long nrh, long ncl, long nch)
-/* allocate a float matrix with subscript range m[nrl..nrh][ncl..nch] */
+void CrossCorrelator::refineShift(int x0, int y0, double *deltax, double *deltay) const
 {
-    long i, nrow = nrh - nrl + 1, ncol = nch - ncl + 1;
-    float **m;
-
-    /* allocate pointers to rows */
-    m = (float **)malloc((size_t)((nrow + NR_END) * sizeof(float *)));
-    if (!m)
-        nrerrorNR();
-    m += NR_END;
-    m -= nrl;
-
-    /* allocate rows and set pointers to them */
-    m[nrl] = (float *)malloc((size_t)((nrow * ncol + NR_END) * sizeof(float)));
-    if (!m[nrl])
-        nrerrorNR();
-    m[nrl] += NR_END;
-    m[nrl] -= ncl;
-
-    for (i = nrl + 1; i <= nrh; i++)
-        m[i] = m[i - 1] + ncol;
-
-    /* return pointer to array of pointers to rows */
-    return m;
-}
+    const int n = m_Size;
+    const double ff = 1.0 / n;
+    const double f2limit = FFITMAX * FFITMAX;
+    // Only the lowest frequencies are used
+    const int kmax = std::min(n / 2, static_cast<int>(std::ceil(FFITMAX * n)));
 
-float ***f3tensorSP(long nrl, long nrh, long ncl, long nch, long ndl, long ndh)
-/* allocate a float 3tensor with range t[nrl..nrh][ncl..nch][ndl..ndh] */
-{
-    long i, j, nrow = nrh - nrl + 1, ncol = nch - ncl + 1, ndep = ndh - ndl + 1;
-    float ***t;
-
-    /* allocate pointers to pointers to rows */
-    t = (float ***)malloc((size_t)((nrow + NR_END) * sizeof(float **)));
-    if (!t)
-        nrerrorNR();
-    t += NR_END;
-    t -= nrl;
-
-    /* allocate pointers to rows and set pointers to them */
-    t[nrl] = (float **)malloc((size_t)((nrow * ncol + NR_END) * sizeof(float *)));
-    if (!t[nrl])
-        nrerrorNR();
-    t[nrl] += NR_END;
-    t[nrl] -= ncl;
-
-    /* allocate rows and set pointers to them */
-    t[nrl][ncl] = (float *)malloc((size_t)((nrow * ncol * ndep + NR_END) * sizeof(float)));
-    if (!t[nrl][ncl])
-        nrerrorNR();
-    t[nrl][ncl] += NR_END;
-    t[nrl][ncl] -= ndl;
-
-    for (j = ncl + 1; j <= nch; j++)
-        t[nrl][j] = t[nrl][j - 1] + ndep;
-    for (i = nrl + 1; i <= nrh; i++)
+    double fx2sum = 0, fy2sum = 0, phifxsum = 0, phifysum = 0, fxfysum = 0;
+
+    for (int u = -kmax; u <= kmax; u++)
     {
-        t[i]      = t[i - 1] + ncol;
-        t[i][ncl] = t[i - 1][ncl] + ncol * ndep;
-        for (j = ncl + 1; j <= nch; j++)
-            t[i][j] = t[i][j - 1] + ndep;
+        const double fx = ff * u;
+        const Complex *row = m_Cross.data() + static_cast<size_t>((u + n) % n) * m_Width;
+        const Complex *ref = m_Reference.data() + static_cast<size_t>((u + n) % n) * m_Width;
+
+        for (int v = 0; v <= kmax && v < n / 2; v++)
+        {
+            const double fy = ff * v;
+            const double f2 = fx * fx + fy * fy;
+
+            /* Limit to Low Spatial Frequencies */
+
+            if (f2 >= f2limit)
+                continue;
+
+            const double power = std::norm(ref[v]);
+
+            /* Phase left after removing the integer shift */
+
+            const double shift = -TWOPI * (fx * x0 + fy * y0);
+            const std::complex<double> residual = std::complex<double>(row[v].real(), row[v].imag()) *
+                                                  std::complex<double>(std::cos(shift), std::sin(shift));
+            const double phi = std::arg(residual);
+
+            fx2sum += power * fx * fx;
+            fy2sum += power * fy * fy;
+
+            phifxsum += power * fx * phi;
+            phifysum += power * fy * phi;
+
+            fxfysum += power * fx * fy;
+        }
     }
 
-    /* return pointer to array of pointers to rows */
-    return t;
-}
+    /* calculate subpixel shift */
 
-void free_matrixSP(float **m, long nrl, long nrh, long ncl, long nch)
-/* free a float matrix allocated by matrix() */
-{
-    Q_UNUSED(nrh);
-    Q_UNUSED(nch);
-    free((FREE_ARG)(m[nrl] + ncl - NR_END));
-    free((FREE_ARG)(m + nrl - NR_END));
-}
+    const double dem = fx2sum * fy2sum - fxfysum * fxfysum;
+    if (dem <= 0)
+    {
+        *deltax = 0;
+        *deltay = 0;
+        return;
+    }
 
-void free_f3tensorSP(float ***t, long nrl, long nrh, long ncl, long nch, long ndl, long ndh)
-/* free a float f3tensor allocated by f3tensor() */
-{
-    Q_UNUSED(nrh);
-    Q_UNUSED(nch);
-    Q_UNUSED(ndh);
-    free((FREE_ARG)(t[nrl][ncl] + ndl - NR_END));
-    free((FREE_ARG)(t[nrl] + ncl - NR_END));
-    free((FREE_ARG)(t + nrl - NR_END));
+    *deltax = (phifxsum * fy2sum - fxfysum * phifysum) / (dem * TWOPI);
+    *deltay = (phifysum * fx2sum - fxfysum * phifxsum) / (dem * TWOPI);
+}
 }
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <complex>
+#include <vector>
+
 // Robert Majewski
 
 // ImageAutoGuiding1 is self contained
@@ -19,7 +22,87 @@
 // 256 X 256 is A good Choice
 // These should be portions of the camera imagery
 
+// xshift is the shift along the rows of the images (the slow index), yshift along the columns
+
 namespace ImageAutoGuiding
 {
+// Transforms both ref and im on every call, only the FFT tables and work buffers are reused between calls
+// of the same size. To guide on a series of frames against one reference, keep a CrossCorrelator, set the
+// reference once and call findShift() per frame.
 void ImageAutoGuiding1(float *ref, float *im, int n, float *xshift, float *yshift);
+
+/**
+ * @class CrossCorrelator
+ * @brief Estimates the shift of guide images relative to a reference image.
+ *
+ * The FFT twiddle and bit reversal tables, the work buffers and the spectrum of the reference are all kept
+ * between calls, so each new guide frame only costs one forward and one inverse FFT and no allocations.
+ *
+ * The integer shift is the peak of the phase correlation of the two images. It is refined to sub-pixel
+ * accuracy by a power weighted fit of the slope of the residual phase difference at low spatial frequencies.
+ */
+class CrossCorrelator
+{
+    public:
+        /**
+         * @param n width and height of the images, which must be a power of 2
+         */
+        explicit CrossCorrelator(int n);
+
+        /**
+         * @return width and height of the images, or 0 if the size given wasn't a power of 2
+         */
+        int size() const
+        {
+            return m_Size;
+        }
+
+        /**
+         * @brief Transform and keep the reference image
+         * @param ref n x n row major image
+         * @return false if the size isn't valid
+         */
+        bool setReference(const float *ref);
+
+        bool hasReference() const
+        {
+            return m_HasReference;
+        }
+
+        /**
+         * @brief Estimate the shift of an image relative to the reference
+         * @param im n x n row major image
+         * @param xshift returned shift along the rows
+         * @param yshift returned shift along the columns
+         * @return false if there is no reference
+         */
+        bool findShift(const float *im, float *xshift, float *yshift);
+
+    private:
+        typedef std::complex<float> Complex;
+
+        // Transforms use the exp(+i) convention of the original Numerical Recipes code for the forward direction
+        void transformRow(Complex *row, bool forward) const;
+        void transformColumns(Complex *data, bool forward) const;
+        // Spectrum of a real image into m_Spectrum
+        void forwardTransform(const float *image);
+        // Position of the largest value of the real inverse transform of m_Spectrum, which is overwritten
+        void findPeak(int *x0, int *y0);
+        // Sub-pixel shift from the phase of the cross spectrum, after removing the integer shift
+        void refineShift(int x0, int y0, double *deltax, double *deltay) const;
+
+        int m_Size { 0 };
+        // The spectra of real images are Hermitian, so only columns 0 to n/2 are kept
+        int m_Width { 0 };
+        // FFT plan for the size
+        std::vector<int> m_BitReversed;
+        std::vector<Complex> m_Twiddles;
+        // Work buffers, n and n x m_Width
+        std::vector<Complex> m_Row;
+        std::vector<Complex> m_Spectrum;
+        std::vector<Complex> m_Reference;
+        // Cross spectrum of the reference and the latest image
+        std::vector<Complex> m_Cross;
+        bool m_HasReference { false };
+};
 }
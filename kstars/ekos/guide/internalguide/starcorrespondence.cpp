@@ -6,88 +6,24 @@
 
 #include "starcorrespondence.h"
 
+#include <algorithm>
 #include <math.h>
+#include <numeric>
 #include "ekos_guide_debug.h"
 #include "Options.h"
 
-// Finds the star in sortedStars that's closest to x,y and within maxDistance pixels.
-// Returns the index of the closest star in  sortedStars, or -1 if none satisfies the criteria.
-// sortedStars must be sorted by x, from lower x to higher x.
+// Finds the star in starGrid that's closest to x,y and within maxDistance pixels.
+// Returns the index of the closest star, or -1 if none satisfies the criteria.
 // Fills distance to the pixel distance to the closest star.
-int StarCorrespondence::findClosestStar(double x, double y, const QList<Edge> sortedStars,
-                                        double maxDistance, double *distance) const
+int StarCorrespondence::findClosestStar(double x, double y, double maxDistance, double *distance) const
 {
     if (x < -maxDistance || y < -maxDistance ||
-            x > imageWidth + maxDistance || y > imageWidth + maxDistance)
+            x > imageWidth + maxDistance || y > imageHeight + maxDistance)
         return -1;
 
-    const int size = sortedStars.size();
-    int startPoint = 0;
-
-    // Efficiency improvement to quickly find the start point.
-    // Increments by size/10 to find a better start point.
-    const int coarseIncrement = size / 10;
-    if (coarseIncrement > 1)
-    {
-        for (int i = 0; i < size; i += coarseIncrement)
-        {
-            if (sortedStars[i].x < x - maxDistance)
-                startPoint = i;
-            else
-                break;
-        }
-    }
-
-    // Iterate through the stars starting with the star with lowest x where x >= x - maxDistance
-    // through the star with greatest x where x <= x + maxDistance.  Find the closest star to x,y.
-    int bestIndex = -1;
-    double bestSquaredDistance = maxDistance * maxDistance;
-    for (int i = startPoint; i < size; ++i)
-    {
-        auto &star = sortedStars[i];
-        if (star.x < x - maxDistance) continue;
-        if (star.x > x + maxDistance) break;
-        const double xDiff = star.x - x;
-        const double yDiff = star.y - y;
-        const double squaredDistance = xDiff * xDiff + yDiff * yDiff;
-        if (squaredDistance <= bestSquaredDistance)
-        {
-            bestIndex = i;
-            bestSquaredDistance = squaredDistance;
-        }
-    }
-    if (distance != nullptr) *distance = sqrt(bestSquaredDistance);
-    return bestIndex;
+    return starGrid.findClosest(x, y, maxDistance, distance);
 }
 
-namespace
-{
-// Sorts stars by their x values, places the sorted stars into sortedStars.
-// sortedToOriginal is a map whose index is the index of a star in sortedStars and whose
-// value is the index of a star in stars.
-// Therefore, sortedToOrigial[a] = b, means that sortedStars[a] corresponds to stars[b].
-void sortByX(const QList<Edge> &stars, QList<Edge> *sortedStars, QVector<int> *sortedToOriginal)
-{
-    sortedStars->clear();
-    sortedToOriginal->clear();
-
-    // Sort the stars by their x-positions, lower to higher.
-    QVector<std::pair<int, float>> rx;
-    for (int i = 0; i < stars.size(); ++i)
-        rx.push_back(std::pair<int, float>(i, stars[i].x));
-    std::sort(rx.begin(), rx.end(), [](const std::pair<int, float> &a, const std::pair<int, double> &b)
-    {
-        return a.second < b.second;
-    });
-    for (int i = 0; i < stars.size(); ++i)
-    {
-        sortedStars->append(stars[ rx[i].first ]);
-        sortedToOriginal->push_back(rx[i].first);
-    }
-}
-
-}  // namespace
-
 StarCorrespondence::StarCorrespondence(const QList<Edge> &stars, int guideStar)
 {
     initialize(stars, guideStar);
@@ -122,6 +58,7 @@ void StarCorrespondence::initialize(const QList<Edge> &stars, int guideStar)
 
     initializeAdaptation();
 
+    havePrediction = false;
     initialized = true;
 }
 
@@ -131,12 +68,14 @@ void StarCorrespondence::reset()
     guideStarOffsets.clear();
     referenceSums.clear();
     referenceNumPixels.clear();
+    havePrediction = false;
     initialized = false;
 }
 
 int StarCorrespondence::findInternal(const QList<Edge> &stars, double maxDistance, QVector<int> *starMap,
                                      int guideStarIndex, const QVector<Offsets> &offsets,
-                                     int *numFound, int *numNotFound, double minFraction) const
+                                     int *numFound, int *numNotFound, double minFraction,
+                                     const Offsets *predicted) const
 {
     // This is the cost of not finding one of the reference stars.
     constexpr double missingRefStarCost = 100;
@@ -152,7 +91,7 @@ int StarCorrespondence::findInternal(const QList<Edge> &stars, double maxDistanc
     // E.g. that the more likely solution is one where the stars are close to the references.
     // This can be an issue if the number of input stars is way less than the number of reference stars
     // but in that case we can fail and go to the default star-finding algorithm.
-    int bestCost = offsets.size() * missingRefStarCost * (1 - minFraction);
+    double bestCost = offsets.size() * missingRefStarCost * (1 - minFraction);
     // Note that the above implies that if stars.size() < offsets.size() * minFraction
     // then it is impossible to succeed.
     if (stars.size() < minFraction * offsets.size())
@@ -160,15 +99,37 @@ int StarCorrespondence::findInternal(const QList<Edge> &stars, double maxDistanc
 
     // Assume the guide star corresponds to each of the stars.
     // Score the assignment, pick the best, and then assign the rest.
+    // Stars near the predicted position are tried first. The right one gives a low cost,
+    // after which the others are abandoned as soon as one of their references is missing.
     const int numStars = stars.size();
+    QVector<int> candidates(numStars);
+    std::iota(candidates.begin(), candidates.end(), 0);
+    if (predicted != nullptr)
+    {
+        QVector<double> squaredDistances(numStars);
+        for (int i = 0; i < numStars; ++i)
+        {
+            const double xDiff = stars[i].x - predicted->x;
+            const double yDiff = stars[i].y - predicted->y;
+            squaredDistances[i] = xDiff * xDiff + yDiff * yDiff;
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [&squaredDistances](int a, int b)
+        {
+            return squaredDistances[a] < squaredDistances[b];
+        });
+    }
+
     int bestStarIndex = -1, bestNumFound = 0, bestNumNotFound = 0;
-    for (int starIndex = 0; starIndex < numStars; ++starIndex)
+    // Pairs of the star index and the reference index it was mapped to.
+    QVector<std::pair<int, int>> mapping;
+    mapping.reserve(offsets.size());
+    for (const int starIndex : candidates)
     {
         const float starX = stars[starIndex].x;
         const float starY = stars[starIndex].y;
 
         double cost = 0.0;
-        QVector<int> mapping(stars.size(), -1);
+        mapping.clear();
         int numFound = 0, numNotFound = 0;
         for (int offsetIndex = 0; offsetIndex < offsets.size(); ++offsetIndex)
         {
@@ -179,11 +140,9 @@ int StarCorrespondence::findInternal(const QList<Edge> &stars, double maxDistanc
             if (cost > bestCost) break;
 
             // Look for an input star at the offset position.
-            // Note the index value returned is the sorted index, which is converted back later.
             const auto &offset = offsets[offsetIndex];
             double distance;
-            const int closestIndex = findClosestStar(starX + offset.x, starY + offset.y,
-                                     stars, maxDistance, &distance);
+            const int closestIndex = findClosestStar(starX + offset.x, starY + offset.y, maxDistance, &distance);
             if (closestIndex < 0)
             {
                 // This reference star position had no corresponding input star.
@@ -195,10 +154,11 @@ int StarCorrespondence::findInternal(const QList<Edge> &stars, double maxDistanc
 
             // If starIndex is the star that corresponds to guideStarIndex, then
             // stars[index] corresponds to references[offsetIndex]
-            mapping[closestIndex] = offsetIndex;
+            mapping.push_back(std::make_pair(closestIndex, offsetIndex));
             cost += distance * distanceWeight;
         }
-        if (cost < bestCost)
+        // Break ties in favor of the lower index, as if the stars were tried in order.
+        if (cost < bestCost || (cost == bestCost && bestStarIndex >= 0 && starIndex < bestStarIndex))
         {
             bestCost = cost;
             bestStarIndex = starIndex;
@@ -206,8 +166,8 @@ int StarCorrespondence::findInternal(const QList<Edge> &stars, double maxDistanc
             bestNumNotFound = numNotFound;
 
             *starMap = QVector<int>(stars.size(), -1);
-            for (int i = 0; i < mapping.size(); ++i)
-                (*starMap)[i] = mapping[i];
+            for (const auto &m : mapping)
+                (*starMap)[m.first] = m.second;
             (*starMap)[starIndex] = guideStarIndex;
         }
     }
@@ -306,17 +266,6 @@ Edge StarCorrespondence::inventStarPosition(const QList<Edge> &stars, const QVec
     return inventedStar;
 }
 
-namespace
-{
-// This utility converts the starMap to refer to indexes in the original star QVector
-// instead of the sorted-by-x version.
-void unmapStarMap(const QVector<int> &sortedStarMap, const QVector<int> &sortedToOriginal, QVector<int> *starMap)
-{
-    for (int i = 0; i < sortedStarMap.size(); ++i)
-        (*starMap)[sortedToOriginal[i]] = sortedStarMap[i];
-}
-}
-
 Edge StarCorrespondence::find(const QList<Edge> &stars, double maxDistance,
                               QVector<int> *starMap, bool adapt, double minFraction)
 {
@@ -327,11 +276,9 @@ Edge StarCorrespondence::find(const QList<Edge> &stars, double maxDistance,
     if (!initialized)  return foundStar;
     int numFound = 0, numNotFound = 0;
 
-    // findClosestStar needs an input with stars sorted by their x.
-    // Do this outside of the loops.
-    QList<Edge> sortedStars;
-    QVector<int> sortedToOriginal;
-    sortByX(stars, &sortedStars, &sortedToOriginal);
+    // findClosestStar searches this index of the stars. Build it outside of the loops.
+    starGrid.build(stars, maxDistance);
+    const Offsets *predicted = havePrediction ? &lastGuideStar : nullptr;
 
     const bool alwaysInvent = Options::alwaysInventGuideStar() &&
                               stars.size() >= minFraction * guideStarOffsets.size();
@@ -341,18 +288,15 @@ Edge StarCorrespondence::find(const QList<Edge> &stars, double maxDistance,
                 .arg(minFraction, 0, 'f', 2).arg(guideStarOffsets.size()).arg(minFraction * guideStarOffsets.size(), 0, 'f', 1);
     const bool canInvent = allowMissingGuideStar && stars.size() >= minFraction * guideStarOffsets.size();
 
-    QVector<int> sortedStarMap;
     int bestStarIndex =
-        alwaysInvent ? -1 : findInternal(sortedStars, maxDistance, &sortedStarMap, guideStarIndex,
-                                         guideStarOffsets, &numFound, &numNotFound, minFraction);
+        alwaysInvent ? -1 : findInternal(stars, maxDistance, starMap, guideStarIndex,
+                                         guideStarOffsets, &numFound, &numNotFound, minFraction, predicted);
 
     if (!alwaysInvent && bestStarIndex > -1)
     {
-        // Convert back to the unsorted index value.
-        bestStarIndex = sortedToOriginal[bestStarIndex];
-        unmapStarMap(sortedStarMap, sortedToOriginal, starMap);
-
         foundStar = stars[bestStarIndex];
+        lastGuideStar = Offsets(foundStar.x, foundStar.y);
+        havePrediction = true;
         qCDebug(KSTARS_EKOS_GUIDE)
                 << "StarCorrespondence found guideStar at " << bestStarIndex << "found/not"
                 << numFound << numNotFound;
@@ -376,6 +320,7 @@ Edge StarCorrespondence::find(const QList<Edge> &stars, double maxDistance,
         int bestNumNotFound = 0;
         Edge bestInvented;
         bestInvented.invalidate();
+        QVector<int> bestStarMap;
         // For each reference star, pretend it was the guide star by using makeOffsets() to convert the
         // original guide-star's offsets to new offsets relative to that reference star.
         // Then, using findInternal(), map the detected stars to the reference stars.
@@ -390,13 +335,19 @@ Edge StarCorrespondence::find(const QList<Edge> &stars, double maxDistance,
                 continue;
             QVector<Offsets> gStarOffsets;
             makeOffsets(guideStarOffsets, &gStarOffsets, gStarIndex);
+            // This reference star is expected at the same offset from the last guide star position.
+            Offsets gStarPrediction;
+            if (predicted != nullptr)
+                gStarPrediction = Offsets(predicted->x + guideStarOffsets[gStarIndex].x,
+                                          predicted->y + guideStarOffsets[gStarIndex].y);
             QVector<int> newStarMap;
-            int detectedStarIndex = findInternal(sortedStars, maxDistance, &newStarMap,
+            int detectedStarIndex = findInternal(stars, maxDistance, &newStarMap,
                                                  gStarIndex, gStarOffsets,
-                                                 &numFound, &numNotFound, minFraction);
+                                                 &numFound, &numNotFound, minFraction,
+                                                 predicted != nullptr ? &gStarPrediction : nullptr);
             if (detectedStarIndex >= 0 && numFound > bestNumFound)
             {
-                Edge invented = inventStarPosition(sortedStars, newStarMap, gStarOffsets,
+                Edge invented = inventStarPosition(stars, newStarMap, gStarOffsets,
                                                    guideStarOffsets[gStarIndex]);
                 if (invented.x < 0 || invented.y < 0)
                     continue;
@@ -404,7 +355,7 @@ Edge StarCorrespondence::find(const QList<Edge> &stars, double maxDistance,
                 bestInvented = invented;
                 bestNumFound = numFound;
                 bestNumNotFound = numNotFound;
-                sortedStarMap = newStarMap;
+                bestStarMap = newStarMap;
 
                 // If enough of the references were found to reliably estimate the guide-star position
                 // then we can break out of the loop. Nothing special about 7, just a guess.
@@ -414,8 +365,9 @@ Edge StarCorrespondence::find(const QList<Edge> &stars, double maxDistance,
         }
         if (bestNumFound > 0)
         {
-            // Convert back to the unsorted index value.
-            unmapStarMap(sortedStarMap, sortedToOriginal, starMap);
+            *starMap = bestStarMap;
+            lastGuideStar = Offsets(bestInvented.x, bestInvented.y);
+            havePrediction = true;
             qCDebug(KSTARS_EKOS_GUIDE)
                     << "StarCorrespondence found guideStar (invented) at "
                     << bestInvented.x << bestInvented.y << "found/not" << bestNumFound << bestNumNotFound;
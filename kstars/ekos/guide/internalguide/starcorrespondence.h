@@ -12,6 +12,7 @@
 #include <QVector2D>
 
 #include "fitsviewer/fitsdata.h"
+#include "stargrid.h"
 #include "vect.h"
 
 /*
@@ -111,9 +112,12 @@ class StarCorrespondence
         void adaptOffsets(const QList<Edge> &stars, const QVector<int> &starMap, double x, double y);
 
         // Utility used by find. Useful for iterating when the guide star is missing.
+        // If predicted isn't null, it is where the guide star is expected to be, and the stars
+        // closest to it are tried first.
         int findInternal(const QList<Edge> &stars, double maxDistance, QVector<int> *starMap,
                          int guideStarIndex, const QVector<Offsets> &offsets,
-                         int *numFound, int *numNotFound, double minFraction) const;
+                         int *numFound, int *numNotFound, double minFraction,
+                         const Offsets *predicted = nullptr) const;
 
         // Used to when guide star is missing. Creates offsets as if other stars were the guide star.
         void makeOffsets(const QVector<Offsets> &offsets, QVector<Offsets> *targetOffsets, int targetStar) const;
@@ -127,10 +131,8 @@ class StarCorrespondence
         Edge inventStarPosition(const QList<Edge> &stars, const QVector<int> &starMap,
                                 const QVector<Offsets> &offsets, const Offsets &offset) const;
 
-        // Finds the star closest to x,y. Returns the index in sortedStars.
-        // sortedStars should be sorted in x, which allows for a speedup in search.
-        int findClosestStar(double x, double y, const QList<Edge> sortedStars,
-                            double maxDistance, double *distance) const;
+        // Finds the star closest to x,y in the stars indexed in starGrid. Returns its index.
+        int findClosestStar(double x, double y, double maxDistance, double *distance) const;
 
         // The offsets of the reference stars relative to the guide star.
         QVector<Offsets> guideStarOffsets;
@@ -159,5 +161,13 @@ class StarCorrespondence
 
         // A copy of the original reference offsets used so that the values don't move too far.
         QVector<Offsets> originalGuideStarOffsets;
+
+        // Spatial index of the input stars, rebuilt on each call to find().
+        StarGrid starGrid;
+
+        // Guide star position found by the last successful call to find(). The guide star
+        // rarely moves much between frames, so it is used to predict where to look next.
+        bool havePrediction { false };
+        Offsets lastGuideStar;
 };
 
@@ -0,0 +1,165 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "stargrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+void StarGrid::build(const QList<Edge> &stars, double cellSize)
+{
+    m_X.resize(stars.size());
+    m_Y.resize(stars.size());
+    for (int i = 0; i < stars.size(); ++i)
+    {
+        m_X[i] = stars[i].x;
+        m_Y[i] = stars[i].y;
+    }
+    buildCells(cellSize);
+}
+
+void StarGrid::build(const QList<Edge *> &stars, double cellSize)
+{
+    m_X.resize(stars.size());
+    m_Y.resize(stars.size());
+    for (int i = 0; i < stars.size(); ++i)
+    {
+        m_X[i] = stars[i]->x;
+        m_Y[i] = stars[i]->y;
+    }
+    buildCells(cellSize);
+}
+
+void StarGrid::buildCells(double cellSize)
+{
+    const int numStars = m_X.size();
+    m_CellStart.clear();
+    m_Indices.clear();
+    m_Columns = 0;
+    m_Rows = 0;
+    if (numStars == 0)
+        return;
+
+    const auto xRange = std::minmax_element(m_X.begin(), m_X.end());
+    const auto yRange = std::minmax_element(m_Y.begin(), m_Y.end());
+    m_MinX = *xRange.first;
+    m_MinY = *yRange.first;
+    const double width = *xRange.second - m_MinX;
+    const double height = *yRange.second - m_MinY;
+
+    // Roughly one star per cell if the caller has no preference.
+    if (cellSize <= 0)
+        cellSize = std::sqrt(width * height / numStars);
+    // Don't let a small search distance on a large, sparse field make a huge grid.
+    const double maxCells = 4.0 * numStars + 16;
+    m_CellSize = std::max({cellSize, std::sqrt(width * height / maxCells), 1.0});
+    while ((std::floor(width / m_CellSize) + 1) * (std::floor(height / m_CellSize) + 1) > maxCells)
+        m_CellSize *= 1.25;
+    m_Columns = std::floor(width / m_CellSize) + 1;
+    m_Rows = std::floor(height / m_CellSize) + 1;
+
+    // Counting sort of the stars by cell.
+    std::vector<int> cells(numStars);
+    m_CellStart.assign(m_Columns * m_Rows + 1, 0);
+    for (int i = 0; i < numStars; ++i)
+    {
+        cells[i] = row(m_Y[i]) * m_Columns + column(m_X[i]);
+        m_CellStart[cells[i] + 1]++;
+    }
+    for (int c = 0; c < m_Columns * m_Rows; ++c)
+        m_CellStart[c + 1] += m_CellStart[c];
+    m_Indices.resize(numStars);
+    std::vector<int> next(m_CellStart.begin(), m_CellStart.end() - 1);
+    for (int i = 0; i < numStars; ++i)
+        m_Indices[next[cells[i]]++] = i;
+}
+
+int StarGrid::column(double x) const
+{
+    // Clamp before converting so positions far outside the grid can't overflow.
+    return std::max(-1.0, std::min<double>(m_Columns, std::floor((x - m_MinX) / m_CellSize)));
+}
+
+int StarGrid::row(double y) const
+{
+    return std::max(-1.0, std::min<double>(m_Rows, std::floor((y - m_MinY) / m_CellSize)));
+}
+
+void StarGrid::searchCell(int cell, double x, double y, int exclude, int *bestIndex,
+                          double *bestSquaredDistance) const
+{
+    for (int k = m_CellStart[cell]; k < m_CellStart[cell + 1]; ++k)
+    {
+        const int i = m_Indices[k];
+        if (i == exclude)
+            continue;
+        const double xDiff = m_X[i] - x;
+        const double yDiff = m_Y[i] - y;
+        const double squaredDistance = xDiff * xDiff + yDiff * yDiff;
+        if (squaredDistance < *bestSquaredDistance ||
+                (squaredDistance == *bestSquaredDistance && i > *bestIndex))
+        {
+            *bestIndex = i;
+            *bestSquaredDistance = squaredDistance;
+        }
+    }
+}
+
+int StarGrid::findClosest(double x, double y, double maxDistance, double *distance) const
+{
+    if (m_Columns == 0)
+        return -1;
+
+    const int firstColumn = std::max(0, column(x - maxDistance));
+    const int lastColumn = std::min(m_Columns - 1, column(x + maxDistance));
+    const int firstRow = std::max(0, row(y - maxDistance));
+    const int lastRow = std::min(m_Rows - 1, row(y + maxDistance));
+
+    int bestIndex = -1;
+    double bestSquaredDistance = maxDistance * maxDistance;
+    for (int r = firstRow; r <= lastRow; ++r)
+        for (int c = firstColumn; c <= lastColumn; ++c)
+            searchCell(r * m_Columns + c, x, y, -1, &bestIndex, &bestSquaredDistance);
+
+    if (distance != nullptr) *distance = std::sqrt(bestSquaredDistance);
+    return bestIndex;
+}
+
+double StarGrid::nearestNeighborDistance(int index) const
+{
+    double bestSquaredDistance = 1e10;
+    if (index < 0 || index >= size())
+        return std::sqrt(bestSquaredDistance);
+
+    const double x = m_X[index];
+    const double y = m_Y[index];
+    const int starColumn = column(x);
+    const int starRow = row(y);
+    int bestIndex = -1;
+
+    // Search rings of cells around the star's cell. Stars beyond ring k are at least
+    // k cells away, so stop once the closest star found is nearer than that.
+    const int maxRing = std::max(m_Columns, m_Rows);
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        for (int r = starRow - ring; r <= starRow + ring; ++r)
+        {
+            if (r < 0 || r >= m_Rows)
+                continue;
+            const bool edgeRow = (r == starRow - ring || r == starRow + ring);
+            const int step = edgeRow ? 1 : std::max(1, 2 * ring);
+            for (int c = starColumn - ring; c <= starColumn + ring; c += step)
+            {
+                if (c >= 0 && c < m_Columns)
+                    searchCell(r * m_Columns + c, x, y, index, &bestIndex, &bestSquaredDistance);
+            }
+        }
+        const double searched = ring * m_CellSize;
+        if (bestIndex >= 0 && bestSquaredDistance <= searched * searched)
+            break;
+    }
+    return std::sqrt(bestSquaredDistance);
+}
@@ -0,0 +1,70 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QList>
+
+#include <vector>
+
+#include "fitsviewer/fitsdata.h"
+
+/*
+ * A uniform grid over a set of star positions, used to find the stars near a position
+ * without scanning all of them. It is cheap to build, so it is meant to be rebuilt for
+ * every guide frame. The stars are bucketed by cell with a counting sort, so building is
+ * linear in the number of stars and a search only visits the cells it overlaps.
+ */
+class StarGrid
+{
+    public:
+        StarGrid() {}
+
+        // Indexes the positions of stars. Cells are cellSize pixels square. If cellSize is 0,
+        // it is chosen from the density of the stars. The number of cells is limited to a few
+        // per star, so cells may be larger than requested for sparse fields.
+        void build(const QList<Edge> &stars, double cellSize = 0);
+        void build(const QList<Edge *> &stars, double cellSize = 0);
+
+        int size() const
+        {
+            return m_X.size();
+        }
+
+        // Returns the index of the star closest to x,y that is at most maxDistance away,
+        // or -1 if there is none. If several stars are equally close, the one with the
+        // highest index is returned. Fills distance with the distance to that star.
+        int findClosest(double x, double y, double maxDistance, double *distance = nullptr) const;
+
+        // Returns the distance from the star at index to the closest other star,
+        // or 1e5 if there are no other stars.
+        double nearestNeighborDistance(int index) const;
+
+    private:
+        void buildCells(double cellSize);
+
+        // Cell coordinates of a position, which may be outside the grid.
+        int column(double x) const;
+        int row(double y) const;
+
+        // Updates bestIndex and bestSquaredDistance with the stars in a cell, skipping exclude.
+        void searchCell(int cell, double x, double y, int exclude, int *bestIndex, double *bestSquaredDistance) const;
+
+        // Star positions, in the order given to build().
+        std::vector<float> m_X;
+        std::vector<float> m_Y;
+
+        double m_MinX { 0 };
+        double m_MinY { 0 };
+        double m_CellSize { 1 };
+        int m_Columns { 0 };
+        int m_Rows { 0 };
+
+        // The stars in cell c are m_Indices[m_CellStart[c]] to m_Indices[m_CellStart[c + 1] - 1],
+        // in increasing order. Cells are numbered row by row.
+        std::vector<int> m_CellStart;
+        std::vector<int> m_Indices;
+};
@@ -3429,6 +3429,9 @@ void Manager::connectModules()
 
             connect(guideModule(), &Ekos::Guide::guideStats,
                     analyzeProcess.get(), &Ekos::Analyze::guideStats, Qt::UniqueConnection);
+
+            connect(guideModule(), &Ekos::Guide::guideLatency,
+                    analyzeProcess.get(), &Ekos::Analyze::guideLatency, Qt::UniqueConnection);
         }
     }
 
@@ -306,10 +306,10 @@ static CatObjType catObjTypes[MAX_CAT_OBJ_TYPES] =
 };
 
 // Live Stacking
-typedef enum { LS_ALIGNMENT_PLATE_SOLVE, LS_ALIGNMENT_NONE } LiveStackAlignMethod;
+typedef enum { LS_ALIGNMENT_PLATE_SOLVE, LS_ALIGNMENT_NONE, LS_ALIGNMENT_STARS } LiveStackAlignMethod;
 typedef enum { LS_DOWNSCALE_NONE, LS_DOWNSCALE_2X, LS_DOWNSCALE_3X, LS_DOWNSCALE_4X } LiveStackDownscale;
 typedef enum { LS_STACKING_EQUAL, LS_STACKING_HFR, LS_STACKING_NUM_STARS } LiveStackFrameWeighting;
-typedef enum { LS_STACKING_REJ_NONE, LS_STACKING_REJ_SIGMA, LS_STACKING_REJ_WINDSOR } LiveStackRejection;
+typedef enum { LS_STACKING_REJ_NONE, LS_STACKING_REJ_SIGMA, LS_STACKING_REJ_WINDSOR, LS_STACKING_REJ_LINEAR_FIT } LiveStackRejection;
 
 typedef struct
 {
@@ -335,5 +335,7 @@ typedef struct
     double lowSigma;
     double highSigma;
     double windsorCutoff;
+    bool tiled;
+    int tileRows;
     LiveStackPPData postProcessing;
 } LiveStackData;
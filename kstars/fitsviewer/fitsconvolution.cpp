@@ -0,0 +1,268 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsconvolution.h"
+
+#include <fitsio.h>
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace
+{
+// Rows smaller than this many pixels are processed together in one band
+const uint32_t minBandPixels = 1 << 16;
+// The separable passes keep the horizontal pass of a band in scratch rows of at most about this many pixels
+const uint32_t maxBandPixels = 1 << 20;
+// Width of the column tiles of the vertical pass, whose sums are kept in cache
+const uint32_t tileWidth = 2048;
+
+// 8 and 16 bit pixels and floats are summed in single precision, which is exact enough and twice as wide in SIMD
+template <typename T>
+using Accumulator = typename std::conditional < sizeof(T) <= 2 || std::is_same<T, float>::value, float, double >::type;
+
+// Split rows into roughly equal bands, one per thread, and more if needed to keep them to maxRows rows
+std::vector<std::pair<uint32_t, uint32_t>> bands(const uint32_t width, const uint32_t height,
+        const uint32_t maxRows = std::numeric_limits<uint32_t>::max())
+{
+    uint32_t numBands = std::max(1u, std::min({ static_cast<uint32_t>(QThread::idealThreadCount()), height,
+                                 static_cast<uint32_t>(static_cast<uint64_t>(width) * height / minBandPixels) }));
+    numBands = std::min(height, std::max(numBands, (height + maxRows - 1) / maxRows));
+    const uint32_t stride = height / numBands;
+    std::vector<std::pair<uint32_t, uint32_t>> result;
+    for (uint32_t i = 0; i < numBands; i++)
+        result.push_back(std::make_pair(i * stride, (i == numBands - 1) ? height : (i + 1) * stride));
+    return result;
+}
+
+template <typename T, typename A>
+inline T toPixel(const A value)
+{
+    if (std::is_floating_point<T>::value)
+        return static_cast<T>(value);
+    // Round integers, and clamp them to the range of the type
+    const A rounded = std::nearbyint(value);
+    if (rounded <= static_cast<A>(std::numeric_limits<T>::lowest()))
+        return std::numeric_limits<T>::lowest();
+    if (rounded >= static_cast<A>(std::numeric_limits<T>::max()))
+        return std::numeric_limits<T>::max();
+    return static_cast<T>(rounded);
+}
+
+// Add weight * input[x + shift] to output[x] for every x where the input is within the row
+template <typename T, typename A>
+inline void addShifted(const T *input, A *output, const uint32_t width, const int shift, const A weight)
+{
+    const int64_t start = std::max<int64_t>(0, -shift);
+    const int64_t end = std::min<int64_t>(width, static_cast<int64_t>(width) - shift);
+    for (int64_t x = start; x < end; x++)
+        output[x] += weight * static_cast<A>(input[x + shift]);
+}
+}
+
+bool FITSConvolution::convolve(const uint8_t *source, uint8_t *destination, const uint32_t dataType,
+                               const uint32_t width, const uint32_t height, const int channels, const std::vector<double> &kernel, const int size)
+{
+    if (size < 1 || size % 2 == 0 || kernel.size() != static_cast<size_t>(size * size))
+        return false;
+
+    std::vector<double> column, row;
+    const bool separable = separate(kernel, size, column, row);
+    const uint32_t samples = width * height;
+
+    for (int n = 0; n < channels; n++)
+    {
+        switch (dataType)
+        {
+#define FITS_CONVOLVE(T) \
+            if (separable) \
+                convolveSeparable(reinterpret_cast<const T *>(source) + n * samples, \
+                                  reinterpret_cast<T *>(destination) + n * samples, width, height, column, row); \
+            else \
+                convolveDense(reinterpret_cast<const T *>(source) + n * samples, \
+                              reinterpret_cast<T *>(destination) + n * samples, width, height, kernel, size); \
+            break;
+
+            case TBYTE:
+                FITS_CONVOLVE(uint8_t)
+            case TSHORT:
+                FITS_CONVOLVE(int16_t)
+            case TUSHORT:
+                FITS_CONVOLVE(uint16_t)
+            case TLONG:
+                FITS_CONVOLVE(int32_t)
+            case TULONG:
+                FITS_CONVOLVE(uint32_t)
+            case TFLOAT:
+                FITS_CONVOLVE(float)
+            case TLONGLONG:
+                FITS_CONVOLVE(int64_t)
+            case TDOUBLE:
+                FITS_CONVOLVE(double)
+#undef FITS_CONVOLVE
+
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool FITSConvolution::separate(const std::vector<double> &kernel, const int size, std::vector<double> &column,
+                               std::vector<double> &row)
+{
+    if (kernel.size() != static_cast<size_t>(size * size))
+        return false;
+
+    // Take the row and column through the largest value as the factors
+    const auto pivot = std::max_element(kernel.begin(), kernel.end(), [](double a, double b)
+    {
+        return std::fabs(a) < std::fabs(b);
+    });
+    const double largest = std::fabs(*pivot);
+    if (largest == 0)
+        return false;
+    const int pivotRow = (pivot - kernel.begin()) / size;
+    const int pivotColumn = (pivot - kernel.begin()) % size;
+
+    row.assign(kernel.begin() + pivotRow * size, kernel.begin() + (pivotRow + 1) * size);
+    column.resize(size);
+    for (int i = 0; i < size; i++)
+        column[i] = kernel[i * size + pivotColumn] / *pivot;
+
+    // The kernel is separable if every value is reproduced
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j < size; j++)
+        {
+            if (std::fabs(kernel[i * size + j] - column[i] * row[j]) > 1e-9 * largest)
+                return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void FITSConvolution::convolveSeparable(const T *source, T *destination, const uint32_t width,
+                                        const uint32_t height, const std::vector<double> &column, const std::vector<double> &row)
+{
+    typedef Accumulator<T> A;
+    const int radius = static_cast<int>(row.size()) / 2;
+    const std::vector<A> rowWeights(row.begin(), row.end()), columnWeights(column.begin(), column.end());
+    // Bands much taller than their halo, so little of the horizontal pass is repeated
+    const uint32_t maxRows = std::max({ 1u, 8u * radius, maxBandPixels / std::max(1u, width) });
+    auto work = bands(width, height, maxRows);
+
+    // Filtering in place, a band would overwrite rows that the halos of its neighbours still have to read,
+    // so keep a copy of the rows within the kernel radius of each boundary between bands
+    std::vector<T> haloRows;
+    std::vector<int64_t> haloIndex;
+    if (source == destination && work.size() > 1)
+    {
+        haloIndex.assign(height, -1);
+        int64_t numHaloRows = 0;
+        for (size_t i = 1; i < work.size(); i++)
+        {
+            const int64_t boundary = work[i].first;
+            for (int64_t y = std::max<int64_t>(0, boundary - radius); y < std::min<int64_t>(height, boundary + radius); y++)
+            {
+                if (haloIndex[y] < 0)
+                    haloIndex[y] = numHaloRows++;
+            }
+        }
+        haloRows.resize(static_cast<size_t>(numHaloRows) * width);
+        for (uint32_t y = 0; y < height; y++)
+        {
+            if (haloIndex[y] >= 0)
+                std::copy(source + static_cast<size_t>(y) * width, source + static_cast<size_t>(y + 1) * width,
+                          haloRows.begin() + haloIndex[y] * width);
+        }
+    }
+
+    QtConcurrent::blockingMap(work, [&](const std::pair<uint32_t, uint32_t> &band)
+    {
+        // Horizontal pass of the band and its halo into scratch rows
+        const int64_t first = std::max<int64_t>(0, static_cast<int64_t>(band.first) - radius);
+        const int64_t last = std::min<int64_t>(height, static_cast<int64_t>(band.second) + radius);
+        std::vector<A> rowPass(static_cast<size_t>(last - first) * width, 0);
+        for (int64_t y = first; y < last; y++)
+        {
+            const bool inBand = y >= band.first && y < band.second;
+            const T *input = (inBand || haloIndex.empty()) ? source + y * width : haloRows.data() + haloIndex[y] * width;
+            for (int i = 0; i < static_cast<int>(rowWeights.size()); i++)
+                addShifted(input, rowPass.data() + (y - first) * width, width, i - radius, rowWeights[i]);
+        }
+
+        // Vertical pass, a tile of columns at a time
+        std::vector<A> sums(std::min(width, tileWidth));
+        for (uint32_t y = band.first; y < band.second; y++)
+        {
+            for (uint32_t tileStart = 0; tileStart < width; tileStart += tileWidth)
+            {
+                const uint32_t tileEnd = std::min(tileStart + tileWidth, width);
+                std::fill(sums.begin(), sums.end(), 0);
+                for (int i = 0; i < static_cast<int>(columnWeights.size()); i++)
+                {
+                    const int64_t sourceY = static_cast<int64_t>(y) + i - radius;
+                    if (sourceY < 0 || sourceY >= height)
+                        continue;
+                    const A weight = columnWeights[i];
+                    const A *input = rowPass.data() + (sourceY - first) * width + tileStart;
+                    for (uint32_t x = 0; x < tileEnd - tileStart; x++)
+                        sums[x] += weight * input[x];
+                }
+
+                T *output = destination + static_cast<size_t>(y) * width + tileStart;
+                for (uint32_t x = 0; x < tileEnd - tileStart; x++)
+                    output[x] = toPixel<T>(sums[x]);
+            }
+        }
+    });
+}
+
+template <typename T>
+void FITSConvolution::convolveDense(const T *source, T *destination, const uint32_t width, const uint32_t height,
+                                    const std::vector<double> &kernel, const int size)
+{
+    typedef Accumulator<T> A;
+    const int radius = size / 2;
+    const std::vector<A> weights(kernel.begin(), kernel.end());
+
+    // Keep the original pixels when filtering in place
+    std::vector<T> copy;
+    if (source == destination)
+    {
+        copy.assign(source, source + static_cast<size_t>(width) * height);
+        source = copy.data();
+    }
+
+    auto work = bands(width, height);
+    QtConcurrent::blockingMap(work, [&](const std::pair<uint32_t, uint32_t> &band)
+    {
+        std::vector<A> sums(width);
+        for (uint32_t y = band.first; y < band.second; y++)
+        {
+            std::fill(sums.begin(), sums.end(), 0);
+            for (int i = 0; i < size; i++)
+            {
+                const int64_t sourceY = static_cast<int64_t>(y) + i - radius;
+                if (sourceY < 0 || sourceY >= height)
+                    continue;
+                for (int j = 0; j < size; j++)
+                    addShifted(source + sourceY * width, sums.data(), width, j - radius, weights[i * size + j]);
+            }
+
+            T *output = destination + static_cast<size_t>(y) * width;
+            for (uint32_t x = 0; x < width; x++)
+                output[x] = toPixel<T>(sums[x]);
+        }
+    });
+}
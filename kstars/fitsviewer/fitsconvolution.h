@@ -0,0 +1,63 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class FITSConvolution
+ * @brief Convolution engine for FITSData filters.
+ *
+ * Convolves each channel of an image with a square kernel, treating pixels beyond the edges as zero.
+ * The result is calculated from the original pixels only, so the source and destination may be the same buffer.
+ *
+ * Kernels that are the outer product of a column and a row vector, such as a Gaussian, are applied as a
+ * horizontal pass followed by a vertical pass, which is O(size) rather than O(size²) per pixel. Other kernels
+ * are applied directly. Either way the inner loops run along rows without bounds checks so the compiler can
+ * vectorise them, the vertical pass works on column tiles that stay in cache, and the rows are split between
+ * threads. The separable passes work on bands of rows with a halo of the kernel radius, so only the bands in
+ * progress hold an intermediate horizontal pass rather than a full frame.
+ */
+class FITSConvolution
+{
+    public:
+        /**
+         * @brief Convolve each channel of an image with a kernel
+         * @param source planar image data, one channel after another
+         * @param destination for the result, which may be the same as source
+         * @param dataType of the pixels (TBYTE, TSHORT, TUSHORT, TLONG, TULONG, TFLOAT, TLONGLONG or TDOUBLE)
+         * @param width of the image
+         * @param height of the image
+         * @param channels in the image
+         * @param kernel row major kernel of size x size values
+         * @param size of the kernel, which must be odd
+         * @return success (or not if the data type or kernel is not supported)
+         */
+        static bool convolve(const uint8_t *source, uint8_t *destination, const uint32_t dataType, const uint32_t width,
+                             const uint32_t height, const int channels, const std::vector<double> &kernel, const int size);
+
+        /**
+         * @brief Split a kernel into column and row vectors, if it is their outer product
+         * @param kernel row major kernel of size x size values
+         * @param size of the kernel
+         * @param column returned column vector
+         * @param row returned row vector
+         * @return whether the kernel is separable
+         */
+        static bool separate(const std::vector<double> &kernel, const int size, std::vector<double> &column,
+                             std::vector<double> &row);
+
+    private:
+        template <typename T>
+        static void convolveSeparable(const T *source, T *destination, const uint32_t width, const uint32_t height,
+                                      const std::vector<double> &column, const std::vector<double> &row);
+
+        template <typename T>
+        static void convolveDense(const T *source, T *destination, const uint32_t width, const uint32_t height,
+                                  const std::vector<double> &kernel, const int size);
+};
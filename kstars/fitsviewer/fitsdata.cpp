@@ -13,6 +13,8 @@
 #include "fitsgradientdetector.h"
 #include "fitscentroiddetector.h"
 #include "fitssepdetector.h"
+#include "fitsconvolution.h"
+#include "fitsstatistics.h"
 
 #include "fpack.h"
 
@@ -28,6 +30,7 @@
 #include <QApplication>
 #include <QImage>
 #include <QtConcurrent>
+#include <QtEndian>
 #include <QImageReader>
 #include <QUrl>
 #include <QNetworkAccessManager>
@@ -194,6 +197,9 @@ void FITSData::loadCommon(const QString &inFilename)
     {
         fits_flush_file(fptr, &status);
         fits_close_file(fptr, &status);
+        // The image buffer may point into the pack buffer
+        if (m_ImageBufferAdopted)
+            clearImageBuffers();
         free(m_PackBuffer);
         m_PackBuffer = nullptr;
         fptr = nullptr;
@@ -202,16 +208,23 @@ void FITSData::loadCommon(const QString &inFilename)
     m_Filename = inFilename;
 }
 
-bool FITSData::loadFromBuffer(const QByteArray &buffer)
+bool FITSData::loadFromBuffer(QByteArray buffer)
 {
     loadCommon("");
-    qCDebug(KSTARS_FITS) << "Reading file buffer (" << KFormat().formatByteSize(buffer.size()) << ")";
-    return privateLoad(buffer);
+    // Replacing the previous file buffer is safe now its fptr is closed
+    if (m_ImageBufferAdopted)
+        clearImageBuffers();
+    m_FileBuffer = std::move(buffer);
+    qCDebug(KSTARS_FITS) << "Reading file buffer (" << KFormat().formatByteSize(m_FileBuffer.size()) << ")";
+    return privateLoad(m_FileBuffer);
 }
 
 QFuture<bool> FITSData::loadFromFile(const QString &inFilename)
 {
     loadCommon(inFilename);
+    if (m_ImageBufferAdopted)
+        clearImageBuffers();
+    m_FileBuffer.clear();
     QFileInfo info(m_Filename);
     m_Extension = info.completeSuffix().toLower();
     qCDebug(KSTARS_FITS) << "Loading file " << m_Filename;
@@ -235,6 +248,16 @@ bool FITSData::loadStack(const QString &inDir, const LiveStackData &params)
         emit stackReady();
     });
 
+    // Resume loading subs when the stack was waiting for subs to be aligned
+    connect(m_Stack.get(), &FITSStack::subPrepared, this, [this]()
+    {
+        if (m_StackWaitingForPrepare && !m_Stack->isPreparePoolFull())
+        {
+            m_StackWaitingForPrepare = false;
+            nextStackAction();
+        }
+    });
+
     // Clear the work queue
     m_StackQ.clear();
 
@@ -297,6 +320,7 @@ bool FITSData::loadStack(const QString &inDir, const LiveStackData &params)
     m_Stack->setStackInProgress(true);
     m_DarkLoaded = false;
     m_FlatLoaded = false;
+    m_StackWaitingForPrepare = false;
     m_CancelRequest = m_StackFITSWatcherCancel = m_StackWatcherCancel = false;
     setStackSubSolution(0.0, 0.0, 0.0, -1, -1);
     nextStackAction();
@@ -417,7 +441,7 @@ bool FITSData::processNextSub(QString &sub)
             qCDebug(KSTARS_FITS) << QString("Unable to load sub %1").arg(sub);
         else
         {
-            bool plateSolving = (m_Stack->getStackData().alignMethod == LS_ALIGNMENT_PLATE_SOLVE);
+            bool plateSolving = (m_Stack->getStackData().alignMethod != LS_ALIGNMENT_NONE);
             if (plateSolving && m_StackSubIndex <= 0)
             {
                 // 1st time solving, or solving had a problem so use WCS from sub header
@@ -535,7 +559,7 @@ void FITSData::stackFITSLoaded()
         return;
     }
 
-    bool plateSolving = (m_Stack->getStackData().alignMethod == LS_ALIGNMENT_PLATE_SOLVE);
+    bool plateSolving = (m_Stack->getStackData().alignMethod != LS_ALIGNMENT_NONE);
     switch (action)
     {
         case stackFITSDark:
@@ -590,6 +614,20 @@ void FITSData::solverDone(const bool timedOut, const bool success, const double
     nextStackAction();
 }
 
+// Try aligning the sub by star pattern rather than plate solving
+bool FITSData::stackSubStars(const QList<FITSImage::Star> &stars, const double hfr, const int numStars)
+{
+    if (!m_Stack->alignSubByStars(stars, hfr, numStars))
+        return false;
+
+    qCDebug(KSTARS_FITS) << "Sub aligned by star pattern";
+    emit stackUpdateStats(true, m_StackSubPos, m_StackDirWatcher->getCurrentFiles().size(), m_Stack->getMeanSubSNR(),
+                          m_Stack->getMinSubSNR(), m_Stack->getMaxSubSNR());
+    // Return to the caller, which still has the solver connected, before loading the next sub
+    QTimer::singleShot(0, this, &FITSData::nextStackAction);
+    return true;
+}
+
 // Current stack action is complete so do next action... either process next sub or stack
 void FITSData::nextStackAction()
 {
@@ -604,18 +642,28 @@ void FITSData::nextStackAction()
             return;
         }
 
+        // Load calibration masters (if any) first, so subs can be calibrated as soon as they are solved
+        if (!m_DarkLoaded || !m_FlatLoaded)
+        {
+            processMasters();
+            return;
+        }
+
+        // Backpressure: don't load another sub until the subs already solved have been aligned.
+        // FITSStack::subPrepared resumes loading
+        if (m_StackSubs.size() > m_StackSubPos + 1 && m_Stack->isPreparePoolFull())
+        {
+            m_StackWaitingForPrepare = true;
+            return;
+        }
+
         m_StackSubPos++;
         if (m_StackSubs.size() > m_StackSubPos)
             done = processNextSub(m_StackSubs[m_StackSubPos]);
         else
         {
-            // All subs have been processed so load calibration masters (if any)
+            // All subs have been processed so stack them
             done = true;
-            if (!m_DarkLoaded || !m_FlatLoaded)
-            {
-                processMasters();
-                return;
-            }
 
             // If we haven't already chosen an alignment master use the first sub
             if (!m_AlignMasterChosen)
@@ -978,27 +1026,42 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const bool isCompressed)
     if ( (m_Mode != FITS_NORMAL && m_Mode != FITS_CALIBRATE && m_Mode != FITS_LIVESTACKING) || !Options::auto3DCube())
         m_Statistics.channels = 1;
 
-    m_ImageBufferSize = m_Statistics.samples_per_channel * m_Statistics.channels * m_Statistics.bytesPerPixel;
-    m_ImageBuffer = new uint8_t[m_ImageBufferSize];
-    if (m_ImageBuffer == nullptr)
-    {
-        qCWarning(KSTARS_FITS) << "FITSData: Not enough memory for image_buffer channel. Requested: "
-                               << m_ImageBufferSize << " bytes.";
-        clearImageBuffers();
-        free(m_PackBuffer);
-        m_PackBuffer = nullptr;
-        return false;
-    }
-
     rotCounter     = 0;
     flipHCounter   = 0;
     flipVCounter   = 0;
     long nelements = m_Statistics.samples_per_channel * m_Statistics.channels;
+    m_ImageBufferSize = nelements * m_Statistics.bytesPerPixel;
 
-    if (fits_read_img(fptr, m_Statistics.dataType, 1, nelements, nullptr, m_ImageBuffer, &anynull, &status))
+    // Where we own the file data fptr was opened on, try using the pixels where they are rather than copying them
+    if (!buffer.isEmpty() && (m_Extension.contains(".fz") || isCompressed))
     {
-        m_LastError = i18n("Error reading image: %1", fitsErrorToString(status));
-        return false;
+        if (m_PackBuffer)
+            m_ImageBuffer = adoptImageData(m_PackBuffer, m_Statistics.size, nelements);
+    }
+    // Buffers wrapping raw data report no capacity, and would be copied rather than written in place
+    else if (!buffer.isEmpty() && buffer.constData() == m_FileBuffer.constData() && m_FileBuffer.isDetached() &&
+             m_FileBuffer.capacity() > 0)
+        m_ImageBuffer = adoptImageData(reinterpret_cast<uint8_t *>(m_FileBuffer.data()), m_FileBuffer.size(), nelements);
+    m_ImageBufferAdopted = (m_ImageBuffer != nullptr);
+
+    if (!m_ImageBufferAdopted)
+    {
+        m_ImageBuffer = new uint8_t[m_ImageBufferSize];
+        if (m_ImageBuffer == nullptr)
+        {
+            qCWarning(KSTARS_FITS) << "FITSData: Not enough memory for image_buffer channel. Requested: "
+                                   << m_ImageBufferSize << " bytes.";
+            clearImageBuffers();
+            free(m_PackBuffer);
+            m_PackBuffer = nullptr;
+            return false;
+        }
+
+        if (fits_read_img(fptr, m_Statistics.dataType, 1, nelements, nullptr, m_ImageBuffer, &anynull, &status))
+        {
+            m_LastError = i18n("Error reading image: %1", fitsErrorToString(status));
+            return false;
+        }
     }
 
     parseHeader();
@@ -1029,10 +1092,14 @@ bool FITSData::loadFITSImage(const QByteArray &buffer, const bool isCompressed)
     else
         calculateStats(false, false);
 
+    // fptr and the image buffer refer to the unpacked data, so don't hold the compressed frame as well
+    if (m_PackBuffer && !buffer.isEmpty() && buffer.constData() == m_FileBuffer.constData())
+        m_FileBuffer.clear();
+
     if (m_Mode == FITS_NORMAL || m_Mode == FITS_ALIGN)
         loadWCS();
 #if !defined (KSTARS_LITE) && defined (HAVE_WCSLIB) && defined (HAVE_OPENCV)
-    else if (m_Mode == FITS_LIVESTACKING && m_Stack->getStackData().alignMethod == LS_ALIGNMENT_PLATE_SOLVE)
+    else if (m_Mode == FITS_LIVESTACKING && m_Stack->getStackData().alignMethod != LS_ALIGNMENT_NONE)
         stackSetupWCS();
 #endif // !KSTARS_LITE, HAVE_WCSLIB, HAVE_OPENCV
 
@@ -2032,8 +2099,7 @@ bool FITSData::saveImage(const QString &newFilename)
 
 void FITSData::clearImageBuffers()
 {
-    delete[] m_ImageBuffer;
-    m_ImageBuffer = nullptr;
+    releaseImageBuffer();
     if(m_ImageRoiBuffer != nullptr )
     {
         delete[] m_ImageRoiBuffer;
@@ -2116,572 +2182,139 @@ void FITSData::setupWCSParams()
 
 void FITSData::calculateStats(bool refresh, bool roi)
 {
-    // Calculate min max
     if(roi == false)
     {
-        calculateMinMax(refresh);
-        calculateMedian(refresh);
+        bool minMaxFound = false, medianFound = false, meanFound = false;
 
-        // Try to read mean/median/stddev if in file
+        // Try to read min/max/median/mean/stddev if in file
         if (refresh == false && fptr)
         {
             int status = 0;
             int nfound = 0;
-            if (fits_read_key_dbl(fptr, "MEAN1", &m_Statistics.mean[0], nullptr, &status) == 0)
-                nfound++;
-            // NB. These could fail if missing, which is OK.
-            fits_read_key_dbl(fptr, "MEAN2", & m_Statistics.mean[1], nullptr, &status);
-            fits_read_key_dbl(fptr, "MEAN3", &m_Statistics.mean[2], nullptr, &status);
+            double min[3] = {0}, max[3] = {0}, median[3] = {0}, mean[3] = {0}, stddev[3] = {0};
 
-            status = 0;
-            if (fits_read_key_dbl(fptr, "STDDEV1", &m_Statistics.stddev[0], nullptr, &status) == 0)
+            if (fits_read_key_dbl(fptr, "DATAMIN", &min[0], nullptr, &status) == 0)
                 nfound++;
-            // NB. These could fail if missing, which is OK.
-            fits_read_key_dbl(fptr, "STDDEV2", &m_Statistics.stddev[1], nullptr, &status);
-            fits_read_key_dbl(fptr, "STDDEV3", &m_Statistics.stddev[2], nullptr, &status);
-
-            // If all is OK, we're done
-            if (nfound == 2)
-                return;
-        }
-
-        // Get standard deviation and mean in one run
-        switch (m_Statistics.dataType)
-        {
-            case TBYTE:
-                calculateStdDev<uint8_t>();
-                break;
-
-            case TSHORT:
-                calculateStdDev<int16_t>();
-                break;
-
-            case TUSHORT:
-                calculateStdDev<uint16_t>();
-                break;
-
-            case TLONG:
-                calculateStdDev<int32_t>();
-                break;
-
-            case TULONG:
-                calculateStdDev<uint32_t>();
-                break;
-
-            case TFLOAT:
-                calculateStdDev<float>();
-                break;
-
-            case TLONGLONG:
-                calculateStdDev<int64_t>();
-                break;
-
-            case TDOUBLE:
-                calculateStdDev<double>();
-                break;
-
-            default:
-                return;
-        }
-
-        // FIXME That's not really SNR, must implement a proper solution for this value
-        m_Statistics.SNR = m_Statistics.mean[0] / m_Statistics.stddev[0];
-    }
-    else
-    {
-        calculateMinMax(refresh, roi);
-        calculateMedian(refresh, roi);
-
-        switch (m_ROIStatistics.dataType)
-        {
-            case TBYTE:
-                calculateStdDev<uint8_t>(roi);
-                break;
-
-            case TSHORT:
-                calculateStdDev<int16_t>(roi);
-                break;
-
-            case TUSHORT:
-                calculateStdDev<uint16_t>(roi);
-                break;
-
-            case TLONG:
-                calculateStdDev<int32_t>(roi);
-                break;
-
-            case TULONG:
-                calculateStdDev<uint32_t>(roi);
-                break;
-
-            case TFLOAT:
-                calculateStdDev<float>(roi);
-                break;
-
-            case TLONGLONG:
-                calculateStdDev<int64_t>(roi);
-                break;
-
-            case TDOUBLE:
-                calculateStdDev<double>(roi);
-                break;
-
-            default:
-                return;
-        }
-    }
-}
-
-void FITSData::calculateMinMax(bool refresh, bool roi)
-{
-    if(roi == false)
-    {
-        int status, nfound = 0;
-
-        status = 0;
-
-        // Only fetch from header if we have a single channel
-        // Otherwise, calculate manually.
-        if (fptr != nullptr && !refresh)
-        {
-
-            status = 0;
-
-            if (fits_read_key_dbl(fptr, "DATAMIN", &(m_Statistics.min[0]), nullptr, &status) == 0)
-                nfound++;
-            else if (fits_read_key_dbl(fptr, "MIN1", &(m_Statistics.min[0]), nullptr, &status) == 0)
+            else if (fits_read_key_dbl(fptr, "MIN1", &min[0], nullptr, &status) == 0)
                 nfound++;
 
             // NB. These could fail if missing, which is OK.
-            fits_read_key_dbl(fptr, "MIN2", &m_Statistics.min[1], nullptr, &status);
-            fits_read_key_dbl(fptr, "MIN3", &m_Statistics.min[2], nullptr, &status);
+            fits_read_key_dbl(fptr, "MIN2", &min[1], nullptr, &status);
+            fits_read_key_dbl(fptr, "MIN3", &min[2], nullptr, &status);
 
             status = 0;
-
-            if (fits_read_key_dbl(fptr, "DATAMAX", &(m_Statistics.max[0]), nullptr, &status) == 0)
+            if (fits_read_key_dbl(fptr, "DATAMAX", &max[0], nullptr, &status) == 0)
                 nfound++;
-            else if (fits_read_key_dbl(fptr, "MAX1", &(m_Statistics.max[0]), nullptr, &status) == 0)
+            else if (fits_read_key_dbl(fptr, "MAX1", &max[0], nullptr, &status) == 0)
                 nfound++;
 
             // NB. These could fail if missing, which is OK.
-            fits_read_key_dbl(fptr, "MAX2", &m_Statistics.max[1], nullptr, &status);
-            fits_read_key_dbl(fptr, "MAX3", &m_Statistics.max[2], nullptr, &status);
-
-            // If we found both keywords, no need to calculate them, unless they are both zeros
-            if (nfound == 2 && !(m_Statistics.min[0] == 0 && m_Statistics.max[0] == 0))
-                return;
-        }
-
-        m_Statistics.min[0] = 1.0E30;
-        m_Statistics.max[0] = -1.0E30;
-
-        m_Statistics.min[1] = 1.0E30;
-        m_Statistics.max[1] = -1.0E30;
-
-        m_Statistics.min[2] = 1.0E30;
-        m_Statistics.max[2] = -1.0E30;
-
-        switch (m_Statistics.dataType)
-        {
-            case TBYTE:
-                calculateMinMax<uint8_t>();
-                break;
-
-            case TSHORT:
-                calculateMinMax<int16_t>();
-                break;
-
-            case TUSHORT:
-                calculateMinMax<uint16_t>();
-                break;
-
-            case TLONG:
-                calculateMinMax<int32_t>();
-                break;
-
-            case TULONG:
-                calculateMinMax<uint32_t>();
-                break;
-
-            case TFLOAT:
-                calculateMinMax<float>();
-                break;
-
-            case TLONGLONG:
-                calculateMinMax<int64_t>();
-                break;
-
-            case TDOUBLE:
-                calculateMinMax<double>();
-                break;
-
-            default:
-                break;
-        }
-    }
-    else
-    {
-        m_ROIStatistics.min[0] = 1.0E30;
-        m_ROIStatistics.max[0] = -1.0E30;
-
-        m_ROIStatistics.min[1] = 1.0E30;
-        m_ROIStatistics.max[1] = -1.0E30;
-
-        m_ROIStatistics.min[2] = 1.0E30;
-        m_ROIStatistics.max[2] = -1.0E30;
-
-        switch (m_Statistics.dataType)
-        {
-            case TBYTE:
-                calculateMinMax<uint8_t>(roi);
-                break;
-
-            case TSHORT:
-                calculateMinMax<int16_t>(roi);
-                break;
-
-            case TUSHORT:
-                calculateMinMax<uint16_t>(roi);
-                break;
-
-            case TLONG:
-                calculateMinMax<int32_t>(roi);
-                break;
-
-            case TULONG:
-                calculateMinMax<uint32_t>(roi);
-                break;
-
-            case TFLOAT:
-                calculateMinMax<float>(roi);
-                break;
-
-            case TLONGLONG:
-                calculateMinMax<int64_t>(roi);
-                break;
-
-            case TDOUBLE:
-                calculateMinMax<double>(roi);
-                break;
-
-            default:
-                break;
-        }
-
-    }
-}
+            fits_read_key_dbl(fptr, "MAX2", &max[1], nullptr, &status);
+            fits_read_key_dbl(fptr, "MAX3", &max[2], nullptr, &status);
 
-void FITSData::calculateMedian(bool refresh, bool roi)
-{
-    if(!roi)
-    {
-        int status, nfound = 0;
+            // We found both keywords, unless they are both zeros
+            minMaxFound = (nfound == 2 && !(min[0] == 0 && max[0] == 0));
 
-        status = 0;
+            status = 0;
+            medianFound = (fits_read_key_dbl(fptr, "MEDIAN1", &median[0], nullptr, &status) == 0);
+            // NB. These could fail if missing, which is OK.
+            fits_read_key_dbl(fptr, "MEDIAN2", &median[1], nullptr, &status);
+            fits_read_key_dbl(fptr, "MEDIAN3", &median[2], nullptr, &status);
 
-        // Only fetch from header if we have a single channel
-        // Otherwise, calculate manually.
-        if (fptr != nullptr && !refresh)
-        {
             status = 0;
-            if (fits_read_key_dbl(fptr, "MEDIAN1", &m_Statistics.median[0], nullptr, &status) == 0)
+            nfound = 0;
+            if (fits_read_key_dbl(fptr, "MEAN1", &mean[0], nullptr, &status) == 0)
                 nfound++;
+            // NB. These could fail if missing, which is OK.
+            fits_read_key_dbl(fptr, "MEAN2", &mean[1], nullptr, &status);
+            fits_read_key_dbl(fptr, "MEAN3", &mean[2], nullptr, &status);
 
+            status = 0;
+            if (fits_read_key_dbl(fptr, "STDDEV1", &stddev[0], nullptr, &status) == 0)
+                nfound++;
             // NB. These could fail if missing, which is OK.
-            fits_read_key_dbl(fptr, "MEDIAN2", &m_Statistics.median[1], nullptr, &status);
-            fits_read_key_dbl(fptr, "MEDIAN3", &m_Statistics.median[2], nullptr, &status);
+            fits_read_key_dbl(fptr, "STDDEV2", &stddev[1], nullptr, &status);
+            fits_read_key_dbl(fptr, "STDDEV3", &stddev[2], nullptr, &status);
+            meanFound = (nfound == 2);
 
-            if (nfound == 1)
+            for (int n = 0; n < 3; n++)
+            {
+                if (minMaxFound)
+                {
+                    m_Statistics.min[n] = min[n];
+                    m_Statistics.max[n] = max[n];
+                }
+                if (medianFound)
+                    m_Statistics.median[n] = median[n];
+                if (meanFound)
+                {
+                    m_Statistics.mean[n] = mean[n];
+                    m_Statistics.stddev[n] = stddev[n];
+                }
+            }
+
+            // If all is OK, we're done
+            if (minMaxFound && medianFound && meanFound)
                 return;
         }
 
-        m_Statistics.median[RED_CHANNEL] = 0;
-        m_Statistics.median[GREEN_CHANNEL] = 0;
-        m_Statistics.median[BLUE_CHANNEL] = 0;
-
-        switch (m_Statistics.dataType)
-        {
-            case TBYTE:
-                calculateMedian<uint8_t>();
-                break;
-
-            case TSHORT:
-                calculateMedian<int16_t>();
-                break;
-
-            case TUSHORT:
-                calculateMedian<uint16_t>();
-                break;
-
-            case TLONG:
-                calculateMedian<int32_t>();
-                break;
-
-            case TULONG:
-                calculateMedian<uint32_t>();
-                break;
-
-            case TFLOAT:
-                calculateMedian<float>();
-                break;
-
-            case TLONGLONG:
-                calculateMedian<int64_t>();
-                break;
-
-            case TDOUBLE:
-                calculateMedian<double>();
-                break;
-
-            default:
-                break;
-        }
-    }
-    else
-    {
-        m_ROIStatistics.median[RED_CHANNEL] = 0;
-        m_ROIStatistics.median[GREEN_CHANNEL] = 0;
-        m_ROIStatistics.median[BLUE_CHANNEL] = 0;
+        // Calculate whatever isn't in the file in a single pass over the image
+        FITSStatistics::Channel results[3];
+        if (!FITSStatistics::calculate(m_ImageBuffer, m_Statistics.dataType, m_Statistics.samples_per_channel,
+                                       m_Statistics.channels, results))
+            return;
 
-        switch (m_ROIStatistics.dataType)
+        for (int n = 0; n < m_Statistics.channels; n++)
         {
-            case TBYTE:
-                calculateMedian<uint8_t>(roi);
-                break;
-
-            case TSHORT:
-                calculateMedian<int16_t>(roi);
-                break;
-
-            case TUSHORT:
-                calculateMedian<uint16_t>(roi);
-                break;
-
-            case TLONG:
-                calculateMedian<int32_t>(roi);
-                break;
-
-            case TULONG:
-                calculateMedian<uint32_t>(roi);
-                break;
-
-            case TFLOAT:
-                calculateMedian<float>(roi);
-                break;
-
-            case TLONGLONG:
-                calculateMedian<int64_t>(roi);
-                break;
-
-            case TDOUBLE:
-                calculateMedian<double>(roi);
-                break;
-
-            default:
-                break;
+            if (!minMaxFound)
+            {
+                m_Statistics.min[n] = results[n].min;
+                m_Statistics.max[n] = results[n].max;
+            }
+            if (!medianFound)
+                m_Statistics.median[n] = results[n].median;
+            if (!meanFound)
+            {
+                m_Statistics.mean[n] = results[n].mean;
+                m_Statistics.stddev[n] = results[n].stddev;
+            }
         }
 
-    }
-}
-
-template <typename T>
-void FITSData::calculateMedian(bool roi)
-{
-    auto * buffer = reinterpret_cast<T *>(roi ? m_ImageRoiBuffer : m_ImageBuffer);
-    const uint32_t maxMedianSize = 500000;
-    uint32_t medianSize = roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel;
-    uint8_t downsample = 1;
-    if (medianSize > maxMedianSize)
-    {
-        downsample = (static_cast<double>(medianSize) / maxMedianSize) + 0.999;
-        medianSize /= downsample;
-    }
-    // Ideally samples would be declared like this...
-    // std::vector<T> samples;
-    // Unfortunately this doesn't compile on Mac - see the comments in robuststatistics.cpp for more details
-    // So for now declare samples like this...
-    std::vector<int32_t> samples;
-    samples.reserve(medianSize);
-
-    for (uint8_t n = 0; n < m_Statistics.channels; n++)
-    {
-        auto *oneChannel = buffer + n * (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
-        for (uint32_t upto = 0; upto < (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
-                upto += downsample)
-            samples.push_back(oneChannel[upto]);
-        auto median = Mathematics::RobustStatistics::ComputeLocation(Mathematics::RobustStatistics::LOCATION_MEDIAN, samples);
-        roi ? m_ROIStatistics.median[n] = median : m_Statistics.median[n] = median;
-    }
-}
-
-template <typename T>
-QPair<T, T> FITSData::getParitionMinMax(uint32_t start, uint32_t stride, bool roi)
-{
-    auto * buffer = reinterpret_cast<T *>(roi ? m_ImageRoiBuffer : m_ImageBuffer);
-    T min = std::numeric_limits<T>::max();
-    T max = std::numeric_limits<T>::min();
-
-    uint32_t end = start + stride;
+        if (meanFound)
+            return;
 
-    for (uint32_t i = start; i < end; i++)
-    {
-        min = qMin(buffer[i], min);
-        max = qMax(buffer[i], max);
-        //        if (buffer[i] < min)
-        //            min = buffer[i];
-        //        else if (buffer[i] > max)
-        //            max = buffer[i];
+        // FIXME That's not really SNR, must implement a proper solution for this value
+        m_Statistics.SNR = m_Statistics.mean[0] / m_Statistics.stddev[0];
     }
-
-    return qMakePair(min, max);
-}
-
-template <typename T>
-void FITSData::calculateMinMax(bool roi)
-{
-    T min = std::numeric_limits<T>::max();
-    T max = std::numeric_limits<T>::min();
-
-
-    // Create N threads
-    const uint8_t nThreads = 16;
-
-    for (int n = 0; n < m_Statistics.channels; n++)
+    else
     {
-        uint32_t cStart = n * (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
-
-        // Calculate how many elements we process per thread
-        uint32_t tStride = (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel) / nThreads;
-
-        // Calculate the final stride since we can have some left over due to division above
-        uint32_t fStride = tStride + ((roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel) -
-                                      (tStride * nThreads));
-
-        // Start location for inspecting elements
-        uint32_t tStart = cStart;
-
-        // List of futures
-        QList<QFuture<QPair<T, T>>> futures;
-
-        for (int i = 0; i < nThreads; i++)
-        {
-            // Run threads
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-            futures.append(QtConcurrent::run(&FITSData::getParitionMinMax<T>, this, tStart, (i == (nThreads - 1)) ? fStride : tStride,
-                                             roi));
-#else
-            futures.append(QtConcurrent::run(this, &FITSData::getParitionMinMax<T>, tStart, (i == (nThreads - 1)) ? fStride : tStride,
-                                             roi));
-#endif
-            tStart += tStride;
-        }
-
-        // Now wait for results
-        for (int i = 0; i < nThreads; i++)
-        {
-            QPair<T, T> result = futures[i].result();
-            min = qMin(result.first, min);
-            max = qMax(result.second, max);
-        }
+        FITSStatistics::Channel results[3];
+        if (!FITSStatistics::calculate(m_ImageRoiBuffer, m_Statistics.dataType, m_ROIStatistics.samples_per_channel,
+                                       m_Statistics.channels, results))
+            return;
 
-        if(!roi)
+        for (int n = 0; n < m_Statistics.channels; n++)
         {
-            m_Statistics.min[n] = min;
-            m_Statistics.max[n] = max;
-        }
-        else
-        {
-            m_ROIStatistics.min[n] = min;
-            m_ROIStatistics.max[n] = max;
+            m_ROIStatistics.min[n] = results[n].min;
+            m_ROIStatistics.max[n] = results[n].max;
+            m_ROIStatistics.median[n] = results[n].median;
+            m_ROIStatistics.mean[n] = results[n].mean;
+            m_ROIStatistics.stddev[n] = results[n].stddev;
         }
     }
-
 }
 
-// This struct is used when returning results from the threaded getSumAndSquaredSum calculations
-// used to compute the mean and variance of the image.
-struct SumData
+void FITSData::calculateMeanStdDev()
 {
-    double sum;
-    double squaredSum;
-    double numSamples;
-    SumData(double s, double sq, int n) : sum(s), squaredSum(sq), numSamples(n) {}
-    SumData() : sum(0), squaredSum(0), numSamples(0) {}
-};
-
-template <typename T>
-SumData getSumAndSquaredSum(uint32_t start, uint32_t stride, uint8_t *buff)
-{
-    auto * buffer = reinterpret_cast<T *>(buff);
-    const uint32_t end = start + stride;
-    double sum = 0;
-    double squaredSum = 0;
-    for (uint32_t i = start; i < end; i++)
-    {
-        double sample = buffer[i];
-        sum += sample;
-        squaredSum += sample * sample;
-    }
-    const double numSamples = end - start;
-    return SumData(sum, squaredSum, numSamples);
-}
-
-template <typename T>
-void FITSData::calculateStdDev(bool roi )
-{
-    // Create N threads
-    const uint8_t nThreads = 16;
+    FITSStatistics::Channel results[3];
+    if (!FITSStatistics::calculateMeanStdDev(m_ImageBuffer, m_Statistics.dataType, m_Statistics.samples_per_channel,
+            m_Statistics.channels, results))
+        return;
 
     for (int n = 0; n < m_Statistics.channels; n++)
     {
-        uint32_t cStart = n * (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel);
-
-        // Calculate how many elements we process per thread
-        uint32_t tStride = (roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel) / nThreads;
-
-        // Calculate the final stride since we can have some left over due to division above
-        uint32_t fStride = tStride + ((roi ? m_ROIStatistics.samples_per_channel : m_Statistics.samples_per_channel) -
-                                      (tStride * nThreads));
-
-        // Start location for inspecting elements
-        uint32_t tStart = cStart;
-
-        // List of futures
-        QList<QFuture<SumData>> futures;
-
-        for (int i = 0; i < nThreads; i++)
-        {
-            // Run threads
-            uint8_t *buff = roi ? m_ImageRoiBuffer : m_ImageBuffer;
-            futures.append(QtConcurrent::run(&getSumAndSquaredSum<T>, tStart,
-                                             (i == (nThreads - 1)) ? fStride : tStride, buff));
-            tStart += tStride;
-        }
-
-        // Now wait for results
-        double sum = 0, squared_sum = 0;
-        double numSamples = 0;
-        for (int i = 0; i < nThreads; i++)
-        {
-            const SumData result = futures[i].result();
-            sum += result.sum;
-            squared_sum += result.squaredSum;
-            numSamples += result.numSamples;
-
-        }
-        if (numSamples <= 0) continue;
-        const double mean = sum / numSamples;
-        const double variance = squared_sum / numSamples - mean * mean;
-        if(!roi)
-        {
-            m_Statistics.mean[n]   = mean;
-            m_Statistics.stddev[n] = sqrt(variance);
-        }
-        else
-        {
-            m_ROIStatistics.mean[n] = mean;
-            m_ROIStatistics.stddev[n] = sqrt(variance);
-        }
+        m_Statistics.mean[n] = results[n].mean;
+        m_Statistics.stddev[n] = results[n].stddev;
     }
 }
 
@@ -2715,52 +2348,15 @@ QVector<double> FITSData::createGaussianKernel(int size, double sigma)
     return kernel;
 }
 
-template <typename T>
 void FITSData::convolutionFilter(const QVector<double> &kernel, int kernelSize)
 {
-    T * imagePtr = reinterpret_cast<T *>(m_ImageBuffer);
-
-    // Create variable for pixel data for each kernel
-    T gt = 0;
-
-    // This is how much your center pixel is offset from the border of your kernel
-    int fOff = (kernelSize - 1) / 2;
-
-    // Start with the pixel that is offset fOff from top and fOff from the left side
-    // this is so entire kernel is on your image
-    for (int offsetY = 0; offsetY < m_Statistics.height; offsetY++)
-    {
-        for (int offsetX = 0; offsetX < m_Statistics.width; offsetX++)
-        {
-            // reset gray value to 0
-            gt = 0;
-            // position of the kernel center pixel
-            int byteOffset = offsetY * m_Statistics.width + offsetX;
-
-            // kernel calculations
-            for (int filterY = -fOff; filterY <= fOff; filterY++)
-            {
-                for (int filterX = -fOff; filterX <= fOff; filterX++)
-                {
-                    if ((offsetY + filterY) >= 0 && (offsetY + filterY) < m_Statistics.height
-                            && ((offsetX + filterX) >= 0 && (offsetX + filterX) < m_Statistics.width ))
-                    {
-
-                        int calcOffset = byteOffset + filterX + filterY * m_Statistics.width;
-                        int index = (filterY + fOff) * kernelSize + (filterX + fOff);
-                        double kernelValue = kernel.at(index);
-                        gt += (imagePtr[calcOffset]) * kernelValue;
-                    }
-                }
-            }
-
-            // set new data in the other byte array for your image data
-            imagePtr[byteOffset] = gt;
-        }
-    }
+    // Convolves every channel, with the result calculated from the original pixels
+    if (!FITSConvolution::convolve(m_ImageBuffer, m_ImageBuffer, m_Statistics.dataType, m_Statistics.width,
+                                   m_Statistics.height, m_Statistics.channels, std::vector<double>(kernel.begin(), kernel.end()), kernelSize))
+        qCWarning(KSTARS_FITS) << "Convolution of data type" << m_Statistics.dataType << "with a kernel of size" << kernelSize
+                               << "is not supported";
 }
 
-template <typename T>
 void FITSData::gaussianBlur(int kernelSize, double sigma)
 {
     // Size must be an odd number!
@@ -2776,7 +2372,7 @@ void FITSData::gaussianBlur(int kernelSize, double sigma)
     }
 
     QVector<double> gaussianKernel = createGaussianKernel(kernelSize, sigma);
-    convolutionFilter<T>(gaussianKernel, kernelSize);
+    convolutionFilter(gaussianKernel, kernelSize);
 }
 
 void FITSData::setMinMax(double newMin, double newMax, uint8_t channel)
@@ -3521,7 +3117,7 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
                     m_Statistics.min[i] = min[i];
                     m_Statistics.max[i] = max[i];
                 }
-                calculateStdDev<T>();
+                calculateMeanStdDev();
             }
         }
         break;
@@ -3625,12 +3221,12 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
             delete[] extension;
 
             if (calcStats)
-                calculateStdDev<T>();
+                calculateMeanStdDev();
         }
         break;
 
         case FITS_GAUSSIAN:
-            gaussianBlur<T>(Options::focusGaussianKernelSize(), Options::focusGaussianSigma());
+            gaussianBlur(Options::focusGaussianKernelSize(), Options::focusGaussianSigma());
             if (calcStats)
                 calculateStats(true, false);
             break;
@@ -4811,7 +4407,7 @@ bool FITSData::rotFITS(int rotate, int mirror)
         }
     }
 
-    delete[] m_ImageBuffer;
+    releaseImageBuffer();
     m_ImageBuffer = rotimage;
 
     return true;
@@ -5112,10 +4708,99 @@ uint8_t const * FITSData::getImageBuffer() const
 
 void FITSData::setImageBuffer(uint8_t * buffer)
 {
-    delete[] m_ImageBuffer;
+    releaseImageBuffer();
     m_ImageBuffer = buffer;
 }
 
+void FITSData::releaseImageBuffer()
+{
+    // An adopted buffer belongs to the file data, which is kept as long as fptr
+    if (!m_ImageBufferAdopted)
+        delete[] m_ImageBuffer;
+    m_ImageBufferAdopted = false;
+    m_ImageBuffer = nullptr;
+}
+
+uint8_t *FITSData::adoptImageData(uint8_t *fileData, const size_t fileSize, const long nelements)
+{
+    int status = 0, equivType = 0;
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+    if (fits_get_hduaddrll(fptr, &headStart, &dataStart, &dataEnd, &status) ||
+            fits_get_img_equivtype(fptr, &equivType, &status))
+        return nullptr;
+
+    // Debayering may read the raw pixels again
+    char bayerPattern[FLEN_VALUE];
+    if (fits_read_key_str(fptr, "BAYERPAT", bayerPattern, nullptr, &status) == 0)
+        return nullptr;
+
+    double bscale = 1.0, bzero = 0.0;
+    status = 0;
+    fits_read_key_dbl(fptr, "BSCALE", &bscale, nullptr, &status);
+    status = 0;
+    fits_read_key_dbl(fptr, "BZERO", &bzero, nullptr, &status);
+
+    uint8_t *data = fileData + dataStart;
+    const size_t dataSize = nelements * m_Statistics.bytesPerPixel;
+    if (bscale != 1.0 || static_cast<size_t>(dataStart) + dataSize > fileSize ||
+            reinterpret_cast<quintptr>(data) % m_Statistics.bytesPerPixel != 0)
+        return nullptr;
+
+    // FITS data is big endian. Unsigned 16 and 32 bit types are stored signed, offset by BZERO
+    switch (m_Statistics.dataType)
+    {
+        case TBYTE:
+            if (equivType != BYTE_IMG || bzero != 0.0)
+                return nullptr;
+            break;
+
+        case TUSHORT:
+        {
+            if (equivType != USHORT_IMG)
+                return nullptr;
+            auto *pixels = reinterpret_cast<quint16 *>(data);
+            qFromBigEndian<quint16>(pixels, nelements, pixels);
+            for (long i = 0; i < nelements; i++)
+                pixels[i] ^= 0x8000;
+        }
+        break;
+
+        case TULONG:
+        {
+            if (equivType != ULONG_IMG)
+                return nullptr;
+            auto *pixels = reinterpret_cast<quint32 *>(data);
+            qFromBigEndian<quint32>(pixels, nelements, pixels);
+            for (long i = 0; i < nelements; i++)
+                pixels[i] ^= 0x80000000;
+        }
+        break;
+
+        case TFLOAT:
+            if (equivType != FLOAT_IMG || bzero != 0.0)
+                return nullptr;
+            qFromBigEndian<quint32>(data, nelements, data);
+            break;
+
+        case TLONGLONG:
+            if (equivType != LONGLONG_IMG || bzero != 0.0)
+                return nullptr;
+            qFromBigEndian<quint64>(data, nelements, data);
+            break;
+
+        case TDOUBLE:
+            if (equivType != DOUBLE_IMG || bzero != 0.0)
+                return nullptr;
+            qFromBigEndian<quint64>(data, nelements, data);
+            break;
+
+        default:
+            return nullptr;
+    }
+
+    return data;
+}
+
 bool FITSData::checkDebayer()
 {
     int status = 0;
@@ -5386,7 +5071,7 @@ bool FITSData::debayer_8bit()
 
     if (m_ImageBufferSize != rgb_size)
     {
-        delete[] m_ImageBuffer;
+        releaseImageBuffer();
         try
         {
             m_ImageBuffer = new uint8_t[rgb_size];
@@ -5478,7 +5163,7 @@ bool FITSData::debayer_16bit()
 
     if (m_ImageBufferSize != rgb_size)
     {
-        delete[] m_ImageBuffer;
+        releaseImageBuffer();
         try
         {
             m_ImageBuffer = new uint8_t[rgb_size];
@@ -123,10 +123,11 @@ class FITSData : public QObject
 
         /**
          * @brief loadFITSFromMemory Loading FITS from memory buffer.
-         * @param buffer The memory buffer containing the fits data.
+         * @param buffer The memory buffer containing the fits data. If the caller moves in a buffer that isn't
+         * shared, the pixels of an uncompressed FITS image are converted in place and used without copying them.
          * @return bool indicating success or failure.
          */
-        bool loadFromBuffer(const QByteArray &buffer);
+        bool loadFromBuffer(QByteArray buffer);
 
         /**
          * @brief parseSolution Parse the WCS solution information from the header into the given struct.
@@ -733,6 +734,15 @@ class FITSData : public QObject
          */
         void solverDone(const bool timedOut, const bool success, const double hfr, const int numStars);
 
+        /**
+         * @brief Stars have been extracted from the sub so try to align it by star pattern, avoiding a plate solve
+         * @param stars extracted from the sub
+         * @param median hfr
+         * @param number of stars
+         * @return whether the sub was aligned. If not it should be plate solved
+         */
+        bool stackSubStars(const QList<FITSImage::Star> &stars, const double hfr, const int numStars);
+
         /**
          * @brief Process new subs into an existing stack
          */
@@ -847,6 +857,21 @@ class FITSData : public QObject
          */
         bool privateLoad(const QByteArray &buffer);
 
+        /**
+         * @brief adoptImageData Convert the pixels of the current HDU to native format where they are in the file
+         * data, if cfitsio would only byte swap (and offset unsigned types) them when reading.
+         * @param fileData The FITS file in memory, which must be owned by FITSData.
+         * @param fileSize Size of the file data in bytes.
+         * @param nelements Number of pixels to convert.
+         * @return Pointer to the converted pixels, or nullptr if they have to be read by cfitsio.
+         */
+        uint8_t *adoptImageData(uint8_t *fileData, const size_t fileSize, const long nelements);
+
+        /**
+         * @brief releaseImageBuffer Free the image buffer, unless it was adopted from the file data.
+         */
+        void releaseImageBuffer();
+
         // Load Qt-supported images.
         bool loadCanonicalImage(const QByteArray &buffer);
         // Load FITS images.
@@ -859,8 +884,6 @@ class FITSData : public QObject
         bool loadRAWImage(const QByteArray &buffer);
 
         void rotWCSFITS(int angle, int mirror);
-        void calculateMinMax(bool refresh = false, bool roi = false);
-        void calculateMedian(bool refresh = false, bool roi = false);
         bool checkDebayer();
         void readWCSKeys();
 
@@ -899,24 +922,13 @@ class FITSData : public QObject
         template <typename T>
         void applyFilter(FITSScale type, uint8_t *targetImage, QVector<double> * min = nullptr, QVector<double> * max = nullptr);
 
-        template <typename T>
-        void calculateMinMax(bool roi = false);
-        template <typename T>
-        void calculateMedian(bool roi = false);
-
-        template <typename T>
-        QPair<T, T> getParitionMinMax(uint32_t start, uint32_t stride, bool roi);
-
         /* Calculate the Gaussian blur matrix and apply it to the image using the convolution filter */
         QVector<double> createGaussianKernel(int size, double sigma);
-        template <typename T>
         void convolutionFilter(const QVector<double> &kernel, int kernelSize);
-        template <typename T>
         void gaussianBlur(int kernelSize, double sigma);
 
-        /* Calculate running average & standard deviation */
-        template <typename T>
-        void calculateStdDev( bool roi = false );
+        /* Calculate average & standard deviation only, e.g. after a filter has set min & max */
+        void calculateMeanStdDev();
 
         template <typename T>
         void convertToQImage(double dataMin, double dataMax, double scale, double zero, QImage &image);
@@ -1050,6 +1062,10 @@ class FITSData : public QObject
         fitsfile *fptr { nullptr };
         /// Generic data image buffer
         uint8_t *m_ImageBuffer { nullptr };
+        /// Does the image buffer point into the file data (m_FileBuffer or m_PackBuffer) rather than its own allocation?
+        bool m_ImageBufferAdopted { false };
+        /// FITS file loaded from memory. Kept while fptr refers to it, i.e. unless it was unpacked into m_PackBuffer
+        QByteArray m_FileBuffer;
         /// Above buffer size in bytes
         uint32_t m_ImageBufferSize { 0 };
         /// Image Buffer if Selection is to be done
@@ -1179,6 +1195,8 @@ class FITSData : public QObject
         bool m_AlignMasterChosen { false };
         bool m_DarkLoaded { false };
         bool m_FlatLoaded { false };
+        // Loading the next sub is waiting for FITSStack to align some of the subs already loaded
+        bool m_StackWaitingForPrepare { false };
         uint8_t *m_StackImageBuffer { nullptr };
         uint32_t m_StackImageBufferSize { 0 };
         typedef struct
@@ -1209,4 +1227,6 @@ class FITSData : public QObject
         double m_StackSubPixscale { 0.0 };
         int m_StackSubIndex { 0 };
         int m_StackSubHealpix { 0 };
+
+        friend class TestFitsDataBuffer;
 };
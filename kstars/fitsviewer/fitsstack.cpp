@@ -8,6 +8,7 @@
 
 #include "fitsstack.h"
 #include "fitsdata.h"
+#include "fitsstackrejection.h"
 #include <fits_debug.h>
 #include "fitscommon.h"
 #include "ekos/auxiliary/solverutils.h"
@@ -17,6 +18,9 @@
 #include <wcshdr.h>
 #include <fitsio.h>
 
+// Pixels processed by the rejection kernel between cancellation checks
+#define REJECTION_BATCH 256
+
 /**
  * @file fitsstack.cpp
  * @brief Implementation of the FITSStack class used in the KStars Live Stacker module.
@@ -49,6 +53,7 @@
  * - Image consistency checks: checkSub(), convertMat(), convertToCV()
  * - Calibration: calibrateSub(), addMaster()
  * - Alignment: calcWarpMatrix(), solverDone()
+ * - Pipeline: startPrepareSub(), prepareSub(), prepareSubs()
  * - Stacking logic: stack(), stackn(), stackSubs(), stackSubsSigmaClipping()
  * - Post-processing: postProcessImage(), wienerDeconvolution()
  * - SNR and PSF utilities: getSNR(), calculatePSF()
@@ -59,10 +64,16 @@ FITSStack::FITSStack(FITSData *parent, LiveStackData params) : QObject(parent)
 {
     m_Data = parent;
     m_StackData = params;
+
+    // Leave threads for loading and plate solving the next sub. Each warp is itself multithreaded by openCV
+    m_PreparePool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
 }
 
 FITSStack::~FITSStack()
 {
+    // Background jobs reference this object so make sure they are finished
+    m_PreparePool.clear();
+    m_PreparePool.waitForDone();
     tidyUpInitalStack(nullptr);
     tidyUpRunningStack();
     if (m_WCSStackImage)
@@ -105,6 +116,11 @@ void FITSStack::setupNextSub()
     imageData.wcsprm = nullptr;
     imageData.hfr = -1;
     imageData.numStars = 0;
+    imageData.scratchIndex = -1;
+    imageData.stars.clear();
+    imageData.warp = cv::Mat();
+
+    QMutexLocker locker(&m_StackImageMutex);
     m_StackImageData.push_back(imageData);
 }
 
@@ -160,7 +176,12 @@ bool FITSStack::addSub(void * imageBuffer, const int cvType, const int width, co
         if (!checkSub(newImage.cols, newImage.rows, bytesPerPixel, channels))
             return false;
 
+        // Subs are calibrated only once solved, so the masters can still be adjusted here
+        if (!m_MastersChecked)
+            checkMasters();
+
         double snr = getSNR(newImage);
+        QMutexLocker locker(&m_StackImageMutex);
         if (snr > 0.0)
         {
             m_MaxSubSNR = std::max(m_MaxSubSNR, snr);
@@ -172,6 +193,10 @@ bool FITSStack::addSub(void * imageBuffer, const int cvType, const int width, co
         }
 
         m_StackImageData.last().image = newImage;
+
+        // With tiled stacking the sub waits on disk until it is needed
+        if (m_StackData.tiled && !spillSub(m_StackImageData.last()))
+            qCDebug(KSTARS_FITS) << QString("Unable to move sub to scratch file, keeping it in memory");
         return true;
     }
     catch (const cv::Exception &ex)
@@ -187,10 +212,14 @@ void FITSStack::addMaster(const bool dark, void * imageBuffer, const int width,
 {
     try
     {
-        if (dark)
-            m_MasterDark.release();
-        else
-            m_MasterFlatInv.release();
+        {
+            // Workers calibrating subs keep their own references to the old master
+            QMutexLocker locker(&m_StackImageMutex);
+            if (dark)
+                m_MasterDark.release();
+            else
+                m_MasterFlatInv.release();
+        }
 
         int channels = CV_MAT_CN(cvType);
 
@@ -236,26 +265,11 @@ void FITSStack::addMaster(const bool dark, void * imageBuffer, const int width,
         if (!convertMat(image, imageClone))
             return;
 
-        // Check the image is the correct shape - pass 0 for bytesPerPixel to skip check
-        // This allows masters to be different datatypes to subs
-        if (!checkSub(imageClone.cols, imageClone.rows, 0, channels))
-            return;
-
+        // Masters are usually loaded before the first sub. So the shape check and the scaling of a
+        // normalised dark, which both depend on the subs, wait for the first sub (see checkMasters)
+        cv::Mat master;
         if (dark)
-        {
-            m_MasterDark = imageClone;
-
-            // If the dark has been normalised to 0-1 then we need to increase values so they match the subs
-            double minVal, maxVal;
-            cv::minMaxLoc(m_MasterDark, &minVal, &maxVal);
-            if (maxVal <= 1.0)
-            {
-                if (m_BytesPerPixel == 1)
-                    m_MasterDark *= 255;
-                else if (m_BytesPerPixel == 2)
-                    m_MasterDark *= 65535;
-            }
-        }
+            master = imageClone;
         else
         {
             // Scale the flat down using the median value (note that this also takes care of normalised flats 0-1
@@ -283,8 +297,72 @@ void FITSStack::addMaster(const bool dark, void * imageBuffer, const int width,
             cv::merge(channels, imageClone);
             // Store the inverse of the flat so we can then multiply it with the sub because
             // multiply is faster than divide in openCV
-            cv::divide(1.0f, imageClone, m_MasterFlatInv);
+            cv::divide(1.0f, imageClone, master);
+        }
+
+        {
+            QMutexLocker locker(&m_StackImageMutex);
+            if (dark)
+                m_MasterDark = master;
+            else
+                m_MasterFlatInv = master;
+        }
+
+        m_MastersChecked = false;
+        if (m_BytesPerPixel > 0)
+            checkMasters();
+    }
+    catch (const cv::Exception &ex)
+    {
+        QString s1 = ex.what();
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(s1).arg(__FUNCTION__);
+    }
+}
+
+// Check the masters match the subs, and scale a normalised dark to the range of the subs.
+// Called once the first sub has set the image shape and bytes per pixel
+void FITSStack::checkMasters()
+{
+    try
+    {
+        m_MastersChecked = true;
+
+        cv::Mat dark, flatInv;
+        {
+            QMutexLocker locker(&m_StackImageMutex);
+            dark = m_MasterDark;
+            flatInv = m_MasterFlatInv;
+        }
+
+        // Pass 0 for bytesPerPixel to skip the check. This allows masters to be different datatypes to subs
+        if (!dark.empty() && !checkSub(dark.cols, dark.rows, 0, dark.channels()))
+        {
+            qCDebug(KSTARS_FITS) << QString("%1 Master dark doesn't match the subs so ignoring it").arg(__FUNCTION__);
+            dark.release();
+        }
+        if (!flatInv.empty() && !checkSub(flatInv.cols, flatInv.rows, 0, flatInv.channels()))
+        {
+            qCDebug(KSTARS_FITS) << QString("%1 Master flat doesn't match the subs so ignoring it").arg(__FUNCTION__);
+            flatInv.release();
+        }
+
+        if (!dark.empty())
+        {
+            // If the dark has been normalised to 0-1 then we need to increase values so they match the subs.
+            // Scale into a new Mat, as workers may still be calibrating with the old one
+            double minVal, maxVal;
+            cv::minMaxLoc(dark.reshape(1), &minVal, &maxVal);
+            if (maxVal <= 1.0 && (m_BytesPerPixel == 1 || m_BytesPerPixel == 2))
+            {
+                cv::Mat scaled;
+                dark.convertTo(scaled, -1, (m_BytesPerPixel == 1) ? 255 : 65535);
+                dark = scaled;
+            }
         }
+
+        QMutexLocker locker(&m_StackImageMutex);
+        m_MasterDark = dark;
+        m_MasterFlatInv = flatInv;
     }
     catch (const cv::Exception &ex)
     {
@@ -398,6 +476,7 @@ bool FITSStack::checkSub(const int width, const int height, const int bytesPerPi
 // Update plate solving status
 bool FITSStack::solverDone(const wcsprm * wcsHandle, const bool timedOut, const bool success, const double hfr, const int numStars)
 {
+    QMutexLocker locker(&m_StackImageMutex);
     if (m_StackImageData.size() <= 0)
     {
         // This shouldn't happen
@@ -433,11 +512,16 @@ bool FITSStack::solverDone(const wcsprm * wcsHandle, const bool timedOut, const
     m_StackImageData.last().wcsprm = wcsCopy;
     m_StackImageData.last().hfr = hfr;
     m_StackImageData.last().numStars = numStars;
+    locker.unlock();
+
+    // Align the sub while the next one is loaded and solved
+    startPrepareSub(m_StackImageData.size() - 1);
     return true;
 }
 
 void FITSStack::addSubStatus(const bool ok)
 {
+    QMutexLocker locker(&m_StackImageMutex);
     if (m_StackImageData.size() <= 0)
     {
         // This shouldn't happen
@@ -446,60 +530,204 @@ void FITSStack::addSubStatus(const bool ok)
     }
 
     (ok) ? m_StackImageData.last().status = OK : m_StackImageData.last().status = PLATESOLVE_FAILED;
+    locker.unlock();
+
+    if (ok)
+        startPrepareSub(m_StackImageData.size() - 1);
 }
 
-// Perform the initial stack
-bool FITSStack::stack()
+bool FITSStack::alignSubByStars(const QList<FITSImage::Star> &stars, const double hfr, const int numStars)
 {
-    try
+    QMutexLocker locker(&m_StackImageMutex);
+    if (m_StackImageData.size() <= 0)
     {
-        QElapsedTimer timer;
-        timer.start();
-        int numSubs = m_StackImageData.size();
+        // This shouldn't happen
+        qCDebug(KSTARS_FITS) << "alignSubByStars called but no m_StackImageData";
+        return false;
+    }
 
-        for(int i = 0; i < numSubs; i++)
-        {
-            // Ignore any bad subs
-            if (m_StackImageData[i].status != OK)
-                continue;
+    // Keep the stars in case this sub becomes the reference
+    m_StackImageData.last().stars = stars;
+    m_StackImageData.last().hfr = hfr;
+    m_StackImageData.last().numStars = numStars;
+    if (m_StackData.alignMethod != LS_ALIGNMENT_STARS || !m_StarMatcher.hasReference())
+        return false;
 
-            // Calibrate sub
-            if (!m_StackImageData[i].isCalibrated)
-            {
-                if (calibrateSub(m_StackImageData[i].image))
-                    m_StackImageData[i].isCalibrated = true;
-                else
-                {
-                    m_StackImageData[i].status = CALIBRATION_FAILED;
-                    continue;
-                }
-            }
+    cv::Mat warp;
+    if (!m_StarMatcher.align(stars, warp))
+    {
+        qCDebug(KSTARS_FITS) << "Star alignment failed, falling back to plate solving";
+        return false;
+    }
 
+    scaleWarpMatrix(warp);
+    m_StackImageData.last().warp = warp;
+    m_StackImageData.last().status = OK;
+    locker.unlock();
+
+    // Align the sub while the next one is loaded
+    startPrepareSub(m_StackImageData.size() - 1);
+    return true;
+}
+
+// The first good sub of the initial stack is the reference to which others are aligned
+void FITSStack::setReferenceSub(const int sub)
+{
+    m_InitialStackRef = sub;
+    m_StackImageData[sub].isAligned = true;
+    setWCSStackImage(m_StackImageData[sub].wcsprm);
+    if (m_StackData.alignMethod == LS_ALIGNMENT_STARS)
+        m_StarMatcher.setReference(m_StackImageData[sub].stars);
+}
+
+// Called on the main thread once a sub has been loaded and solved
+void FITSStack::startPrepareSub(const int sub)
+{
+    struct wcsprm * refWCS = nullptr;
+    {
+        QMutexLocker locker(&m_StackImageMutex);
+        if (m_InitialStackDone)
+            refWCS = m_RunningStackImageData.ref_wcsprm;
+        else
+        {
             if (m_InitialStackRef < 0)
+                setReferenceSub(sub);
+            refWCS = m_StackImageData[m_InitialStackRef].wcsprm;
+        }
+    }
+
+    m_SubsPreparing.ref();
+    QtConcurrent::run(&m_PreparePool, [this, sub, refWCS]()
+    {
+        prepareSub(sub, refWCS);
+        m_SubsPreparing.deref();
+        emit subPrepared();
+    });
+}
+
+// Calibrate and align a sub. This runs on worker threads so the sub is worked on outside the lock
+bool FITSStack::prepareSub(const int sub, struct wcsprm * refWCS)
+{
+    StackImageData data;
+    // The masters may be replaced while the sub is prepared, so calibrate with those current now
+    cv::Mat dark, flatInv;
+    {
+        QMutexLocker locker(&m_StackImageMutex);
+        if (sub < 0 || sub >= m_StackImageData.size())
+            return false;
+        data = m_StackImageData[sub];
+        dark = m_MasterDark;
+        flatInv = m_MasterFlatInv;
+    }
+
+    if (data.status != OK)
+        return false;
+    if (data.isCalibrated && data.isAligned)
+        return true;
+
+    try
+    {
+        // With tiled stacking bring the sub back into memory for calibration and alignment
+        if (!loadSub(data))
+            data.status = CALIBRATION_FAILED;
+        else if (!data.isCalibrated)
+        {
+            if (calibrateSub(data.image, dark, flatInv))
+                data.isCalibrated = true;
+            else
+                data.status = CALIBRATION_FAILED;
+        }
+
+        if (data.status == OK && !data.isAligned)
+        {
+            cv::Mat warp, warpedImage;
+            bool warpOK = true;
+            if (!data.warp.empty())
+                // Already aligned by star pattern
+                warp = data.warp;
+            else if (m_StackData.alignMethod != LS_ALIGNMENT_NONE)
             {
-                // First image ise reference  thto which others are aligned
-                m_InitialStackRef = i;
-                m_StackImageData[i].isAligned = true;
-                setWCSStackImage(m_StackImageData[i].wcsprm);
+                // wcslib may update the shared reference WCS so serialise its use
+                QMutexLocker locker(&m_WCSMutex);
+                warpOK = calcWarpMatrix(refWCS, data.wcsprm, warp);
             }
+
             if (m_StackData.alignMethod == LS_ALIGNMENT_NONE)
                 // No alignment needed so skip this stage
-                m_StackImageData[i].isAligned = true;
-            else if (!m_StackImageData[i].isAligned)
+                data.isAligned = true;
+            else if (!warpOK)
+                data.status = ALIGNMENT_FAILED;
+            else
             {
-                // Align this image to the reference image
-                cv::Mat warp, warpedImage;
-                if (!calcWarpMatrix(m_StackImageData[m_InitialStackRef].wcsprm, m_StackImageData[i].wcsprm, warp))
-                    m_StackImageData[i].status = ALIGNMENT_FAILED;
-                else
+                cv::warpPerspective(data.image, warpedImage, warp, data.image.size(), cv::INTER_LANCZOS4);
+                data.image = warpedImage;
+                data.isAligned = true;
+            }
+        }
+
+        // With tiled stacking return the aligned sub to disk
+        if (m_StackData.tiled && data.status == OK && !spillSub(data))
+            qCDebug(KSTARS_FITS) << QString("Unable to move sub to scratch file, keeping it in memory");
+    }
+    catch (const cv::Exception &ex)
+    {
+        QString s1 = ex.what();
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(s1).arg(__FUNCTION__);
+        data.status = ALIGNMENT_FAILED;
+    }
+
+    QMutexLocker locker(&m_StackImageMutex);
+    m_StackImageData[sub] = data;
+    return data.status == OK;
+}
+
+// Called from the stacking thread once every sub has been loaded and solved
+void FITSStack::prepareSubs(struct wcsprm * refWCS)
+{
+    m_PreparePool.waitForDone();
+
+    QVector<int> subs;
+    for (int i = 0; i < m_StackImageData.size(); i++)
+    {
+        if (m_StackImageData[i].status == OK && (!m_StackImageData[i].isCalibrated || !m_StackImageData[i].isAligned))
+            subs.push_back(i);
+    }
+    if (subs.isEmpty())
+        return;
+
+    qCDebug(KSTARS_FITS) << QString("Preparing %1 subs on %2 threads").arg(subs.size()).arg(QThread::idealThreadCount());
+    QtConcurrent::blockingMap(subs, [this, refWCS](const int sub)
+    {
+        prepareSub(sub, refWCS);
+    });
+}
+
+// Perform the initial stack
+bool FITSStack::stack()
+{
+    try
+    {
+        QElapsedTimer timer;
+        timer.start();
+        int numSubs = m_StackImageData.size();
+
+        // Calibrate and align any subs not already done in the background. If no sub has been
+        // prepared yet then the first good sub is the reference
+        m_PreparePool.waitForDone();
+        if (m_InitialStackRef < 0)
+        {
+            for (int i = 0; i < numSubs; i++)
+            {
+                if (m_StackImageData[i].status == OK)
                 {
-                    cv::warpPerspective(m_StackImageData[i].image, warpedImage, warp,
-                                        m_StackImageData[i].image.size(), cv::INTER_LANCZOS4);
-                    m_StackImageData[i].image = warpedImage;
-                    m_StackImageData[i].isAligned = true;
+                    setReferenceSub(i);
+                    break;
                 }
             }
         }
+        if (m_InitialStackRef >= 0)
+            prepareSubs(m_StackImageData[m_InitialStackRef].wcsprm);
+
         // Stack the aligned subs
         float totalWeight = 0.0;
         stackSubs(true, totalWeight, m_StackedImage32F);
@@ -540,39 +768,9 @@ bool FITSStack::stackn()
         timer.start();
         int numSubs = m_StackImageData.size();
 
-        for(int i = 0; i < numSubs; i++)
-        {
-            // Ignore any bad subs
-            if (m_StackImageData[i].status != OK)
-                continue;
-
-            // Calibrate sub
-            if (!m_StackImageData[i].isCalibrated)
-            {
-                if (calibrateSub(m_StackImageData[i].image))
-                    m_StackImageData[i].isCalibrated = true;
-                else
-                {
-                    m_StackImageData[i].status = CALIBRATION_FAILED;
-                    continue;
-                }
-            }
+        // Calibrate and align any subs not already done in the background
+        prepareSubs(m_RunningStackImageData.ref_wcsprm);
 
-            // Alignment stage
-            cv::Mat warp, warpedImage;
-            if (m_StackData.alignMethod == LS_ALIGNMENT_NONE)
-                // No alignment needed so skip this stage
-                m_StackImageData[i].isAligned = true;
-            else if (!calcWarpMatrix(m_RunningStackImageData.ref_wcsprm, m_StackImageData[i].wcsprm, warp))
-                m_StackImageData[i].status = ALIGNMENT_FAILED;
-            else
-            {
-                cv::warpPerspective(m_StackImageData[i].image, warpedImage, warp, m_StackImageData[i].image.size(),
-                                    cv::INTER_LANCZOS4);
-                m_StackImageData[i].image = warpedImage;
-                m_StackImageData[i].isAligned = true;
-            }
-        }
         // Stack the aligned subs
         float totalWeight = m_RunningStackImageData.totalWeight;
         if (stackSubs(false, totalWeight, m_StackedImage32F))
@@ -643,17 +841,8 @@ bool FITSStack::calcWarpMatrix(struct wcsprm * wcs1, struct wcsprm * wcs2, cv::M
         }
 
         // If we are downscaling the image we need to adjust the warp matrix which is calculated from the un-downscaled images
-        if (m_StackData.downscale != LS_DOWNSCALE_NONE)
-        {
-            double scale = 1.0 / getDownscaleFactor();
-            cv::Mat S = (cv::Mat_<double>(3,3) <<
-                         scale, 0,     0,
-                         0,     scale, 0,
-                         0,     0,     1 );
-            cv::Mat S_inv;
-            cv::invert(S, S_inv);
-            warp = S * warp * S_inv;
-        }
+        scaleWarpMatrix(warp);
+
         // Uncomment to display warp matrix - useless for debugging alignment issues
         //cv::Ptr<cv::Formatter> fmt = cv::Formatter::get(cv::Formatter::FMT_DEFAULT);
         //std::cout << fmt->format(warp) << std::endl;
@@ -667,8 +856,24 @@ bool FITSStack::calcWarpMatrix(struct wcsprm * wcs1, struct wcsprm * wcs2, cv::M
     }
 }
 
+// Warp matrices are calculated from the un-downscaled images so adjust them if we are downscaling
+void FITSStack::scaleWarpMatrix(cv::Mat &warp)
+{
+    if (m_StackData.downscale != LS_DOWNSCALE_NONE)
+    {
+        double scale = 1.0 / getDownscaleFactor();
+        cv::Mat S = (cv::Mat_<double>(3,3) <<
+                     scale, 0,     0,
+                     0,     scale, 0,
+                     0,     0,     1 );
+        cv::Mat S_inv;
+        cv::invert(S, S_inv);
+        warp = S * warp * S_inv;
+    }
+}
+
 // Calibrate the passed in sub with an associated Dark (if available) and / or Flat (if available)
-bool FITSStack::calibrateSub(cv::Mat &sub)
+bool FITSStack::calibrateSub(cv::Mat &sub, const cv::Mat &dark, const cv::Mat &flatInv)
 {
     try
     {
@@ -676,15 +881,15 @@ bool FITSStack::calibrateSub(cv::Mat &sub)
             return false;
 
         // Dark subtraction (make sure no negative pixels)
-        if (!m_MasterDark.empty())
+        if (!dark.empty())
         {
-            cv::subtract(sub, m_MasterDark, sub);
+            cv::subtract(sub, dark, sub);
             cv::max(sub, 0.0f, sub);
         }
 
         // Flat calibration
-        if (!m_MasterFlatInv.empty())
-            sub = sub.mul(m_MasterFlatInv);
+        if (!flatInv.empty())
+            sub = sub.mul(flatInv);
         return true;
     }
     catch (const cv::Exception &ex)
@@ -712,33 +917,26 @@ bool FITSStack::stackSubs(const bool initial, float &totalWeight, cv::Mat &stack
 
         QVector<float> weights = getWeights();
 
-        if (m_StackData.rejection == LS_STACKING_REJ_SIGMA || m_StackData.rejection == LS_STACKING_REJ_WINDSOR)
+        if (m_StackData.rejection == LS_STACKING_REJ_SIGMA || m_StackData.rejection == LS_STACKING_REJ_WINDSOR ||
+                m_StackData.rejection == LS_STACKING_REJ_LINEAR_FIT)
         {
-            if (initial)
+            if (m_Scratch)
+                stack = stackSubsSigmaClippingTiled(initial, weights);
+            else if (initial)
                 stack = stackSubsSigmaClipping(weights);
             else
                 stack = stacknSubsSigmaClipping(weights);
         }
-        else
+        else if (m_Scratch)
+            return stackSubsMeanTiled(initial, weights, totalWeight, stack);
+        else if (initial)
         {
             // Add the pixels weighted per sub based on user setting. Then divide by the total weight
-            // If its an initial stack then just use the subs, if not then include the existing partial stack
-            int start;
-            if (initial)
-            {
-                totalWeight = weights[0];
-                stack = m_StackImageData[0].image;
-                start = 1;
-            }
-            else
-            {
-                totalWeight = m_RunningStackImageData.totalWeight;
-                stack = m_StackedImage32F * totalWeight;
-                start = 0;
-            }
+            totalWeight = weights[0];
+            stack = m_StackImageData[0].image;
 
             cv::Mat temp;
-            for (int sub = start; sub < m_StackImageData.size(); sub++)
+            for (int sub = 1; sub < m_StackImageData.size(); sub++)
             {
                 if (m_StackData.weighting == LS_STACKING_EQUAL)
                     // No need to multiply by 1 for equal weighting
@@ -754,6 +952,19 @@ bool FITSStack::stackSubs(const bool initial, float &totalWeight, cv::Mat &stack
             cv::multiply(stack, 1.0 / totalWeight, stack, 1.0, m_CVType);
             //stack /= totalWeight;
         }
+        else
+        {
+            // Fold each sub into the running weighted mean in place, so the cost per sub doesn't depend
+            // on the number of subs already stacked
+            totalWeight = m_RunningStackImageData.totalWeight;
+            stack = m_StackedImage32F;
+            for (int sub = 0; sub < m_StackImageData.size(); sub++)
+            {
+                totalWeight += weights[sub];
+                const double fraction = weights[sub] / totalWeight;
+                cv::addWeighted(stack, 1.0 - fraction, m_StackImageData[sub].image, fraction, 0.0, stack, m_CVType);
+            }
+        }
         return true;
     }
     catch (const cv::Exception &ex)
@@ -822,7 +1033,6 @@ cv::Mat FITSStack::stackSubsSigmaClipping(const QVector<float> &weights)
         m_SigmaClip32FC4.resize(m_Channels);
         for (int ch = 0; ch < m_Channels; ch++)
             m_SigmaClip32FC4[ch] = cv::Mat::zeros(rows, cols, CV_32FC4);
-        QVector<cv::Vec4f *> sigmaClipPtr(m_Channels);
 
         // If all subs are continuous so we can treat as 1D arrays to speed things up
         bool continuous = finalImage.isContinuous() &&
@@ -855,21 +1065,24 @@ cv::Mat FITSStack::stackSubsSigmaClipping(const QVector<float> &weights)
                 imagesPtrs[i] = m_StackImageData[i].image.ptr<float>(0);
 
             float* finalImagePtr = finalImage.ptr<float>(0);
-            QVector<cv::Vec4f *> sigmaClipPtr(m_Channels);
+            QVector<float *> sigmaClipPtr(m_Channels);
             for (int ch = 0; ch < m_Channels; ch++)
-                sigmaClipPtr[ch] = m_SigmaClip32FC4[ch].ptr<cv::Vec4f>(0);
+                sigmaClipPtr[ch] = m_SigmaClip32FC4[ch].ptr<float>(0);
 
             // Setup the function for parallel processing to handle a chunk of pixels
             auto processPixelChunk = [&](const QPair<int, int>& chunk)
             {
-                for (int x = chunk.first; x < chunk.second; x++)
+                // One kernel per chunk so its scratch buffers are reused for every pixel of the chunk
+                FITSStackRejection rejection(m_StackData.rejection, m_StackData.lowSigma, m_StackData.highSigma,
+                                             m_StackData.windsorCutoff, weights);
+                for (int x = chunk.first; x < chunk.second; x += REJECTION_BATCH)
                 {
-                    // Cancellation check every once per 100 iterations
-                    if ((x - chunk.first) % 100 == 0 && QThread::currentThread()->isInterruptionRequested())
+                    // Cancellation check once per batch of pixels
+                    if (QThread::currentThread()->isInterruptionRequested())
                         return;
 
-                    // Process the pixel
-                    stackSigmaClipPixel(x, imagesPtrs, finalImagePtr, sigmaClipPtr, weights);
+                    rejection.process(imagesPtrs, x, std::min(x + REJECTION_BATCH, chunk.second), m_Channels,
+                                      finalImagePtr, sigmaClipPtr);
                 }
             };
 
@@ -879,9 +1092,11 @@ cv::Mat FITSStack::stackSubsSigmaClipping(const QVector<float> &weights)
         {
             qCDebug(KSTARS_FITS) << QString("Starting single thread sigma clipping");
 
-            std::vector<float> values(numImages);
+            FITSStackRejection rejection(m_StackData.rejection, m_StackData.lowSigma, m_StackData.highSigma,
+                                         m_StackData.windsorCutoff, weights);
+            QVector<float *> sigmaClipPtr(m_Channels);
 
-            // Process each pixel position
+            // Process each row
             std::vector<const float *> imagesPtrs(numImages);
             for (int y = 0; y < rows; y++)
             {
@@ -891,85 +1106,9 @@ cv::Mat FITSStack::stackSubsSigmaClipping(const QVector<float> &weights)
 
                 finalImagePtr = finalImage.ptr<float>(y);
                 for (int ch = 0; ch < m_Channels; ch++)
-                    sigmaClipPtr[ch] = m_SigmaClip32FC4[ch].ptr<cv::Vec4f>(y);
+                    sigmaClipPtr[ch] = m_SigmaClip32FC4[ch].ptr<float>(y);
 
-                for (int x = 0; x < cols; x++)
-                {
-                    // Process the pixel
-                    stackSigmaClipPixel(x, imagesPtrs, finalImagePtr, sigmaClipPtr, weights);
-
-                    // Collect values for this pixel/channel from all images
-                    for (int ch = 0; ch < m_Channels; ch++)
-                    {
-                        for (int image = 0; image < numImages; image++)
-                            values[image] = imagesPtrs[image][x * m_Channels + ch];
-
-                        float pixelValue = 0.0;
-
-                        if (m_StackData.rejection == LS_STACKING_REJ_WINDSOR)
-                        {
-                            // Winsorize the data
-                            float median = Mathematics::RobustStatistics::ComputeLocation(
-                                                    Mathematics::RobustStatistics::LOCATION_MEDIAN, values);
-                            auto const stddev = std::sqrt(Mathematics::RobustStatistics::ComputeScale(
-                                                    Mathematics::RobustStatistics::SCALE_VARIANCE, values));
-
-                            float lower = std::max(0.0, median - (stddev * m_StackData.windsorCutoff));
-                            float upper = median + (stddev * m_StackData.windsorCutoff);
-
-                            for (unsigned int i = 0; i < values.size(); i++)
-                            {
-                                if (values[i] < lower)
-                                    values[i] = lower;
-                                else if (values[i] > upper)
-                                    values[i] = upper;
-                            }
-                        }
-
-                        // Now process the data
-                        float median = Mathematics::RobustStatistics::ComputeLocation(
-                                                    Mathematics::RobustStatistics::LOCATION_MEDIAN, values);
-
-                        float sum = 0.0, weightSum = 0.0, lower = -1.0, upper = -1.0;
-                        if (values.size() <= 3)
-                            // For small samples just use median
-                            pixelValue = median;
-                        else
-                        {
-                            // Sigma clipping
-                            auto const stddev = std::sqrt(Mathematics::RobustStatistics::ComputeScale(
-                                                    Mathematics::RobustStatistics::SCALE_VARIANCE, values));
-
-                            // Get the lower and upper bounds
-                            lower = std::max(0.0, median - (stddev * m_StackData.lowSigma));
-                            upper = median + (stddev * m_StackData.highSigma);
-
-                            for (unsigned int i = 0; i < values.size(); i++)
-                            {
-                                if (values[i] < lower || values[i] > upper)
-                                    continue;
-
-                                sum += values[i] * weights[i];
-                                weightSum += weights[i];
-                            }
-
-                            if (weightSum > 0.0)
-                                pixelValue = sum / weightSum;
-                            else
-                                pixelValue = median;
-                        }
-                        // Store intermediate calcs from this process, necessary for processing new subs
-                        cv::Vec4f sigmaClip;
-                        sigmaClip[0] = lower;
-                        sigmaClip[1] = upper;
-                        sigmaClip[2] = sum;
-                        sigmaClip[3] = weightSum;
-                        sigmaClipPtr[ch][x] = sigmaClip;
-
-                        // Update the pixel/channel with the calculated value
-                        finalImagePtr[x * m_Channels + ch] = pixelValue;
-                    }
-                }
+                rejection.process(imagesPtrs, 0, cols, m_Channels, finalImagePtr, sigmaClipPtr);
             }
         }
         qCDebug(KSTARS_FITS) << QString("Sigma clipping completed in %1 ms").arg(timer.elapsed());
@@ -983,169 +1122,316 @@ cv::Mat FITSStack::stackSubsSigmaClipping(const QVector<float> &weights)
     }
 }
 
-// This function does the pixel level sigma clipping and Winsorization
-void FITSStack::stackSigmaClipPixel(int x, const std::vector<const float *> &imagesPtrs, float* finalImagePtr,
-                                    const QVector<cv::Vec4f *> &sigmaClipPtr, const QVector<float> &weights)
+// Function to add n subs to an existing stack using the running state of each pixel. The cost per sub
+// is independent of the number of subs already stacked
+cv::Mat FITSStack::stacknSubsSigmaClipping(const QVector<float> &weights)
 {
-    int numImages = imagesPtrs.size();
-    std::vector<float> values(numImages);
-    for (int ch = 0; ch < m_Channels; ch++)
+    try
     {
-        for (int image = 0; image < numImages; image++)
-            values[image] = imagesPtrs[image][x * m_Channels + ch];
+        QElapsedTimer timer;
+        timer.start();
 
-        float pixelValue = 0.0;
+        int rows = m_StackImageData[0].image.rows;
+        int cols = m_StackImageData[0].image.cols;
+        int numImages = m_StackImageData.size();
+        cv::Mat finalImage = m_StackedImage32F;
+        QVector<float *> sigmaClipPtr(m_Channels);
 
-        if (m_StackData.rejection == LS_STACKING_REJ_WINDSOR)
+        if (m_StackImageData.size() != weights.size() || m_SigmaClip32FC4.size() != m_Channels)
         {
-            // Winsorize the data
-            float median = Mathematics::RobustStatistics::ComputeLocation(
-                Mathematics::RobustStatistics::LOCATION_MEDIAN, values);
-            auto const stddev = std::sqrt(Mathematics::RobustStatistics::ComputeScale(
-                Mathematics::RobustStatistics::SCALE_VARIANCE, values));
-
-            float lower = std::max(0.0, median - (stddev * m_StackData.windsorCutoff));
-            float upper = median + (stddev * m_StackData.windsorCutoff);
-
-            for (unsigned int i = 0; i < values.size(); i++)
-            {
-                if (values[i] < lower)
-                    values[i] = lower;
-                else if (values[i] > upper)
-                    values[i] = upper;
-            }
+            qCDebug(KSTARS_FITS) << QString("Inconsistent subs and weights in %1").arg(__FUNCTION__);
+            return finalImage;
         }
 
-        // Now process the data
-        float median = Mathematics::RobustStatistics::ComputeLocation(
-            Mathematics::RobustStatistics::LOCATION_MEDIAN, values);
+        // If all images are continuous so we can treat as 1D arrays to speed things up
+        bool continuous = finalImage.isContinuous() &&
+                          std::all_of(m_SigmaClip32FC4.begin(), m_SigmaClip32FC4.end(),
+                                      [](const cv::Mat& mat) { return mat.isContinuous(); }) &&
+                          std::all_of(m_StackImageData.begin(), m_StackImageData.end(),
+                                      [](const StackImageData &data) {return data.image.isContinuous(); });
+        if (continuous)
+        {
+            cols *= rows;
+            rows = 1;
+        }
 
-        float sum = 0.0, weightSum = 0.0, lower = -1.0, upper = -1.0;
-        if (values.size() <= 3)
-            // For small samples just use median
-            pixelValue = median;
-        else
+        // Process a chunk of rows or, for continuous images, of pixels in parallel
+        std::vector<const float *> imagesPtrs(numImages);
+        for (int y = 0; y < rows; y++)
         {
-            // Sigma clipping
-            auto const stddev = std::sqrt(Mathematics::RobustStatistics::ComputeScale(
-                Mathematics::RobustStatistics::SCALE_VARIANCE, values));
+            // Update pointers for current y
+            for (int i = 0; i < numImages; i++)
+                imagesPtrs[i] = m_StackImageData[i].image.ptr<float>(y);
 
-            // Get the lower and upper bounds
-            lower = std::max(0.0, median - (stddev * m_StackData.lowSigma));
-            upper = median + (stddev * m_StackData.highSigma);
+            float *finalImagePtr = finalImage.ptr<float>(y);
+            for (int ch = 0; ch < m_Channels; ch++)
+                sigmaClipPtr[ch] = m_SigmaClip32FC4[ch].ptr<float>(y);
 
-            for (unsigned int i = 0; i < values.size(); i++)
+            const int chunkSize = std::max(REJECTION_BATCH, cols / (QThread::idealThreadCount() * 2));
+            QVector<QPair<int, int>> pixelChunks;
+            for (int start = 0; start < cols; start += chunkSize)
+                pixelChunks.append(qMakePair(start, std::min(start + chunkSize, cols)));
+
+            auto processPixelChunk = [&](const QPair<int, int>& chunk)
             {
-                if (values[i] < lower || values[i] > upper)
-                    continue;
+                FITSStackRejection rejection(m_StackData.rejection, m_StackData.lowSigma, m_StackData.highSigma,
+                                             m_StackData.windsorCutoff, weights);
+                for (int x = chunk.first; x < chunk.second; x += REJECTION_BATCH)
+                {
+                    // Cancellation check once per batch of pixels
+                    if (QThread::currentThread()->isInterruptionRequested())
+                        return;
 
-                sum += values[i] * weights[i];
-                weightSum += weights[i];
-            }
+                    rejection.accumulate(imagesPtrs, x, std::min(x + REJECTION_BATCH, chunk.second), m_Channels,
+                                         finalImagePtr, sigmaClipPtr);
+                }
+            };
 
-            if (weightSum > 0.0)
-                pixelValue = sum / weightSum;
-            else
-                pixelValue = median;
+            QtConcurrent::blockingMap(pixelChunks, processPixelChunk);
         }
-
-        // Store intermediate calcs from this process
-        cv::Vec4f sigmaClip;
-        sigmaClip[0] = lower;
-        sigmaClip[1] = upper;
-        sigmaClip[2] = sum;
-        sigmaClip[3] = weightSum;
-        sigmaClipPtr[ch][x] = sigmaClip;
-
-        // Update the pixel/channel with the calculated value
-        finalImagePtr[x * m_Channels + ch] = pixelValue;
+        qCDebug(KSTARS_FITS) << QString("Added %1 subs to running stack in %2 ms").arg(numImages).arg(timer.elapsed());
+        return finalImage;
+    }
+    catch (const cv::Exception &ex)
+    {
+        QString s1 = ex.what();
+        qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(s1).arg(__FUNCTION__);
+        return m_StackedImage32F;
     }
 }
 
-// Function to stack n subs to an existing stack using Sigma Clipping
-cv::Mat FITSStack::stacknSubsSigmaClipping(const QVector<float> &weights)
+// Function to stack subs held in the scratch file using standard or Windsorized Sigma Clipping.
+// A tile of rows of every sub is processed at a time, using parallel processing within the tile
+cv::Mat FITSStack::stackSubsSigmaClippingTiled(const bool initial, const QVector<float> &weights)
 {
     try
     {
-        int rows = m_StackImageData[0].image.rows;
-        int cols = m_StackImageData[0].image.cols;
-        int numImages = m_StackImageData.size();
-        cv::Mat finalImage = m_StackedImage32F;
-        float *finalImagePtr;
-        QVector<cv::Vec4f *> sigmaClipPtr(m_Channels);
+        QElapsedTimer timer;
+        timer.start();
 
         if (m_StackImageData.size() != weights.size())
         {
             qCDebug(KSTARS_FITS) << QString("Inconsistent subs and weights in %1").arg(__FUNCTION__);
-            return finalImage;
+            return initial ? cv::Mat() : m_StackedImage32F;
         }
 
-        // If all images are continuous so we can treat as 1D arrays to speed things up
+        int rows = m_Scratch->rows();
+        int cols = m_Scratch->cols();
+        int numImages = m_StackImageData.size();
+        int tileRows = std::max(1, m_StackData.tileRows);
+
+        cv::Mat finalImage;
+        if (initial)
+        {
+            // Setup structure for each channel for future sigma clipping
+            finalImage = cv::Mat::zeros(rows, cols, m_CVType);
+            m_SigmaClip32FC4.clear();
+            m_SigmaClip32FC4.resize(m_Channels);
+            for (int ch = 0; ch < m_Channels; ch++)
+                m_SigmaClip32FC4[ch] = cv::Mat::zeros(rows, cols, CV_32FC4);
+        }
+        else
+            finalImage = m_StackedImage32F;
+
+        // Rows of a tile are contiguous so each tile is processed as a 1D array
         bool continuous = finalImage.isContinuous() &&
                           std::all_of(m_SigmaClip32FC4.begin(), m_SigmaClip32FC4.end(),
-                                      [](const cv::Mat& mat) { return mat.isContinuous(); }) &&
-                          std::all_of(m_StackImageData.begin(), m_StackImageData.end(),
-                                      [](const StackImageData &data) {return data.image.isContinuous(); });
-        if (continuous)
+                                      [](const cv::Mat &mat) { return mat.isContinuous(); });
+        if (!continuous)
         {
-            cols *= rows;
-            rows = 1;
+            qCDebug(KSTARS_FITS) << QString("Tiled sigma clipping requires continuous images in %1").arg(__FUNCTION__);
+            return initial ? cv::Mat() : m_StackedImage32F;
         }
 
-        // Process each pixel position
+        qCDebug(KSTARS_FITS) << QString("Starting tiled sigma clipping: %1 subs in tiles of %2 rows on %3 threads")
+                                            .arg(numImages).arg(tileRows).arg(QThread::idealThreadCount());
+
+        std::vector<cv::Mat> tiles;
         std::vector<const float *> imagesPtrs(numImages);
-        for (int y = 0; y < rows; y++)
+        QVector<float *> statePtr(m_Channels);
+        for (int firstRow = 0; firstRow < rows; firstRow += tileRows)
         {
-            // Update pointers for current y
-            for (int i = 0; i < numImages; i++)
-                imagesPtrs[i] = m_StackImageData[i].image.ptr<float>(y);
+            int numRows = std::min(tileRows, rows - firstRow);
+            if (!getSubTiles(firstRow, numRows, tiles) ||
+                    !std::all_of(tiles.begin(), tiles.end(), [](const cv::Mat &tile) { return tile.isContinuous(); }))
+            {
+                qCDebug(KSTARS_FITS) << QString("Unable to read tile at row %1 in %2").arg(firstRow).arg(__FUNCTION__);
+                m_Scratch->unmapTiles();
+                return initial ? cv::Mat() : m_StackedImage32F;
+            }
 
-            finalImagePtr = finalImage.ptr<float>(y);
+            for (int i = 0; i < numImages; i++)
+                imagesPtrs[i] = tiles[i].ptr<float>(0);
+            float* finalImagePtr = finalImage.ptr<float>(firstRow);
             for (int ch = 0; ch < m_Channels; ch++)
-                sigmaClipPtr[ch] = m_SigmaClip32FC4[ch].ptr<cv::Vec4f>(y);
+                statePtr[ch] = m_SigmaClip32FC4[ch].ptr<float>(firstRow);
 
-            for (int x = 0; x < cols; x++)
+            // Chunk up the tile for available threads
+            int pixels = numRows * cols;
+            const int chunkSize = std::max(1, pixels / (QThread::idealThreadCount() * 2));
+
+            QVector<QPair<int, int>> pixelChunks;
+            for (int start = 0; start < pixels; start += chunkSize)
+                pixelChunks.append(qMakePair(start, std::min(start + chunkSize, pixels)));
+
+            auto processPixelChunk = [&](const QPair<int, int>& chunk)
             {
-                for (int ch = 0; ch < m_Channels; ch++)
+                // One kernel per chunk so its scratch buffers are reused for every pixel of the chunk
+                FITSStackRejection rejection(m_StackData.rejection, m_StackData.lowSigma, m_StackData.highSigma,
+                                             m_StackData.windsorCutoff, weights);
+                for (int x = chunk.first; x < chunk.second; x += REJECTION_BATCH)
                 {
-                    // Get the sigma clip data from the current pixel/channel
-                    cv::Vec4f sigmaClip = sigmaClipPtr[ch][x];
-                    float lower = sigmaClip[0];
-                    float upper = sigmaClip[1];
-                    float sum = sigmaClip[2];
-                    float weightSum = sigmaClip[3];
-
-                    // Process each image
-                    for (int image = 0; image < numImages; image++)
-                    {
-                        float pixel = imagesPtrs[image][x * m_Channels + ch];
-                        if (lower < 0.0 || (pixel >= lower && pixel <= upper))
-                        {
-                            sum += pixel * weights[image];
-                            weightSum += weights[image];
-                        }
-                    }
-
-                    // Update image pixel with new value
-                    finalImagePtr[x * m_Channels + ch] = sum / weightSum;
-
-                    // Save the new intermediate results for next time
-                    sigmaClip[2] = sum;
-                    sigmaClip[3] = weightSum;
-                    sigmaClipPtr[ch][x] = sigmaClip;
+                    // Cancellation check once per batch of pixels
+                    if (QThread::currentThread()->isInterruptionRequested())
+                        return;
+
+                    const int last = std::min(x + REJECTION_BATCH, chunk.second);
+                    if (initial)
+                        rejection.process(imagesPtrs, x, last, m_Channels, finalImagePtr, statePtr);
+                    else
+                        rejection.accumulate(imagesPtrs, x, last, m_Channels, finalImagePtr, statePtr);
                 }
-            }
+            };
+
+            QtConcurrent::blockingMap(pixelChunks, processPixelChunk);
         }
+        m_Scratch->unmapTiles();
+
+        qCDebug(KSTARS_FITS) << QString("Tiled sigma clipping completed in %1 ms").arg(timer.elapsed());
         return finalImage;
     }
     catch (const cv::Exception &ex)
     {
         QString s1 = ex.what();
         qCDebug(KSTARS_FITS) << QString("openCV exception %1 called from %2").arg(s1).arg(__FUNCTION__);
-        return m_StackedImage32F;
+        m_Scratch->unmapTiles();
+        return initial ? cv::Mat() : m_StackedImage32F;
     }
 }
 
+// Weighted mean of subs held in the scratch file, a tile of rows of every sub at a time
+bool FITSStack::stackSubsMeanTiled(const bool initial, const QVector<float> &weights, float &totalWeight, cv::Mat &stack)
+{
+    int rows = m_Scratch->rows();
+    int tileRows = std::max(1, m_StackData.tileRows);
+
+    // An initial stack is the weighted sum of the subs divided by the total weight at the end. An incremental
+    // stack folds each sub into the running weighted mean in place, using the fraction of the total weight
+    // reached by that sub
+    QVector<double> fractions(weights.size());
+    if (initial)
+    {
+        totalWeight = 0.0;
+        stack = cv::Mat::zeros(rows, m_Scratch->cols(), m_CVType);
+    }
+    else
+    {
+        totalWeight = m_RunningStackImageData.totalWeight;
+        stack = m_StackedImage32F;
+    }
+    for (int sub = 0; sub < weights.size(); sub++)
+    {
+        totalWeight += weights[sub];
+        fractions[sub] = weights[sub] / totalWeight;
+    }
+
+    std::vector<cv::Mat> tiles;
+    for (int firstRow = 0; firstRow < rows; firstRow += tileRows)
+    {
+        int numRows = std::min(tileRows, rows - firstRow);
+        if (!getSubTiles(firstRow, numRows, tiles))
+        {
+            qCDebug(KSTARS_FITS) << QString("Unable to read tile at row %1 in %2").arg(firstRow).arg(__FUNCTION__);
+            m_Scratch->unmapTiles();
+            return false;
+        }
+
+        cv::Mat stackTile = stack.rowRange(firstRow, firstRow + numRows);
+        for (unsigned int sub = 0; sub < tiles.size(); sub++)
+        {
+            if (!initial)
+                cv::addWeighted(stackTile, 1.0 - fractions[sub], tiles[sub], fractions[sub], 0.0, stackTile, m_CVType);
+            else if (m_StackData.weighting == LS_STACKING_EQUAL)
+                cv::add(stackTile, tiles[sub], stackTile);
+            else
+                cv::scaleAdd(tiles[sub], weights[sub], stackTile, stackTile);
+        }
+    }
+    m_Scratch->unmapTiles();
+
+    if (initial)
+        cv::multiply(stack, 1.0 / totalWeight, stack, 1.0, m_CVType);
+    return true;
+}
+
+// Move the sub's image to the scratch file, creating the file for the first sub
+bool FITSStack::spillSub(StackImageData &data)
+{
+    if (data.image.empty())
+        return true;
+
+    QMutexLocker locker(&m_ScratchMutex);
+    if (!m_Scratch)
+    {
+        m_Scratch.reset(new FITSStackScratch(data.image.rows, data.image.cols, data.image.type()));
+        if (!m_Scratch->isOpen())
+        {
+            m_Scratch.reset();
+            return false;
+        }
+    }
+
+    int index = m_Scratch->store(data.image, data.scratchIndex);
+    if (index < 0)
+        return false;
+
+    data.scratchIndex = index;
+    data.image.release();
+    return true;
+}
+
+// Bring the sub's image back from the scratch file, if it was spilled
+bool FITSStack::loadSub(StackImageData &data)
+{
+    if (!data.image.empty() || data.scratchIndex < 0)
+        return true;
+
+    QMutexLocker locker(&m_ScratchMutex);
+    std::vector<cv::Mat> tiles;
+    if (!m_Scratch || !m_Scratch->mapTiles({ data.scratchIndex }, 0, m_Scratch->rows(), tiles))
+        return false;
+
+    data.image = tiles[0].clone();
+    m_Scratch->unmapTiles();
+    return true;
+}
+
+// Get the same tile from each sub, mapped from the scratch file for subs that have been spilled
+bool FITSStack::getSubTiles(const int firstRow, const int numRows, std::vector<cv::Mat> &tiles)
+{
+    QVector<int> indexes;
+    for (const auto &sub : m_StackImageData)
+    {
+        if (sub.image.empty() && sub.scratchIndex >= 0)
+            indexes.push_back(sub.scratchIndex);
+    }
+
+    std::vector<cv::Mat> mapped;
+    if (!indexes.isEmpty() && (!m_Scratch || !m_Scratch->mapTiles(indexes, firstRow, numRows, mapped)))
+        return false;
+
+    tiles.clear();
+    int next = 0;
+    for (const auto &sub : m_StackImageData)
+    {
+        if (sub.image.empty() && sub.scratchIndex >= 0)
+            tiles.push_back(mapped[next++]);
+        else
+            tiles.push_back(sub.image.rowRange(firstRow, firstRow + numRows));
+    }
+    return true;
+}
+
 void FITSStack::setWCSStackImage(const struct wcsprm *wcs)
 {
     if (!wcs)
@@ -1787,6 +2073,7 @@ void FITSStack::tidyUpInitalStack(struct wcsprm * refWCS)
         m_StackImageData[i].image.release();
     }
     m_StackImageData.clear();
+    m_Scratch.reset();
 }
 
 // Release FITS and openCV memory used in the running stack
@@ -19,10 +19,17 @@
 #endif
 
 #include "fitscommon.h"
+#include "fitsstackscratch.h"
+#include "fitsstackstarmatch.h"
 #include "ekos/auxiliary/solverutils.h"
 #include <fits_debug.h>
+#include <QAtomicInt>
+#include <QMutex>
 #include <QObject>
 #include <QPointer>
+#include <QThreadPool>
+
+#include <memory>
 
 // Include OpenCV headers after Windows headers
 #ifdef _WIN32
@@ -75,7 +82,9 @@ class StellarSolverProfileEditor;
  * - **Alignment**: An alignment master is selected and all frames aligned to the master.
  *   Plate solving is used for alignment. WCS is used to workout the transformation from the
  *   existing sub to the aligned sub and openCV functions warp the sub based on the
- *   transformation.
+ *   transformation. Alternatively, with star pattern alignment only the master is plate solved;
+ *   other subs just have their stars extracted and matched to the master's stars by
+ *   FITSStackStarMatcher, falling back to plate solving if the match fails.
  *
  * - **Calibration Support**: Master darks and flats can be optionally applied before stacking.
  *   Flats and darks may be stacked separately and saved as masters to be applied during
@@ -91,6 +100,15 @@ class StellarSolverProfileEditor;
  *   displayed. The system then repeats until all subs have been processed, then waits for new
  *   subs to arrives and adds these to the stack.
  *
+ * - **Tiled Stacking**: Optionally, subs are moved to a scratch file as soon as they are loaded.
+ *   Calibration and alignment bring one sub at a time back into memory, and stacking maps a tile
+ *   of rows of every sub at a time, so memory use no longer grows with the number of subs in memory.
+ *
+ * - **Pipeline**: As soon as a sub has been plate solved it is calibrated and aligned on a pool of
+ *   worker threads, while the next sub is loaded and solved. Stacking waits for the pool to finish.
+ *   FITSData stops loading subs while the pool is full, so a directory of existing subs doesn't
+ *   queue up in memory faster than it can be aligned.
+ *
  * - **Live Output**: The integrated stack is updated after new subs are added.
  *
  * - **Post Processing**: Optionally, simple routines for deconvolution, unsharp mask and
@@ -152,6 +170,25 @@ class FITSStack : public QObject
          */
         void addSubStatus(const bool ok);
 
+        /**
+         * @brief Stars have been extracted from the latest sub. With star pattern alignment, try to align
+         * the sub to the reference sub's stars so it doesn't need to be plate solved.
+         * @param stars extracted from the sub
+         * @param median HFR of stars
+         * @param number of stars
+         * @return sub aligned (or not, in which case it should be plate solved)
+         */
+        bool alignSubByStars(const QList<FITSImage::Star> &stars, const double hfr, const int numStars);
+
+        /**
+         * @brief Determine whether the pool calibrating and aligning subs has as much work as it can take
+         * @return pool full (or not)
+         */
+        bool isPreparePoolFull() const
+        {
+            return m_SubsPreparing.loadAcquire() >= 2 * m_PreparePool.maxThreadCount();
+        }
+
         /**
          * @brief Perform an initial stack
          */
@@ -273,6 +310,11 @@ class FITSStack : public QObject
     signals:
         void stackChanged();
 
+        /**
+         * @brief Emitted from a worker thread when a sub has been calibrated and aligned
+         */
+        void subPrepared();
+
     public slots:
     private:      
         typedef enum
@@ -290,6 +332,11 @@ class FITSStack : public QObject
          */
         bool checkSub(const int width, const int height, const int bytesPerPixel, const int channels);
 
+        /**
+         * @brief Check the masters against the first sub and scale a normalised master dark to match it.
+         */
+        void checkMasters();
+
         /**
          * @brief Convert the input image to float and downscale if required
          * @param input image
@@ -341,6 +388,12 @@ class FITSStack : public QObject
          */
         bool calcWarpMatrix(struct wcsprm * wcs1, struct wcsprm * wcs2, cv::Mat &warp);
 
+        /**
+         * @brief Adjust a warp matrix calculated on full size subs for any downscaling
+         * @param warp matrix
+         */
+        void scaleWarpMatrix(cv::Mat &warp);
+
         /**
          * @brief Convert passed in Mat to FITS format
          * @param image
@@ -351,9 +404,11 @@ class FITSStack : public QObject
         /**
          * @brief Calibrate the passed in sub
          * @param sub to be calibrated
+         * @param dark master, or empty for none
+         * @param flatInv inverse of the master flat, or empty for none
          * @return success (or not)
          */
-        bool calibrateSub(cv::Mat &sub);
+        bool calibrateSub(cv::Mat &sub, const cv::Mat &dark, const cv::Mat &flatInv);
 
         /**
          * @brief Stack the passed in vector of subs
@@ -365,29 +420,48 @@ class FITSStack : public QObject
         bool stackSubs(const bool initial, float &totalWeight, cv::Mat &stack);
 
         /**
-         * @brief Stack the passed in vector of subs using Sigma Clipping
+         * @brief Stack the passed in vector of subs using Sigma, Winsorized Sigma or Linear Fit Clipping.
+         * Pixels are processed by FITSStackRejection.
          * @param weights of each sub for the stack
          * @return stack is returned to the caller
          */
         cv::Mat stackSubsSigmaClipping(const QVector<float> &weights);
 
         /**
-         * @brief Called by stackSubsSigmaClipping to do the sigma clipping on pixel at position x
-         * @param x position to process
-         * @param imagesPtrs array of pointers to each image
-         * @param finalImagePtr results image
-         * @param sigmaClipPtr intermediate results pointer
-         * @param weights to apply to sigma clipping
+         * @brief Add the passed in vector of subs to an existing stack, rejecting outliers against the running
+         * mean and standard deviation of each pixel held in m_SigmaClip32FC4
+         * @param weights of each sub for the stack
+         * @return stack
          */
-        void stackSigmaClipPixel(int x, const std::vector<const float *> &imagesPtrs, float* finalImagePtr,
-                                 const QVector<cv::Vec4f *> &sigmaClipPtr, const QVector<float> &weights);
+        cv::Mat stacknSubsSigmaClipping(const QVector<float> &weights);
 
         /**
-         * @brief Stack the passed in vector of subs to an existing stack using Sigma Clipping
+         * @brief Tiled equivalent of stackSubsSigmaClipping (initial) and stacknSubsSigmaClipping (incremental)
+         * processing a tile of rows of every sub at a time
+         * @param initial stack (or incremental)
          * @param weights of each sub for the stack
          * @return stack
          */
-        cv::Mat stacknSubsSigmaClipping(const QVector<float> &weights);
+        cv::Mat stackSubsSigmaClippingTiled(const bool initial, const QVector<float> &weights);
+
+        /**
+         * @brief Tiled equivalent of the weighted mean stack, processing a tile of rows of every sub at a time
+         * @param initial stack (or incremental)
+         * @param weights of each sub for the stack
+         * @param totalWeight is the weight of the current stack if this is an incremental stack
+         * @param stack is returned to the caller
+         * @return success (or not)
+         */
+        bool stackSubsMeanTiled(const bool initial, const QVector<float> &weights, float &totalWeight, cv::Mat &stack);
+
+        /**
+         * @brief Get rows [firstRow, firstRow + numRows) of every sub, from memory or the scratch file
+         * @param firstRow of the tile
+         * @param numRows in the tile
+         * @param tiles returned views, one per sub, valid until the next call
+         * @return success (or not)
+         */
+        bool getSubTiles(const int firstRow, const int numRows, std::vector<cv::Mat> &tiles);
 
         /**
          * @brief Store the WCS for the stack image based on the WCS for the master alignment sub
@@ -473,8 +547,55 @@ class FITSStack : public QObject
             struct wcsprm * wcsprm;
             double hfr;
             int numStars;
+            int scratchIndex;
+            // Stars extracted for star pattern alignment, and the resulting warp to the reference sub
+            QList<FITSImage::Star> stars;
+            cv::Mat warp;
         } StackImageData;
         QVector<StackImageData> m_StackImageData;
+        // Guards m_StackImageData and the masters while subs are prepared in the background
+        QMutex m_StackImageMutex;
+
+        /**
+         * @brief Move the image of a sub to the scratch file and release its memory. Thread safe
+         * @param data of the sub
+         * @return success (or not). On failure the image stays in memory
+         */
+        bool spillSub(StackImageData &data);
+
+        /**
+         * @brief Bring the image of a spilled sub back into memory. Thread safe
+         * @param data of the sub
+         * @return success (or not)
+         */
+        bool loadSub(StackImageData &data);
+
+        /**
+         * @brief Make the sub the reference frame to which other subs in the initial stack are aligned
+         * @param sub index in m_StackImageData
+         */
+        void setReferenceSub(const int sub);
+
+        /**
+         * @brief Start calibrating and aligning the sub on the prepare pool
+         * @param sub index in m_StackImageData
+         */
+        void startPrepareSub(const int sub);
+
+        /**
+         * @brief Calibrate and align the sub, and return it to the scratch file when tiled stacking.
+         * Thread safe: the sub is copied out of m_StackImageData, processed and copied back.
+         * @param sub index in m_StackImageData
+         * @param refWCS of the reference frame to align to
+         * @return sub is OK
+         */
+        bool prepareSub(const int sub, struct wcsprm * refWCS);
+
+        /**
+         * @brief Wait for subs being prepared in the background, then prepare any others in parallel
+         * @param refWCS of the reference frame to align to
+         */
+        void prepareSubs(struct wcsprm * refWCS);
 
         typedef struct
         {
@@ -499,16 +620,29 @@ class FITSStack : public QObject
         LiveStackData m_StackData;
 
         // Calibration
+        // Kept as loaded until checkMasters() has compared them with the first sub. Replaced, never changed
+        // in place, under m_StackImageMutex so workers can calibrate with a snapshot of them
         cv::Mat m_MasterDark;
         cv::Mat m_MasterFlatInv;
+        bool m_MastersChecked { true };
 
         // Aligning
         int m_InitialStackRef = -1;
+        FITSStackStarMatcher m_StarMatcher;
 
         // Stacking
         cv::Mat m_StackedImage32F;
+        // Per channel running state of each pixel when rejecting outliers: mean, sum of squared deviations,
+        // sum of weights and count of accepted values (see FITSStackRejection)
         QVector<cv::Mat> m_SigmaClip32FC4;
         QSharedPointer<QByteArray> m_StackedBuffer { nullptr };
+        std::unique_ptr<FITSStackScratch> m_Scratch;
+        QMutex m_ScratchMutex;
+
+        // Calibration and alignment of subs in the background
+        QThreadPool m_PreparePool;
+        QAtomicInt m_SubsPreparing { 0 };
+        QMutex m_WCSMutex;
 
         // Stack Image
         struct wcsprm * m_WCSStackImage { nullptr };
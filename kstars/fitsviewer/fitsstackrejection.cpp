@@ -0,0 +1,310 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsstackrejection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+// Linear fit clipping stops when no more than this number of values remain
+const int minLinearFitValues = 3;
+// and after this number of iterations
+const int maxLinearFitIterations = 10;
+}
+
+FITSStackRejection::FITSStackRejection(const LiveStackRejection method, const double lowSigma, const double highSigma,
+                                       const double winsorCutoff, const QVector<float> &weights)
+    : m_Method(method), m_LowSigma(lowSigma), m_HighSigma(highSigma), m_WinsorCutoff(winsorCutoff),
+      m_Weights(weights), m_NumImages(weights.size())
+{
+    m_Block.resize(m_NumImages * BlockSize);
+    m_Values.resize(m_NumImages);
+}
+
+void FITSStackRejection::process(const std::vector<const float *> &images, const int first, const int last,
+                                 const int channels, float *result, const QVector<float *> &state)
+{
+    if (m_NumImages <= 0 || static_cast<int>(images.size()) != m_NumImages)
+        return;
+
+    for (int x = first; x < last; x += BlockSize)
+    {
+        const int n = std::min(BlockSize, last - x);
+        for (int ch = 0; ch < channels; ch++)
+            processBlock(images, x, n, channels, ch, result, state[ch]);
+    }
+}
+
+void FITSStackRejection::processBlock(const std::vector<const float *> &images, const int x, const int n,
+                                      const int channels, const int ch, float *result, float *state)
+{
+    float *block = m_Block.data();
+
+    // Gather the block sub by sub. Unused columns of a partial block are zeroed and ignored
+    for (int i = 0; i < m_NumImages; i++)
+    {
+        const float *src = images[i] + x * channels + ch;
+        float *dst = block + i * BlockSize;
+        for (int p = 0; p < n; p++)
+            dst[p] = src[p * channels];
+        for (int p = n; p < BlockSize; p++)
+            dst[p] = 0.0f;
+    }
+
+    if (m_Method == LS_STACKING_REJ_WINDSOR)
+    {
+        // Winsorize the data
+        standardDeviations();
+        for (int p = 0; p < n; p++)
+        {
+            const float median = this->median(p);
+            m_Lower[p] = std::max(0.0, median - (m_StdDev[p] * m_WinsorCutoff));
+            m_Upper[p] = median + (m_StdDev[p] * m_WinsorCutoff);
+        }
+        for (int i = 0; i < m_NumImages; i++)
+        {
+            float *values = block + i * BlockSize;
+            for (int p = 0; p < n; p++)
+                values[p] = (values[p] < m_Lower[p]) ? m_Lower[p] : ((values[p] > m_Upper[p]) ? m_Upper[p] : values[p]);
+        }
+    }
+
+    // Get the lower and upper bounds
+    const bool smallSample = m_NumImages <= MinRejectionCount;
+    if (smallSample)
+    {
+        // For small samples just use the median, but keep every value in the running state
+        for (int p = 0; p < n; p++)
+        {
+            m_Median[p] = median(p);
+            m_Lower[p] = std::numeric_limits<float>::lowest();
+            m_Upper[p] = std::numeric_limits<float>::max();
+        }
+    }
+    else if (m_Method == LS_STACKING_REJ_LINEAR_FIT)
+    {
+        for (int p = 0; p < n; p++)
+            m_Median[p] = linearFit(p, m_Lower[p], m_Upper[p]);
+    }
+    else
+    {
+        standardDeviations();
+        for (int p = 0; p < n; p++)
+        {
+            m_Median[p] = median(p);
+            m_Lower[p] = std::max(0.0, m_Median[p] - (m_StdDev[p] * m_LowSigma));
+            m_Upper[p] = m_Median[p] + (m_StdDev[p] * m_HighSigma);
+        }
+    }
+    for (int p = n; p < BlockSize; p++)
+    {
+        m_Lower[p] = 0.0f;
+        m_Upper[p] = 0.0f;
+    }
+
+    // Weighted sum of the accepted values of the whole block
+    float sum[BlockSize] = { 0.0f };
+    float weightSum[BlockSize] = { 0.0f };
+    float count[BlockSize] = { 0.0f };
+    for (int i = 0; i < m_NumImages; i++)
+    {
+        const float *values = block + i * BlockSize;
+        const float weight = m_Weights[i];
+        for (int p = 0; p < BlockSize; p++)
+        {
+            const bool accept = values[p] >= m_Lower[p] && values[p] <= m_Upper[p];
+            sum[p] += accept ? values[p] * weight : 0.0f;
+            weightSum[p] += accept ? weight : 0.0f;
+            count[p] += accept ? 1.0f : 0.0f;
+        }
+    }
+
+    // Weighted sum of squared deviations of the accepted values from their mean
+    float mean[BlockSize];
+    float m2[BlockSize] = { 0.0f };
+    for (int p = 0; p < BlockSize; p++)
+        mean[p] = (weightSum[p] > 0.0f) ? sum[p] / weightSum[p] : 0.0f;
+    for (int i = 0; i < m_NumImages; i++)
+    {
+        const float *values = block + i * BlockSize;
+        const float weight = m_Weights[i];
+        for (int p = 0; p < BlockSize; p++)
+        {
+            const bool accept = values[p] >= m_Lower[p] && values[p] <= m_Upper[p];
+            const float delta = values[p] - mean[p];
+            m2[p] += accept ? weight * delta * delta : 0.0f;
+        }
+    }
+
+    for (int p = 0; p < n; p++)
+    {
+        const int pixel = x + p;
+        const bool accepted = weightSum[p] > 0.0f;
+        result[pixel * channels + ch] = (smallSample || !accepted) ? m_Median[p] : mean[p];
+        float *pixelState = state + pixel * 4;
+        pixelState[0] = accepted ? mean[p] : m_Median[p];
+        pixelState[1] = accepted ? m2[p] : 0.0f;
+        pixelState[2] = weightSum[p];
+        pixelState[3] = count[p];
+    }
+}
+
+void FITSStackRejection::accumulate(const std::vector<const float *> &images, const int first, const int last,
+                                    const int channels, float *result, const QVector<float *> &state)
+{
+    const int numImages = std::min(static_cast<int>(images.size()), m_NumImages);
+
+    for (int x = first; x < last; x++)
+    {
+        for (int ch = 0; ch < channels; ch++)
+        {
+            float *pixelState = state[ch] + x * 4;
+            double mean = pixelState[0];
+            double m2 = pixelState[1];
+            double weightSum = pixelState[2];
+            double count = pixelState[3];
+
+            for (int i = 0; i < numImages; i++)
+            {
+                double value = images[i][x * channels + ch];
+
+                if (count > MinRejectionCount && weightSum > 0.0)
+                {
+                    // Bounds follow the running statistics of the accepted values rather than being fixed
+                    // by the initial stack. The weighted variance is scaled to a sample variance.
+                    const double stddev = std::sqrt(m2 / weightSum * count / (count - 1.0));
+                    if (m_Method == LS_STACKING_REJ_WINDSOR)
+                    {
+                        const double lower = std::max(0.0, mean - (stddev * m_WinsorCutoff));
+                        const double upper = mean + (stddev * m_WinsorCutoff);
+                        value = (value < lower) ? lower : ((value > upper) ? upper : value);
+                    }
+                    if (value < std::max(0.0, mean - (stddev * m_LowSigma)) || value > mean + (stddev * m_HighSigma))
+                        continue;
+                }
+
+                // West's weighted update of the running mean and sum of squared deviations
+                const double weight = m_Weights[i];
+                weightSum += weight;
+                const double delta = value - mean;
+                mean += delta * weight / weightSum;
+                m2 += weight * delta * (value - mean);
+                count += 1.0;
+            }
+
+            result[x * channels + ch] = mean;
+            pixelState[0] = mean;
+            pixelState[1] = m2;
+            pixelState[2] = weightSum;
+            pixelState[3] = count;
+        }
+    }
+}
+
+float FITSStackRejection::median(const int p)
+{
+    for (int i = 0; i < m_NumImages; i++)
+        m_Values[i] = m_Block[i * BlockSize + p];
+
+    const int middle = m_NumImages / 2;
+    std::nth_element(m_Values.begin(), m_Values.begin() + middle, m_Values.end());
+    if (m_NumImages % 2 != 0)
+        return m_Values[middle];
+
+    // Even number of values: average the two middle values
+    const float lowerMiddle = *std::max_element(m_Values.begin(), m_Values.begin() + middle);
+    return 0.5 * (static_cast<double>(lowerMiddle) + m_Values[middle]);
+}
+
+void FITSStackRejection::standardDeviations()
+{
+    double mean[BlockSize] = { 0.0 };
+    double variance[BlockSize] = { 0.0 };
+
+    for (int i = 0; i < m_NumImages; i++)
+    {
+        const float *values = m_Block.data() + i * BlockSize;
+        for (int p = 0; p < BlockSize; p++)
+            mean[p] += values[p];
+    }
+    for (int p = 0; p < BlockSize; p++)
+        mean[p] /= m_NumImages;
+
+    for (int i = 0; i < m_NumImages; i++)
+    {
+        const float *values = m_Block.data() + i * BlockSize;
+        for (int p = 0; p < BlockSize; p++)
+        {
+            const double delta = values[p] - mean[p];
+            variance[p] += delta * delta;
+        }
+    }
+
+    // Sample standard deviation
+    const double scale = (m_NumImages > 1) ? 1.0 / (m_NumImages - 1) : 0.0;
+    for (int p = 0; p < BlockSize; p++)
+        m_StdDev[p] = std::sqrt(variance[p] * scale);
+}
+
+float FITSStackRejection::linearFit(const int p, float &lower, float &upper)
+{
+    for (int i = 0; i < m_NumImages; i++)
+        m_Values[i] = m_Block[i * BlockSize + p];
+    std::sort(m_Values.begin(), m_Values.end());
+
+    const int middle = m_NumImages / 2;
+    const float median = (m_NumImages % 2 != 0) ? m_Values[middle] :
+                         0.5 * (static_cast<double>(m_Values[middle - 1]) + m_Values[middle]);
+
+    // Fit value = a + b * index to the sorted values in [start, end). Outliers are at either end of the
+    // sorted values, so rejecting them trims the range.
+    int start = 0, end = m_NumImages;
+    double a = median, b = 0.0, sigma = 0.0;
+    for (int iteration = 0; iteration < maxLinearFitIterations; iteration++)
+    {
+        const int count = end - start;
+        const double meanIndex = 0.5 * (start + end - 1);
+        double meanValue = 0.0;
+        for (int i = start; i < end; i++)
+            meanValue += m_Values[i];
+        meanValue /= count;
+
+        double sxy = 0.0, sxx = 0.0;
+        for (int i = start; i < end; i++)
+        {
+            const double dx = i - meanIndex;
+            sxy += dx * (m_Values[i] - meanValue);
+            sxx += dx * dx;
+        }
+        b = (sxx > 0.0) ? sxy / sxx : 0.0;
+        a = meanValue - b * meanIndex;
+
+        // Mean absolute deviation from the line
+        sigma = 0.0;
+        for (int i = start; i < end; i++)
+            sigma += std::fabs(m_Values[i] - (a + b * i));
+        sigma /= count;
+
+        if (sigma <= 0.0 || count <= minLinearFitValues)
+            break;
+
+        const int oldStart = start, oldEnd = end;
+        while (end - start > minLinearFitValues && m_Values[start] < a + b * start - m_LowSigma * sigma)
+            start++;
+        while (end - start > minLinearFitValues && m_Values[end - 1] > a + b * (end - 1) + m_HighSigma * sigma)
+            end--;
+        if (start == oldStart && end == oldEnd)
+            break;
+    }
+
+    // Accept values within the envelope of the line over the retained range
+    lower = std::max(0.0, a + b * start - m_LowSigma * sigma);
+    upper = a + b * (end - 1) + m_HighSigma * sigma;
+    return median;
+}
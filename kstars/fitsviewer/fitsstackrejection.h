@@ -0,0 +1,119 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "fitscommon.h"
+
+#include <QVector>
+
+#include <vector>
+
+/**
+ * @class FITSStackRejection
+ * @brief Pixel rejection kernel for the Live Stacker.
+ *
+ * Combines the same pixel of every sub into a stacked pixel, rejecting outliers with sigma clipping,
+ * Winsorized sigma clipping or linear fit clipping. Pixels are processed in blocks of BlockSize: the
+ * values of a block are gathered sub by sub so that the mean, variance and clipped sums of the whole
+ * block are computed by simple loops the compiler can vectorise. Medians use partial selection rather
+ * than sorting.
+ *
+ * All scratch memory is allocated by the constructor, so an object must not be shared between threads:
+ * create one per thread or per chunk of pixels.
+ *
+ * For each pixel and channel the kernel also returns the running state of the accepted values: their
+ * weighted mean, weighted sum of squared deviations from the mean, sum of weights and count. accumulate()
+ * folds further subs into this state one at a time with Welford's method, rejecting values against the
+ * running mean and standard deviation, so adding a sub to a long running stack costs the same as adding
+ * one to a short stack and needs no memory beyond the state.
+ */
+class FITSStackRejection
+{
+    public:
+        /**
+         * @param method of rejection. LS_STACKING_REJ_NONE is treated as sigma clipping
+         * @param lowSigma rejection criteria for low values
+         * @param highSigma rejection criteria for high values
+         * @param winsorCutoff used to Winsorize values before sigma clipping
+         * @param weights of each sub
+         */
+        FITSStackRejection(const LiveStackRejection method, const double lowSigma, const double highSigma,
+                           const double winsorCutoff, const QVector<float> &weights);
+
+        /**
+         * @brief Stack pixels [first, last) of the subs
+         * @param images one pointer per sub to its interleaved pixels
+         * @param first pixel to process
+         * @param last pixel (excluded)
+         * @param channels per pixel
+         * @param result interleaved stacked pixels
+         * @param state per channel, 4 floats per pixel: mean, sum of squared deviations, sum of weights and count
+         */
+        void process(const std::vector<const float *> &images, const int first, const int last, const int channels,
+                     float *result, const QVector<float *> &state);
+
+        /**
+         * @brief Add pixels [first, last) of the subs to an existing stack, updating its state in place
+         * @param images one pointer per sub to its interleaved pixels
+         * @param first pixel to process
+         * @param last pixel (excluded)
+         * @param channels per pixel
+         * @param result interleaved stacked pixels
+         * @param state per channel as returned by process()
+         */
+        void accumulate(const std::vector<const float *> &images, const int first, const int last, const int channels,
+                        float *result, const QVector<float *> &state);
+
+        /// Number of pixels processed together
+        static constexpr int BlockSize = 8;
+
+        /// No values are rejected from a pixel until more than this number have been stacked
+        static constexpr int MinRejectionCount = 3;
+
+    private:
+        /**
+         * @brief Stack channel ch of the n (<= BlockSize) pixels starting at pixel x
+         */
+        void processBlock(const std::vector<const float *> &images, const int x, const int n, const int channels,
+                          const int ch, float *result, float *state);
+
+        /**
+         * @brief Median of column p of the block, using partial selection
+         */
+        float median(const int p);
+
+        /**
+         * @brief Sample standard deviation of every column of the block
+         */
+        void standardDeviations();
+
+        /**
+         * @brief Fit a line to the sorted values of column p, rejecting outliers until the fit is stable
+         * @param p column of the block
+         * @param lower returned lower bound of accepted values
+         * @param upper returned upper bound of accepted values
+         * @return median of the column
+         */
+        float linearFit(const int p, float &lower, float &upper);
+
+        LiveStackRejection m_Method;
+        double m_LowSigma;
+        double m_HighSigma;
+        double m_WinsorCutoff;
+        QVector<float> m_Weights;
+        int m_NumImages;
+
+        /// Values of the current block: BlockSize consecutive pixels for each sub in turn
+        std::vector<float> m_Block;
+        /// Scratch column for selection and sorting
+        std::vector<float> m_Values;
+
+        float m_Median[BlockSize];
+        float m_Lower[BlockSize];
+        float m_Upper[BlockSize];
+        double m_StdDev[BlockSize];
+};
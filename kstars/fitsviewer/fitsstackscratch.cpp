@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsstackscratch.h"
+
+#include <QDir>
+
+#include <fits_debug.h>
+
+FITSStackScratch::FITSStackScratch(const int rows, const int cols, const int cvType)
+    : m_Rows(rows), m_Cols(cols), m_CVType(cvType)
+{
+    m_RowBytes = static_cast<qint64>(cols) * CV_ELEM_SIZE(cvType);
+    m_File.setFileTemplate(QDir(QDir::tempPath()).filePath("kstars_livestack_XXXXXX.raw"));
+    m_Open = m_File.open();
+    if (!m_Open)
+        qCDebug(KSTARS_FITS) << QString("Unable to create live stacking scratch file: %1").arg(m_File.errorString());
+}
+
+FITSStackScratch::~FITSStackScratch()
+{
+    unmapTiles();
+}
+
+int FITSStackScratch::store(const cv::Mat &image, const int index)
+{
+    if (!m_Open || image.rows != m_Rows || image.cols != m_Cols || image.type() != m_CVType || index >= m_NumSubs)
+        return -1;
+
+    unmapTiles();
+    const int slot = (index >= 0) ? index : m_NumSubs;
+    if (!m_File.seek(slot * m_RowBytes * m_Rows))
+        return -1;
+
+    for (int y = 0; y < m_Rows; y++)
+    {
+        if (m_File.write(reinterpret_cast<const char *>(image.ptr(y)), m_RowBytes) != m_RowBytes)
+        {
+            qCDebug(KSTARS_FITS) << QString("Unable to write live stacking scratch file: %1").arg(m_File.errorString());
+            return -1;
+        }
+    }
+    m_File.flush();
+    if (slot == m_NumSubs)
+        m_NumSubs++;
+    return slot;
+}
+
+bool FITSStackScratch::mapTiles(const QVector<int> &indexes, const int firstRow, const int numRows,
+                                std::vector<cv::Mat> &tiles)
+{
+    unmapTiles();
+    tiles.clear();
+    if (!m_Open || firstRow < 0 || numRows <= 0 || firstRow + numRows > m_Rows)
+        return false;
+
+    for (const int index : indexes)
+    {
+        if (index < 0 || index >= m_NumSubs)
+        {
+            unmapTiles();
+            return false;
+        }
+
+        const qint64 offset = (index * static_cast<qint64>(m_Rows) + firstRow) * m_RowBytes;
+        uchar *data = m_File.map(offset, numRows * m_RowBytes);
+        if (data == nullptr)
+        {
+            qCDebug(KSTARS_FITS) << QString("Unable to map live stacking scratch file: %1").arg(m_File.errorString());
+            unmapTiles();
+            return false;
+        }
+        m_Mapped.push_back(data);
+        tiles.push_back(cv::Mat(numRows, m_Cols, m_CVType, data));
+    }
+    return true;
+}
+
+void FITSStackScratch::unmapTiles()
+{
+    for (uchar *data : m_Mapped)
+        m_File.unmap(data);
+    m_Mapped.clear();
+}
@@ -0,0 +1,91 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QTemporaryFile>
+#include <QVector>
+
+#include "opencv2/core.hpp"
+
+/**
+ * @class FITSStackScratch
+ * @brief Disk backing store for the aligned subs of the Live Stacker.
+ *
+ * Subs of identical size and type are appended to a temporary file, one after the other, and
+ * their memory released by the caller. Stacking then maps a band of rows (a tile) of every sub
+ * at a time, so that memory use is bounded by the tile size times the number of subs instead of
+ * the frame size times the number of subs. Mappings are read-only and are released by unmapTiles()
+ * or when the next tile is mapped.
+ */
+class FITSStackScratch
+{
+    public:
+        /**
+         * @brief Create a scratch file for subs of the given shape
+         * @param rows of each sub
+         * @param cols of each sub
+         * @param cvType openCV type of each sub
+         */
+        FITSStackScratch(const int rows, const int cols, const int cvType);
+        ~FITSStackScratch();
+
+        /**
+         * @brief Was the scratch file created successfully
+         */
+        bool isOpen() const
+        {
+            return m_Open;
+        }
+
+        int rows() const
+        {
+            return m_Rows;
+        }
+
+        int cols() const
+        {
+            return m_Cols;
+        }
+
+        int cvType() const
+        {
+            return m_CVType;
+        }
+
+        /**
+         * @brief Write a sub to the scratch file
+         * @param image must have the shape the scratch file was created with
+         * @param index of a previously stored sub to overwrite, or -1 to append a new sub
+         * @return index of the sub in the scratch file, or -1 on failure
+         */
+        int store(const cv::Mat &image, const int index = -1);
+
+        /**
+         * @brief Map rows [firstRow, firstRow + numRows) of each of the passed in subs
+         * @param indexes of the subs, as returned by store()
+         * @param firstRow of the tile
+         * @param numRows in the tile
+         * @param tiles returned views, one per sub, continuous and read-only
+         * @return success (or not)
+         */
+        bool mapTiles(const QVector<int> &indexes, const int firstRow, const int numRows, std::vector<cv::Mat> &tiles);
+
+        /**
+         * @brief Release the mappings made by mapTiles()
+         */
+        void unmapTiles();
+
+    private:
+        QTemporaryFile m_File;
+        bool m_Open { false };
+        int m_Rows { 0 };
+        int m_Cols { 0 };
+        int m_CVType { 0 };
+        qint64 m_RowBytes { 0 };
+        int m_NumSubs { 0 };
+        QVector<uchar *> m_Mapped;
+};
@@ -0,0 +1,193 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsstackstarmatch.h"
+
+#include "opencv2/calib3d.hpp"
+
+#include <fits_debug.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Triangles match when their side ratios agree to within this tolerance
+const float ratioTolerance = 0.01f;
+// and their sizes agree to within this fraction
+const float scaleTolerance = 0.1f;
+// Triangles with a longest side shorter than this (pixels) are too sensitive to centroid errors
+const float minLongestSide = 20.0f;
+// Triangles with sides differing by less than this fraction of the longest side can't label their vertices
+const float minSideDifference = 0.02f;
+// Star pairs need at least this many votes
+const int minVotes = 2;
+// Maximum distance (pixels) of a star pair from the fitted transform
+const double ransacThreshold = 3.0;
+}
+
+void FITSStackStarMatcher::setReference(const QList<FITSImage::Star> &stars)
+{
+    m_Reference = brightest(stars);
+    m_ReferenceTriangles = triangles(m_Reference);
+}
+
+void FITSStackStarMatcher::reset()
+{
+    m_Reference.clear();
+    m_ReferenceTriangles.clear();
+}
+
+bool FITSStackStarMatcher::align(const QList<FITSImage::Star> &stars, cv::Mat &warp) const
+{
+    if (!hasReference())
+        return false;
+
+    const std::vector<cv::Point2f> points = brightest(stars);
+    if (static_cast<int>(points.size()) < MinMatches)
+    {
+        qCDebug(KSTARS_FITS) << QString("Star alignment: only %1 stars in sub").arg(points.size());
+        return false;
+    }
+
+    // Each pair of similar triangles votes for the correspondence of their vertices
+    std::vector<int> votes(points.size() * m_Reference.size(), 0);
+    for (const auto &triangle : triangles(points))
+    {
+        auto first = std::lower_bound(m_ReferenceTriangles.begin(), m_ReferenceTriangles.end(),
+                                      triangle.ratioMiddle - ratioTolerance,
+                                      [](const Triangle & t, const float value)
+        {
+            return t.ratioMiddle < value;
+        });
+        for (auto ref = first; ref != m_ReferenceTriangles.end() && ref->ratioMiddle <= triangle.ratioMiddle + ratioTolerance;
+                ++ref)
+        {
+            if (std::fabs(ref->ratioShort - triangle.ratioShort) > ratioTolerance ||
+                    std::fabs(triangle.longest / ref->longest - 1.0f) > scaleTolerance)
+                continue;
+
+            for (int v = 0; v < 3; v++)
+                votes[triangle.vertex[v] * m_Reference.size() + ref->vertex[v]]++;
+        }
+    }
+
+    // Take the pairs with the most votes, each star used at most once
+    std::vector<int> order(votes.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&votes](const int a, const int b)
+    {
+        return votes[a] > votes[b];
+    });
+
+    std::vector<bool> subUsed(points.size(), false), refUsed(m_Reference.size(), false);
+    std::vector<cv::Point2f> subMatches, refMatches;
+    for (const int pair : order)
+    {
+        if (votes[pair] < minVotes)
+            break;
+        const int sub = pair / m_Reference.size();
+        const int ref = pair % m_Reference.size();
+        if (subUsed[sub] || refUsed[ref])
+            continue;
+        subUsed[sub] = refUsed[ref] = true;
+        subMatches.push_back(points[sub]);
+        refMatches.push_back(m_Reference[ref]);
+    }
+
+    if (static_cast<int>(subMatches.size()) < MinMatches)
+    {
+        qCDebug(KSTARS_FITS) << QString("Star alignment: only %1 star pairs found").arg(subMatches.size());
+        return false;
+    }
+
+    // Fit the transform, ignoring any false pairs
+    std::vector<uchar> inliers;
+    cv::Mat affine = cv::estimateAffine2D(subMatches, refMatches, inliers, cv::RANSAC, ransacThreshold);
+    const int numInliers = std::count(inliers.begin(), inliers.end(), 1);
+    if (affine.empty() || numInliers < MinMatches)
+    {
+        qCDebug(KSTARS_FITS) << QString("Star alignment: only %1 of %2 star pairs fit a transform")
+                             .arg(numInliers).arg(subMatches.size());
+        return false;
+    }
+
+    // Subs from the same optical train shouldn't change scale
+    const double scale = std::sqrt(std::fabs(cv::determinant(affine.colRange(0, 2))));
+    if (std::fabs(scale - 1.0) > scaleTolerance)
+    {
+        qCDebug(KSTARS_FITS) << QString("Star alignment: unexpected scale %1").arg(scale);
+        return false;
+    }
+
+    warp = cv::Mat::eye(3, 3, CV_64F);
+    affine.copyTo(warp.rowRange(0, 2));
+    qCDebug(KSTARS_FITS) << QString("Star alignment: %1 of %2 star pairs fit").arg(numInliers).arg(subMatches.size());
+    return true;
+}
+
+std::vector<cv::Point2f> FITSStackStarMatcher::brightest(const QList<FITSImage::Star> &stars)
+{
+    QList<FITSImage::Star> sorted;
+    for (const auto &star : stars)
+    {
+        if (std::isfinite(star.x) && std::isfinite(star.y))
+            sorted.append(star);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const FITSImage::Star & a, const FITSImage::Star & b)
+    {
+        return a.flux > b.flux;
+    });
+
+    std::vector<cv::Point2f> points;
+    for (int i = 0; i < sorted.size() && i < MaxStars; i++)
+        points.push_back(cv::Point2f(sorted[i].x, sorted[i].y));
+    return points;
+}
+
+std::vector<FITSStackStarMatcher::Triangle> FITSStackStarMatcher::triangles(const std::vector<cv::Point2f> &points)
+{
+    std::vector<Triangle> result;
+    const int n = points.size();
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = i + 1; j < n; j++)
+        {
+            for (int k = j + 1; k < n; k++)
+            {
+                // Each side with the vertex opposite it
+                std::pair<float, int> sides[3] =
+                {
+                    { cv::norm(points[j] - points[k]), i },
+                    { cv::norm(points[i] - points[k]), j },
+                    { cv::norm(points[i] - points[j]), k }
+                };
+                std::sort(sides, sides + 3);
+
+                const float longest = sides[2].first;
+                if (longest < minLongestSide ||
+                        (sides[1].first - sides[0].first) < minSideDifference * longest ||
+                        (sides[2].first - sides[1].first) < minSideDifference * longest)
+                    continue;
+
+                Triangle triangle;
+                triangle.ratioShort = sides[0].first / longest;
+                triangle.ratioMiddle = sides[1].first / longest;
+                triangle.longest = longest;
+                for (int v = 0; v < 3; v++)
+                    triangle.vertex[v] = sides[v].second;
+                result.push_back(triangle);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const Triangle & a, const Triangle & b)
+    {
+        return a.ratioMiddle < b.ratioMiddle;
+    });
+    return result;
+}
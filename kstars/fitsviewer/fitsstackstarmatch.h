@@ -0,0 +1,97 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "config-kstars.h"
+
+// From StellarSolver
+#ifdef HAVE_STELLARSOLVER
+#include <structuredefinitions.h>
+#else
+#include "structuredefinitions.h"
+#endif
+
+#include <QList>
+
+#include <vector>
+
+#include "opencv2/core.hpp"
+
+/**
+ * @class FITSStackStarMatcher
+ * @brief Align a sub to the Live Stacking reference sub by matching star patterns.
+ *
+ * The brightest stars of the reference sub are formed into triangles, each described by the ratios of
+ * its sides, which don't change with translation, rotation or small changes of scale. Triangles from the
+ * sub's stars vote for the reference stars matching each of their vertices, the strongest votes give a
+ * set of star pairs and an affine transform is fitted to the pairs by RANSAC.
+ *
+ * This only needs stars to be extracted from the sub so it is much quicker than plate solving. If too few
+ * stars match the caller falls back to plate solving.
+ */
+class FITSStackStarMatcher
+{
+    public:
+        FITSStackStarMatcher() = default;
+
+        /**
+         * @brief Set the stars of the reference sub
+         * @param stars extracted from the reference sub
+         */
+        void setReference(const QList<FITSImage::Star> &stars);
+
+        /**
+         * @brief Clear the reference stars
+         */
+        void reset();
+
+        /**
+         * @brief Determine whether there are enough reference stars to align to
+         * @return reference available (or not)
+         */
+        bool hasReference() const
+        {
+            return static_cast<int>(m_Reference.size()) >= MinMatches;
+        }
+
+        /**
+         * @brief Find the transform from the sub's stars to the reference stars
+         * @param stars extracted from the sub
+         * @param warp returned 3x3 (CV_64F) matrix taking sub pixels to reference pixels
+         * @return success (or not)
+         */
+        bool align(const QList<FITSImage::Star> &stars, cv::Mat &warp) const;
+
+        /// Number of brightest stars used from each sub
+        static constexpr int MaxStars = 30;
+        /// Minimum number of star pairs agreeing with the transform
+        static constexpr int MinMatches = 6;
+
+    private:
+        typedef struct
+        {
+            // Shortest and middle sides over the longest side
+            float ratioShort;
+            float ratioMiddle;
+            float longest;
+            // Vertices opposite the shortest, middle and longest sides
+            int vertex[3];
+        } Triangle;
+
+        /**
+         * @brief Return the positions of the brightest stars
+         */
+        static std::vector<cv::Point2f> brightest(const QList<FITSImage::Star> &stars);
+
+        /**
+         * @brief Return the usable triangles formed from the points, sorted by ratioMiddle
+         */
+        static std::vector<Triangle> triangles(const std::vector<cv::Point2f> &points);
+
+        std::vector<cv::Point2f> m_Reference;
+        std::vector<Triangle> m_ReferenceTriangles;
+};
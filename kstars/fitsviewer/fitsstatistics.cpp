@@ -0,0 +1,373 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "fitsstatistics.h"
+
+#include <fitsio.h>
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+// Chunks smaller than this aren't worth a thread. It is also large compared to the 65536 bins of a
+// 16 bit histogram, so merging chunk histograms is cheap compared to filling them
+const uint32_t minChunkSize = 1 << 18;
+// Pixels summed together while in cache, before their median samples are collected
+const uint32_t blockSize = 4096;
+
+// Split samples into roughly equal chunks, one per thread
+std::vector<std::pair<uint32_t, uint32_t>> chunks(const uint32_t samples)
+{
+    const uint32_t numChunks = std::max(1u, std::min(static_cast<uint32_t>(QThread::idealThreadCount()),
+                                        samples / minChunkSize));
+    const uint32_t stride = samples / numChunks;
+    std::vector<std::pair<uint32_t, uint32_t>> result;
+    for (uint32_t i = 0; i < numChunks; i++)
+        result.push_back(std::make_pair(i * stride, (i == numChunks - 1) ? samples : (i + 1) * stride));
+    return result;
+}
+
+// Sums are of the pixel values less shift, which should be close to the mean, to avoid losing precision
+// when subtracting the squared mean from the mean of squares
+FITSStatistics::Channel finish(const double min, const double max, const double shift, const double sum,
+                               const double squaredSum, const double median, const uint32_t samples)
+{
+    const double mean = sum / samples;
+    const double variance = std::max(0.0, squaredSum / samples - mean * mean);
+    return { min, max, shift + mean, std::sqrt(variance), median };
+}
+}
+
+bool FITSStatistics::calculate(const uint8_t *buffer, const uint32_t dataType, const uint32_t samplesPerChannel,
+                               const int channels, Channel *results)
+{
+    for (int n = 0; n < channels; n++)
+    {
+        results[n] = { 0, 0, 0, 0, 0 };
+        if (samplesPerChannel == 0)
+            continue;
+
+        switch (dataType)
+        {
+            case TBYTE:
+                results[n] = calculateHistogram(reinterpret_cast<const uint8_t *>(buffer) + n * samplesPerChannel,
+                                                samplesPerChannel);
+                break;
+
+            case TSHORT:
+                results[n] = calculateHistogram(reinterpret_cast<const int16_t *>(buffer) + n * samplesPerChannel,
+                                                samplesPerChannel);
+                break;
+
+            case TUSHORT:
+                results[n] = calculateHistogram(reinterpret_cast<const uint16_t *>(buffer) + n * samplesPerChannel,
+                                                samplesPerChannel);
+                break;
+
+            case TLONG:
+                results[n] = calculateSampled(reinterpret_cast<const int32_t *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TULONG:
+                results[n] = calculateSampled(reinterpret_cast<const uint32_t *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TFLOAT:
+                results[n] = calculateSampled(reinterpret_cast<const float *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TLONGLONG:
+                results[n] = calculateSampled(reinterpret_cast<const int64_t *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TDOUBLE:
+                results[n] = calculateSampled(reinterpret_cast<const double *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool FITSStatistics::calculateMeanStdDev(const uint8_t *buffer, const uint32_t dataType,
+        const uint32_t samplesPerChannel, const int channels, Channel *results)
+{
+    for (int n = 0; n < channels; n++)
+    {
+        results[n] = { 0, 0, 0, 0, 0 };
+        if (samplesPerChannel == 0)
+            continue;
+
+        switch (dataType)
+        {
+            case TBYTE:
+                results[n] = calculateMoments(reinterpret_cast<const uint8_t *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TSHORT:
+                results[n] = calculateMoments(reinterpret_cast<const int16_t *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TUSHORT:
+                results[n] = calculateMoments(reinterpret_cast<const uint16_t *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TLONG:
+                results[n] = calculateMoments(reinterpret_cast<const int32_t *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TULONG:
+                results[n] = calculateMoments(reinterpret_cast<const uint32_t *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TFLOAT:
+                results[n] = calculateMoments(reinterpret_cast<const float *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TLONGLONG:
+                results[n] = calculateMoments(reinterpret_cast<const int64_t *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            case TDOUBLE:
+                results[n] = calculateMoments(reinterpret_cast<const double *>(buffer) + n * samplesPerChannel,
+                                              samplesPerChannel);
+                break;
+
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+FITSStatistics::Channel FITSStatistics::calculateHistogram(const T *buffer, const uint32_t samples)
+{
+    // Bin 0 holds the lowest value of T
+    constexpr int numBins = 1 << (8 * sizeof(T));
+    constexpr int offset = -static_cast<int>(std::numeric_limits<T>::lowest());
+
+    typedef struct
+    {
+        uint32_t start;
+        uint32_t end;
+        std::vector<uint32_t> histogram;
+    } Chunk;
+
+    std::vector<Chunk> work;
+    for (const auto &range : chunks(samples))
+        work.push_back({ range.first, range.second, std::vector<uint32_t>() });
+
+    QtConcurrent::blockingMap(work, [buffer](Chunk & chunk)
+    {
+        chunk.histogram.assign(numBins, 0);
+        uint32_t *histogram = chunk.histogram.data();
+        for (uint32_t i = chunk.start; i < chunk.end; i++)
+            histogram[buffer[i] + offset]++;
+    });
+
+    std::vector<uint32_t> histogram(numBins, 0);
+    for (const auto &chunk : work)
+    {
+        for (int b = 0; b < numBins; b++)
+            histogram[b] += chunk.histogram[b];
+    }
+
+    int first = 0, last = numBins - 1;
+    while (histogram[first] == 0)
+        first++;
+    while (histogram[last] == 0)
+        last--;
+
+    // The histogram is small so take the mean first and then sum the squared deviations from it
+    double sum = 0, squaredSum = 0;
+    for (int b = first; b <= last; b++)
+        sum += static_cast<double>(b - offset) * histogram[b];
+    const double mean = sum / samples;
+    for (int b = first; b <= last; b++)
+    {
+        const double deviation = b - offset - mean;
+        squaredSum += deviation * deviation * histogram[b];
+    }
+
+    // The median is the middle value, or the mean of the two middle values
+    const uint32_t lowerRank = (samples - 1) / 2, upperRank = samples / 2;
+    int lowerBin = -1, upperBin = -1;
+    uint32_t count = 0;
+    for (int b = first; b <= last && upperBin < 0; b++)
+    {
+        count += histogram[b];
+        if (lowerBin < 0 && count > lowerRank)
+            lowerBin = b;
+        if (count > upperRank)
+            upperBin = b;
+    }
+    const double median = (lowerBin + upperBin) / 2.0 - offset;
+
+    return finish(first - offset, last - offset, mean, 0, squaredSum, median, samples);
+}
+
+template <typename T>
+FITSStatistics::Channel FITSStatistics::calculateSampled(const T *buffer, const uint32_t samples)
+{
+    const uint32_t downsample = (samples + MaxMedianSamples - 1) / MaxMedianSamples;
+    const double shift = buffer[0];
+
+    typedef struct
+    {
+        uint32_t start;
+        uint32_t end;
+        T min;
+        T max;
+        double sum;
+        double squaredSum;
+        std::vector<double> medianSamples;
+    } Chunk;
+
+    std::vector<Chunk> work;
+    for (const auto &range : chunks(samples))
+        work.push_back({ range.first, range.second, T(0), T(0), 0, 0, std::vector<double>() });
+
+    QtConcurrent::blockingMap(work, [buffer, downsample, shift](Chunk & chunk)
+    {
+        T min = std::numeric_limits<T>::max();
+        T max = std::numeric_limits<T>::lowest();
+        // Independent partial sums so the compiler can vectorise the loop
+        double sum[4] = { 0, 0, 0, 0 }, squaredSum[4] = { 0, 0, 0, 0 };
+        chunk.medianSamples.reserve((chunk.end - chunk.start) / downsample + 1);
+
+        for (uint32_t blockStart = chunk.start; blockStart < chunk.end; blockStart += blockSize)
+        {
+            const uint32_t blockEnd = std::min(blockStart + blockSize, chunk.end);
+            uint32_t i = blockStart;
+            for (; i + 4 <= blockEnd; i += 4)
+            {
+                for (int lane = 0; lane < 4; lane++)
+                {
+                    const T value = buffer[i + lane];
+                    min = std::min(min, value);
+                    max = std::max(max, value);
+                    const double sample = value - shift;
+                    sum[lane] += sample;
+                    squaredSum[lane] += sample * sample;
+                }
+            }
+            for (; i < blockEnd; i++)
+            {
+                const T value = buffer[i];
+                min = std::min(min, value);
+                max = std::max(max, value);
+                const double sample = value - shift;
+                sum[0] += sample;
+                squaredSum[0] += sample * sample;
+            }
+
+            // Median samples are every downsample'th pixel of the whole channel
+            for (uint32_t s = (blockStart + downsample - 1) / downsample * downsample; s < blockEnd; s += downsample)
+                chunk.medianSamples.push_back(buffer[s]);
+        }
+
+        chunk.min = min;
+        chunk.max = max;
+        chunk.sum = sum[0] + sum[1] + sum[2] + sum[3];
+        chunk.squaredSum = squaredSum[0] + squaredSum[1] + squaredSum[2] + squaredSum[3];
+    });
+
+    T min = std::numeric_limits<T>::max();
+    T max = std::numeric_limits<T>::lowest();
+    double sum = 0, squaredSum = 0;
+    std::vector<double> medianSamples;
+    medianSamples.reserve(samples / downsample + 1);
+    for (const auto &chunk : work)
+    {
+        min = std::min(min, chunk.min);
+        max = std::max(max, chunk.max);
+        sum += chunk.sum;
+        squaredSum += chunk.squaredSum;
+        medianSamples.insert(medianSamples.end(), chunk.medianSamples.begin(), chunk.medianSamples.end());
+    }
+
+    // The median is the middle sample, or the mean of the two middle samples
+    const auto middle = medianSamples.begin() + medianSamples.size() / 2;
+    std::nth_element(medianSamples.begin(), middle, medianSamples.end());
+    double median = *middle;
+    if (medianSamples.size() % 2 == 0)
+        median = (median + *std::max_element(medianSamples.begin(), middle)) / 2.0;
+
+    return finish(min, max, shift, sum, squaredSum, median, samples);
+}
+
+template <typename T>
+FITSStatistics::Channel FITSStatistics::calculateMoments(const T *buffer, const uint32_t samples)
+{
+    const double shift = buffer[0];
+
+    typedef struct
+    {
+        uint32_t start;
+        uint32_t end;
+        double sum;
+        double squaredSum;
+    } Chunk;
+
+    std::vector<Chunk> work;
+    for (const auto &range : chunks(samples))
+        work.push_back({ range.first, range.second, 0, 0 });
+
+    QtConcurrent::blockingMap(work, [buffer, shift](Chunk & chunk)
+    {
+        // Independent partial sums so the compiler can vectorise the loop
+        double sum[4] = { 0, 0, 0, 0 }, squaredSum[4] = { 0, 0, 0, 0 };
+        uint32_t i = chunk.start;
+        for (; i + 4 <= chunk.end; i += 4)
+        {
+            for (int lane = 0; lane < 4; lane++)
+            {
+                const double sample = buffer[i + lane] - shift;
+                sum[lane] += sample;
+                squaredSum[lane] += sample * sample;
+            }
+        }
+        for (; i < chunk.end; i++)
+        {
+            const double sample = buffer[i] - shift;
+            sum[0] += sample;
+            squaredSum[0] += sample * sample;
+        }
+
+        chunk.sum = sum[0] + sum[1] + sum[2] + sum[3];
+        chunk.squaredSum = squaredSum[0] + squaredSum[1] + squaredSum[2] + squaredSum[3];
+    });
+
+    double sum = 0, squaredSum = 0;
+    for (const auto &chunk : work)
+    {
+        sum += chunk.sum;
+        squaredSum += chunk.squaredSum;
+    }
+
+    return finish(0, 0, shift, sum, squaredSum, 0, samples);
+}
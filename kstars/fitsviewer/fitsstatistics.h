@@ -0,0 +1,75 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @class FITSStatistics
+ * @brief Fused statistics kernel for FITSData.
+ *
+ * Calculates the minimum, maximum, mean, standard deviation and median of each channel of an image in a
+ * single pass over the pixels, rather than one pass for each statistic. Each channel is split into chunks
+ * which are processed in parallel and then combined.
+ *
+ * 8 and 16 bit images are reduced to a histogram of every possible value, from which all the statistics
+ * including an exact median are derived. Wider types keep running sums over blocks of pixels in loops the
+ * compiler can vectorise, and take the median of at most MaxMedianSamples evenly spaced samples, collected
+ * while each block is still in cache.
+ */
+class FITSStatistics
+{
+    public:
+        typedef struct
+        {
+            double min;
+            double max;
+            double mean;
+            double stddev;
+            double median;
+        } Channel;
+
+        /**
+         * @brief Calculate the statistics of each channel of an image
+         * @param buffer planar image data, one channel after another
+         * @param dataType of the pixels (TBYTE, TSHORT, TUSHORT, TLONG, TULONG, TFLOAT, TLONGLONG or TDOUBLE)
+         * @param samplesPerChannel number of pixels in each channel
+         * @param channels in the image, at most 3
+         * @param results returned statistics, one per channel
+         * @return success (or not if the data type is not supported)
+         */
+        static bool calculate(const uint8_t *buffer, const uint32_t dataType, const uint32_t samplesPerChannel,
+                              const int channels, Channel *results);
+
+        /**
+         * @brief Calculate only the mean and standard deviation of each channel of an image
+         *
+         * Cheaper than calculate(), as it neither builds a histogram nor collects median samples.
+         * The min, max and median of the results are set to 0.
+         * @param buffer planar image data, one channel after another
+         * @param dataType of the pixels (TBYTE, TSHORT, TUSHORT, TLONG, TULONG, TFLOAT, TLONGLONG or TDOUBLE)
+         * @param samplesPerChannel number of pixels in each channel
+         * @param channels in the image, at most 3
+         * @param results returned statistics, one per channel
+         * @return success (or not if the data type is not supported)
+         */
+        static bool calculateMeanStdDev(const uint8_t *buffer, const uint32_t dataType, const uint32_t samplesPerChannel,
+                                        const int channels, Channel *results);
+
+        /// Medians of types wider than 16 bits are taken from at most this many samples
+        static constexpr uint32_t MaxMedianSamples = 500000;
+
+    private:
+        template <typename T>
+        static Channel calculateHistogram(const T *buffer, const uint32_t samples);
+
+        template <typename T>
+        static Channel calculateSampled(const T *buffer, const uint32_t samples);
+
+        template <typename T>
+        static Channel calculateMoments(const T *buffer, const uint32_t samples);
+};
@@ -945,6 +945,8 @@ void FITSTab::initSettings()
     m_LiveStackingUI.LowSigma->setValue(Options::fitsLSLowSigma());
     m_LiveStackingUI.HighSigma->setValue(Options::fitsLSHighSigma());
     m_LiveStackingUI.WinsorCutoff->setValue(Options::fitsLSWinsorCutoff());
+    m_LiveStackingUI.TiledStacking->setChecked(Options::fitsLSTiledStacking());
+    m_LiveStackingUI.TileRows->setValue(Options::fitsLSTileRows());
     m_LiveStackingUI.PostProcGroupBox->setChecked(Options::fitsLSPostProc());
     m_LiveStackingUI.DeconvAmt->setValue(Options::fitsLSDeconvAmt());
     m_LiveStackingUI.PSFSigma->setValue(Options::fitsLSPSFSigma());
@@ -966,6 +968,8 @@ void FITSTab::saveSettings()
     Options::setFitsLSLowSigma(m_LiveStackingUI.LowSigma->value());
     Options::setFitsLSHighSigma(m_LiveStackingUI.HighSigma->value());
     Options::setFitsLSWinsorCutoff(m_LiveStackingUI.WinsorCutoff->value());
+    Options::setFitsLSTiledStacking(m_LiveStackingUI.TiledStacking->isChecked());
+    Options::setFitsLSTileRows(m_LiveStackingUI.TileRows->value());
     Options::setFitsLSPostProc(m_LiveStackingUI.PostProcGroupBox->isChecked());
     Options::setFitsLSDeconvAmt(m_LiveStackingUI.DeconvAmt->value());
     Options::setFitsLSPSFSigma(m_LiveStackingUI.PSFSigma->value());
@@ -992,6 +996,8 @@ LiveStackData FITSTab::getAllSettings()
     data.lowSigma = m_LiveStackingUI.LowSigma->value();
     data.highSigma = m_LiveStackingUI.HighSigma->value();
     data.windsorCutoff = m_LiveStackingUI.WinsorCutoff->value();
+    data.tiled = m_LiveStackingUI.TiledStacking->isChecked();
+    data.tileRows = m_LiveStackingUI.TileRows->value();
     data.postProcessing = getPPSettings();
     return data;
 }
@@ -1348,13 +1354,24 @@ void FITSTab::liveStack()
 void FITSTab::plateSolveSub(const double ra, const double dec, const double pixScale, const int index,
                             const int healpix, const LiveStackFrameWeighting &weighting)
 {
-    connect(m_PlateSolve.data(), &PlateSolve::subExtractorSuccess, this, [this, ra, dec, pixScale, index, healpix]
-            (double medianHFR, int numStars)
+    // With star pattern alignment stars are always extracted, then the sub is only plate solved if the
+    // stars can't be matched to the reference sub
+    const bool alignByStars = m_View->imageData()->stack() &&
+                              m_View->imageData()->stack()->getStackData().alignMethod == LS_ALIGNMENT_STARS;
+
+    connect(m_PlateSolve.data(), &PlateSolve::subExtractorSuccess, this, [this, ra, dec, pixScale, index, healpix,
+                                                                          alignByStars](double medianHFR, int numStars)
     {
         disconnect(m_PlateSolve.data(), &PlateSolve::subExtractorSuccess, nullptr, nullptr);
         disconnect(m_PlateSolve.data(), &PlateSolve::subExtractorFailed, nullptr, nullptr);
         m_StackMedianHFR = medianHFR;
         m_StackNumStars = numStars;
+        if (alignByStars && m_View->imageData()->stackSubStars(m_PlateSolve->subStars(), medianHFR, numStars))
+        {
+            disconnect(m_PlateSolve.data(), &PlateSolve::subSolverSuccess, nullptr, nullptr);
+            disconnect(m_PlateSolve.data(), &PlateSolve::subSolverFailed, nullptr, nullptr);
+            return;
+        }
         qCDebug(KSTARS_FITS) << "Star extraction complete, plate solving starting...";
         m_PlateSolve->plateSolveSub(m_View->imageData(), ra, dec, pixScale, index, healpix, SSolver::SOLVE);
     });
@@ -1402,7 +1419,7 @@ void FITSTab::plateSolveSub(const double ra, const double dec, const double pixS
 
     SSolver::ProcessType solveType;
 
-    if (!m_StackExtracted && (weighting == LS_STACKING_HFR || weighting == LS_STACKING_NUM_STARS))
+    if (alignByStars || (!m_StackExtracted && (weighting == LS_STACKING_HFR || weighting == LS_STACKING_NUM_STARS)))
     {
         // We need star details for later calculations so firstly extract stars
         solveType = (weighting == LS_STACKING_HFR) ? SSolver::EXTRACT_WITH_HFR : SSolver::EXTRACT;
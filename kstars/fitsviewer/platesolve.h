@@ -35,6 +35,9 @@ class PlateSolve: public QDialog, public Ui::PlateSolveUI
       const FITSImage::Solution &solution() {
           return m_Solution;
       }
+      QList<FITSImage::Star> subStars() const {
+          return m_Solver ? m_Solver->getStarList() : QList<FITSImage::Star>();
+      }
       void setPosition(const SkyPoint &p);
       void setUsePosition(bool yesNo);
       void setScale(double scale);
@@ -18,10 +18,12 @@
 
 #include <KConfigDialog>
 
+#include <QFutureWatcher>
 #include <QTime>
 #include <QHash>
 #include <QNetworkDiskCache>
 #include <QPainter>
+#include <QtConcurrent>
 
 static QNetworkDiskCache *g_discCache = nullptr;
 static UrlFileDownload *g_download = nullptr;
@@ -222,13 +224,37 @@ QImage *HIPSManager::getPix(bool allsky, int level, int pix, bool &freeImage)
         return cacheImage;
     }
 
+    requestTile(allsky, key);
+
+    return nullptr;
+}
+
+void HIPSManager::prefetchPix(int level, int pix)
+{
+    if (Options::hIPSUseOfflineSource() == false && m_currentSource.isEmpty())
+        return;
+
+    pixCacheKey_t key;
+
+    key.level = level;
+    key.pix = pix;
+    key.uid = m_uid;
+
+    if (m_downloadMap.contains(key) || getCacheItem(key) != nullptr)
+        return;
+
+    requestTile(false, key);
+}
+
+void HIPSManager::requestTile(bool allsky, pixCacheKey_t &key)
+{
     QString path;
 
     if (!allsky)
     {
-        int dir = (pix / 10000) * 10000;
+        int dir = (key.pix / 10000) * 10000;
 
-        path = "/Norder" + QString::number(level) + "/Dir" + QString::number(dir) + "/Npix" + QString::number(pix) +
+        path = "/Norder" + QString::number(key.level) + "/Dir" + QString::number(dir) + "/Npix" + QString::number(key.pix) +
                '.' + m_currentFormat;
     }
     else
@@ -240,8 +266,6 @@ QImage *HIPSManager::getPix(bool allsky, int level, int pix, bool &freeImage)
     downloadURL.setPath(downloadURL.path() + path);
     g_download->begin(downloadURL, key);
     m_downloadMap.insert(key);
-
-    return nullptr;
 }
 
 
@@ -348,22 +372,34 @@ void HIPSManager::slotDone(QNetworkReply::NetworkError error, QByteArray &data,
 {
     if (error == QNetworkReply::NoError)
     {
-        m_downloadMap.remove(key);
+        // Decode the tile on the thread pool, so that a burst of tiles doesn't hold up the GUI.
+        // It stays in the download map until it is in the memory cache, so it isn't requested again.
+        const pixCacheKey_t tileKey = key;
+        const int dataSize = data.length();
+        auto *watcher = new QFutureWatcher<QImage>(this);
+        connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, tileKey, dataSize]()
+        {
+            pixCacheKey_t key = tileKey;
+            m_downloadMap.remove(key);
 
-        auto *item = new pixCacheItem_t;
+            const QImage image = watcher->result();
+            watcher->deleteLater();
+            if (image.isNull())
+            {
+                qCWarning(KSTARS) << "no image. Data size: " << dataSize;
+                return;
+            }
 
-        item->image = new QImage();
-        if (item->image->loadFromData(data))
-        {
+            auto *item = new pixCacheItem_t;
+            item->image = new QImage(image);
             addToMemoryCache(key, item);
-
-            //SkyMap::Instance()->forceUpdate();
-        }
-        else
+        });
+        watcher->setFuture(QtConcurrent::run([data]()
         {
-            delete item;
-            qCWarning(KSTARS) << "no image. Data size: " << data.length();
-        }
+            QImage image;
+            image.loadFromData(data);
+            return image;
+        }));
     }
     else
     {
@@ -52,6 +52,8 @@ class HIPSManager : public QObject
         typedef enum { HIPS_EQUATORIAL_FRAME, HIPS_GALACTIC_FRAME, HIPS_OTHER_FRAME } HIPSFrame;
 
         QImage *getPix(bool allsky, int level, int pix, bool &freeImage);
+        // Starts loading a tile that is not visible yet, unless it is already cached or on its way.
+        void prefetchPix(int level, int pix);
 
         void readSources();
 
@@ -119,6 +121,7 @@ class HIPSManager : public QObject
         QSet <pixCacheKey_t> m_downloadMap;
 
         void addToMemoryCache(pixCacheKey_t &key, pixCacheItem_t *item);
+        void requestTile(bool allsky, pixCacheKey_t &key);
         pixCacheItem_t *getCacheItem(pixCacheKey_t &key);
 
         // List of all sources in the database
@@ -15,9 +15,48 @@
 #include "skyqpainter.h"
 #include "projections/projector.h"
 
+#include <QThread>
+#include <QtConcurrent>
+
+#include <numeric>
+
+namespace
+{
+// UV Mapping to apply image unto the destination image
+// 4x4 = 16 points are mapped from the source image unto the destination image.
+// Starting from each grandchild pixel, each pix polygon is mapped accordingly.
+// For example, pixel 357 will have 4 child pixels, each of them will have 4 childs pixels and so
+// on. Each healpix pixel appears roughly as a diamond on the sky map.
+// The corners points for HealPIX moves from NORTH -> EAST -> SOUTH -> WEST
+// Hence first point is 0.25, 0.25 in UV coordinate system.
+// Depending on the selected algorithm, the mapping will either utilize nearest neighbour
+// or bilinear interpolation.
+// N.B. Only read, but ScanRender takes it as non-const.
+QPointF tileUV[16][4] = {{QPointF(.25, .25), QPointF(0.25, 0), QPointF(0, .0), QPointF(0, .25)},
+    {QPointF(.25, .5), QPointF(0.25, 0.25), QPointF(0, .25), QPointF(0, .5)},
+    {QPointF(.5, .25), QPointF(0.5, 0), QPointF(.25, .0), QPointF(.25, .25)},
+    {QPointF(.5, .5), QPointF(0.5, 0.25), QPointF(.25, .25), QPointF(.25, .5)},
+
+    {QPointF(.25, .75), QPointF(0.25, 0.5), QPointF(0, 0.5), QPointF(0, .75)},
+    {QPointF(.25, 1), QPointF(0.25, 0.75), QPointF(0, .75), QPointF(0, 1)},
+    {QPointF(.5, .75), QPointF(0.5, 0.5), QPointF(.25, .5), QPointF(.25, .75)},
+    {QPointF(.5, 1), QPointF(0.5, 0.75), QPointF(.25, .75), QPointF(.25, 1)},
+
+    {QPointF(.75, .25), QPointF(0.75, 0), QPointF(0.5, .0), QPointF(0.5, .25)},
+    {QPointF(.75, .5), QPointF(0.75, 0.25), QPointF(0.5, .25), QPointF(0.5, .5)},
+    {QPointF(1, .25), QPointF(1, 0), QPointF(.75, .0), QPointF(.75, .25)},
+    {QPointF(1, .5), QPointF(1, 0.25), QPointF(.75, .25), QPointF(.75, .5)},
+
+    {QPointF(.75, .75), QPointF(0.75, 0.5), QPointF(0.5, .5), QPointF(0.5, .75)},
+    {QPointF(.75, 1), QPointF(0.75, 0.75), QPointF(0.5, .75), QPointF(0.5, 1)},
+    {QPointF(1, .75), QPointF(1, 0.5), QPointF(.75, .5), QPointF(.75, .75)},
+    {QPointF(1, 1), QPointF(1, 0.75), QPointF(.75, .75), QPointF(.75, 1)},
+};
+}
+
 HIPSRenderer::HIPSRenderer()
 {
-    m_scanRender.reset(new ScanRender());
+    m_scanRenders.emplace_back(new ScanRender());
     m_HEALpix.reset(new HEALPix());
 }
 
@@ -44,6 +83,9 @@ bool HIPSRenderer::render(uint16_t w, uint16_t h, QImage *hipsImage, const Proje
     level = HIPSManager::Instance()->getUsableLevel(level);
 
     m_renderedMap.clear();
+    m_prefetchMap.clear();
+    m_tiles.clear();
+    m_gridCells.clear();
     m_rendered = 0;
     m_blocks = 0;
     m_size = 0;
@@ -92,17 +134,102 @@ bool HIPSRenderer::render(uint16_t w, uint16_t h, QImage *hipsImage, const Proje
     if (size < 0)
         size = HIPSManager::Instance()->getCurrentTileWidth();
 
-    bool old = m_scanRender->isBilinearInterpolationEnabled();
-    m_scanRender->setBilinearInterpolationEnabled(Options::hIPSBiLinearInterpolation()
-            && (size >= HIPSManager::Instance()->getCurrentTileWidth() || allSky));
-
+    // First find the visible tiles and get their images, then draw them all at once
     renderRec(allSky, level, centerPix, hipsImage);
 
-    m_scanRender->setBilinearInterpolationEnabled(old);
+    rasterizeTiles(hipsImage, Options::hIPSBiLinearInterpolation()
+                   && (size >= HIPSManager::Instance()->getCurrentTileWidth() || allSky));
+
+    for (auto &tile : m_tiles)
+    {
+        if (tile.freeImage)
+            delete tile.image;
+    }
+    m_tiles.clear();
+
+    if (Options::hIPSShowGrid())
+        drawGrid(hipsImage, level);
+
+    // The all sky image holds every tile of the level already
+    if (!allSky && Options::hIPSPrefetch())
+    {
+        for (int pix : m_prefetchMap)
+            HIPSManager::Instance()->prefetchPix(level, pix);
+    }
 
     return true;
 }
 
+void HIPSRenderer::rasterizeTiles(QImage *pDest, bool bilinear)
+{
+    if (m_tiles.empty())
+        return;
+
+    // Each band of rows is filled by its own renderer. Every band goes through the tiles in
+    // the same order, so the image is the same as when the tiles are drawn one after another.
+    const int height = pDest->height();
+    const int bandCount = qBound(1, QThread::idealThreadCount(), height / 64);
+    const int bandHeight = (height + bandCount - 1) / bandCount;
+    while (static_cast<int>(m_scanRenders.size()) < bandCount)
+        m_scanRenders.emplace_back(new ScanRender());
+
+    uchar *bits = pDest->bits();
+    const int width = pDest->width();
+    const auto bytesPerLine = pDest->bytesPerLine();
+    const QImage::Format format = pDest->format();
+
+    std::vector<int> bands(bandCount);
+    std::iota(bands.begin(), bands.end(), 0);
+    QtConcurrent::blockingMap(bands, [&](const int &band)
+    {
+        const int top = band * bandHeight;
+        const int bottom = qMin(height, top + bandHeight);
+        // An image of its own over the same pixels, as QImage objects can't be shared between threads
+        QImage destination(bits, width, height, bytesPerLine, format);
+        ScanRender *scanRender = m_scanRenders[band].get();
+        scanRender->setBilinearInterpolationEnabled(bilinear);
+        scanRender->setRowRange(top, bottom);
+
+        for (auto &tile : m_tiles)
+        {
+            for (int j = 0; j < 16; j++)
+            {
+                QPointF *fineScreenCoords = tile.fineScreenCoords[j];
+                double minY = fineScreenCoords[0].y(), maxY = minY;
+                for (int i = 1; i < 4; i++)
+                {
+                    minY = qMin(minY, fineScreenCoords[i].y());
+                    maxY = qMax(maxY, fineScreenCoords[i].y());
+                }
+                // Coordinates are truncated to whole rows, which may move them by one
+                if (maxY + 1 < top || minY > bottom)
+                    continue;
+                scanRender->renderPolygon(3, fineScreenCoords, &destination, tile.image, tileUV[j]);
+            }
+        }
+    });
+}
+
+void HIPSRenderer::drawGrid(QImage *pDest, int level)
+{
+    QPainter p(pDest);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(gridColor);
+
+    for (const auto &cell : m_gridCells)
+    {
+        const QPointF *cornerScreenCoords = cell.corners;
+        p.drawLine(cornerScreenCoords[0].x(), cornerScreenCoords[0].y(), cornerScreenCoords[1].x(), cornerScreenCoords[1].y());
+        p.drawLine(cornerScreenCoords[1].x(), cornerScreenCoords[1].y(), cornerScreenCoords[2].x(), cornerScreenCoords[2].y());
+        p.drawLine(cornerScreenCoords[2].x(), cornerScreenCoords[2].y(), cornerScreenCoords[3].x(), cornerScreenCoords[3].y());
+        p.drawLine(cornerScreenCoords[3].x(), cornerScreenCoords[3].y(), cornerScreenCoords[0].x(), cornerScreenCoords[0].y());
+        p.drawText((cornerScreenCoords[0].x() + cornerScreenCoords[1].x() + cornerScreenCoords[2].x() + cornerScreenCoords[3].x()) /
+                   4,
+                   (cornerScreenCoords[0].y() + cornerScreenCoords[1].y() + cornerScreenCoords[2].y() + cornerScreenCoords[3].y()) / 4,
+                   QString::number(cell.pix) + " / " + QString::number(level));
+    }
+}
+
 void HIPSRenderer::renderRec(bool allsky, int level, int pix, QImage *pDest)
 {
     if (m_renderedMap.contains(pix))
@@ -123,6 +250,10 @@ void HIPSRenderer::renderRec(bool allsky, int level, int pix, QImage *pDest)
         renderRec(allsky, level, dirs[4], pDest);
         renderRec(allsky, level, dirs[6], pDest);
     }
+    else
+    {
+        m_prefetchMap.insert(pix);
+    }
 }
 
 bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
@@ -160,36 +291,14 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
 
             m_size += image->sizeInBytes();
 
-            // UV Mapping to apply image unto the destination image
-            // 4x4 = 16 points are mapped from the source image unto the destination image.
-            // Starting from each grandchild pixel, each pix polygon is mapped accordingly.
-            // For example, pixel 357 will have 4 child pixels, each of them will have 4 childs pixels and so
-            // on. Each healpix pixel appears roughly as a diamond on the sky map.
-            // The corners points for HealPIX moves from NORTH -> EAST -> SOUTH -> WEST
-            // Hence first point is 0.25, 0.25 in UV coordinate system.
-            // Depending on the selected algorithm, the mapping will either utilize nearest neighbour
-            // or bilinear interpolation.
-            QPointF uv[16][4] = {{QPointF(.25, .25), QPointF(0.25, 0), QPointF(0, .0), QPointF(0, .25)},
-                {QPointF(.25, .5), QPointF(0.25, 0.25), QPointF(0, .25), QPointF(0, .5)},
-                {QPointF(.5, .25), QPointF(0.5, 0), QPointF(.25, .0), QPointF(.25, .25)},
-                {QPointF(.5, .5), QPointF(0.5, 0.25), QPointF(.25, .25), QPointF(.25, .5)},
-
-                {QPointF(.25, .75), QPointF(0.25, 0.5), QPointF(0, 0.5), QPointF(0, .75)},
-                {QPointF(.25, 1), QPointF(0.25, 0.75), QPointF(0, .75), QPointF(0, 1)},
-                {QPointF(.5, .75), QPointF(0.5, 0.5), QPointF(.25, .5), QPointF(.25, .75)},
-                {QPointF(.5, 1), QPointF(0.5, 0.75), QPointF(.25, .75), QPointF(.25, 1)},
-
-                {QPointF(.75, .25), QPointF(0.75, 0), QPointF(0.5, .0), QPointF(0.5, .25)},
-                {QPointF(.75, .5), QPointF(0.75, 0.25), QPointF(0.5, .25), QPointF(0.5, .5)},
-                {QPointF(1, .25), QPointF(1, 0), QPointF(.75, .0), QPointF(.75, .25)},
-                {QPointF(1, .5), QPointF(1, 0.25), QPointF(.75, .25), QPointF(.75, .5)},
-
-                {QPointF(.75, .75), QPointF(0.75, 0.5), QPointF(0.5, .5), QPointF(0.5, .75)},
-                {QPointF(.75, 1), QPointF(0.75, 0.75), QPointF(0.5, .75), QPointF(0.5, 1)},
-                {QPointF(1, .75), QPointF(1, 0.5), QPointF(.75, .5), QPointF(.75, .75)},
-                {QPointF(1, 1), QPointF(1, 0.75), QPointF(.75, .75), QPointF(.75, 1)},
-            };
+            hipsTile_t tile;
+            tile.image = image;
+            tile.freeImage = freeImage;
 
+            // The image is interpolated and rendered over the 4x4 grandchildren of the pixel
+            // to minimize any distortions due to the projection system. See tileUV.
+            SkyPoint fineSkyPoints[16][4];
+            const SkyPoint *finePoints[64];
             int childPixelID[4];
 
             // Find all the 4 children of the current pixel
@@ -200,46 +309,32 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
             {
                 int grandChildPixelID[4];
                 // Find the children of this child (i.e. grand child)
-                // Then we have 4x4 pixels under the primary pixel
-                // The image is interpolated and rendered over these pixels
-                // coordinate to minimize any distortions due to the projection
-                // system.
                 m_HEALpix->getPixChilds(id, grandChildPixelID);
 
-                QPointF fineScreenCoords[4];
-
                 for (int id2 : grandChildPixelID)
                 {
-                    SkyPoint fineSkyPoints[4];
-                    m_HEALpix->getCornerPoints(level + 2, id2, fineSkyPoints);
-
+                    m_HEALpix->getCornerPoints(level + 2, id2, fineSkyPoints[j]);
                     for (int i = 0; i < 4; i++)
-                        fineScreenCoords[i] = m_projector->toScreen(&fineSkyPoints[i]);
-                    m_scanRender->renderPolygon(3, fineScreenCoords, pDest, image, uv[j]);
+                        finePoints[j * 4 + i] = &fineSkyPoints[j][i];
                     j++;
                 }
             }
 
-            if (freeImage)
-            {
-                delete image;
-            }
+            float x[64], y[64];
+            m_projector->toScreenBatch(finePoints, 64, x, y);
+            for (int k = 0; k < 64; k++)
+                tile.fineScreenCoords[k / 4][k % 4] = QPointF(x[k], y[k]);
+
+            m_tiles.push_back(tile);
         }
 
         if (Options::hIPSShowGrid())
         {
-            QPainter p(pDest);
-            p.setRenderHint(QPainter::Antialiasing);
-            p.setPen(gridColor);
-
-            p.drawLine(cornerScreenCoords[0].x(), cornerScreenCoords[0].y(), cornerScreenCoords[1].x(), cornerScreenCoords[1].y());
-            p.drawLine(cornerScreenCoords[1].x(), cornerScreenCoords[1].y(), cornerScreenCoords[2].x(), cornerScreenCoords[2].y());
-            p.drawLine(cornerScreenCoords[2].x(), cornerScreenCoords[2].y(), cornerScreenCoords[3].x(), cornerScreenCoords[3].y());
-            p.drawLine(cornerScreenCoords[3].x(), cornerScreenCoords[3].y(), cornerScreenCoords[0].x(), cornerScreenCoords[0].y());
-            p.drawText((cornerScreenCoords[0].x() + cornerScreenCoords[1].x() + cornerScreenCoords[2].x() + cornerScreenCoords[3].x()) /
-                       4,
-                       (cornerScreenCoords[0].y() + cornerScreenCoords[1].y() + cornerScreenCoords[2].y() + cornerScreenCoords[3].y()) / 4,
-                       QString::number(pix) + " / " + QString::number(level));
+            hipsGridCell_t cell;
+            cell.pix = pix;
+            for (int i = 0; i < 4; i++)
+                cell.corners[i] = cornerScreenCoords[i];
+            m_gridCells.push_back(cell);
         }
 
         return true;
@@ -13,6 +13,7 @@
 #include "scanrender.h"
 
 #include <memory>
+#include <vector>
 
 class Projector;
 
@@ -30,13 +31,37 @@ signals:
 
 public slots:
 
-private:  
+private:
+  // A visible tile and the screen corners of its 4x4 grandchildren, waiting to be drawn
+  typedef struct
+  {
+    QImage *image;
+    bool freeImage;
+    QPointF fineScreenCoords[16][4];
+  } hipsTile_t;
+
+  // The screen corners of a visible tile, for the HiPS grid
+  typedef struct
+  {
+    int pix;
+    QPointF corners[4];
+  } hipsGridCell_t;
+
+  // Draws the tiles collected by renderRec(), a band of rows per thread
+  void rasterizeTiles(QImage *pDest, bool bilinear);
+  void drawGrid(QImage *pDest, int level);
+
   int m_blocks { 0 };
   int m_rendered { 0 };
   int m_size { 0 };
   QSet<int>  m_renderedMap;
+  // Tiles next to the visible ones, to be loaded ahead of panning
+  QSet<int>  m_prefetchMap;
+  std::vector<hipsTile_t> m_tiles;
+  std::vector<hipsGridCell_t> m_gridCells;
   std::unique_ptr<HEALPix> m_HEALpix;
-  std::unique_ptr<ScanRender> m_scanRender;
+  // One renderer per band of rows
+  std::vector<std::unique_ptr<ScanRender>> m_scanRenders;
   const Projector *m_projector;
   QColor gridColor;
 };
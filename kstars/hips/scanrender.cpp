@@ -19,6 +19,19 @@
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-align"
 
+// Same as index % size for the indices of a bilinear sample, without the division
+static inline int wrapIndex(int index, int size)
+{
+  return (index >= size) ? index - size : index;
+}
+
+// Spreads the red and blue channels of a pixel into the two halves of a 64 bit integer,
+// so that both can be weighted with one multiplication.
+static inline quint64 spreadRedBlue(quint32 pixel)
+{
+  return (pixel & 0xff) | (static_cast<quint64>(pixel & 0xff0000) << 16);
+}
+
 //////////////////////////////
 ScanRender::ScanRender(void)
 //////////////////////////////
@@ -39,6 +52,14 @@ bool ScanRender::isBilinearInterpolationEnabled()
   return(bBilinear);
 }
 
+////////////////////////////////////////////////
+void ScanRender::setRowRange(int top, int bottom)
+////////////////////////////////////////////////
+{
+  m_top = top;
+  m_bottom = bottom;
+}
+
 ///////////////////////////////////////////////
 void ScanRender::resetScanPoly(int sx, int sy)
 ///////////////////////////////////////////////
@@ -233,7 +254,7 @@ void ScanRender::renderPolygon(QColor col, QImage *dst)
   int       dw = dst->width();
   bkScan_t *scan = scLR;
 
-  for (int y = plMinY; y <= plMaxY; y++)
+  for (int y = qMax(plMinY, m_top); y <= qMin(plMaxY, m_bottom - 1); y++)
   {
     int px1 = scan[y].scan[0];
     int px2 = scan[y].scan[1];
@@ -284,7 +305,7 @@ void ScanRender::renderPolygonAlpha(QColor col, QImage *dst)
   int       gc = qGreen(c);
   int       bc = qBlue(c);
 
-  for (int y = plMinY; y <= plMaxY; y++)
+  for (int y = qMax(plMinY, m_top); y <= qMin(plMaxY, m_bottom - 1); y++)
   {
     int px1 = scan[y].scan[0];
     int px2 = scan[y].scan[1];    
@@ -416,7 +437,7 @@ void ScanRender::renderPolygonNI(QImage *dst, QImage *src)
   bool bw = src->format() == QImage::Format_Indexed8 || src->format() == QImage::Format_Grayscale8;      
 
   //#pragma omp parallel for
-  for (int y = plMinY; y <= plMaxY; y++)
+  for (int y = qMax(plMinY, m_top); y <= qMin(plMaxY, m_bottom - 1); y++)
   {   
     if (scan[y].scan[0] > scan[y].scan[1])
     {
@@ -522,7 +543,7 @@ void ScanRender::renderPolygonBI(QImage *dst, QImage *src)
 #ifdef PARALLEL_OMP
   #pragma omp parallel for
 #endif
-  for (int y = plMinY; y <= plMaxY; y++)
+  for (int y = qMax(plMinY, m_top); y <= qMin(plMaxY, m_bottom - 1); y++)
   {
     if (scan[y].scan[0] > scan[y].scan[1])
     {
@@ -580,9 +601,9 @@ void ScanRender::renderPolygonBI(QImage *dst, QImage *src)
         int index = ((int)uv[0] + ((int)uv[1] * sw));
 
         uchar a = bitsSrc8[index];
-        uchar b = bitsSrc8[(index + 1) % size];
-        uchar c = bitsSrc8[(index + sw) % size];
-        uchar d = bitsSrc8[(index + sw + 1) % size];
+        uchar b = bitsSrc8[wrapIndex(index + 1, size)];
+        uchar c = bitsSrc8[wrapIndex(index + sw, size)];
+        uchar d = bitsSrc8[wrapIndex(index + sw + 1, size)];
 
         int val = (a&0xff)*(x_1diff)*(y_1diff) + (b&0xff)*(x_diff)*(y_1diff) +
                   (c&0xff)*(y_diff)*(x_1diff)   + (d&0xff)*(x_diff*y_diff);
@@ -609,24 +630,24 @@ void ScanRender::renderPolygonBI(QImage *dst, QImage *src)
         int index = ((int)uv[0] + ((int)uv[1] * sw));
 
         quint32 a = bitsSrc[index];
-        quint32 b = bitsSrc[(index + 1) % size];
-        quint32 c = bitsSrc[(index + sw) % size];
-        quint32 d = bitsSrc[(index + sw + 1) % size];
+        quint32 b = bitsSrc[wrapIndex(index + 1, size)];
+        quint32 c = bitsSrc[wrapIndex(index + sw, size)];
+        quint32 d = bitsSrc[wrapIndex(index + sw + 1, size)];
 
         int qxy1 = (x_1diff * y_1diff) * 65536;
         int qxy2 =(x_diff * y_1diff) * 65536;
         int qxy = (x_diff * y_diff) * 65536;
         int qyx1 = (y_diff * x_1diff) * 65536;
 
-        // blue element
-        int blue = ((a&0xff)*(qxy1) + (b&0xff)*(qxy2) + (c&0xff)*(qyx1)  + (d&0xff)*(qxy)) >> 16;
+        // red and blue elements, weighted together. The weights add up to at most 65536,
+        // so each sum fits in 24 bits and can't spill into the other half.
+        quint64 redBlue = spreadRedBlue(a) * qxy1 + spreadRedBlue(b) * qxy2 + spreadRedBlue(c) * qyx1 + spreadRedBlue(d) * qxy;
+        int blue = (redBlue & 0xffffffff) >> 16;
+        int red = redBlue >> 48;
 
         // green element
         int green = (((a>>8)&0xff)*(qxy1) + ((b>>8)&0xff)*(qxy2) + ((c>>8)&0xff)*(qyx1)  + ((d>>8)&0xff)*(qxy)) >> 16;
 
-        // red element
-        int red = (((a>>16)&0xff)*(qxy1) + ((b>>16)&0xff)*(qxy2) +((c>>16)&0xff)*(qyx1)  + ((d>>16)&0xff)*(qxy)) >> 16;
-
         *pDst = 0xff000000 | (((red)<<16)&0xff0000) | (((green)<<8)&0xff00) | (blue);
 
         pDst++;
@@ -663,7 +684,7 @@ void ScanRender::renderPolygonAlphaBI(QImage *dst, QImage *src)
 #ifdef PARALLEL_OMP
   #pragma omp parallel for shared(bitsDst, bitsSrc, scan, tsx, tsy, w, sw)
 #endif
-  for (int y = plMinY; y <= plMaxY; y++)
+  for (int y = qMax(plMinY, m_top); y <= qMin(plMaxY, m_bottom - 1); y++)
   {
     if (scan[y].scan[0] > scan[y].scan[1])
     {
@@ -722,9 +743,9 @@ void ScanRender::renderPolygonAlphaBI(QImage *dst, QImage *src)
         int index = ((int)uv[0] + ((int)uv[1] * sw));
 
         uchar a = bitsSrc8[index];
-        uchar b = bitsSrc8[(index + 1) % size];
-        uchar c = bitsSrc8[(index + sw) % size];
-        uchar d = bitsSrc8[(index + sw + 1) % size];
+        uchar b = bitsSrc8[wrapIndex(index + 1, size)];
+        uchar c = bitsSrc8[wrapIndex(index + sw, size)];
+        uchar d = bitsSrc8[wrapIndex(index + sw + 1, size)];
 
         int val = (a&0xff)*(x_1diff)*(y_1diff) + (b&0xff)*(x_diff)*(y_1diff) +
                   (c&0xff)*(y_diff)*(x_1diff)   + (d&0xff)*(x_diff*y_diff);
@@ -753,9 +774,9 @@ void ScanRender::renderPolygonAlphaBI(QImage *dst, QImage *src)
         int index = ((int)uv[0] + ((int)uv[1] * sw));
 
         quint32 a = bitsSrc[index];
-        quint32 b = bitsSrc[(index + 1) % size];
-        quint32 c = bitsSrc[(index + sw) % size];
-        quint32 d = bitsSrc[(index + sw + 1) % size];
+        quint32 b = bitsSrc[wrapIndex(index + 1, size)];
+        quint32 c = bitsSrc[wrapIndex(index + sw, size)];
+        quint32 d = bitsSrc[wrapIndex(index + sw + 1, size)];
 
         int x1y1 = (x_1diff * y_1diff) * 65536;
         int xy = (x_diff * y_diff) * 65536;
@@ -812,7 +833,7 @@ void ScanRender::renderPolygonAlphaNI(QImage *dst, QImage *src)
 #ifdef PARALLEL_OMP
   #pragma omp parallel for shared(bitsDst, bitsSrc, scan, tsx, tsy, w, sw)
 #endif
-  for (int y = plMinY; y <= plMaxY; y++)
+  for (int y = qMax(plMinY, m_top); y <= qMin(plMaxY, m_bottom - 1); y++)
   {
     if (scan[y].scan[0] > scan[y].scan[1])
     {
@@ -27,6 +27,9 @@ class ScanRender
     explicit ScanRender(void);
     void setBilinearInterpolationEnabled(bool enable);
     bool isBilinearInterpolationEnabled(void);
+    // Only rows from top up to but not including bottom are drawn, so that
+    // several renderers can fill separate bands of an image at the same time.
+    void setRowRange(int top, int bottom);
     void resetScanPoly(int sx, int sy);
     void scanLine(int x1, int y1, int x2, int y2);
     void scanLine(int x1, int y1, int x2, int y2, float u1, float v1, float u2, float v2);
@@ -48,6 +51,8 @@ private:
     float    m_opacity { 1.0f };
     int      plMinY { 0 };
     int      plMaxY { 0 };
+    int      m_top { 0 };
+    int      m_bottom { MAX_BK_SCANLINES };
     int      m_sx { 0 };
     int      m_sy { 0 };
     bkScan_t scLR[MAX_BK_SCANLINES];
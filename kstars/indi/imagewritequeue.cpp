@@ -0,0 +1,200 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "imagewritequeue.h"
+
+#include "Options.h"
+#include "indi_debug.h"
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace ISD
+{
+ImageWriteQueue::ImageWriteQueue(QObject *parent) : QObject(parent)
+{
+}
+
+ImageWriteQueue::~ImageWriteQueue()
+{
+    waitForFinished();
+}
+
+void ImageWriteQueue::enqueue(const QString &filename, const QByteArray &data)
+{
+    int pending = 0;
+    double throughput = 0;
+    {
+        QMutexLocker locker(&m_Mutex);
+        // Callers are expected to hold back while the queue is full, but never stall the GUI thread here
+        if (m_Queue.size() >= depth())
+            qCWarning(KSTARS_INDI) << "Image write queue is full," << m_Queue.size() << "images pending, queuing" << filename;
+
+        m_Queue.enqueue({filename, data});
+        pending = m_Queue.size();
+        throughput = m_Throughput;
+
+        if (!m_Draining)
+        {
+            m_Draining = true;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+            m_Worker = QtConcurrent::run(&ImageWriteQueue::drain, this);
+#else
+            m_Worker = QtConcurrent::run(this, &ImageWriteQueue::drain);
+#endif
+        }
+    }
+
+    emit statusChanged(pending, throughput);
+}
+
+void ImageWriteQueue::waitForFinished()
+{
+    QMutexLocker locker(&m_Mutex);
+    while (m_Draining)
+        m_Updated.wait(&m_Mutex);
+}
+
+int ImageWriteQueue::pending() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Queue.size();
+}
+
+bool ImageWriteQueue::isFull() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Queue.size() >= depth();
+}
+
+int ImageWriteQueue::depth()
+{
+    return std::max(1, static_cast<int>(Options::imageWriteQueueDepth()));
+}
+
+double ImageWriteQueue::throughput() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Throughput;
+}
+
+void ImageWriteQueue::drain()
+{
+    const int syncBatch = Options::imageWriteSyncBatch();
+    QElapsedTimer timer;
+
+    while (true)
+    {
+        Job job;
+        {
+            QMutexLocker locker(&m_Mutex);
+            if (m_Queue.isEmpty())
+            {
+                m_Draining = false;
+                m_Updated.wakeAll();
+                return;
+            }
+            job = m_Queue.head();
+        }
+
+        timer.start();
+        const bool ok = writeFile(job.filename, job.data);
+
+        // Sync a full batch, or whatever is left once the queue runs empty
+        QStringList toSync;
+        {
+            QMutexLocker locker(&m_Mutex);
+            if (ok)
+                m_Unsynced << job.filename;
+            if (syncBatch > 0 && (m_Unsynced.size() >= syncBatch || m_Queue.size() == 1))
+                toSync.swap(m_Unsynced);
+        }
+        if (!toSync.isEmpty() && !syncFiles(toSync))
+            qCWarning(KSTARS_INDI) << "Failed to sync images to disk:" << toSync;
+
+        // Smooth the throughput over the last few images
+        const double seconds = std::max(timer.nsecsElapsed() / 1e9, 1e-6);
+        int pending = 0;
+        double throughput = 0;
+        {
+            QMutexLocker locker(&m_Mutex);
+            m_Queue.dequeue();
+            const double rate = job.data.size() / seconds;
+            m_Throughput = (m_Throughput > 0) ? 0.7 * m_Throughput + 0.3 * rate : rate;
+            pending = m_Queue.size();
+            throughput = m_Throughput;
+            m_Updated.wakeAll();
+        }
+
+        if (ok)
+            emit written(job.filename);
+        else
+            emit writeFailed(job.filename);
+        emit statusChanged(pending, throughput);
+    }
+}
+
+bool ImageWriteQueue::writeFile(const QString &filename, const QByteArray &data)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCCritical(KSTARS_INDI) << "ISD:CCD Error: Unable to open write file: " <<
+                                filename;
+        return false;
+    }
+    int n = 0;
+    QDataStream out(&file);
+    bool ok = true;
+    const size_t size = data.size();
+    for (size_t nr = 0; nr < size; nr += n)
+    {
+        n = out.writeRawData(data.constData() + nr, size - nr);
+        if (n < 0)
+        {
+            ok = false;
+            break;
+        }
+    }
+    ok = file.flush() && ok;
+    file.close();
+    file.setPermissions(QFileDevice::ReadUser |
+                        QFileDevice::WriteUser |
+                        QFileDevice::ReadGroup |
+                        QFileDevice::ReadOther);
+    return ok;
+}
+
+bool ImageWriteQueue::syncFiles(const QStringList &filenames)
+{
+    bool ok = true;
+    for (const auto &filename : filenames)
+    {
+        QFile file(filename);
+        if (!file.open(QIODevice::ReadWrite))
+        {
+            ok = false;
+            continue;
+        }
+#ifdef Q_OS_WIN
+        ok = (_commit(file.handle()) == 0) && ok;
+#else
+        ok = (fsync(file.handle()) == 0) && ok;
+#endif
+    }
+    return ok;
+}
+}
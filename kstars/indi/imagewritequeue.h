@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QFuture>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QStringList>
+#include <QWaitCondition>
+
+namespace ISD
+{
+/**
+ * @class ImageWriteQueue
+ * Writes captured images to disk in the background, one after another in the order they were queued.
+ *
+ * Queuing never blocks. Up to Options::imageWriteQueueDepth() images should be pending, callers check
+ * isFull() and hold back the next capture until statusChanged() reports room in the queue. If Options::imageWriteSyncBatch() is set, the written files are synced to disk in batches
+ * of that many, and whenever the queue runs empty, rather than leaving it to the operating system.
+ */
+class ImageWriteQueue : public QObject
+{
+        Q_OBJECT
+
+    public:
+        explicit ImageWriteQueue(QObject *parent = nullptr);
+        virtual ~ImageWriteQueue() override;
+
+        /**
+         * @brief enqueue Write data to a file in the background.
+         * @param filename of the file, which is overwritten.
+         * @param data to write. Shared with the caller, not copied.
+         * @note Never blocks. The outcome is reported by written() or writeFailed().
+         */
+        void enqueue(const QString &filename, const QByteArray &data);
+
+        /**
+         * @brief waitForFinished Block until all queued images are written.
+         */
+        void waitForFinished();
+
+        /**
+         * @return number of images queued or being written.
+         */
+        int pending() const;
+
+        /**
+         * @return true if Options::imageWriteQueueDepth() or more images are pending.
+         */
+        bool isFull() const;
+
+        /**
+         * @return recent write throughput in bytes per second.
+         */
+        double throughput() const;
+
+    signals:
+        /**
+         * @brief statusChanged Emitted when an image is queued or written.
+         * @param pending images queued or being written.
+         * @param throughput recent write throughput in bytes per second.
+         */
+        void statusChanged(int pending, double throughput);
+        /**
+         * @brief written Emitted once an image is completely written to filename.
+         */
+        void written(const QString &filename);
+        void writeFailed(const QString &filename);
+
+    private:
+        typedef struct
+        {
+            QString filename;
+            QByteArray data;
+        } Job;
+
+        void drain();
+        static int depth();
+        static bool writeFile(const QString &filename, const QByteArray &data);
+        static bool syncFiles(const QStringList &filenames);
+
+        mutable QMutex m_Mutex;
+        QWaitCondition m_Updated;
+        // The head of the queue is the image being written
+        QQueue<Job> m_Queue;
+        bool m_Draining { false };
+        QFuture<void> m_Worker;
+        // Written but not yet synced to disk
+        QStringList m_Unsynced;
+        double m_Throughput { 0 };
+};
+}
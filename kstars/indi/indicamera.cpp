@@ -30,6 +30,8 @@
 
 #include <basedevice.h>
 
+#include <chrono>
+
 const QStringList RAWFormats = { "cr2", "cr3", "crw", "nef", "raf", "dng", "arw", "orf" };
 
 const QString getFITSModeStringString(FITSMode mode)
@@ -49,16 +51,17 @@ Camera::Camera(GenericDevice *parent) : ConcreteDevice(parent)
 
     connect(m_Parent->getClientManager(), &ClientManager::newBLOBManager, this, &Camera::setBLOBManager, Qt::UniqueConnection);
     m_LastNotificationTS = QDateTime::currentDateTime();
+
+    connect(&m_ImageWriteQueue, &ImageWriteQueue::statusChanged, this, &Camera::imageWriteQueueUpdated);
+    connect(&m_ImageWriteQueue, &ImageWriteQueue::written, this, &Camera::imageWritten);
+    connect(&m_ImageWriteQueue, &ImageWriteQueue::writeFailed, this, &Camera::imageWriteFailed);
 }
 
 Camera::~Camera()
 {
     if (m_ImageViewerWindow)
         m_ImageViewerWindow->close();
-    if (fileWriteThread.isRunning())
-        fileWriteThread.waitForFinished();
-    if (fileWriteBuffer != nullptr)
-        delete [] fileWriteBuffer;
+    m_ImageWriteQueue.waitForFinished();
 }
 
 void Camera::setBLOBManager(const char *device, INDI::Property prop)
@@ -560,62 +563,27 @@ void Camera::processStream(INDI::Property prop)
     emit showVideoFrame(prop, streamW, streamH);
 }
 
-void ISD::Camera::updateFileBuffer(INDI::Property prop, bool is_fits)
+bool Camera::saveCurrentImage(QString &filename)
 {
-    if (is_fits)
-    {
-        // Check if the last write is still ongoing, and if so wait.
-        // It is using the fileWriteBuffer.
-        if (fileWriteThread.isRunning())
-        {
-            fileWriteThread.waitForFinished();
-        }
-    }
-
-    // Will write blob data in a separate thread, and can't depend on the blob
-    // memory, so copy it first.
-
-    auto bp = prop.getBLOB()->at(0);
-    // Check buffer size.
-    if (fileWriteBufferSize != bp->getBlobLen())
+    if (fileWriteBuffer.isEmpty())
     {
-        if (fileWriteBuffer != nullptr)
-            delete [] fileWriteBuffer;
-        fileWriteBufferSize = bp->getBlobLen();
-        fileWriteBuffer = new char[fileWriteBufferSize];
+        qCWarning(KSTARS_INDI) << "No image data to save to" << filename;
+        return false;
     }
 
-    // Copy memory, and write file on a separate thread.
-    // Probably too late to return an error if the file couldn't write.
-    memcpy(fileWriteBuffer, bp->getBlob(), bp->getBlobLen());
+    // The queue holds its own reference to the buffer, so the next BLOB doesn't have to wait for the write.
+    m_ImageWriteQueue.enqueue(filename, fileWriteBuffer);
+    return true;
 }
 
-bool Camera::saveCurrentImage(QString &filename)
+bool Camera::isImageWriteQueueFull() const
 {
-    // TODO: Not yet threading the writes for non-fits files.
-    // Would need to deal with the raw conversion, etc.
-    if (BType == BLOB_FITS)
-    {
-        // Check if the last write is still ongoing, and if so wait.
-        // It is using the fileWriteBuffer.
-        if (fileWriteThread.isRunning())
-        {
-            fileWriteThread.waitForFinished();
-        }
-
-        // Wait until the file is written before overwriting the filename.
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        fileWriteThread = QtConcurrent::run(&ISD::Camera::WriteImageFileInternal, this, filename, fileWriteBuffer,
-                                            fileWriteBufferSize);
-#else
-        fileWriteThread = QtConcurrent::run(this, &ISD::Camera::WriteImageFileInternal, filename, fileWriteBuffer,
-                                            fileWriteBufferSize);
-#endif
-    }
-    else if (!WriteImageFileInternal(filename, static_cast<char*>(fileWriteBuffer), fileWriteBufferSize))
-        return false;
+    return m_ImageWriteQueue.isFull();
+}
 
-    return true;
+void Camera::waitForImageWrites()
+{
+    m_ImageWriteQueue.waitForFinished();
 }
 
 bool Camera::processBLOB(INDI::Property prop)
@@ -628,6 +596,9 @@ bool Camera::processBLOB(INDI::Property prop)
     BType = BLOB_OTHER;
 
     auto bp = bvp->at(0);
+    // Monotonic arrival time, used to time the guide loop
+    const qint64 receivedTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch()).count();
 
     auto format = QString(bp->getFormat()).toLower();
 
@@ -668,12 +639,6 @@ bool Camera::processBLOB(INDI::Property prop)
                              bp->getSize();
     }
 
-    // Create temporary name if ANY of the following conditions are met:
-    // 1. file is preview or batch mode is not enabled
-    // 2. file type is not FITS_NORMAL (focus, guide..etc)
-    // create the file buffer only, saving the image file must be triggered from outside.
-    updateFileBuffer(prop, BType == BLOB_FITS);
-
     // Don't spam, just one notification per 3 seconds
     if (QDateTime::currentDateTime().secsTo(m_LastNotificationTS) <= -3)
     {
@@ -681,7 +646,20 @@ bool Camera::processBLOB(INDI::Property prop)
         m_LastNotificationTS = QDateTime::currentDateTime();
     }
 
-    QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<char *>(bp->getBlob()), bp->getSize());
+    // INDI reuses the BLOB memory, so copy it once. The copy is shared by the file write buffer and FITSData.
+    // Frames that are never saved to disk (focus, guide, align) are handed over to FITSData, which may then
+    // convert the pixels in place rather than copy them again.
+    const FITSMode mode = targetChip->getCaptureMode();
+    const bool mayBeSaved = (mode != FITS_FOCUS && mode != FITS_GUIDE && mode != FITS_ALIGN);
+    QByteArray buffer(reinterpret_cast<const char *>(bp->getBlob()), bp->getBlobLen());
+    if (mayBeSaved)
+        fileWriteBuffer = buffer;
+    else
+        fileWriteBuffer.clear();
+    // The size of the image can differ from the BLOB length, e.g. if it is still compressed.
+    if (bp->getSize() != bp->getBlobLen())
+        buffer = QByteArray::fromRawData(reinterpret_cast<char *>(bp->getBlob()), bp->getSize());
+
     QSharedPointer<FITSData> imageData;
     imageData.reset(new FITSData(targetChip->getCaptureMode()), &QObject::deleteLater);
     imageData->setExtension(shortFormat);
@@ -691,7 +669,7 @@ bool Camera::processBLOB(INDI::Property prop)
     // so that we do not incur delays in loading from buffer that may delay the sequence unnecessairly.
     if ((Options::useFITSViewer() || Options::useSummaryPreview() || targetChip->getCaptureMode() != FITS_NORMAL
             || !targetChip->isBatchMode()) &&
-            !imageData->loadFromBuffer(buffer))
+            !imageData->loadFromBuffer(mayBeSaved ? buffer : std::move(buffer)))
     {
         emit error(ERROR_LOAD);
         return true;
@@ -702,6 +680,9 @@ bool Camera::processBLOB(INDI::Property prop)
     imageData->setProperty("blobVector", prop.getName());
     imageData->setProperty("blobElement", bp->getName());
     imageData->setProperty("chip", targetChip->getType());
+    imageData->setProperty("blobReceived", receivedTime);
+    imageData->setProperty("blobLoaded", static_cast<qint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch()).count()));
 
     // Retain a copy
     targetChip->setImageData(imageData);
@@ -1594,37 +1575,6 @@ bool Camera::setScopeInfo(double focalLength, double aperture)
     return true;
 }
 
-// Internal function to write an image blob to disk.
-bool Camera::WriteImageFileInternal(const QString &filename, char *buffer, const size_t size)
-{
-    QFile file(filename);
-    if (!file.open(QIODevice::WriteOnly))
-    {
-        qCCritical(KSTARS_INDI) << "ISD:CCD Error: Unable to open write file: " <<
-                                filename;
-        return false;
-    }
-    int n = 0;
-    QDataStream out(&file);
-    bool ok = true;
-    for (size_t nr = 0; nr < size; nr += n)
-    {
-        n = out.writeRawData(buffer + nr, size - nr);
-        if (n < 0)
-        {
-            ok = false;
-            break;
-        }
-    }
-    ok = file.flush() && ok;
-    file.close();
-    file.setPermissions(QFileDevice::ReadUser |
-                        QFileDevice::WriteUser |
-                        QFileDevice::ReadGroup |
-                        QFileDevice::ReadOther);
-    return ok;
-}
-
 QString Camera::getCaptureFormat() const
 {
     if (m_CaptureFormatIndex < 0 || m_CaptureFormats.isEmpty() || m_CaptureFormatIndex >= m_CaptureFormats.size())
@@ -9,6 +9,7 @@
 #include "fitsviewer/fitsdata.h"
 #include "indiconcretedevice.h"
 #include "indicamerachip.h"
+#include "imagewritequeue.h"
 
 #include "wsmedia.h"
 #include "auxiliary/imageviewer.h"
@@ -237,11 +238,23 @@ class Camera : public ConcreteDevice
         }
 
         /**
-         * @brief saveCurrentImage save the image that is currently in the image data buffer
-         * @return true if saving succeeded
+         * @brief saveCurrentImage queue the image that is currently in the image data buffer to be saved
+         * @return true if the image was queued. The file exists once imageWritten() is emitted, write
+         * failures are reported by imageWriteFailed()
+         * @note Never blocks, check isImageWriteQueueFull() before capturing the next image.
          */
         bool saveCurrentImage(QString &filename);
 
+        /**
+         * @return true if the image write queue is full and capture should wait for the disk.
+         */
+        bool isImageWriteQueueFull() const;
+
+        /**
+         * @brief waitForImageWrites Block until all queued images are written to disk.
+         */
+        void waitForImageWrites();
+
 
     public slots:
         void StreamWindowHidden();
@@ -271,10 +284,13 @@ class Camera : public ConcreteDevice
         void newImage(const QSharedPointer<FITSData> &data, const QString &extension = "");
         // View
         void newView(const QSharedPointer<FITSView> &view);
+        // Saving
+        void imageWriteQueueUpdated(int pending, double throughput);
+        void imageWritten(const QString &filename);
+        void imageWriteFailed(const QString &filename);
 
     private:
         void processStream(INDI::Property prop);
-        bool WriteImageFileInternal(const QString &filename, char *buffer, const size_t size);
 
         bool HasGuideHead { false };
         bool HasCooler { false };
@@ -325,11 +341,9 @@ class Camera : public ConcreteDevice
         QMap<QString, double> m_ExposurePresets;
         QPair<double, double> m_ExposurePresetsMinMax;
 
-        // Used when writing the image fits file to disk in a separate thread.
-        void updateFileBuffer(INDI::Property prop, bool is_fits);
-        char *fileWriteBuffer { nullptr };
-        int fileWriteBufferSize { 0 };
-        QString fileWriteFilename;
-        QFuture<void> fileWriteThread;
+        // Last received image, to be saved on request.
+        // Shares the received BLOB copy with the FITSData loaded from it.
+        QByteArray fileWriteBuffer;
+        ImageWriteQueue m_ImageWriteQueue;
 };
 }
@@ -111,6 +111,8 @@ void DeepStarItem::update()
             maglim = hideStarsMag;
 
         StarBlockFactory *m_StarBlockFactory = StarBlockFactory::Instance();
+        // Keep a background prefetch from touching the cache while fillToMag and the draw walk the blocks
+        QMutexLocker cacheLocker(&m_StarBlockFactory->mutex());
         //    m_StarBlockFactory->drawID = m_skyMesh->drawID();
         //    qDebug() << "Mesh size = " << m_skyMesh->size() << "; drawID = " << m_skyMesh->drawID();
 
@@ -320,5 +322,6 @@ void DeepStarItem::update()
             trixelID++;
         }
         m_skyMesh->inDraw(false);
+        cacheLocker.unlock();
     }
 }
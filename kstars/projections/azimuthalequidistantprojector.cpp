@@ -10,6 +10,8 @@
 
 #include "azimuthalequidistantprojector.h"
 
+#include "projectorbatch.h"
+
 AzimuthalEquidistantProjector::AzimuthalEquidistantProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -35,3 +37,21 @@ double AzimuthalEquidistantProjector::projectionL(double x) const
 {
     return x;
 }
+
+void AzimuthalEquidistantProjector::toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                                                  float *x, float *y, quint8 *flags, bool oRefract) const
+{
+    azimuthalToScreenBatch(longitudes, latitudes, count, x, y, flags, oRefract, [this](double c)
+    {
+        return AzimuthalEquidistantProjector::projectionK(c);
+    });
+}
+
+void AzimuthalEquidistantProjector::fromScreenBatch(const float *x, const float *y, int count,
+                                                    double *longitudes, double *latitudes) const
+{
+    azimuthalFromScreenBatch(x, y, count, longitudes, latitudes, [this](double r)
+    {
+        return AzimuthalEquidistantProjector::projectionL(r);
+    });
+}
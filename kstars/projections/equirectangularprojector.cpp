@@ -10,6 +10,8 @@
 #include "kstarsdata.h"
 #include "skycomponents/skylabeler.h"
 
+#include <algorithm>
+
 EquirectangularProjector::EquirectangularProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -111,6 +113,70 @@ bool EquirectangularProjector::unusablePoint(const QPointF &p) const
     return (dx * dx > M_PI * M_PI / 4.0) || (dy * dy > M_PI * M_PI / 4.0);
 }
 
+void EquirectangularProjector::toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                                             float *x, float *y, quint8 *flags, bool oRefract) const
+{
+    oRefract &= m_vp.useRefraction;
+    const bool altAz = m_vp.useAltAz;
+    // Azimuth goes in the opposite direction compared to RA
+    const double sign = altAz ? -1.0 : 1.0;
+    const double focusLongitude = altAz ? m_vp.focus->az().reduce().radians() : m_vp.focus->ra().reduce().radians();
+    const double Y0 = altAz ? SkyPoint::refract(m_vp.focus->alt(), oRefract).radians() : m_vp.focus->dec().radians();
+
+    double Y[BatchBlockSize];
+    for (int start = 0; start < count; start += BatchBlockSize)
+    {
+        const int n = std::min(BatchBlockSize, count - start);
+        const double *lon = longitudes + start;
+        const double *lat = latitudes + start;
+
+        if (altAz && oRefract)
+        {
+            for (int i = 0; i < n; i++)
+                Y[i] = SkyPoint::refract(lat[i] / dms::DegToRad) * dms::DegToRad;
+        }
+        else
+            std::copy(lat, lat + n, Y);
+
+        for (int i = 0; i < n; i++)
+        {
+            const double dX = sign * (KSUtils::reduceAngle(lon[i], 0.0, 2 * dms::PI) - focusLongitude);
+            const auto p = rst(KSUtils::reduceAngle(dX, -dms::PI, dms::PI), Y[i] - Y0);
+            x[start + i] = p[0];
+            y[start + i] = p[1];
+            if (flags)
+            {
+                const bool visible = p[0] > 0 && p[0] < m_vp.width;
+                const bool inside = 0 <= p[1] && p[1] <= m_vp.height;
+                flags[start + i] = (visible ? OnVisibleHemisphere : 0) | (visible && inside ? OnScreen : 0);
+            }
+        }
+    }
+}
+
+void EquirectangularProjector::fromScreenBatch(const float *x, const float *y, int count,
+                                               double *longitudes, double *latitudes) const
+{
+    const bool altAz = m_vp.useAltAz;
+    const double sign = altAz ? -1.0 : 1.0;
+    const double focusLongitude = altAz ? m_vp.focus->az().radians() : m_vp.focus->ra().radians();
+    const double focusLatitude = altAz ? SkyPoint::refract(m_vp.focus->alt(), m_vp.useRefraction).radians() :
+                                 m_vp.focus->dec().radians();
+
+    for (int i = 0; i < count; i++)
+    {
+        const auto p = derst(x[i], y[i]);
+        longitudes[i] = KSUtils::reduceAngle(sign * p[0] + focusLongitude, 0.0, 2 * dms::PI);
+        latitudes[i] = p[1] + focusLatitude;
+    }
+
+    if (altAz && m_vp.useRefraction)
+    {
+        for (int i = 0; i < count; i++)
+            latitudes[i] = SkyPoint::unrefract(latitudes[i] / dms::DegToRad) * dms::DegToRad;
+    }
+}
+
 QVector<Eigen::Vector2f> EquirectangularProjector::groundPoly(SkyPoint *labelpoint, bool *drawLabel) const
 {
     float x0 = m_vp.width / 2.;
@@ -24,6 +24,11 @@ class EquirectangularProjector : public Projector
         bool unusablePoint(const QPointF &p) const override;
         Eigen::Vector2f toScreenVec(const SkyPoint *o, bool oRefract = true, bool *onVisibleHemisphere = nullptr) const override;
         SkyPoint fromScreen(const QPointF &p, KStarsData* data, bool onlyAltAz = false) const override;
+        using Projector::toScreenBatch;
+        void toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                           float *x, float *y, quint8 *flags = nullptr, bool oRefract = true) const override;
+        void fromScreenBatch(const float *x, const float *y, int count,
+                             double *longitudes, double *latitudes) const override;
         QVector<Eigen::Vector2f> groundPoly(SkyPoint *labelpoint = nullptr, bool *drawLabel = nullptr) const override;
         void updateClipPoly() override;
 };
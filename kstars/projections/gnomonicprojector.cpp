@@ -6,6 +6,8 @@
 
 #include "gnomonicprojector.h"
 
+#include "projectorbatch.h"
+
 GnomonicProjector::GnomonicProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -31,6 +33,24 @@ double GnomonicProjector::projectionL(double x) const
     return atan(x);
 }
 
+void GnomonicProjector::toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                                      float *x, float *y, quint8 *flags, bool oRefract) const
+{
+    azimuthalToScreenBatch(longitudes, latitudes, count, x, y, flags, oRefract, [this](double c)
+    {
+        return GnomonicProjector::projectionK(c);
+    });
+}
+
+void GnomonicProjector::fromScreenBatch(const float *x, const float *y, int count,
+                                        double *longitudes, double *latitudes) const
+{
+    azimuthalFromScreenBatch(x, y, count, longitudes, latitudes, [this](double r)
+    {
+        return GnomonicProjector::projectionL(r);
+    });
+}
+
 double GnomonicProjector::cosMaxFieldAngle() const
 {
     //Don't let things approach infty.
@@ -23,6 +23,11 @@ class GnomonicProjector : public Projector
     double radius() const override;
     double projectionK(double x) const override;
     double projectionL(double x) const override;
+    using Projector::toScreenBatch;
+    void toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                       float *x, float *y, quint8 *flags = nullptr, bool oRefract = true) const override;
+    void fromScreenBatch(const float *x, const float *y, int count,
+                         double *longitudes, double *latitudes) const override;
     double cosMaxFieldAngle() const override;
 };
 
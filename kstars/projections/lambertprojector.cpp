@@ -6,6 +6,8 @@
 
 #include "lambertprojector.h"
 
+#include "projectorbatch.h"
+
 LambertProjector::LambertProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -30,3 +32,21 @@ double LambertProjector::projectionL(double x) const
 {
     return 2.0 * asin(0.5 * x);
 }
+
+void LambertProjector::toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                                     float *x, float *y, quint8 *flags, bool oRefract) const
+{
+    azimuthalToScreenBatch(longitudes, latitudes, count, x, y, flags, oRefract, [this](double c)
+    {
+        return LambertProjector::projectionK(c);
+    });
+}
+
+void LambertProjector::fromScreenBatch(const float *x, const float *y, int count,
+                                       double *longitudes, double *latitudes) const
+{
+    azimuthalFromScreenBatch(x, y, count, longitudes, latitudes, [this](double r)
+    {
+        return LambertProjector::projectionL(r);
+    });
+}
@@ -6,6 +6,8 @@
 
 #include "orthographicprojector.h"
 
+#include "projectorbatch.h"
+
 OrthographicProjector::OrthographicProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -31,3 +33,21 @@ double OrthographicProjector::projectionL(double x) const
 {
     return asin(x);
 }
+
+void OrthographicProjector::toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                                          float *x, float *y, quint8 *flags, bool oRefract) const
+{
+    azimuthalToScreenBatch(longitudes, latitudes, count, x, y, flags, oRefract, [this](double c)
+    {
+        return OrthographicProjector::projectionK(c);
+    });
+}
+
+void OrthographicProjector::fromScreenBatch(const float *x, const float *y, int count,
+                                            double *longitudes, double *latitudes) const
+{
+    azimuthalFromScreenBatch(x, y, count, longitudes, latitudes, [this](double r)
+    {
+        return OrthographicProjector::projectionL(r);
+    });
+}
@@ -7,6 +7,7 @@
 #include "projector.h"
 
 #include "ksutils.h"
+#include "projectorbatch.h"
 #ifdef KSTARS_LITE
 #include "skymaplite.h"
 #endif
@@ -599,3 +600,38 @@ Eigen::Vector2f Projector::toScreenVec(const SkyPoint *o, bool oRefract, bool *o
 #endif
     return p;
 }
+
+void Projector::toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                              float *x, float *y, quint8 *flags, bool oRefract) const
+{
+    azimuthalToScreenBatch(longitudes, latitudes, count, x, y, flags, oRefract, [this](double c)
+    {
+        return projectionK(c);
+    });
+}
+
+void Projector::toScreenBatch(const SkyPoint *const *points, int count, float *x, float *y,
+                              quint8 *flags, bool oRefract) const
+{
+    double longitudes[BatchBlockSize], latitudes[BatchBlockSize];
+    for (int start = 0; start < count; start += BatchBlockSize)
+    {
+        const int n = std::min(BatchBlockSize, count - start);
+        for (int i = 0; i < n; i++)
+        {
+            const SkyPoint *p = points[start + i];
+            longitudes[i] = m_vp.useAltAz ? p->az().radians() : p->ra().radians();
+            latitudes[i] = m_vp.useAltAz ? p->alt().radians() : p->dec().radians();
+        }
+        toScreenBatch(longitudes, latitudes, n, x + start, y + start, flags ? flags + start : nullptr, oRefract);
+    }
+}
+
+void Projector::fromScreenBatch(const float *x, const float *y, int count,
+                                double *longitudes, double *latitudes) const
+{
+    azimuthalFromScreenBatch(x, y, count, longitudes, latitudes, [this](double r)
+    {
+        return projectionL(r);
+    });
+}
@@ -143,6 +143,52 @@ class Projector
          */
         virtual SkyPoint fromScreen(const QPointF &p, KStarsData* data, bool onlyAltAz = false) const;
 
+        /** Flags set by toScreenBatch() for each point */
+        enum BatchFlag
+        {
+            OnVisibleHemisphere = 1, ///< Same as onVisibleHemisphere of toScreenVec()
+            OnScreen            = 2  ///< On the visible hemisphere and within the screen, see onScreen()
+        };
+
+        /**
+         * @short Determine the screen positions of many points at once.
+         *
+         * The points are given as separate arrays of longitudes and latitudes, in radians:
+         * RA and Dec, or azimuth and unrefracted altitude when the sky map uses horizontal
+         * coordinates. The results are those of toScreenVec() for each point, but the
+         * projection is not called through virtual functions for every point and the
+         * loops work on plain arrays, so the compiler can vectorize them.
+         *
+         * @param longitudes RA or azimuth of the points
+         * @param latitudes Dec or altitude of the points
+         * @param count the number of points
+         * @param x filled with the screen x coordinates
+         * @param y filled with the screen y coordinates
+         * @param flags if not null, filled with the BatchFlag values of each point
+         * @param oRefract as for toScreenVec()
+         */
+        virtual void toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                                   float *x, float *y, quint8 *flags = nullptr, bool oRefract = true) const;
+
+        /**
+         * @short Determine the screen positions of many SkyPoints at once.
+         *
+         * Gathers the coordinates of the points in blocks and projects them with the
+         * array version of toScreenBatch().
+         */
+        void toScreenBatch(const SkyPoint *const *points, int count, float *x, float *y,
+                           quint8 *flags = nullptr, bool oRefract = true) const;
+
+        /**
+         * @short Determine the sky coordinates of many screen positions at once.
+         *
+         * This is the inverse of toScreenBatch(). Like fromScreen(), refraction is removed
+         * from altitudes, but only the coordinates of the sky map's own system are computed:
+         * RA and Dec, or azimuth and altitude. Longitudes are reduced to [0, 2π).
+         */
+        virtual void fromScreenBatch(const float *x, const float *y, int count,
+                                     double *longitudes, double *latitudes) const;
+
         /**
          * ASSUMES *p1 did not clip but *p2 did.  Returns the QPointF on the line
          * between *p1 and *p2 that just clips.
@@ -344,6 +390,27 @@ class Projector
             };
         }
 
+        /**
+         * Implementation of toScreenBatch() for the azimuthal projections, which only
+         * differ by their projectionK() and cosMaxFieldAngle(). @p projectionK is called
+         * for every point, so subclasses pass a lambda calling their own projectionK()
+         * non-virtually to let it be inlined. Defined in projectorbatch.h.
+         */
+        template <typename K>
+        void azimuthalToScreenBatch(const double *longitudes, const double *latitudes, int count,
+                                    float *x, float *y, quint8 *flags, bool oRefract, K projectionK) const;
+
+        /**
+         * Implementation of fromScreenBatch() for the azimuthal projections.
+         * @see azimuthalToScreenBatch()
+         */
+        template <typename L>
+        void azimuthalFromScreenBatch(const float *x, const float *y, int count,
+                                      double *longitudes, double *latitudes, L projectionL) const;
+
+        /** Number of points processed at once by the batch functions */
+        static constexpr int BatchBlockSize = 256;
+
         /**
          * Helper function for drawing ground.
          * @return the point with Alt = 0, az = @p az
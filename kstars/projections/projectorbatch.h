@@ -0,0 +1,107 @@
+/*
+    SPDX-FileCopyrightText: 2026 KStars Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "projector.h"
+#include "ksutils.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+ * Batch kernels shared by the azimuthal projections. They follow toScreenVec() and
+ * fromScreen() step by step, but work through blocks of plain arrays. The steps with
+ * branches (refraction) are done in their own loop so the main loops have none.
+ */
+
+template <typename K>
+void Projector::azimuthalToScreenBatch(const double *longitudes, const double *latitudes, int count,
+                                       float *x, float *y, quint8 *flags, bool oRefract, K projectionK) const
+{
+    oRefract &= m_vp.useRefraction;
+    const bool altAz = m_vp.useAltAz;
+    // Azimuth goes in the opposite direction compared to RA
+    const double sign = altAz ? -1.0 : 1.0;
+    const double focusLongitude = altAz ? m_vp.focus->az().radians() : m_vp.focus->ra().radians();
+    const double sinY0 = m_sinY0, cosY0 = m_cosY0;
+    const double cosMax = cosMaxFieldAngle();
+
+    double Y[BatchBlockSize];
+    for (int start = 0; start < count; start += BatchBlockSize)
+    {
+        const int n = std::min(BatchBlockSize, count - start);
+        const double *lon = longitudes + start;
+        const double *lat = latitudes + start;
+        float *px = x + start;
+        float *py = y + start;
+
+        if (altAz && oRefract)
+        {
+            for (int i = 0; i < n; i++)
+                Y[i] = SkyPoint::refract(lat[i] / dms::DegToRad) * dms::DegToRad;
+        }
+        else
+            std::copy(lat, lat + n, Y);
+
+        for (int i = 0; i < n; i++)
+        {
+            double dX = sign * (lon[i] - focusLongitude);
+            const bool finite = std::isfinite(Y[i]) && std::isfinite(dX);
+            dX = KSUtils::reduceAngle(dX, -dms::PI, dms::PI);
+
+            const double sindX = std::sin(dX), cosdX = std::cos(dX);
+            const double sinY = std::sin(Y[i]), cosY = std::cos(Y[i]);
+            //c is the cosine of the angular distance from the center
+            const double c = sinY0 * sinY + cosY0 * cosY * cosdX;
+            const double k = projectionK(c);
+            const auto p = rst(k * cosY * sindX, k * (cosY0 * sinY - sinY0 * cosY * cosdX));
+
+            px[i] = finite ? p[0] : 0;
+            py[i] = finite ? p[1] : 0;
+            if (flags)
+            {
+                const bool visible = finite && c > cosMax;
+                const bool inside = 0 <= px[i] && px[i] <= m_vp.width && 0 <= py[i] && py[i] <= m_vp.height;
+                flags[start + i] = (visible ? OnVisibleHemisphere : 0) | (visible && inside ? OnScreen : 0);
+            }
+        }
+    }
+}
+
+template <typename L>
+void Projector::azimuthalFromScreenBatch(const float *x, const float *y, int count,
+                                         double *longitudes, double *latitudes, L projectionL) const
+{
+    // Not the cached values, see fromScreen()
+    double sinY0, cosY0;
+    const bool altAz = m_vp.useAltAz;
+    if (altAz)
+        SkyPoint::refract(m_vp.focus->alt(), m_vp.useRefraction).SinCos(sinY0, cosY0);
+    else
+        m_vp.focus->dec().SinCos(sinY0, cosY0);
+    const double sign = altAz ? -1.0 : 1.0;
+    const double focusLongitude = altAz ? m_vp.focus->az().radians() : m_vp.focus->ra().radians();
+
+    for (int i = 0; i < count; i++)
+    {
+        const auto p = derst(x[i], y[i]);
+        const double dx = sign * p[0], dy = p[1];
+        const double r = std::sqrt(dx * dx + dy * dy);
+        const double c = projectionL(r);
+        const double sinc = std::sin(c), cosc = std::cos(c);
+
+        latitudes[i] = std::asin(cosc * sinY0 + (r == 0 ? 0 : (dy * sinc * cosY0) / r));
+        const double A = std::atan2(dx * sinc, r * cosY0 * cosc - dy * sinY0 * sinc);
+        longitudes[i] = KSUtils::reduceAngle(A + focusLongitude, 0.0, 2 * dms::PI);
+    }
+
+    if (altAz && m_vp.useRefraction)
+    {
+        for (int i = 0; i < count; i++)
+            latitudes[i] = SkyPoint::unrefract(latitudes[i] / dms::DegToRad) * dms::DegToRad;
+    }
+}
@@ -6,6 +6,8 @@
 
 #include "stereographicprojector.h"
 
+#include "projectorbatch.h"
+
 StereographicProjector::StereographicProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -32,6 +34,24 @@ double StereographicProjector::projectionL(double x) const
     return 2.0 * atan2(x, 2.0);
 }
 
+void StereographicProjector::toScreenBatch(const double *longitudes, const double *latitudes, int count,
+                                           float *x, float *y, quint8 *flags, bool oRefract) const
+{
+    azimuthalToScreenBatch(longitudes, latitudes, count, x, y, flags, oRefract, [this](double c)
+    {
+        return StereographicProjector::projectionK(c);
+    });
+}
+
+void StereographicProjector::fromScreenBatch(const float *x, const float *y, int count,
+                                             double *longitudes, double *latitudes) const
+{
+    azimuthalFromScreenBatch(x, y, count, longitudes, latitudes, [this](double r)
+    {
+        return StereographicProjector::projectionL(r);
+    });
+}
+
 double StereographicProjector::cosMaxFieldAngle() const
 {
     // Allow everything
@@ -21,6 +21,7 @@
 
 #include <QtConcurrent>
 
+#include <algorithm>
 #include <cmath>
 
 constexpr std::size_t expectedKnownMagObjectsPerTrixel = 500;
@@ -47,6 +48,15 @@ CatalogsComponent::CatalogsComponent(SkyComposite *parent, const QString &db_fil
 
     m_catalog_colors = m_db_manager.get_catalog_colors();
     tryImportSkyComponents();
+
+    m_loader.reset(new CatalogsDB::TrixelLoader(m_db_manager.db_file_name()));
+    QObject::connect(m_loader.get(), &CatalogsDB::TrixelLoader::trixelsLoaded, m_loader.get(),
+                     []()
+    {
+        if (SkyMap::Instance())
+            SkyMap::Instance()->forceUpdate();
+    }, Qt::QueuedConnection);
+
     qCInfo(KSTARS) << "Loaded DSO catalogs.";
 }
 
@@ -93,6 +103,12 @@ void CatalogsComponent::draw(SkyPainter *skyp)
 
     updateSkyMesh(map);
 
+    // Missing trixels are left out and loaded in the background
+    const bool loadAsync = Options::dSOAsyncLoading();
+    std::vector<CatalogsDB::TrixelLoader::Request> requests;
+    if (loadAsync)
+        takeLoadedTrixels();
+
     size_t num_trixels{ 0 };
     const auto zoomFactor = Options::zoomFactor();
     const double sizeScale = dms::PI * zoomFactor / 10800.0; // FIXME: magic number 10800
@@ -129,15 +145,23 @@ void CatalogsComponent::draw(SkyPainter *skyp)
     // galaxies of unknown magnitude, and many of them also of unknown
     // size, remains smooth.
 
-    // Helper lambda to fill the appropriate cache for a given trixel
+    // Helper lambda to fill the appropriate cache for a given trixel,
+    // returns whether the trixel is loaded
     auto fillCache = [&](
                          TrixelCache<ObjectList>::element & cacheElement,
                          ObjectList (CatalogsDB::DBManager::*fillFunction)(const int),
+                         CatalogsDB::TrixelLoader::Query query,
                          Trixel trixel
-                     ) -> void
+                     ) -> bool
     {
         if (!cacheElement.is_set())
         {
+            if (loadAsync)
+            {
+                requests.push_back({ trixel, query });
+                return false;
+            }
+
             try
             {
                 cacheElement = (m_db_manager.*fillFunction)(trixel);
@@ -155,6 +179,7 @@ void CatalogsComponent::draw(SkyPainter *skyp)
                 throw; // do not silently fail
             }
         }
+        return true;
     };
 
     // Helper lambda to JIT update and draw
@@ -201,7 +226,9 @@ void CatalogsComponent::draw(SkyPainter *skyp)
 
         // Fill the cache for this trixel
         auto &objectsKnownMag = m_mainCache[trixel];
-        fillCache(objectsKnownMag, &CatalogsDB::DBManager::get_objects_in_trixel_no_nulls, trixel);
+        if (!fillCache(objectsKnownMag, &CatalogsDB::DBManager::get_objects_in_trixel_no_nulls,
+                       CatalogsDB::TrixelLoader::Query::KnownMag, trixel))
+            continue;
         drawListKnownMag.clear();
 
         // Filter based on magnitude and size
@@ -246,7 +273,9 @@ void CatalogsComponent::draw(SkyPainter *skyp)
 
             // Fill cache
             auto &objectsUnknownMag = m_unknownMagCache[trixel];
-            fillCache(objectsUnknownMag, &CatalogsDB::DBManager::get_objects_in_trixel_null_mag, trixel);
+            if (!fillCache(objectsUnknownMag, &CatalogsDB::DBManager::get_objects_in_trixel_null_mag,
+                           CatalogsDB::TrixelLoader::Query::UnknownMag, trixel))
+                continue;
 
             // Filter
             QtConcurrent::blockingMap(
@@ -281,6 +310,10 @@ void CatalogsComponent::draw(SkyPainter *skyp)
 
     }
 
+    // keep the trixels loaded around the view as well
+    if (loadAsync)
+        num_trixels = std::max(num_trixels, requestTrixels(map, requests, showUnknownMagObjects));
+
     // prune only if the to-be-pruned trixels are likely not visible
     // and we are not zooming
     m_mainCache.prune(num_trixels * 1.2);
@@ -297,6 +330,51 @@ void CatalogsComponent::updateSkyMesh(SkyMap &map, MeshBufNum_t buf)
     m_skyMesh->aperture(focus, radius + 1.0, buf);
 }
 
+void CatalogsComponent::takeLoadedTrixels()
+{
+    for (auto &result : m_loader->takeResults())
+    {
+        auto &cache = result.query == CatalogsDB::TrixelLoader::Query::KnownMag ?
+                      m_mainCache : m_unknownMagCache;
+        cache[result.trixel] = std::move(result.objects);
+    }
+}
+
+size_t CatalogsComponent::requestTrixels(SkyMap &map,
+        std::vector<CatalogsDB::TrixelLoader::Request> &requests,
+        bool unknownMag)
+{
+    // The visible trixels go first, then those within half a field of
+    // view of the screen, which are needed next when panning
+    std::vector<bool> requested(m_skyMesh->size(), false);
+    for (const auto &request : requests)
+        requested[request.trixel] = true;
+
+    SkyPoint *focus = map.focus();
+    float radius    = 1.5 * map.projector()->fov();
+    if (radius > 180.0)
+        radius = 180.0;
+
+    m_skyMesh->aperture(focus, radius + 1.0, PREFETCH_BUF);
+    MeshIterator region(m_skyMesh, PREFETCH_BUF);
+    size_t num_trixels{ 0 };
+    while (region.hasNext())
+    {
+        Trixel trixel = region.next();
+        num_trixels++;
+        if (requested[trixel])
+            continue;
+
+        if (!m_mainCache.is_set(trixel))
+            requests.push_back({ trixel, CatalogsDB::TrixelLoader::Query::KnownMag });
+        if (unknownMag && !m_unknownMagCache.is_set(trixel))
+            requests.push_back({ trixel, CatalogsDB::TrixelLoader::Query::UnknownMag });
+    }
+
+    m_loader->request(requests);
+    return num_trixels;
+}
+
 CatalogObject &CatalogsComponent::insertStaticObject(const CatalogObject &obj)
 {
     auto trixel     = m_skyMesh->index(&obj);
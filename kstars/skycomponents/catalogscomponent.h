@@ -9,12 +9,14 @@
 
 #include "skycomponent.h"
 #include "catalogsdb.h"
+#include "trixelloader.h"
 #include "catalogobject.h"
 #include "skymesh.h"
 #include "trixelcache.h"
 #include "Options.h"
 
 #include "polyfills/qstring_hash.h"
+#include <memory>
 #include <unordered_map>
 
 class SkyMesh;
@@ -32,6 +34,11 @@ class SkyMap;
  * demands a pointer to a CatalogObject, it will be allocated into
  * `m_static_objects` on demand.
  *
+ * Unless Options::dSOAsyncLoading is off, the trixels missing from
+ * the cache are loaded by a `CatalogsDB::TrixelLoader` in the
+ * background, together with the trixels around the visible ones, and
+ * the sky map is updated when they arrive.
+ *
  * If you want to access DSOs in _new_ code you should use a local
  * instance of `CatalogsDB::DBManager` instead and call `dropCache` if
  * necessary.
@@ -110,6 +117,7 @@ class CatalogsComponent : public SkyComponent
          */
         void dropCache()
         {
+            m_loader->clear();
             m_mainCache.clear();
             m_unknownMagCache.clear();
             m_catalog_colors = m_db_manager.get_catalog_colors();
@@ -137,6 +145,11 @@ class CatalogsComponent : public SkyComponent
          */
         SkyMesh *m_skyMesh;
 
+        /**
+         * Loads the trixels missing from the caches in the background.
+         */
+        std::unique_ptr<CatalogsDB::TrixelLoader> m_loader;
+
         /**
          * The main container for the currently loaded objects.
          */
@@ -181,6 +194,21 @@ class CatalogsComponent : public SkyComponent
         /** Helpers */
 
         void updateSkyMesh(SkyMap &map, MeshBufNum_t buf = DRAW_BUF);
+
+        /**
+         * Move the trixels loaded by `m_loader` into the caches.
+         */
+        void takeLoadedTrixels();
+
+        /**
+         * Ask `m_loader` for the missing visible trixels in \p requests
+         * and the missing ones around them.
+         *
+         * \return the number of trixels around the view, visible ones
+         * included
+         */
+        size_t requestTrixels(SkyMap &map, std::vector<CatalogsDB::TrixelLoader::Request> &requests,
+                              bool unknownMag);
         size_t calculateCacheSize(const unsigned int percentage)
         {
             return m_skyMesh->size() * percentage / 100.f;
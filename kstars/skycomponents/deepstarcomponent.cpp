@@ -23,6 +23,10 @@
 #include <QtConcurrent>
 #include <QElapsedTimer>
 
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 #include <kstars_debug.h>
 
 #ifdef _WIN32
@@ -42,6 +46,7 @@ DeepStarComponent::DeepStarComponent(SkyComposite *parent, QString fileName, flo
 
 DeepStarComponent::~DeepStarComponent()
 {
+    m_PrefetchFuture.waitForFinished();
     if (fileOpened)
         starReader.closeFile();
     fileOpened = false;
@@ -93,6 +98,11 @@ bool DeepStarComponent::loadStaticStars()
     // TODO: Read the multiplying factor from the dataFile
     m_FaintMagnitude = faintmag / 100.0;
 
+    // Records follow the 5-byte preamble (faint magnitude, HTM level, MSpT) read above. If the
+    // catalog is memory-mapped, they are copied out of the mapping instead of read with fread.
+    quint64 recordOffset = starReader.getDataOffset() + 5;
+    const bool mapped    = starReader.isMapped();
+
     if (htm_level != m_skyMesh->level())
         qCWarning(KSTARS) << "HTM Level in shallow star data file and HTM Level in m_skyMesh do not match. EXPECT TROUBLE!";
 
@@ -115,7 +125,16 @@ bool DeepStarComponent::loadStaticStars()
 
             for (quint64 j = 0; j < records; ++j)
             {
-                bool fread_success = fread(&stardata, sizeof(StarData), 1, dataFile);
+                bool fread_success = false;
+                if (mapped)
+                {
+                    const uchar *record = starReader.recordAt(recordOffset, sizeof(StarData));
+                    if ((fread_success = (record != nullptr)))
+                        memcpy(&stardata, record, sizeof(StarData));
+                }
+                else
+                    fread_success = fread(&stardata, sizeof(StarData), 1, dataFile);
+                recordOffset += sizeof(StarData);
 
                 if (!fread_success)
                 {
@@ -167,7 +186,15 @@ bool DeepStarComponent::loadStaticStars()
             for (quint64 j = 0; j < records; ++j)
             {
                 bool fread_success = false;
-                fread_success      = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+                if (mapped)
+                {
+                    const uchar *record = starReader.recordAt(recordOffset, sizeof(DeepStarData));
+                    if ((fread_success = (record != nullptr)))
+                        memcpy(&deepstardata, record, sizeof(DeepStarData));
+                }
+                else
+                    fread_success = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+                recordOffset += sizeof(DeepStarData);
 
                 if (!fread_success)
                 {
@@ -245,9 +272,7 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     StarObject::updateCoordsCpuTime = 0.;
     StarObject::starsUpdated        = 0;
 #endif
-    SkyMap *map       = SkyMap::Instance();
-    KStarsData *data  = KStarsData::Instance();
-    UpdateID updateID = data->updateID();
+    SkyMap *map = SkyMap::Instance();
 
     //FIXME_FOV -- maybe not clamp like that...
     float radius = map->projector()->fov();
@@ -289,6 +314,8 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         maglim = hideStarsMag;
 
     StarBlockFactory *m_StarBlockFactory = StarBlockFactory::Instance();
+    // Keep a background prefetch from touching the cache while we draw
+    QMutexLocker cacheLocker(&m_StarBlockFactory->mutex());
     //    m_StarBlockFactory->drawID = m_skyMesh->drawID();
     //    qDebug() << Q_FUNC_INFO << "Mesh size = " << m_skyMesh->size() << "; drawID = " << m_skyMesh->drawID();
     QElapsedTimer t;
@@ -327,6 +354,11 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         region.reset();
     }
 
+    // The stars of each trixel are drawn as one batch
+    std::vector<const SkyPoint *> batchStars;
+    std::vector<float> batchMags;
+    std::vector<char> batchSpectralClasses;
+
     while (region.hasNext())
     {
         ++nTrixels;
@@ -357,20 +389,17 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         //        qDebug() << Q_FUNC_INFO << "Drawing SBL for trixel " << currentRegion << ", SBL has "
         //                 <<  m_starBlockList[ currentRegion ]->getBlockCount() << " blocks";
 
-        // REMARK: The following should never carry state, except for const parameters like updateID and maglim
-        std::function<void(std::shared_ptr<StarBlock>)> mapFunction = [&updateID, &maglim](std::shared_ptr<StarBlock> myBlock)
+        // REMARK: The following should never carry state, except for const parameters like maglim
+        std::function<void(std::shared_ptr<StarBlock>)> mapFunction = [&maglim](std::shared_ptr<StarBlock> myBlock)
         {
-            for (StarObject &star : myBlock->contents())
-            {
-                if (star.updateID != updateID)
-                    star.JITupdate();
-                if (star.mag() > maglim)
-                    break;
-            }
+            myBlock->JITupdate(maglim);
         };
 
         QtConcurrent::blockingMap(m_starBlockList.at(currentRegion)->contents(), mapFunction);
 
+        batchStars.clear();
+        batchMags.clear();
+        batchSpectralClasses.clear();
         for (int i = 0; i < m_starBlockList.at(currentRegion)->getBlockCount(); ++i)
         {
             std::shared_ptr<StarBlock> block = m_starBlockList.at(currentRegion)->block(i);
@@ -378,26 +407,33 @@ void DeepStarComponent::draw(SkyPainter *skyp)
             //                currentRegion << ". SB has " << block->getStarCount() << " stars";
             for (int j = 0; j < block->getStarCount(); j++)
             {
+                float mag = block->mag(j);
+
+                if (mag > maglim)
+                    break;
+
                 StarObject *curStar = block->star(j);
 
                 //                qDebug() << Q_FUNC_INFO << "We claim that he's from trixel " << currentRegion
                 //<< ", and indexStar says he's from " << m_skyMesh->indexStar( curStar );
 
-                float mag = curStar->mag();
-
-                if (mag > maglim)
-                    break;
-
-                if (skyp->drawPointSource(curStar, mag, curStar->spchar()))
-                    visibleStarCount++;
+                batchStars.push_back(curStar);
+                batchMags.push_back(mag);
+                batchSpectralClasses.push_back(curStar->spchar());
             }
         }
+        visibleStarCount += skyp->drawPointSources(batchStars.data(), batchMags.data(), batchSpectralClasses.data(),
+                            static_cast<int>(batchStars.size()));
 
         // DEBUG: Uncomment to identify problems with Star Block Factory / preservation of Magnitude Order in the LRU Cache
         //        verifySBLIntegrity();
         t_drawUnnamed += t.restart();
     }
     m_skyMesh->inDraw(false);
+    cacheLocker.unlock();
+
+    if (!staticStars && Options::prefetchDeepStars())
+        prefetch(focus, radius, m_zoomMagLimit);
 #ifdef PROFILE_SINCOS
     trig_calls_here += dms::trig_function_calls;
     trig_redundancy_here += dms::redundant_trig_function_calls;
@@ -422,6 +458,76 @@ void DeepStarComponent::draw(SkyPainter *skyp)
 #endif
 }
 
+void DeepStarComponent::prefetch(const SkyPoint *focus, float radius, float maglim)
+{
+    // How far ahead of the current frame to load, in seconds
+    const double lookAhead = 0.5;
+
+    const qint64 elapsed = m_PrefetchTimer.isValid() ? m_PrefetchTimer.restart() : 0;
+    if (!m_PrefetchTimer.isValid())
+        m_PrefetchTimer.start();
+
+    const SkyPoint lastFocus = m_LastFocus;
+    const float lastMagLimit = m_LastMagLimit;
+    m_LastFocus              = *focus;
+    m_LastMagLimit           = maglim;
+
+    // No motion trend to extrapolate on the first frame, or after the map has been idle
+    if (elapsed <= 0 || elapsed > 1000)
+        return;
+
+    // A worker is still busy with the previous prediction
+    if (m_PrefetchFuture.isRunning())
+        return;
+
+    double dRA = focus->ra().Degrees() - lastFocus.ra().Degrees();
+    if (dRA > 180.0)
+        dRA -= 360.0;
+    else if (dRA < -180.0)
+        dRA += 360.0;
+    const double dDec  = focus->dec().Degrees() - lastFocus.dec().Degrees();
+    const float dMag   = maglim - lastMagLimit;
+    const double scale = lookAhead * 1000.0 / elapsed;
+
+    // Nothing new to load if the map is not moving and not zooming in
+    const double shift = std::hypot(dRA * focus->dec().cos(), dDec);
+    if (shift < 0.01 * radius && dMag <= 0.0f)
+        return;
+
+    const double predictedDec = qBound(-90.0, focus->dec().Degrees() + dDec * scale, 90.0);
+    dms predictedRA(focus->ra().Degrees() + dRA * scale);
+    const float predictedMag = qMin(maglim + qMax(dMag, 0.0f) * float(scale), m_FaintMagnitude);
+
+    // Trixels are indexed in J2000, the focus is in apparent coordinates
+    SkyPoint predicted(predictedRA.reduce().Hours(), predictedDec);
+    predicted.catalogueCoord(KStarsData::Instance()->updateNum()->julianDay());
+
+    // The mesh buffers are not thread-safe, so resolve the trixels here on the GUI thread
+    m_skyMesh->index(&predicted, radius + 1.0, PREFETCH_BUF);
+    MeshIterator region(m_skyMesh, PREFETCH_BUF);
+    QVector<Trixel> trixels;
+    while (region.hasNext())
+    {
+        Trixel trixel = region.next();
+        if ((int)trixel < m_starBlockList.size() && m_starBlockList.at(trixel)->getFaintMag() < predictedMag)
+            trixels.append(trixel);
+    }
+
+    if (trixels.isEmpty())
+        return;
+
+    m_PrefetchFuture = QtConcurrent::run([this, trixels, predictedMag]()
+    {
+        StarBlockFactory *factory = StarBlockFactory::Instance();
+        for (Trixel trixel : trixels)
+        {
+            // Lock per trixel so that a draw never waits for more than one trixel
+            QMutexLocker locker(&factory->mutex());
+            m_starBlockList.at(trixel)->fillToMag(predictedMag);
+        }
+    });
+}
+
 bool DeepStarComponent::openDataFile()
 {
     if (starReader.getFileHandle())
@@ -462,6 +568,10 @@ bool DeepStarComponent::openDataFile()
         if (starReader.getByteSwap())
             MSpT = bswap_16(MSpT);
         fileOpened = true;
+        // Star records are read in place from a memory mapping when possible, so panning into
+        // unloaded trixels does not stall on buffered file I/O. Fall back to fread otherwise.
+        if (!starReader.mapFile())
+            qCDebug(KSTARS) << "Could not memory-map " << dataFileName << ", reading it through stdio instead.";
         qCInfo(KSTARS) << "  Sky Mesh Size: " << m_skyMesh->size();
         for (long int i = 0; i < m_skyMesh->size(); i++)
         {
@@ -501,6 +611,8 @@ SkyObject *DeepStarComponent::objectNearest(SkyPoint *p, double &maxrad)
     if (!fileOpened)
         return nullptr;
 
+    QMutexLocker cacheLocker(&StarBlockFactory::Instance()->mutex());
+
     m_skyMesh->index(p, maxrad + 1.0, OBJ_NEAREST_BUF);
 
     MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
@@ -570,6 +682,8 @@ bool DeepStarComponent::starsInAperture(QList<StarObject *> &list, const SkyPoin
     if (maglim < -28)
         maglim = m_FaintMagnitude;
 
+    QMutexLocker cacheLocker(&StarBlockFactory::Instance()->mutex());
+
     while (region.hasNext())
     {
         Trixel currentRegion = region.next();
@@ -20,8 +20,12 @@
 #include "listcomponent.h"
 #include "starblockfactory.h"
 #include "skyobjects/deepstardata.h"
+#include "skyobjects/skypoint.h"
 #include "skyobjects/stardata.h"
 
+#include <QElapsedTimer>
+#include <QFuture>
+
 class SkyLabeler;
 class SkyMesh;
 class StarBlockFactory;
@@ -102,6 +106,19 @@ class DeepStarComponent : public ListComponent
     static StarBlockFactory m_StarBlockFactory;
 
   private:
+    /**
+     * @short Load stars ahead of the sky map motion on a worker thread
+     *
+     * Extrapolates the focus velocity and the magnitude limit trend observed between
+     * consecutive draws, and fills the StarBlockLists of the trixels around the predicted
+     * aperture in the background, so the next frames find their stars already loaded.
+     *
+     * @param focus Current focus of the sky map
+     * @param radius Radius of the aperture that was just drawn, in degrees
+     * @param maglim Magnitude limit that was just drawn
+     */
+    void prefetch(const SkyPoint *focus, float radius, float maglim);
+
     SkyMesh *m_skyMesh { nullptr };
     KSNumbers m_reindexNum;
 
@@ -121,6 +138,16 @@ class DeepStarComponent : public ListComponent
     long unsigned t_drawUnnamed { 0 };
     long unsigned t_updateCache { 0 };
 
+    // Prefetch state
+    /// Focus at the previous draw
+    SkyPoint m_LastFocus;
+    /// Magnitude limit at the previous draw
+    float m_LastMagLimit { 0 };
+    /// Time since the previous draw
+    QElapsedTimer m_PrefetchTimer;
+    /// Background fill of the predicted trixels
+    QFuture<void> m_PrefetchFuture;
+
     QVector<std::shared_ptr<StarBlockList>> m_starBlockList;
     QHash<int, StarObject *> m_CatalogNumber;
 
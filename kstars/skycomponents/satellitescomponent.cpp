@@ -85,9 +85,35 @@ void SatellitesComponent::update(KSNumbers *)
     if (!selected())
         return;
 
-    foreach (SatelliteGroup *group, m_groups)
+    struct Propagation
+    {
+        SatelliteGroup *group;
+        Satellite *sat;
+        int rc;
+    };
+
+    // Propagate the selected satellites of all the groups as a single batch, spread over all cores
+    QVector<Propagation> batch;
+    for (SatelliteGroup *group : m_groups)
+    {
+        for (Satellite *sat : *group)
+        {
+            if (sat->selected())
+                batch.append({ group, sat, 0 });
+        }
+    }
+
+    const Satellite::PropagationContext context = Satellite::propagationContext();
+    QtConcurrent::blockingMap(batch, [&context](Propagation & propagation)
+    {
+        propagation.rc = propagation.sat->updatePos(context);
+    });
+
+    // If position cannot be calculated, remove it from its group
+    for (const Propagation &propagation : batch)
     {
-        group->updateSatellitesPos();
+        if (propagation.rc != 0)
+            propagation.group->removeOne(propagation.sat);
     }
 }
 
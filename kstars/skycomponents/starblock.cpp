@@ -7,11 +7,17 @@
 #include <QDebug>
 
 #include "starblock.h"
+#include "kstarsdata.h"
+#include "ksnumbers.h"
+#include "Options.h"
 #include "skyobjects/starobject.h"
 #include "starcomponent.h"
 #include "skyobjects/stardata.h"
 #include "skyobjects/deepstardata.h"
 
+#include <algorithm>
+#include <cmath>
+
 #ifdef KSTARS_LITE
 #include "skymaplite.h"
 #include "kstarslite/skyitems/skynodes/pointsourcenode.h"
@@ -37,6 +43,8 @@ StarBlock::StarBlock(int nstars)
 #else
       stars(nstars, StarObject())
 #endif
+      , m_Mag(nstars), m_X0(nstars), m_Y0(nstars), m_Z0(nstars), m_PMX(nstars), m_PMY(nstars), m_PMZ(nstars),
+      m_PMSq(nstars), m_X(nstars), m_Y(nstars), m_Z(nstars)
 {
 }
 
@@ -64,6 +72,7 @@ StarNode *StarBlock::addStar(const StarData &data)
         faintMag = star.mag();
     if (star.mag() < brightMag)
         brightMag = star.mag();
+    packStar(nStars - 1);
     return &node;
 }
 
@@ -79,6 +88,7 @@ StarNode *StarBlock::addStar(const DeepStarData &data)
         faintMag = star.mag();
     if (star.mag() < brightMag)
         brightMag = star.mag();
+    packStar(nStars - 1);
     return &node;
 }
 #else
@@ -93,6 +103,7 @@ StarObject *StarBlock::addStar(const StarData &data)
         faintMag = star.mag();
     if (star.mag() < brightMag)
         brightMag = star.mag();
+    packStar(nStars - 1);
     return &star;
 }
 
@@ -107,6 +118,133 @@ StarObject *StarBlock::addStar(const DeepStarData &data)
         faintMag = star.mag();
     if (star.mag() < brightMag)
         brightMag = star.mag();
+    packStar(nStars - 1);
     return &star;
 }
 #endif
+
+void StarBlock::packStar(int i)
+{
+#ifdef KSTARS_LITE
+    const StarObject &star = stars[i].star;
+#else
+    const StarObject &star = stars[i];
+#endif
+    double sinRa, cosRa, sinDec, cosDec;
+    star.ra0().SinCos(sinRa, cosRa);
+    star.dec0().SinCos(sinDec, cosDec);
+
+    m_Mag[i] = star.mag();
+    m_X0[i]  = cosDec * cosRa;
+    m_Y0[i]  = cosDec * sinRa;
+    m_Z0[i]  = sinDec;
+
+    // Same first-order proper motion model as StarObject::getIndexCoords(), with the
+    // time-independent part factored out. pmRA already includes the cos(dec) factor.
+    const double pmms = star.pmMagnitudeSquared();
+    if (std::isnan(pmms))
+    {
+        m_PMSq[i] = 0;
+        m_PMX[i] = m_PMY[i] = m_PMZ[i] = 0;
+        return;
+    }
+    const double pmRA = star.pmRA(), pmDec = star.pmDec();
+    m_PMSq[i] = pmms;
+    m_PMX[i]  = -pmRA * sinRa - pmDec * sinDec * cosRa;
+    m_PMY[i]  = pmRA * cosRa - pmDec * sinDec * sinRa;
+    m_PMZ[i]  = pmDec * cosDec;
+}
+
+int StarBlock::countToMag(float maglim) const
+{
+    return std::upper_bound(m_Mag.constBegin(), m_Mag.constBegin() + nStars, maglim) - m_Mag.constBegin();
+}
+
+void StarBlock::JITupdate(float maglim)
+{
+    static KStarsData *data = KStarsData::Instance();
+    const int count = countToMag(maglim);
+
+    auto starAt = [this](int i) -> StarObject &
+    {
+#ifdef KSTARS_LITE
+        return stars[i].star;
+#else
+        return stars[i];
+#endif
+    };
+
+    const UpdateID updateID  = data->updateID();
+    const UpdateID updateNumID = data->updateNumID();
+
+    // Gravitational light bending is decided per star, so leave that case to the per-star path
+    if (Options::useRelativistic())
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            StarObject &star = starAt(i);
+            if (star.updateID != updateID)
+                star.JITupdate();
+        }
+        return;
+    }
+
+    // NOTE: Same short-circuiting as StarObject::JITupdate() and SkyPoint::updateCoords()
+    const KSNumbers *num    = data->updateNum();
+    const bool alwaysUpdate = Options::alwaysRecomputeCoordinates();
+    auto needsRecompute     = [&](const StarObject & star)
+    {
+        return star.updateID != updateID && star.updateNumID != updateNumID &&
+               (alwaysUpdate || std::abs(star.getLastPrecessJD() - num->getJD()) >= 0.00069444);
+    };
+
+    bool recompute = false;
+    for (int i = 0; i < count && !recompute; ++i)
+        recompute = needsRecompute(starAt(i));
+
+    if (recompute)
+    {
+        // Proper motion followed by precession, on the packed arrays
+        const double jm    = num->julianMillenia();
+        const double jm2   = jm * jm;
+        const double scale = jm * (M_PI / (180.0 * 3600.0));
+        const Eigen::Matrix3d &P = num->p2();
+        const double p00 = P(0, 0), p01 = P(0, 1), p02 = P(0, 2);
+        const double p10 = P(1, 0), p11 = P(1, 1), p12 = P(1, 2);
+        const double p20 = P(2, 0), p21 = P(2, 1), p22 = P(2, 2);
+
+        const double *X0 = m_X0.constData(), *Y0 = m_Y0.constData(), *Z0 = m_Z0.constData();
+        const double *PMX = m_PMX.constData(), *PMY = m_PMY.constData(), *PMZ = m_PMZ.constData();
+        const double *PMSq = m_PMSq.constData();
+        double *X = m_X.data(), *Y = m_Y.data(), *Z = m_Z.data();
+
+        for (int i = 0; i < count; ++i)
+        {
+            // StarObject::getIndexCoords() ignores negligible proper motions
+            const double s = (PMSq[i] * jm2 < .01) ? 0.0 : scale;
+            const double x = X0[i] + s * PMX[i];
+            const double y = Y0[i] + s * PMY[i];
+            const double z = Z0[i] + s * PMZ[i];
+            // Project back onto the unit sphere, as getIndexCoords() does through atan2
+            const double n = 1.0 / std::sqrt(x * x + y * y + z * z);
+            X[i] = (p00 * x + p01 * y + p02 * z) * n;
+            Y[i] = (p10 * x + p11 * y + p12 * z) * n;
+            Z[i] = (p20 * x + p21 * y + p22 * z) * n;
+        }
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        StarObject &star = starAt(i);
+        if (star.updateID == updateID)
+            continue;
+        if (star.updateNumID != updateNumID)
+        {
+            if (recompute && needsRecompute(star))
+                star.updateCoordsFromVector(m_X[i], m_Y[i], m_Z[i], num);
+            star.updateNumID = updateNumID;
+        }
+        star.EquatorialToHorizontal(data->lst(), data->geo()->lat());
+        star.updateID = updateID;
+    }
+}
@@ -129,6 +129,37 @@ class StarBlock
      */
     inline int getStarCount() const { return nStars; }
 
+    /**
+     * @short  Return the magnitude of the i-th star, read from the packed magnitude array
+     *
+     * @param  i Index of the star in this StarBlock
+     * @return Magnitude of the i-th star
+     */
+    inline float mag(int i) const { return m_Mag[i]; }
+
+    /**
+     * @short  Return the number of stars in this StarBlock that are not fainter than maglim
+     *
+     * Stars in a StarBlock are ordered by magnitude, so this is a binary search on the packed
+     * magnitude array.
+     *
+     * @param  maglim Magnitude limit
+     * @return Number of leading stars with magnitude <= maglim
+     */
+    int countToMag(float maglim) const;
+
+    /**
+     * @short  Just-in-time update of all the stars in this StarBlock down to maglim
+     *
+     * Equivalent to calling StarObject::JITupdate() on every star down to maglim, but the proper
+     * motion and precession are computed for the whole block at once on the packed
+     * structure-of-arrays copy of the catalog positions, which the compiler can vectorize. Only
+     * nutation, aberration and the horizontal coordinates are computed per star.
+     *
+     * @param  maglim Magnitude limit
+     */
+    void JITupdate(float maglim);
+
     /** @short  Reset this StarBlock's data, for reuse of the StarBlock */
     void reset();
 
@@ -144,8 +175,23 @@ class StarBlock
     StarBlock(const StarBlock &);
     StarBlock &operator=(const StarBlock &);
 
+    /** @short Copy the data used by JITupdate() of the star at index i into the packed arrays */
+    void packStar(int i);
+
     /** Number of initialized stars in StarBlock. */
     int nStars { 0 };
     /** Array of stars. */
     QVector<StarBlockEntry> stars;
+
+    // Structure-of-arrays copy of the per-star data read by the draw loop, indexed like stars
+    /** Magnitudes */
+    QVector<float> m_Mag;
+    /** J2000 catalog position as a unit vector */
+    QVector<double> m_X0, m_Y0, m_Z0;
+    /** Proper motion displacement of the unit vector, in radians per Julian millennium */
+    QVector<double> m_PMX, m_PMY, m_PMZ;
+    /** Squared proper motion magnitude, in (milliarcsec/year)^2 */
+    QVector<double> m_PMSq;
+    /** Scratch space for the precessed unit vectors */
+    QVector<double> m_X, m_Y, m_Z;
 };
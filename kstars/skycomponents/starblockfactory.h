@@ -8,6 +8,8 @@
 
 #include "typedef.h"
 
+#include <QMutex>
+
 class StarBlock;
 
 /**
@@ -83,6 +85,14 @@ class StarBlockFactory
      */
     void printStructure() const;
 
+    /**
+     * @short  Mutex guarding the cache and the StarBlockLists that take blocks from it
+     *
+     * Must be held while filling, marking or reading StarBlockLists whenever a background
+     * prefetch may be running (see DeepStarComponent::prefetch()).
+     */
+    inline QMutex &mutex() { return m_Mutex; }
+
     quint32 drawID; // A number identifying the current draw cycle
 
   private:
@@ -103,6 +113,7 @@ class StarBlockFactory
     std::shared_ptr<StarBlock> first, last; // Pointers to the beginning and end of the linked list
     int nBlocks;             // Number of blocks we currently have in the cache
     int nCache;              // Number of blocks to start recycling cached blocks at
+    QMutex m_Mutex;          // Guards the cache, see mutex()
 
     static StarBlockFactory *pInstance;
 };
@@ -18,6 +18,8 @@
 
 #include <QDebug>
 
+#include <cstring>
+
 StarBlockList::StarBlockList(const Trixel &tr, DeepStarComponent *parent)
 {
     trixel       = tr;
@@ -92,7 +94,11 @@ bool StarBlockList::fillToMag(float maglim)
 
     Q_ASSERT(nBlocks == (unsigned int)blocks.size());
 
-    BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
+    // When the catalog is memory-mapped, records are copied straight out of the mapping and
+    // the file position is never touched.
+    const bool mapped = dSReader->isMapped();
+    if (!mapped)
+        BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
 
     /*
     qDebug() << Q_FUNC_INFO << "Reading trixel" << trixel << ", id on disk =" << trixelId << ", currently nStars =" << nStars
@@ -126,7 +132,18 @@ bool StarBlockList::fillToMag(float maglim)
         // TODO: Make this more general
         if (dSReader->guessRecordSize() == 32)
         {
-            ret = fread(&stardata, sizeof(StarData), 1, dataFile);
+            if (mapped)
+            {
+                const uchar *record = dSReader->recordAt(readOffset, sizeof(StarData));
+                if (!record)
+                {
+                    qWarning() << "ERROR: Record at offset" << readOffset << "in trixel" << trixel << "lies beyond the mapped file";
+                    return false;
+                }
+                memcpy(&stardata, record, sizeof(StarData));
+            }
+            else
+                ret = fread(&stardata, sizeof(StarData), 1, dataFile);
             if (dSReader->getByteSwap())
                 DeepStarComponent::byteSwap(&stardata);
             readOffset += sizeof(StarData);
@@ -134,7 +151,18 @@ bool StarBlockList::fillToMag(float maglim)
         }
         else
         {
-            ret = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+            if (mapped)
+            {
+                const uchar *record = dSReader->recordAt(readOffset, sizeof(DeepStarData));
+                if (!record)
+                {
+                    qWarning() << "ERROR: Record at offset" << readOffset << "in trixel" << trixel << "lies beyond the mapped file";
+                    return false;
+                }
+                memcpy(&deepstardata, record, sizeof(DeepStarData));
+            }
+            else
+                ret = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
             if (dSReader->getByteSwap())
                 DeepStarComponent::byteSwap(&deepstardata);
             readOffset += sizeof(DeepStarData);
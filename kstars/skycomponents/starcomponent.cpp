@@ -27,6 +27,9 @@
 #include "kstars_debug.h"
 
 #include <qplatformdefs.h>
+#include <QVarLengthArray>
+
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -312,12 +315,26 @@ void StarComponent::draw(SkyPainter *skyp)
 
     int nTrixels = 0;
 
+    // Nothing but stars is drawn until endPointSourceLayer(), so the painter may defer them
+    skyp->beginPointSourceLayer();
+
+    // The stars of each trixel are drawn as one batch
+    std::vector<StarObject *> batchStars;
+    std::vector<const SkyPoint *> batchPoints;
+    std::vector<float> batchMags;
+    std::vector<char> batchSpectralClasses;
+    QVarLengthArray<bool, 256> batchDrawn;
+
     while (region.hasNext())
     {
         ++nTrixels;
         Trixel currentRegion = region.next();
         StarList *starList   = m_starIndex->at(currentRegion);
 
+        batchStars.clear();
+        batchPoints.clear();
+        batchMags.clear();
+        batchSpectralClasses.clear();
         for (auto &star : *starList)
         {
             if (!star)
@@ -332,11 +349,23 @@ void StarComponent::draw(SkyPainter *skyp)
             if (star->updateID != updateID)
                 star->JITupdate();
 
-            bool drawn = skyp->drawPointSource(star, mag, star->spchar());
+            batchStars.push_back(star);
+            batchPoints.push_back(star);
+            batchMags.push_back(mag);
+            batchSpectralClasses.push_back(star->spchar());
+        }
 
-            //FIXME_SKYPAINTER: find a better way to do this.
-            if (drawn && !(m_hideLabels || mag > labelMagLim))
-                addLabel(proj->toScreen(star), star);
+        batchDrawn.resize(batchPoints.size());
+        skyp->drawPointSources(batchPoints.data(), batchMags.data(), batchSpectralClasses.data(),
+                               batchDrawn.size(), batchDrawn.data());
+
+        //FIXME_SKYPAINTER: find a better way to do this.
+        if (m_hideLabels)
+            continue;
+        for (int i = 0; i < batchDrawn.size(); i++)
+        {
+            if (batchDrawn[i] && batchMags[i] <= labelMagLim)
+                addLabel(proj->toScreen(batchStars[i]), batchStars[i]);
         }
     }
 
@@ -354,6 +383,8 @@ void StarComponent::draw(SkyPainter *skyp)
     {
         component->draw(skyp);
     }
+
+    skyp->endPointSourceLayer();
 #else
     Q_UNUSED(skyp)
 #endif
@@ -641,9 +672,11 @@ StarObject *StarComponent::findByHDIndex(int HDnum)
         if (offset <= 0)
             return nullptr;
         dataFile = m_DeepStarComponents.at(1)->getStarReader()->getFileHandle();
-        //KDE_fseek( dataFile, offset, SEEK_SET );
-        QT_FSEEK(dataFile, offset, SEEK_SET);
         {
+            // The file position is shared with a background star prefetch
+            QMutexLocker cacheLocker(&StarBlockFactory::Instance()->mutex());
+            //KDE_fseek( dataFile, offset, SEEK_SET );
+            QT_FSEEK(dataFile, offset, SEEK_SET);
             int rc = fread(&stardata, sizeof(StarData), 1, dataFile);
             Q_UNUSED(rc)
         }
@@ -15,13 +15,13 @@
 
 SkyMapQDraw::SkyMapQDraw(SkyMap *sm) : QWidget(sm), SkyMapDrawAbstract(sm)
 {
-    m_SkyPixmap = new QPixmap(width(), height());
-    m_SkyPainter.reset(new SkyQPainter(this, m_SkyPixmap));
+    m_SkyImage = new QImage(width(), height(), QImage::Format_ARGB32_Premultiplied);
+    m_SkyPainter.reset(new SkyQPainter(this, m_SkyImage));
 }
 
 SkyMapQDraw::~SkyMapQDraw()
 {
-    delete m_SkyPixmap;
+    delete m_SkyImage;
 }
 
 void SkyMapQDraw::paintEvent(QPaintEvent *event)
@@ -38,7 +38,7 @@ void SkyMapQDraw::paintEvent(QPaintEvent *event)
     // JM 2016-05-03: Not needed since we're not using OpenGL for now
     //calculateFPS();
 
-    //If computeSkymap is false, then we just refresh the window using the stored sky pixmap
+    //If computeSkymap is false, then we just refresh the window using the stored sky image
     //and draw the "overlays" on top.  This lets us update the overlay information rapidly
     //without needing to recompute the entire skymap.
     //use update() to trigger this "short" paint event; to force a full "recompute"
@@ -49,20 +49,20 @@ void SkyMapQDraw::paintEvent(QPaintEvent *event)
         QPainter p;
         p.begin(this);
         p.drawLine(0, 0, 1, 1); // Dummy operation to circumvent bug. TODO: Add details
-        p.drawPixmap(0, 0, *m_SkyPixmap);
+        p.drawImage(0, 0, *m_SkyImage);
         drawOverlays(p);
         p.end();
 
         setDrawLock(false);
-        return; // exit because the pixmap is repainted and that's all what we want
+        return; // exit because the image is repainted and that's all what we want
     }
 
     m_SkyMap->updateInfoBoxes();
     m_SkyMap->setupProjector();
 
-    m_SkyPixmap->fill(Qt::black);
-    m_SkyPainter->setPaintDevice(m_SkyPixmap);
-    m_SkyPainter->setSize(m_SkyPixmap->width(), m_SkyPixmap->height());
+    m_SkyImage->fill(Qt::black);
+    m_SkyPainter->setPaintDevice(m_SkyImage);
+    m_SkyPainter->setSize(m_SkyImage->width(), m_SkyImage->height());
 
     //FIXME: we may want to move this into the components.
     m_SkyPainter->begin();
@@ -84,16 +84,16 @@ void SkyMapQDraw::paintEvent(QPaintEvent *event)
     QPainter psky2;
     psky2.begin(this);
     psky2.drawLine(0, 0, 1, 1); // Dummy op.
-    psky2.drawPixmap(0, 0, *m_SkyPixmap);
+    psky2.drawImage(0, 0, *m_SkyImage);
     drawOverlays(psky2);
     psky2.end();
 
     if (m_SkyMap->m_previewLegend)
     {
-        m_SkyMap->m_legend.paintLegend(m_SkyPixmap);
+        m_SkyMap->m_legend.paintLegend(m_SkyImage);
     }
 
-    m_SkyMap->computeSkymap = false; // use forceUpdate() to compute new skymap else old pixmap will be shown
+    m_SkyMap->computeSkymap = false; // use forceUpdate() to compute new skymap else old image will be shown
 
     setDrawLock(false);
 }
@@ -101,6 +101,6 @@ void SkyMapQDraw::paintEvent(QPaintEvent *event)
 void SkyMapQDraw::resizeEvent(QResizeEvent *e)
 {
     Q_UNUSED(e)
-    delete m_SkyPixmap;
-    m_SkyPixmap = new QPixmap(width(), height());
+    delete m_SkyImage;
+    m_SkyImage = new QImage(width(), height(), QImage::Format_ARGB32_Premultiplied);
 }
@@ -38,7 +38,8 @@ class SkyMapQDraw : public QWidget, public SkyMapDrawAbstract
 
     void resizeEvent(QResizeEvent *e) override;
 
-    QPixmap *m_SkyPixmap;
+    // A QImage rather than a QPixmap, so that stars can be copied straight into it.
+    QImage *m_SkyImage;
 
     QScopedPointer<SkyQPainter> m_SkyPainter;
 };
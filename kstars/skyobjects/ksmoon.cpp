@@ -7,6 +7,8 @@
 #include "ksmoon.h"
 
 #include "ksnumbers.h"
+#include "Options.h"
+#include "auxiliary/chebyshevephemeris.h"
 #include "ksutils.h"
 #include "kssun.h"
 #include "kstarsdata.h"
@@ -18,6 +20,7 @@
 #include "texturemanager.h"
 
 #include <QFile>
+#include <QMutex>
 #include <QTextStream>
 
 #include <cstdlib>
@@ -26,6 +29,7 @@
 #include <float.h>
 #endif
 
+#include <memory>
 #include <typeinfo>
 
 // Qt version calming
@@ -150,18 +154,15 @@ bool KSMoon::loadData()
     return true;
 }
 
-bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
+void KSMoon::calcEclipticMeeus(double T, EclipticPosition &ep)
 {
     //Algorithms in this subroutine are taken from Chapter 45 of "Astronomical Algorithms"
     //by Jean Meeus (1991, Willmann-Bell, Inc. ISBN 0-943396-35-2.  https://www.willbell.com/math/mc1.htm)
     //updated to Jean Messus (1998, Willmann-Bell, http://www.naughter.com/aa.html )
 
-    double T, L, D, M, M1, F, A1, A2, A3;
+    double L, D, M, M1, F, A1, A2, A3;
     double sumL, sumR, sumB;
 
-    //Julian centuries since J2000
-    T = num->julianCenturies();
-
     double Et = 1.0 - 0.002516 * T - 0.0000074 * T * T;
 
     //Moon's mean longitude
@@ -188,9 +189,6 @@ bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
     sumL = 0.0;
     sumR = 0.0;
 
-    if (!loadData())
-        return false;
-
     for (const auto &mlrd : LRData)
     {
         double E = 1.0;
@@ -225,9 +223,70 @@ bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
              115.0 * sin(L + M1));
 
     //Geocentric coordinates
-    setEcLong(dms(sumL / 1000000.0 + L * 180.0 / dms::PI)); //convert radians to degrees
-    setEcLat(dms(sumB / 1000000.0));
-    Rearth = (385000.56 + sumR / 1000.0) / AU_KM; //distance from Earth, in AU
+    ep.longitude = dms(sumL / 1000000.0 + L * 180.0 / dms::PI); //convert radians to degrees
+    ep.latitude  = dms(sumB / 1000000.0);
+    ep.radius    = (385000.56 + sumR / 1000.0) / AU_KM; //distance from Earth, in AU
+}
+
+ChebyshevEphemeris *KSMoon::ephemeris()
+{
+    static std::unique_ptr<ChebyshevEphemeris> moonEphemeris;
+    static QMutex mutex;
+
+    QMutexLocker locker(&mutex);
+    if (!moonEphemeris)
+    {
+        // Fitted in geocentric ecliptic Cartesian coordinates, in Julian centuries. Degree 13 over
+        // 4-day segments stays far below the 10 arcsecond accuracy of the series itself.
+        auto reference = [](double T, double xyz[3])
+        {
+            EclipticPosition ep;
+            calcEclipticMeeus(T, ep);
+            double sinL, cosL, sinB, cosB;
+            ep.longitude.SinCos(sinL, cosL);
+            ep.latitude.SinCos(sinB, cosB);
+            xyz[0] = ep.radius * cosB * cosL;
+            xyz[1] = ep.radius * cosB * sinL;
+            xyz[2] = ep.radius * sinB;
+        };
+        moonEphemeris.reset(new ChebyshevEphemeris("moon", 4.0 / 36525.0, 13, LRData.size() * 1000 + BData.size(),
+                            reference));
+    }
+    return moonEphemeris.get();
+}
+
+bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
+{
+    //Julian centuries since J2000
+    const double T = num->julianCenturies();
+
+    if (!loadData())
+        return false;
+
+    EclipticPosition moonPos;
+    if (Options::useChebyshevEphemeris())
+    {
+        double xyz[3];
+        ephemeris()->evaluate(T, xyz);
+        const double rho = sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1]);
+
+        // The series does not reduce the longitude. Keep the same turn as the Moon's mean
+        // longitude, so that downstream users see the same values as with the series.
+        const double L = 218.3164477 + 481267.88123421 * T;
+        double lon     = atan2(xyz[1], xyz[0]) * 180.0 / dms::PI;
+        lon += 360.0 * std::round((L - lon) / 360.0);
+
+        moonPos.longitude = dms(lon);
+        moonPos.latitude.setRadians(atan2(xyz[2], rho));
+        moonPos.radius = sqrt(rho * rho + xyz[2] * xyz[2]);
+    }
+    else
+        calcEclipticMeeus(T, moonPos);
+
+    //Geocentric coordinates
+    setEcLong(moonPos.longitude);
+    setEcLat(moonPos.latitude);
+    Rearth = moonPos.radius; //distance from Earth, in AU
 
     EclipticToEquatorial(num->obliquity());
 
@@ -9,6 +9,7 @@
 #include "ksplanetbase.h"
 #include "dms.h"
 
+class ChebyshevEphemeris;
 class KSSun;
 
 /**
@@ -72,6 +73,15 @@ class KSMoon : public KSPlanetBase
      */
     bool findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *) override;
 
+    /**
+     * Sum the lunar series for the given date. This is the reference path: findGeocentricPosition()
+     * evaluates a Chebyshev approximation of it instead, unless Options::useChebyshevEphemeris()
+     * is disabled. loadData() must have succeeded before calling this.
+     * @param T Julian centuries since J2000
+     * @param ep Geocentric ecliptic longitude, latitude and distance (in AU) of the Moon
+     */
+    static void calcEclipticMeeus(double T, EclipticPosition &ep);
+
     /**
      * @brief updateMag calls findMagnitude() to calculate current magnitude of moon
      * according to current phase. This function is required to perform findMagnitude()
@@ -84,6 +94,9 @@ class KSMoon : public KSPlanetBase
   private:
     void findMagnitude(const KSNumbers *) override;
 
+    /** @return the Chebyshev approximation of calcEclipticMeeus(), created on first use */
+    static ChebyshevEphemeris *ephemeris();
+
     static bool data_loaded;
     static int instance_count;
 
@@ -9,6 +9,8 @@
 #include "ksnumbers.h"
 #include "ksutils.h"
 #include "ksfilereader.h"
+#include "Options.h"
+#include "auxiliary/chebyshevephemeris.h"
 
 #include <cmath>
 #include <typeinfo>
@@ -111,6 +113,45 @@ bool KSPlanet::OrbitDataManager::loadData(KSPlanet::OrbitDataColl &odc, const QS
     return true;
 }
 
+ChebyshevEphemeris *KSPlanet::OrbitDataManager::ephemeris(const QString &n)
+{
+    QString nl = n.toLower();
+
+    auto it = ephemerides.constFind(nl);
+    if (it != ephemerides.constEnd())
+        return it.value().get();
+
+    OrbitDataColl odc;
+    if (!loadData(odc, nl))
+        return nullptr;
+
+    // Identify the VSOP data the fits were made from by its number of terms
+    quint32 terms = 0;
+    for (int i = 0; i < 6; ++i)
+        terms += odc.Lon[i].size() + odc.Lat[i].size() + odc.Dst[i].size();
+
+    // Segments are in Julian millennia. Degree 13 over these spans keeps the fit well below
+    // a milliarcsecond of the VSOP87 series; Mercury needs shorter segments for its short period.
+    const double segmentDays = (nl == "mercury") ? 8.0 : 32.0;
+
+    auto reference = [odc](double jm, double xyz[3])
+    {
+        EclipticPosition ep;
+        sumVSOP(odc, jm, ep);
+        double sinL, cosL, sinB, cosB;
+        ep.longitude.SinCos(sinL, cosL);
+        ep.latitude.SinCos(sinB, cosB);
+        xyz[0] = ep.radius * cosB * cosL;
+        xyz[1] = ep.radius * cosB * sinL;
+        xyz[2] = ep.radius * sinB;
+    };
+
+    std::shared_ptr<ChebyshevEphemeris> ephemeris(new ChebyshevEphemeris(nl, segmentDays / 365250.0, 13, terms,
+            reference));
+    ephemerides.insert(nl, ephemeris);
+    return ephemeris.get();
+}
+
 KSPlanet::KSPlanet(const QString &s, const QString &imfile, const QColor &c, double pSize)
     : KSPlanetBase(s, imfile, c, pSize)
 {
@@ -191,16 +232,29 @@ bool KSPlanet::loadData()
 
 void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
 {
-    double sum[6];
-    OrbitDataColl odc;
-    double Tpow[6];
-
-    Tpow[0] = 1.0;
-    for (int i = 1; i < 6; ++i)
+    if (Options::useChebyshevEphemeris())
     {
-        Tpow[i] = Tpow[i - 1] * Tau;
+        ChebyshevEphemeris *ephemeris = odm.ephemeris(untranslatedName());
+        if (ephemeris)
+        {
+            double xyz[3];
+            ephemeris->evaluate(Tau, xyz);
+            const double rho = sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1]);
+            epret.longitude.setRadians(atan2(xyz[1], xyz[0]));
+            epret.longitude.setD(epret.longitude.reduce().Degrees());
+            epret.latitude.setRadians(atan2(xyz[2], rho));
+            epret.radius = sqrt(rho * rho + xyz[2] * xyz[2]);
+            return;
+        }
     }
 
+    calcEclipticVSOP(Tau, epret);
+}
+
+void KSPlanet::calcEclipticVSOP(double Tau, EclipticPosition &epret) const
+{
+    OrbitDataColl odc;
+
     if (!odm.loadData(odc, untranslatedName()))
     {
         epret.longitude = dms(0.0);
@@ -210,6 +264,20 @@ void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
         return;
     }
 
+    sumVSOP(odc, Tau, epret);
+}
+
+void KSPlanet::sumVSOP(const OrbitDataColl &odc, double Tau, EclipticPosition &epret)
+{
+    double sum[6];
+    double Tpow[6];
+
+    Tpow[0] = 1.0;
+    for (int i = 1; i < 6; ++i)
+    {
+        Tpow[i] = Tpow[i - 1] * Tau;
+    }
+
     //Ecliptic Longitude
     for (int i = 0; i < 6; ++i)
     {
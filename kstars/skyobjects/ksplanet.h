@@ -12,6 +12,9 @@
 #include <QString>
 #include <QVector>
 
+#include <memory>
+
+class ChebyshevEphemeris;
 class KSNumbers;
 
 /**
@@ -73,6 +76,15 @@ class KSPlanet : public KSPlanetBase
      */
     virtual void calcEcliptic(double jm, EclipticPosition &ret) const;
 
+    /**
+     * Calculate the ecliptic longitude and latitude of the planet by summing the full VSOP87
+     * series. This is the reference path: calcEcliptic() evaluates a Chebyshev approximation
+     * of it instead, unless Options::useChebyshevEphemeris() is disabled.
+     * @param jm Julian Millenia (=jd/1000)
+     * @param ret The ecliptic coordinates are returned by reference through this argument.
+     */
+    void calcEclipticVSOP(double jm, EclipticPosition &ret) const;
+
   protected:
     /**
      * Calculate the geocentric RA, Dec coordinates of the Planet.
@@ -153,6 +165,14 @@ class KSPlanet : public KSPlanetBase
          */
         bool loadData(OrbitDataColl &odc, const QString &n);
 
+        /**
+         * Return the Chebyshev approximation of the VSOP87 series of a planet, creating it
+         * the first time it is requested.
+         * @param n the name of the planet.
+         * @return the approximation, or nullptr if the orbital data of the planet could not be loaded.
+         */
+        ChebyshevEphemeris *ephemeris(const QString &n);
+
       private:
         /**
          * Read a single orbital data file from disk into an OrbitData vector.
@@ -164,8 +184,17 @@ class KSPlanet : public KSPlanetBase
         bool readOrbitData(const QString &fname, QVector<KSPlanet::OrbitData> *vector);
 
         QHash<QString, OrbitDataColl> hash;
+        QHash<QString, std::shared_ptr<ChebyshevEphemeris>> ephemerides;
     };
 
+    /**
+     * Sum the VSOP87 series for the given date.
+     * @param odc the orbital data of the planet.
+     * @param jm Julian Millenia (=jd/1000)
+     * @param ret The ecliptic coordinates are returned by reference through this argument.
+     */
+    static void sumVSOP(const OrbitDataColl &odc, double jm, EclipticPosition &ret);
+
   private:
     void findMagnitude(const KSNumbers *) override;
 
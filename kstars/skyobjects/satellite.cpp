@@ -702,30 +702,95 @@ void Satellite::init()
     }
 }
 
-int Satellite::updatePos()
+Satellite::PropagationContext Satellite::propagationContext()
 {
     KStarsData *data = KStarsData::Instance();
-    return sgp4((data->clock()->utc().djd() - m_tle_jd) * MINPD);
+    PropagationContext context;
+
+    context.jd               = data->clock()->utc().djd();
+    context.lst              = data->lst();
+    context.lat              = data->geo()->lat();
+    // Objects below the horizon are hidden by the ground
+    context.skipBelowHorizon = Options::showGround();
+
+    // Observer ECI position
+    double thetageo, c, sq, achcp;
+
+    context.sinlat   = sin(data->geo()->lat()->radians());
+    context.coslat   = cos(data->geo()->lat()->radians());
+    context.longitude = data->geo()->lng()->Degrees();
+    thetageo         = data->geo()->LMST(context.jd);
+    context.sintheta = sin(thetageo);
+    context.costheta = cos(thetageo);
+    c                = 1.0 / sqrt(1.0 + F * (F - 2.0) * context.sinlat * context.sinlat);
+    sq               = (1.0 - F) * (1.0 - F) * c;
+    achcp            = (RADIUSEARTHKM * c + MEANALT) * context.coslat;
+    context.obs_posx = achcp * context.costheta;
+    context.obs_posy = achcp * context.sintheta;
+    context.obs_posz = (RADIUSEARTHKM * sq + MEANALT) * context.sinlat;
+    context.obs_posw = sqrt(context.obs_posx * context.obs_posx + context.obs_posy * context.obs_posy +
+                            context.obs_posz * context.obs_posz);
+
+    // Find ECI coordinates of the sun
+    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
+
+    mjd  = context.jd - 2415020.0;
+    year = 1900.0 + mjd / 365.25;
+    T    = (mjd + deltaET(year) / (MINPD * 60.0)) / 36525.0;
+    M    = DEG2RAD * (Modulus(358.47583 + Modulus(35999.04975 * T, 360.0) - (0.000150 + 0.0000033 * T) * T * T, 360.0));
+    L    = DEG2RAD * (Modulus(279.69668 + Modulus(36000.76892 * T, 360.0) + 0.0003025 * T * T, 360.0));
+    e    = 0.01675104 - (0.0000418 + 0.000000126 * T) * T;
+    C    = DEG2RAD * ((1.919460 - (0.004789 + 0.000014 * T) * T) * sin(M) + (0.020094 - 0.000100 * T) * sin(2 * M) +
+                      0.000293 * sin(3 * M));
+    O    = DEG2RAD * (Modulus(259.18 - 1934.142 * T, 360.0));
+    Lsa  = Modulus(L + C - DEG2RAD * (0.00569 - 0.00479 * sin(O)), TWOPI);
+    nu   = Modulus(M + C, TWOPI);
+    R    = 1.0000002 * (1.0 - e * e) / (1.0 + e * cos(nu));
+    eps  = DEG2RAD * (23.452294 - (0.0130125 + (0.00000164 - 0.000000503 * T) * T) * T + 0.00256 * cos(O));
+    R    = AU * R;
+
+    context.sun_posx = R * cos(Lsa);
+    context.sun_posy = R * sin(Lsa) * cos(eps);
+    context.sun_posz = R * sin(Lsa) * sin(eps);
+    context.sun_posw = R;
+
+    KSSun *sun = dynamic_cast<KSSun *>(data->skyComposite()->findByName(i18n("Sun")));
+    context.sunBelowTwilight = sun != nullptr && sun->alt().Degrees() <= -12.0;
+
+    return context;
 }
 
-int Satellite::sgp4(double tsince)
+int Satellite::updatePos()
 {
-    KStarsData *data = KStarsData::Instance();
+    return updatePos(propagationContext());
+}
 
+int Satellite::updatePos(const PropagationContext &context)
+{
+    // Still too far below the horizon to be seen since the last propagation, from the same location
+    if (context.skipBelowHorizon && context.jd >= m_last_update_jd && context.jd < m_next_update_jd &&
+            context.sinlat == m_next_update_sinlat && context.longitude == m_next_update_longitude)
+        return 0;
+
+    m_last_update_jd = context.jd;
+    m_next_update_jd = 0;
+
+    return sgp4((context.jd - m_tle_jd) * MINPD, context);
+}
+
+int Satellite::sgp4(double tsince, const PropagationContext &context)
+{
     int ktr;
     double am, axnl, aynl, betal, cosim, cnod, cos2u, coseo1 = 0, cosi, cosip, cosisq, cossu, cosu, delm, delomg, em,
                                                       ecose, el2, eo1, ep, esine, argpm, argpp, argpdf, pl,
                                                       mrt = 0.0, mvt, rdotl, rl, rvdot, rvdotl, sinim, dndt, sin2u, sineo1 = 0, sini, sinip, sinsu, sinu, snod, su, t2,
                                                       t3, t4, tem5, temp, temp1, temp2, tempa, tempe, templ, u, ux, uy, uz, vx, vy, vz, inclm, mm, nm, nodem, xinc,
                                                       xincp, xl, xlm, mp, xmdf, xmx, xmy, nodedf, xnode, nodep, tc, sat_posx, sat_posy, sat_posz, sat_posw, sat_velx,
-                                                      sat_vely, sat_velz, sinlat, obs_posx, obs_posy, obs_posz, obs_posw, /*obs_velx, obs_vely, obs_velz,*/
-                                                      coslat, thetageo, sintheta, costheta, c, sq, achcp, vkmpersec;
+                                                      sat_vely, sat_velz, vkmpersec;
     //    double emsq;
 
     const double temp4 = 1.5e-12;
 
-    double jul_utc = data->clock()->utc().djd();
-
     vkmpersec = RADIUSEARTHKM * XKE / 60.0;
 
     // Update for secular gravity and atmospheric drag
@@ -1134,29 +1199,17 @@ int Satellite::sgp4(double tsince)
         return (6);
     }
 
-    // Observer ECI position and velocity
-    sinlat   = sin(data->geo()->lat()->radians());
-    coslat   = cos(data->geo()->lat()->radians());
-    thetageo = data->geo()->LMST(jul_utc);
-    sintheta = sin(thetageo);
-    costheta = cos(thetageo);
-    c        = 1.0 / sqrt(1.0 + F * (F - 2.0) * sinlat * sinlat);
-    sq       = (1.0 - F) * (1.0 - F) * c;
-    achcp    = (RADIUSEARTHKM * c + MEANALT) * coslat;
-    obs_posx = achcp * costheta;
-    obs_posy = achcp * sintheta;
-    obs_posz = (RADIUSEARTHKM * sq + MEANALT) * sinlat;
-    obs_posw = sqrt(obs_posx * obs_posx + obs_posy * sat_posy + obs_posz * obs_posz);
-    /*obs_velx = -MFACTOR * obs_posy;
-    obs_vely = MFACTOR * obs_posx;
-    obs_velz = 0.;*/
-
-    m_altitude = sat_posw - obs_posw + MEANALT;
+    const double sinlat   = context.sinlat;
+    const double coslat   = context.coslat;
+    const double sintheta = context.sintheta;
+    const double costheta = context.costheta;
+
+    m_altitude = sat_posw - context.obs_posw + MEANALT;
 
     // Az and Dec
-    double range_posx = sat_posx - obs_posx;
-    double range_posy = sat_posy - obs_posy;
-    double range_posz = sat_posz - obs_posz;
+    double range_posx = sat_posx - context.obs_posx;
+    double range_posy = sat_posy - context.obs_posy;
+    double range_posz = sat_posz - context.obs_posz;
     m_range           = sqrt(range_posx * range_posx + range_posy * range_posy + range_posz * range_posz);
     //     double range_velx = sat_velx - obs_velx;
     //     double range_vely = sat_velx - obs_vely;
@@ -1178,52 +1231,50 @@ int Satellite::sgp4(double tsince)
 
     setAz(azimuth / DEG2RAD);
     setAlt(elevation / DEG2RAD);
-    HorizontalToEquatorial(data->lst(), data->geo()->lat());
-
-    // is the satellite visible ?
-    // Find ECI coordinates of the sun
-    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
-
-    mjd  = jul_utc - 2415020.0;
-    year = 1900.0 + mjd / 365.25;
-    T    = (mjd + deltaET(year) / (MINPD * 60.0)) / 36525.0;
-    M    = DEG2RAD * (Modulus(358.47583 + Modulus(35999.04975 * T, 360.0) - (0.000150 + 0.0000033 * T) * T * T, 360.0));
-    L    = DEG2RAD * (Modulus(279.69668 + Modulus(36000.76892 * T, 360.0) + 0.0003025 * T * T, 360.0));
-    e    = 0.01675104 - (0.0000418 + 0.000000126 * T) * T;
-    C    = DEG2RAD * ((1.919460 - (0.004789 + 0.000014 * T) * T) * sin(M) + (0.020094 - 0.000100 * T) * sin(2 * M) +
-                      0.000293 * sin(3 * M));
-    O    = DEG2RAD * (Modulus(259.18 - 1934.142 * T, 360.0));
-    Lsa  = Modulus(L + C - DEG2RAD * (0.00569 - 0.00479 * sin(O)), TWOPI);
-    nu   = Modulus(M + C, TWOPI);
-    R    = 1.0000002 * (1.0 - e * e) / (1.0 + e * cos(nu));
-    eps  = DEG2RAD * (23.452294 - (0.0130125 + (0.00000164 - 0.000000503 * T) * T) * T + 0.00256 * cos(O));
-    R    = AU * R;
+    HorizontalToEquatorial(context.lst, context.lat);
 
-    double sun_posx = R * cos(Lsa);
-    double sun_posy = R * sin(Lsa) * cos(eps);
-    double sun_posz = R * sin(Lsa) * sin(eps);
-    double sun_posw = R;
+    if (elevation < 0.0)
+    {
+        // The satellite cannot be seen before the geocentric angle between the satellite and the
+        // observer shrinks to the radius of the area of the Earth that sees the satellite at its apogee.
+        // Bound how soon that may happen with the fastest angular motion of the orbit plus the rotation
+        // of the Earth, and wait for half that time.
+        double cos_psi = (context.obs_posx * sat_posx + context.obs_posy * sat_posy + context.obs_posz * sat_posz) /
+                         (context.obs_posw * sat_posw);
+        double psi     = acos(qBound(-1.0, cos_psi, 1.0));
+        double apogee  = am * (1.0 + ep);
+        double horizon = apogee > 1.0 ? acos(1.0 / apogee) : 0.0;
+        double rate    = nm * (1.0 + ep) * (1.0 + ep) / pow(1.0 - ep * ep, 1.5) + MFACTOR * 60.0;
+
+        if (psi > horizon)
+        {
+            m_next_update_jd        = context.jd + 0.5 * (psi - horizon) / rate / MINPD;
+            m_next_update_sinlat    = context.sinlat;
+            m_next_update_longitude = context.longitude;
+        }
+    }
 
+    // is the satellite visible ?
     // Calculates satellite's eclipse status and depth
     double sd_sun, sd_earth, delta, depth;
 
     // Determine partial eclipse
     sd_earth       = arcSin(RADIUSEARTHKM / sat_posw);
-    double rho_x   = sun_posx - sat_posx;
-    double rho_y   = sun_posy - sat_posy;
-    double rho_z   = sun_posz - sat_posz;
+    double rho_x   = context.sun_posx - sat_posx;
+    double rho_y   = context.sun_posy - sat_posy;
+    double rho_z   = context.sun_posz - sat_posz;
     double rho_w   = sqrt(rho_x * rho_x + rho_y * rho_y + rho_z * rho_z);
     sd_sun         = arcSin(SR / rho_w);
     double earth_x = -1.0 * sat_posx;
     double earth_y = -1.0 * sat_posy;
     double earth_z = -1.0 * sat_posz;
     double earth_w = sat_posw;
-    delta      = PIO2 - arcSin((sun_posx * earth_x + sun_posy * earth_y + sun_posz * earth_z) / (sun_posw * earth_w));
-    depth      = sd_earth - sd_sun - delta;
-    KSSun *sun = dynamic_cast<KSSun *>(data->skyComposite()->findByName(i18n("Sun")));
+    delta = PIO2 - arcSin((context.sun_posx * earth_x + context.sun_posy * earth_y + context.sun_posz * earth_z) /
+                          (context.sun_posw * earth_w));
+    depth = sd_earth - sd_sun - delta;
 
     m_is_eclipsed = sd_earth >= sd_sun && depth >= 0;
-    m_is_visible  = !m_is_eclipsed && sun->alt().Degrees() <= -12.0 && elevation >= 0.0;
+    m_is_visible  = !m_is_eclipsed && context.sunBelowTwilight && elevation >= 0.0;
 
     return (0);
 }
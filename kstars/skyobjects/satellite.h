@@ -10,6 +10,7 @@
 
 #include <QString>
 
+class dms;
 class KSPopupMenu;
 
 /**
@@ -22,6 +23,37 @@ class KSPopupMenu;
 class Satellite : public SkyObject
 {
     public:
+        /**
+         * @struct Satellite::PropagationContext
+         * @short Observer and Sun state shared by all the satellites at a given instant
+         *
+         * Computing this once per clock tick, rather than once per satellite, leaves only the
+         * orbit of each satellite to propagate, which makes a batch of satellites cheap to update
+         * and safe to update in parallel.
+         */
+        struct PropagationContext
+        {
+            /// UTC Julian day
+            double jd { 0 };
+            /// Observer geodetic latitude and local mean sidereal time
+            double sinlat { 0 }, coslat { 0 }, sintheta { 0 }, costheta { 0 };
+            /// Observer longitude in degrees, east positive
+            double longitude { 0 };
+            /// Observer ECI position (km)
+            double obs_posx { 0 }, obs_posy { 0 }, obs_posz { 0 }, obs_posw { 0 };
+            /// Sun ECI position (km)
+            double sun_posx { 0 }, sun_posy { 0 }, sun_posz { 0 }, sun_posw { 0 };
+            /// True if the Sun is at least 12° under the horizon
+            bool sunBelowTwilight { false };
+            /// True if satellites far below the horizon may skip updates, because they cannot be seen
+            bool skipBelowHorizon { false };
+            const dms *lst { nullptr };
+            const dms *lat { nullptr };
+        };
+
+        /** @return the propagation context for the current simulation time and location */
+        static PropagationContext propagationContext();
+
         /** @short Constructor */
         Satellite(const QString &name, const QString &line1, const QString &line2);
 
@@ -37,6 +69,16 @@ class Satellite : public SkyObject
         /** @short Update satellite position */
         int updatePos();
 
+        /**
+         * @short Update satellite position using a precomputed context
+         *
+         * If the context allows it, a satellite found far below the horizon is not propagated
+         * again until it may have come close to the horizon. This function only modifies this
+         * satellite, so that distinct satellites may be updated concurrently.
+         * @return 0 on success, or an sgp4() error code
+         */
+        int updatePos(const PropagationContext &context);
+
         /**
          * @return True if the satellite is visible (above horizon, in the sunlight and sun at least 12° under horizon)
          */
@@ -77,10 +119,10 @@ class Satellite : public SkyObject
         void init();
 
         /** @short Compute satellite position */
-        int sgp4(double tsince);
+        int sgp4(double tsince, const PropagationContext &context);
 
         /** @return Arcsine of the argument */
-        double arcSin(double arg);
+        static double arcSin(double arg);
 
         /**
          * Provides the difference between UT (approximately the same as UTC)
@@ -88,10 +130,10 @@ class Satellite : public SkyObject
          * This function is based on a least squares fit of data from 1950
          * to 1991 and will need to be updated periodically.
          */
-        double deltaET(double year);
+        static double deltaET(double year);
 
         /** @return arg1 mod arg2 */
-        double Modulus(double arg1, double arg2);
+        static double Modulus(double arg1, double arg2);
 
         // TLE
         /// Satellite Number
@@ -146,6 +188,13 @@ class Satellite : public SkyObject
         double m_altitude { 0 };
         /// Satellite range from observer in km
         double m_range { 0 };
+        /// Julian day of the last propagation
+        double m_last_update_jd { 0 };
+        /// Julian day before which the satellite cannot rise above the horizon
+        double m_next_update_jd { 0 };
+        /// Observer location for which m_next_update_jd holds
+        double m_next_update_sinlat { 0 };
+        double m_next_update_longitude { 0 };
 
         // Near Earth
         bool isimp { false };
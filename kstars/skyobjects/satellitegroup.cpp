@@ -51,6 +51,7 @@ void SatelliteGroup::readTLE()
 
 void SatelliteGroup::updateSatellitesPos()
 {
+    const Satellite::PropagationContext context = Satellite::propagationContext();
     QMutableListIterator<Satellite *> sats(*this);
 
     while (sats.hasNext())
@@ -59,7 +60,7 @@ void SatelliteGroup::updateSatellitesPos()
 
         if (sat->selected())
         {
-            int rc = sat->updatePos();
+            int rc = sat->updatePos(context);
             // If position cannot be calculated, remove it from list
             if (rc != 0)
                 sats.remove();
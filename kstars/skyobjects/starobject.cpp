@@ -287,6 +287,21 @@ void StarObject::updateCoords(const KSNumbers *num, bool, const CachingDms *, co
 #endif
 }
 
+void StarObject::updateCoordsFromVector(double x, double y, double z, const KSNumbers *num)
+{
+    // Same as SkyPoint::precess() followed by the rest of SkyPoint::updateCoords()
+    CachingDms newRA, newDec;
+    newRA.setUsing_atan2(y, x);
+    newRA.reduceToRange(dms::ZERO_TO_2PI);
+    newDec.setUsing_asin(z);
+
+    setRA(newRA);
+    setDec(newDec);
+    nutate(num);
+    aberrate(num);
+    lastPrecessJD = num->getJD();
+}
+
 bool StarObject::getIndexCoords(const double julianMillenia, CachingDms &ra, CachingDms &dec) const
 {
     static double pmms;
@@ -195,6 +195,18 @@ class StarObject : public SkyObject
     /** @short added for JIT updates from both StarComponent and ConstellationLines */
     void JITupdate();
 
+    /**
+     * @short Finish a coordinate update whose proper motion and precession were computed in bulk
+     *
+     * StarBlock::JITupdate() computes the proper-motion corrected, precessed unit vectors of a
+     * whole block of stars at once. This sets the current coordinates from such a vector and
+     * applies nutation and aberration, i.e. the remainder of updateCoords().
+     *
+     * @param x, y, z Precessed unit vector of the star, in the equatorial frame of date
+     * @param num pointer to KSNumbers object containing current values of time-dependent variables.
+     */
+    void updateCoordsFromVector(double x, double y, double z, const KSNumbers *num);
+
     /** @short returns the magnitude of the proper motion correction in milliarcsec/year */
     inline double pmMagnitude() const
     {
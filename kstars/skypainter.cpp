@@ -27,6 +27,29 @@ void SkyPainter::setSizeMagLimit(float sizeMagLim)
     m_sizeMagLim = sizeMagLim;
 }
 
+int SkyPainter::drawPointSources(const SkyPoint *const *locs, const float *mags, const char *sps,
+                                 int count, bool *drawn)
+{
+    int drawnCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const bool ok = drawPointSource(locs[i], mags[i], sps[i]);
+        if (drawn)
+            drawn[i] = ok;
+        if (ok)
+            drawnCount++;
+    }
+    return drawnCount;
+}
+
+void SkyPainter::beginPointSourceLayer()
+{
+}
+
+void SkyPainter::endPointSourceLayer()
+{
+}
+
 float SkyPainter::starWidth(float mag) const
 {
     //adjust maglimit for ZoomLevel
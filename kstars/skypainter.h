@@ -128,6 +128,34 @@ class SkyPainter
          */
         virtual bool drawPointSource(const SkyPoint *loc, float mag, char sp = 'A') = 0;
 
+        /**
+         * @short Draw a batch of point sources (e.g., stars).
+         * This draws the same as calling drawPointSource() for each source in order,
+         * but lets the backend project and draw the whole batch at once.
+         * @param locs the locations of the sources in the sky
+         * @param mags the magnitudes of the sources
+         * @param sps the spectral classes of the sources
+         * @param count the number of sources
+         * @param drawn if not null, drawn[i] is set to whether source i was drawn
+         * @return the number of sources drawn
+         */
+        virtual int drawPointSources(const SkyPoint *const *locs, const float *mags, const char *sps,
+                                     int count, bool *drawn = nullptr);
+
+        /**
+         * @short Start a layer of point sources.
+         * Until endPointSourceLayer() is called, the backend may keep the point sources in a
+         * list and draw them all at once at the end, so nothing but point sources may be
+         * drawn in between. Their order is kept.
+         */
+        virtual void beginPointSourceLayer();
+
+        /**
+         * @short Finish a layer of point sources, drawing any that are still pending.
+         * @see beginPointSourceLayer()
+         */
+        virtual void endPointSourceLayer();
+
         /**
         * @short Draw a deep sky object (loaded from the new implementation)
         * @param obj the object to draw
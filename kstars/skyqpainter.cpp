@@ -38,8 +38,14 @@
 #include "hips/hipsrenderer.h"
 #include "terrain/terrainrenderer.h"
 #include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent>
 #include "auxiliary/rectangleoverlap.h"
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 namespace
 {
 // Convert spectral class to numerical index.
@@ -86,6 +92,43 @@ const int nSPclasses = 7;
 // These pixmaps are never deallocated. Not really good...
 QPixmap *imageCache[nSPclasses][nStarSizes] = { { nullptr } };
 
+// Premultiplied copies of imageCache, for copying stars straight into a QImage.
+QImage spriteCache[nSPclasses][nStarSizes];
+
+// Multiplies the channels of a premultiplied ARGB pixel by a / 255, rounding like QPainter does.
+inline uint byteMul(uint x, uint a)
+{
+    uint t = (x & 0xff00ff) * a;
+    t = (t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8;
+    t &= 0xff00ff;
+    x = ((x >> 8) & 0xff00ff) * a;
+    x = (x + ((x >> 8) & 0xff00ff) + 0x800080);
+    x &= 0xff00ff00;
+    return x | t;
+}
+
+// Composites a premultiplied sprite onto a 32 bit image at x, y, the same way the raster
+// engine blends with SourceOver. The sprite must lie within the image. Only image rows
+// from top up to but not including bottom are written.
+void blitSprite(uchar *bits, qsizetype bytesPerLine, const QImage &sprite, int x, int y,
+                int top = 0, int bottom = std::numeric_limits<int>::max())
+{
+    const int lastRow = std::min(sprite.height(), bottom - y);
+    for (int row = std::max(0, top - y); row < lastRow; row++)
+    {
+        const QRgb *src = reinterpret_cast<const QRgb *>(sprite.constScanLine(row));
+        QRgb *dst = reinterpret_cast<QRgb *>(bits + (y + row) * bytesPerLine) + x;
+        for (int col = 0; col < sprite.width(); col++)
+        {
+            const uint alpha = qAlpha(src[col]);
+            if (alpha == 255)
+                dst[col] = src[col];
+            else if (alpha != 0)
+                dst[col] = src[col] + byteMul(dst[col], 255 - alpha);
+        }
+    }
+}
+
 std::unique_ptr<QPixmap> visibleSatPixmap, invisibleSatPixmap;
 } // namespace
 
@@ -105,6 +148,7 @@ void SkyQPainter::releaseImageCache()
                 delete pmap[size];
 
             pmap[size] = nullptr;
+            spriteCache[harvardToIndex(color)][size] = QImage();
         }
     }
 }
@@ -152,10 +196,13 @@ void SkyQPainter::begin()
     setRenderHint(QPainter::Antialiasing, aa);
     setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform | QPainter::TextAntialiasing, aa);
     m_proj = SkyMap::Instance()->projector();
+    m_ClipSpans.clear();
+    m_SpriteLayerImage = nullptr;
 }
 
 void SkyQPainter::end()
 {
+    endPointSourceLayer();
     QPainter::end();
 }
 
@@ -357,6 +404,8 @@ void SkyQPainter::initStarImages()
                 pmap[size] = new QPixmap();
             *pmap[size] = BigImage.scaled(size, size, Qt::KeepAspectRatio,
                                           Qt::SmoothTransformation);
+            spriteCache[harvardToIndex(color)][size] =
+                pmap[size]->toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
         }
     }
     starColorMode = Options::starColorMode();
@@ -733,12 +782,213 @@ bool SkyQPainter::drawPointSource(const SkyPoint * loc, float mag, char sp)
     }
 }
 
+int SkyQPainter::drawPointSources(const SkyPoint *const *locs, const float *mags, const char *sps,
+                                  int count, bool *drawn)
+{
+    // Vector stars are only used for exports, where speed doesn't matter.
+    if (m_vectorStars && starColorMode != 0)
+        return SkyPainter::drawPointSources(locs, mags, sps, count, drawn);
+
+    QImage *image = spriteTarget();
+    uchar *bits = image ? image->bits() : nullptr;
+    const qsizetype bytesPerLine = image ? image->bytesPerLine() : 0;
+    const double dx = worldTransform().dx();
+    const double dy = worldTransform().dy();
+
+    // Project the stars that pass the quick visibility check all at once.
+    m_BatchIndices.clear();
+    m_BatchPoints.clear();
+    for (int i = 0; i < count; i++)
+    {
+        if (drawn)
+            drawn[i] = false;
+        if (!m_proj->checkVisibility(locs[i]))
+            continue;
+        m_BatchIndices.push_back(i);
+        m_BatchPoints.push_back(locs[i]);
+    }
+    const int candidates = m_BatchPoints.size();
+    m_BatchX.resize(candidates);
+    m_BatchY.resize(candidates);
+    m_BatchFlags.resize(candidates);
+    m_proj->toScreenBatch(m_BatchPoints.data(), candidates, m_BatchX.data(), m_BatchY.data(), m_BatchFlags.data());
+
+    int drawnCount = 0;
+    for (int k = 0; k < candidates; k++)
+    {
+        if (!(m_BatchFlags[k] & Projector::OnScreen))
+            continue;
+
+        const int i = m_BatchIndices[k];
+        const QPointF pos(m_BatchX[k], m_BatchY[k]);
+        const float size = starWidth(mags[i]);
+        const QImage &sprite = spriteCache[harvardToIndex(sps[i])][qMin(static_cast<int>(size), 14)];
+        const double offset = 0.5 * sprite.width();
+        // The raster engine rounds untransformed images to whole pixels too
+        const int x = qRound(pos.x() - offset + dx);
+        const int y = qRound(pos.y() - offset + dy);
+        if (bits && spriteInsideClip(x, y, sprite.width(), sprite.height()))
+        {
+            if (m_SpriteLayerImage)
+                m_SpriteCommands.push_back({ &sprite, x, y });
+            else
+                blitSprite(bits, bytesPerLine, sprite, x, y);
+        }
+        else
+            drawPointSource(pos, size, sps[i]);
+
+        if (drawn)
+            drawn[i] = true;
+        drawnCount++;
+    }
+    return drawnCount;
+}
+
+void SkyQPainter::beginPointSourceLayer()
+{
+    endPointSourceLayer();
+    // Vector stars are only used for exports, where speed doesn't matter.
+    if (Options::parallelStarRendering() && !(m_vectorStars && starColorMode != 0))
+        m_SpriteLayerImage = spriteTarget();
+}
+
+void SkyQPainter::endPointSourceLayer()
+{
+    flushSprites();
+    m_SpriteLayerImage = nullptr;
+}
+
+void SkyQPainter::flushSprites()
+{
+    if (m_SpriteCommands.empty())
+        return;
+
+    uchar *bits = m_SpriteLayerImage->bits();
+    const qsizetype bytesPerLine = m_SpriteLayerImage->bytesPerLine();
+    const int height = m_SpriteLayerImage->height();
+
+    // A few bands per thread so that the load evens out when the stars are not spread evenly.
+    // Threads are not worth starting for a handful of stars.
+    const int bandCount = (m_SpriteCommands.size() < 1000) ? 1 : qBound(1, 4 * QThread::idealThreadCount(), height / 32);
+    if (bandCount == 1)
+    {
+        for (const auto &command : m_SpriteCommands)
+            blitSprite(bits, bytesPerLine, *command.sprite, command.x, command.y);
+        m_SpriteCommands.clear();
+        return;
+    }
+
+    // Sort the commands by band, keeping their order within each band. A sprite crossing
+    // the edge between two bands is listed in both and each draws its own rows of it.
+    const int bandHeight = (height + bandCount - 1) / bandCount;
+    m_BandStart.assign(bandCount + 1, 0);
+    for (const auto &command : m_SpriteCommands)
+    {
+        for (int band = command.y / bandHeight; band <= (command.y + command.sprite->height() - 1) / bandHeight; band++)
+            m_BandStart[band + 1]++;
+    }
+    std::partial_sum(m_BandStart.begin(), m_BandStart.end(), m_BandStart.begin());
+    m_BandCommands.resize(m_BandStart.back());
+    std::vector<int> next(m_BandStart.begin(), m_BandStart.end() - 1);
+    for (int i = 0; i < static_cast<int>(m_SpriteCommands.size()); i++)
+    {
+        const auto &command = m_SpriteCommands[i];
+        for (int band = command.y / bandHeight; band <= (command.y + command.sprite->height() - 1) / bandHeight; band++)
+            m_BandCommands[next[band]++] = i;
+    }
+
+    // Bands don't share rows, so the threads never write the same pixel.
+    std::vector<int> bands(bandCount);
+    std::iota(bands.begin(), bands.end(), 0);
+    QtConcurrent::blockingMap(bands, [&](const int &band)
+    {
+        const int top = band * bandHeight;
+        const int bottom = top + bandHeight;
+        for (int k = m_BandStart[band]; k < m_BandStart[band + 1]; k++)
+        {
+            const auto &command = m_SpriteCommands[m_BandCommands[k]];
+            blitSprite(bits, bytesPerLine, *command.sprite, command.x, command.y, top, bottom);
+        }
+    });
+    m_SpriteCommands.clear();
+}
+
+QImage *SkyQPainter::spriteTarget()
+{
+    if (m_pd == nullptr || m_pd->devType() != QInternal::Image || compositionMode() != QPainter::CompositionMode_SourceOver
+            || opacity() < 1.0 || worldTransform().type() > QTransform::TxTranslate)
+        return nullptr;
+
+    QImage *image = static_cast<QImage *>(m_pd);
+    if (image->format() != QImage::Format_ARGB32_Premultiplied && image->format() != QImage::Format_RGB32)
+        return nullptr;
+
+    const bool clipped = hasClipping();
+    const QPainterPath clip = clipped ? clipPath() : QPainterPath();
+    if (!m_ClipSpans.empty() && m_ClipSpansSize == image->size() && m_ClipSpansClipped == clipped
+            && m_ClipSpansPath == clip && m_ClipSpansTransform == worldTransform())
+        return image;
+
+    m_ClipSpansSize = image->size();
+    m_ClipSpansClipped = clipped;
+    m_ClipSpansPath = clip;
+    m_ClipSpansTransform = worldTransform();
+    m_ClipSpans.assign(image->height(), std::make_pair(0, image->width() - 1));
+    if (!clipped)
+        return image;
+
+    // The clip may be antialiased, so keep a pixel away from its edges.
+    std::vector<int> rects(image->height(), 0);
+    const QRegion region(worldTransform().map(clip).toFillPolygon().toPolygon(), clip.fillRule());
+    for (auto &span : m_ClipSpans)
+        span = std::make_pair(0, -1);
+    for (const QRect &rect : region)
+    {
+        for (int row = std::max(0, rect.top()); row <= std::min(image->height() - 1, rect.bottom()); row++)
+        {
+            if (++rects[row] == 1)
+                m_ClipSpans[row] = std::make_pair(std::max(0, rect.left() + 1), std::min(image->width() - 1, rect.right() - 1));
+            else
+                m_ClipSpans[row] = std::make_pair(0, -1);
+        }
+    }
+    return image;
+}
+
+bool SkyQPainter::spriteInsideClip(int x, int y, int w, int h) const
+{
+    // Also check the rows just above and below, in case the clip is antialiased.
+    if (y < 1 || y + h >= static_cast<int>(m_ClipSpans.size()))
+        return false;
+    for (int row = y - 1; row <= y + h; row++)
+    {
+        const auto &span = m_ClipSpans[row];
+        if (x < span.first || x + w - 1 > span.second)
+            return false;
+    }
+    return true;
+}
+
 void SkyQPainter::drawPointSource(const QPointF &pos, float size, char sp)
 {
     int isize = qMin(static_cast<int>(size), 14);
     if (!m_vectorStars || starColorMode == 0)
     {
         // Draw stars as bitmaps, either because we were asked to, or because we're painting real colors
+        if (m_SpriteLayerImage)
+        {
+            const QImage &sprite = spriteCache[harvardToIndex(sp)][isize];
+            const double offset = 0.5 * sprite.width();
+            const int x = qRound(pos.x() - offset + worldTransform().dx());
+            const int y = qRound(pos.y() - offset + worldTransform().dy());
+            if (spriteInsideClip(x, y, sprite.width(), sprite.height()))
+            {
+                m_SpriteCommands.push_back({ &sprite, x, y });
+                return;
+            }
+            // Stars drawn so far must stay below this one
+            flushSprites();
+        }
         QPixmap *im  = imageCache[harvardToIndex(sp)][isize];
         float offset = 0.5 * im->width();
         drawPixmap(QPointF(pos.x() - offset, pos.y() - offset), *im);
@@ -12,6 +12,10 @@
 
 #include <QColor>
 #include <QMap>
+#include <QPainterPath>
+
+#include <utility>
+#include <vector>
 
 class Projector;
 class QWidget;
@@ -88,6 +92,10 @@ class SkyQPainter : public SkyPainter, public QPainter
                              LineListLabel *label = nullptr) override;
         void drawSkyPolygon(LineList *list, bool forceClip = true) override;
         bool drawPointSource(const SkyPoint *loc, float mag, char sp = 'A') override;
+        int drawPointSources(const SkyPoint *const *locs, const float *mags, const char *sps,
+                             int count, bool *drawn = nullptr) override;
+        void beginPointSourceLayer() override;
+        void endPointSourceLayer() override;
         bool drawCatalogObject(const CatalogObject &obj) override;
         void drawCatalogObjectImage(const QPointF &pos, const CatalogObject &obj,
                                     float positionAngle);
@@ -116,6 +124,50 @@ class SkyQPainter : public SkyPainter, public QPainter
 
     private:
         QColor skyColor() const;
+
+        /**
+         * @short Returns the image being painted on, if star sprites can be copied straight into it.
+         * That needs a 32 bit image, and a painter that only translates and blends with SourceOver.
+         * Also brings m_ClipSpans up to date with the current clip.
+         */
+        QImage *spriteTarget();
+
+        /** @return true if a w x h sprite at x, y is well inside the clip, so that it can be copied into the image. */
+        bool spriteInsideClip(int x, int y, int w, int h) const;
+
+        /**
+         * @short Copies the sprites recorded since beginPointSourceLayer() into the image.
+         * The image is split into bands of rows that are filled on separate threads.
+         */
+        void flushSprites();
+
+        // For each row of the image, the first and last column well inside the clip, or an empty span
+        // if the clip there is not a single span. Rebuilt when the clip or the image changes.
+        std::vector<std::pair<int, int>> m_ClipSpans;
+        bool m_ClipSpansClipped { false };
+        QPainterPath m_ClipSpansPath;
+        QTransform m_ClipSpansTransform;
+        QSize m_ClipSpansSize;
+        // Scratch space of drawPointSources(), kept to avoid allocating for every trixel.
+        std::vector<int> m_BatchIndices;
+        std::vector<const SkyPoint *> m_BatchPoints;
+        std::vector<float> m_BatchX;
+        std::vector<float> m_BatchY;
+        std::vector<quint8> m_BatchFlags;
+        // A star sprite to be copied into the image at x, y
+        struct SpriteCommand
+        {
+            const QImage *sprite;
+            int x;
+            int y;
+        };
+        // The image of the current point source layer, or null if sprites are copied right away
+        QImage *m_SpriteLayerImage { nullptr };
+        // Sprites of the current point source layer, in drawing order
+        std::vector<SpriteCommand> m_SpriteCommands;
+        // The commands of band b are m_BandCommands[m_BandStart[b]] to m_BandCommands[m_BandStart[b + 1] - 1]
+        std::vector<int> m_BandStart;
+        std::vector<int> m_BandCommands;
         QPaintDevice *m_pd{ nullptr };
         const Projector *m_proj{ nullptr };
         bool m_vectorStars{ false };